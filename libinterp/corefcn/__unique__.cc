@@ -0,0 +1,617 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Array.h"
+#include "boolNDArray.h"
+#include "chNDArray.h"
+#include "dNDArray.h"
+#include "fNDArray.h"
+#include "int16NDArray.h"
+#include "int32NDArray.h"
+#include "int64NDArray.h"
+#include "int8NDArray.h"
+#include "oct-inttypes.h"
+#include "uint16NDArray.h"
+#include "uint32NDArray.h"
+#include "uint64NDArray.h"
+#include "uint8NDArray.h"
+
+#include "defun.h"
+#include "error.h"
+#include "ovl.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Hash based kernels for unique, ismember, intersect, and setdiff.
+//
+// The elements (or rows) of an array are grouped with an open
+// addressing hash table, so that the work is proportional to the
+// number of elements.  Only the distinct values need to be sorted when
+// the output is sorted.  Elements are compared by their bit patterns,
+// after replacing -0 by 0.  Elements or rows that contain NaN are not
+// equal to anything, as with the == operator.
+
+static inline uint64_t
+key_bits (double x)
+{
+  if (x == 0)
+    x = 0;
+
+  uint64_t bits;
+  std::memcpy (&bits, &x, sizeof (bits));
+  return bits;
+}
+
+static inline uint64_t
+key_bits (float x)
+{
+  if (x == 0)
+    x = 0;
+
+  uint32_t bits;
+  std::memcpy (&bits, &x, sizeof (bits));
+  return bits;
+}
+
+static inline uint64_t
+key_bits (char x)
+{
+  return static_cast<unsigned char> (x);
+}
+
+static inline uint64_t
+key_bits (bool x)
+{
+  return x;
+}
+
+template <typename T>
+static inline uint64_t
+key_bits (const octave_int<T>& x)
+{
+  return static_cast<uint64_t> (x.value ());
+}
+
+template <typename T>
+static inline bool
+key_isnan (const T&)
+{
+  return false;
+}
+
+static inline bool
+key_isnan (double x)
+{
+  return std::isnan (x);
+}
+
+static inline bool
+key_isnan (float x)
+{
+  return std::isnan (x);
+}
+
+// Finalizer of the SplitMix64 generator.  Consecutive integers and
+// floating point values that only differ in their high bits must end
+// up in different slots of the table.
+
+static inline uint64_t
+mix_bits (uint64_t h)
+{
+  h = (h ^ (h >> 30)) * UINT64_C (0xbf58476d1ce4e5b9);
+  h = (h ^ (h >> 27)) * UINT64_C (0x94d049bb133111eb);
+  return h ^ (h >> 31);
+}
+
+// The elements of a numeric, char, or logical array, or its rows.
+
+template <typename T>
+class array_keys
+{
+public:
+
+  array_keys (const Array<T>& x, bool by_rows)
+    : m_array (x), m_data (x.data ()),
+      m_n (by_rows ? x.rows () : x.numel ()),
+      m_nc (by_rows ? x.columns () : 1)
+  { }
+
+  OCTAVE_DEFAULT_COPY_MOVE (array_keys)
+
+  octave_idx_type numel () const { return m_n; }
+
+  bool is_unmatched (octave_idx_type i) const
+  {
+    for (octave_idx_type j = 0; j < m_nc; j++)
+      {
+        if (key_isnan (m_data[i + j*m_n]))
+          return true;
+      }
+
+    return false;
+  }
+
+  std::size_t hash (octave_idx_type i) const
+  {
+    uint64_t h = 0;
+
+    for (octave_idx_type j = 0; j < m_nc; j++)
+      h = mix_bits (h + key_bits (m_data[i + j*m_n]));
+
+    return h;
+  }
+
+  bool equal (octave_idx_type i, const array_keys& other,
+              octave_idx_type k) const
+  {
+    for (octave_idx_type j = 0; j < m_nc; j++)
+      {
+        if (key_bits (m_data[i + j*m_n])
+            != key_bits (other.m_data[k + j*other.m_n]))
+          return false;
+      }
+
+    return true;
+  }
+
+  // Ascending order, with NaN last, as sort and sortrows do.
+  bool less (octave_idx_type i, octave_idx_type k) const
+  {
+    for (octave_idx_type j = 0; j < m_nc; j++)
+      {
+        const T& a = m_data[i + j*m_n];
+        const T& b = m_data[k + j*m_n];
+
+        if (key_isnan (a) || key_isnan (b))
+          {
+            if (! key_isnan (a))
+              return true;
+            else if (! key_isnan (b))
+              return false;
+          }
+        else if (a < b)
+          return true;
+        else if (b < a)
+          return false;
+      }
+
+    return false;
+  }
+
+private:
+
+  // Keep a reference to the data.
+  Array<T> m_array;
+
+  const T *m_data;
+
+  octave_idx_type m_n;
+
+  octave_idx_type m_nc;
+};
+
+// The elements of a cell array of strings.
+
+class string_keys
+{
+public:
+
+  string_keys (const Array<std::string>& x)
+    : m_array (x), m_data (x.data ()), m_n (x.numel ())
+  { }
+
+  OCTAVE_DEFAULT_COPY_MOVE (string_keys)
+
+  octave_idx_type numel () const { return m_n; }
+
+  bool is_unmatched (octave_idx_type) const { return false; }
+
+  std::size_t hash (octave_idx_type i) const
+  {
+    return std::hash<std::string> () (m_data[i]);
+  }
+
+  bool equal (octave_idx_type i, const string_keys& other,
+              octave_idx_type k) const
+  {
+    return m_data[i] == other.m_data[k];
+  }
+
+  bool less (octave_idx_type i, octave_idx_type k) const
+  {
+    return m_data[i] < m_data[k];
+  }
+
+private:
+
+  Array<std::string> m_array;
+
+  const std::string *m_data;
+
+  octave_idx_type m_n;
+};
+
+// Number of slots for a table that holds N keys at a load factor of at
+// most 1/2.
+
+static std::size_t
+table_size (octave_idx_type n)
+{
+  std::size_t nslots = 16;
+
+  while (nslots < 2 * static_cast<std::size_t> (n))
+    nslots *= 2;
+
+  return nslots;
+}
+
+// Find the distinct keys of X.  Return the (one-based) indices of the
+// first or last occurrence of each distinct key in II, either in
+// sorted order or in the order of their first occurrence, and the
+// position of the key of each element in that list in JJ.
+
+template <typename K>
+static void
+unique_keys (const K& x, bool optlast, bool optstable,
+             NDArray& ii, NDArray& jj)
+{
+  octave_idx_type n = x.numel ();
+
+  std::vector<octave_idx_type> grp (n);
+  std::vector<octave_idx_type> first;
+  std::vector<octave_idx_type> last;
+
+  std::size_t nslots = table_size (n);
+  std::size_t mask = nslots - 1;
+
+  // Number of the group in each slot, or -1.
+  std::vector<octave_idx_type> slots (nslots, -1);
+
+  for (octave_idx_type i = 0; i < n; i++)
+    {
+      octave_idx_type g = -1;
+
+      if (! x.is_unmatched (i))
+        {
+          std::size_t p = x.hash (i) & mask;
+
+          while (slots[p] >= 0)
+            {
+              if (x.equal (i, x, first[slots[p]]))
+                {
+                  g = slots[p];
+                  break;
+                }
+
+              p = (p + 1) & mask;
+            }
+
+          if (g < 0)
+            slots[p] = first.size ();
+        }
+
+      if (g < 0)
+        {
+          g = first.size ();
+          first.push_back (i);
+          last.push_back (i);
+        }
+      else
+        last[g] = i;
+
+      grp[i] = g;
+    }
+
+  octave_idx_type ngrp = first.size ();
+
+  std::vector<octave_idx_type> order (ngrp);
+  for (octave_idx_type g = 0; g < ngrp; g++)
+    order[g] = g;
+
+  if (! optstable)
+    std::stable_sort (order.begin (), order.end (),
+                      [&x, &first] (octave_idx_type a, octave_idx_type b)
+                      { return x.less (first[a], first[b]); });
+
+  std::vector<octave_idx_type> rank (ngrp);
+
+  ii.resize (dim_vector (ngrp, 1));
+
+  const std::vector<octave_idx_type>& rep = (optlast ? last : first);
+
+  for (octave_idx_type p = 0; p < ngrp; p++)
+    {
+      rank[order[p]] = p;
+      ii.xelem (p) = rep[order[p]] + 1;
+    }
+
+  jj.resize (dim_vector (n, 1));
+
+  for (octave_idx_type i = 0; i < n; i++)
+    jj.xelem (i) = rank[grp[i]] + 1;
+}
+
+// Look up the keys of A in S.  TF is true for the keys that are found
+// and IDX is the (one-based) index of the last occurrence in S, or 0.
+
+template <typename K>
+static void
+member_keys (const K& a, const K& s, boolNDArray& tf, NDArray& idx)
+{
+  octave_idx_type na = a.numel ();
+  octave_idx_type ns = s.numel ();
+
+  std::size_t nslots = table_size (ns);
+  std::size_t mask = nslots - 1;
+
+  // Index in S of the key in each slot, or -1.
+  std::vector<octave_idx_type> slots (nslots, -1);
+
+  for (octave_idx_type k = 0; k < ns; k++)
+    {
+      if (s.is_unmatched (k))
+        continue;
+
+      std::size_t p = s.hash (k) & mask;
+
+      while (slots[p] >= 0 && ! s.equal (k, s, slots[p]))
+        p = (p + 1) & mask;
+
+      slots[p] = k;
+    }
+
+  for (octave_idx_type i = 0; i < na; i++)
+    {
+      octave_idx_type k = -1;
+
+      if (! a.is_unmatched (i))
+        {
+          std::size_t p = a.hash (i) & mask;
+
+          while (slots[p] >= 0)
+            {
+              if (a.equal (i, s, slots[p]))
+                {
+                  k = slots[p];
+                  break;
+                }
+
+              p = (p + 1) & mask;
+            }
+        }
+
+      tf.xelem (i) = (k >= 0);
+      idx.xelem (i) = k + 1;
+    }
+}
+
+// Call FCN with the keys of X, or with the keys of X and Y, which must
+// be of the same class.
+
+#define KEY_CLASS_LIST(ACTION)                                  \
+  ACTION (is_double_type, double, array_value)                  \
+  ACTION (is_single_type, float, float_array_value)             \
+  ACTION (is_int8_type, octave_int8, int8_array_value)          \
+  ACTION (is_int16_type, octave_int16, int16_array_value)       \
+  ACTION (is_int32_type, octave_int32, int32_array_value)       \
+  ACTION (is_int64_type, octave_int64, int64_array_value)       \
+  ACTION (is_uint8_type, octave_uint8, uint8_array_value)       \
+  ACTION (is_uint16_type, octave_uint16, uint16_array_value)    \
+  ACTION (is_uint32_type, octave_uint32, uint32_array_value)    \
+  ACTION (is_uint64_type, octave_uint64, uint64_array_value)    \
+  ACTION (is_char_matrix, char, char_array_value)               \
+  ACTION (islogical, bool, bool_array_value)
+
+template <typename Fcn>
+static void
+dispatch_keys (const char *who, const octave_value& x, bool by_rows,
+               Fcn fcn)
+{
+  if (x.iscellstr ())
+    {
+      fcn (string_keys (x.cellstr_value ()));
+      return;
+    }
+
+  if (! x.issparse () && ! x.iscomplex ())
+    {
+#define CALL_WITH_KEYS(PRED, T, VALUE)                          \
+      if (x.PRED ())                                            \
+        {                                                       \
+          fcn (array_keys<T> (x.VALUE (), by_rows));            \
+          return;                                               \
+        }
+
+      KEY_CLASS_LIST (CALL_WITH_KEYS)
+
+#undef CALL_WITH_KEYS
+    }
+
+  error ("%s: X must be a real full array or a cell array of strings", who);
+}
+
+template <typename Fcn>
+static void
+dispatch_keys (const char *who, const octave_value& x, const octave_value& y,
+               bool by_rows, Fcn fcn)
+{
+  if (x.iscellstr () && y.iscellstr ())
+    {
+      fcn (string_keys (x.cellstr_value ()), string_keys (y.cellstr_value ()));
+      return;
+    }
+
+  if (! x.issparse () && ! x.iscomplex () && ! y.issparse ()
+      && ! y.iscomplex ())
+    {
+#define CALL_WITH_KEYS(PRED, T, VALUE)                          \
+      if (x.PRED () && y.PRED ())                               \
+        {                                                       \
+          fcn (array_keys<T> (x.VALUE (), by_rows),             \
+               array_keys<T> (y.VALUE (), by_rows));            \
+          return;                                               \
+        }
+
+      KEY_CLASS_LIST (CALL_WITH_KEYS)
+
+#undef CALL_WITH_KEYS
+    }
+
+  error ("%s: A and S must be real full arrays of the same class or cell arrays of strings",
+         who);
+}
+
+#undef KEY_CLASS_LIST
+
+DEFUN (__unique__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{i}, @var{j}] =} __unique__ (@var{x}, @var{by_rows}, @var{last}, @var{stable})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 4)
+    print_usage ();
+
+  octave_value x = args(0);
+  bool by_rows = args(1).bool_value ();
+  bool optlast = args(2).bool_value ();
+  bool optstable = args(3).bool_value ();
+
+  if (by_rows && x.ndims () > 2)
+    error ("__unique__: X must be a 2-D array with \"rows\"");
+
+  NDArray ii, jj;
+
+  dispatch_keys ("__unique__", x, by_rows,
+                 [=, &ii, &jj] (const auto& keys)
+                 { unique_keys (keys, optlast, optstable, ii, jj); });
+
+  return ovl (ii, jj);
+}
+
+DEFUN (__ismember__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{tf}, @var{s_idx}] =} __ismember__ (@var{a}, @var{s}, @var{by_rows})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 3)
+    print_usage ();
+
+  octave_value a = args(0);
+  octave_value s = args(1);
+  bool by_rows = args(2).bool_value ();
+
+  if (by_rows && (a.ndims () > 2 || s.ndims () > 2))
+    error ("__ismember__: A and S must be 2-D arrays with \"rows\"");
+
+  if (by_rows && a.columns () != s.columns () && a.rows () > 0
+      && s.rows () > 0)
+    error ("__ismember__: A and S must have the same number of columns");
+
+  // Arrays of different classes are compared as double values, which
+  // is exact unless one of them is a 64-bit integer array.
+  if (! a.iscellstr () && ! s.iscellstr ()
+      && a.class_name () != s.class_name ())
+    {
+      if (a.is_int64_type () || a.is_uint64_type ()
+          || s.is_int64_type () || s.is_uint64_type ())
+        error ("__ismember__: 64-bit integer arrays can only be compared with arrays of the same class");
+
+      a = a.array_value (true);
+      s = s.array_value (true);
+    }
+
+  dim_vector dv = (by_rows ? dim_vector (a.rows (), 1) : a.dims ());
+
+  boolNDArray tf (dv);
+  NDArray idx (dv);
+
+  dispatch_keys ("__ismember__", a, s, by_rows,
+                 [&tf, &idx] (const auto& akeys, const auto& skeys)
+                 { member_keys (akeys, skeys, tf, idx); });
+
+  return ovl (tf, idx);
+}
+
+/*
+%!test
+%! [i, j] = __unique__ ([3, 1, 3, NaN, 2, NaN, -0, 0], false, false, false);
+%! assert (i, [7; 2; 5; 1; 4; 6]);
+%! assert (j, [4; 2; 4; 5; 3; 6; 1; 1]);
+%! [i, j] = __unique__ ([3, 1, 3, NaN, 2, NaN, -0, 0], false, true, false);
+%! assert (i, [8; 2; 5; 3; 4; 6]);
+%! [i, j] = __unique__ ([3, 1, 3, NaN, 2, NaN, -0, 0], false, false, true);
+%! assert (i, [1; 2; 4; 5; 6; 7]);
+%! assert (j, [1; 2; 1; 3; 4; 5; 6; 6]);
+
+%!test
+%! x = {"b", "a", "b", "", "a"};
+%! [i, j] = __unique__ (x, false, false, false);
+%! assert (x(i), {"", "a", "b"});
+%! assert (j, [3; 2; 3; 1; 2]);
+
+%!test
+%! x = int8 ([1, 2; 3, 4; 1, 2; -1, 5]);
+%! [i, j] = __unique__ (x, true, true, false);
+%! assert (i, [4; 3; 2]);
+%! assert (j, [2; 3; 2; 1]);
+
+%!test
+%! [tf, idx] = __ismember__ ([1, 5, NaN; 2, 0, 3], [3, 1, 1, NaN, -0], false);
+%! assert (tf, [true, false, false; false, true, true]);
+%! assert (idx, [3, 0, 0; 0, 5, 1]);
+
+%!test
+%! [tf, idx] = __ismember__ ({"a", "c"; "b", "a"}, {"a", "b", "a"}, false);
+%! assert (tf, [true, false; true, true]);
+%! assert (idx, [3, 0; 2, 3]);
+
+%!test
+%! [tf, idx] = __ismember__ (int16 ([1, 2; 3, 4]), [3, 4; 1, 2; 3, 4], true);
+%! assert (tf, [true; true]);
+%! assert (idx, [2; 3]);
+%! [tf, idx] = __ismember__ ("abc", [98, 99.5], false);
+%! assert (tf, [false, true, false]);
+%! assert (idx, [0, 1, 0]);
+
+%!error <64-bit integer arrays>
+%! __ismember__ (int64 (1), 1, false);
+%!error <must be a real full array> __unique__ (sparse (1), false, false, false)
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -7252,6 +7252,47 @@ ordered lists.
 %! assert (v, [false, false, true, true]);
 %! assert (i, [2, 4, 1, 3]);
 
+## Large arrays are sorted by radix sort and in parallel
+%!test
+%! x = [fix(10 * randn(3e5, 1)); NaN; -0; 0; NaN; -Inf; Inf];
+%! [v, i] = sort (x);
+%! assert (v, x(i));
+%! assert (all (diff (v(1:end-2)) >= 0));
+%! assert (isnan (v(end-1:end)));
+%! same = diff (v) == 0;
+%! assert (all (diff (i)(same) > 0));
+%! [v, i] = sort (x, "descend");
+%! assert (v, x(i));
+%! assert (isnan (v(1:2)));
+%! assert (all (diff (v(3:end)) <= 0));
+%! same = diff (v) == 0;
+%! assert (all (diff (i)(same) > 0));
+
+%!test
+%! x = single (randn (3e5, 1));
+%! assert (sort (x), sort (double (x)));
+%! assert (sort (x, "descend"), flipud (sort (double (x))));
+
+%!test
+%! x = int16 (fix (1000 * randn (3e5, 1)));
+%! [v, i] = sort (x);
+%! assert (v, x(i));
+%! assert (all (diff (v) >= 0));
+%! assert (all (diff (i)(diff (v) == 0) > 0));
+%! assert (sort (x, "descend"), flipud (v));
+
+%!test
+%! x = randi ([-1e6, 1e6], 4e5, 1);
+%! old_nthreads = maxNumCompThreads (1);
+%! unwind_protect
+%!   [v1, i1] = sort (x, "descend");
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (old_nthreads);
+%! end_unwind_protect
+%! [v2, i2] = sort (x, "descend");
+%! assert (v2, v1);
+%! assert (i2, i1);
+
 ## Sparse Double
 %!assert (sort (sparse ([0, NaN, 1, 0, -1, 2, Inf])),
 %!        sparse ([-1, 0, 0, 1, 2, Inf, NaN]))
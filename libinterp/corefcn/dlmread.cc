@@ -30,15 +30,24 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <atomic>
 #include <clocale>
 #include <cmath>
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <limits>
+#include <vector>
 
+#include "fcntl-wrappers.h"
 #include "file-ops.h"
 #include "lo-ieee.h"
 #include "lo-sysdep.h"
+#include "mman-wrappers.h"
+#include "oct-thread-pool.h"
+#include "unistd-wrappers.h"
 
 #include "defun.h"
 #include "interpreter.h"
@@ -169,6 +178,494 @@ parse_range_spec (const octave_value& range_spec,
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+// A data file that is mapped into memory.  DATA is null if the file
+// can not be mapped, for example because it is not a regular file.
+
+class mapped_data_file
+{
+public:
+
+  mapped_data_file (const std::string& name)
+    : m_data (nullptr), m_size (0), m_base (nullptr), m_map_len (0)
+  {
+    int fd = octave_open_wrapper (name.c_str (), octave_o_rdonly_wrapper (),
+                                  0);
+
+    if (fd >= 0)
+      {
+        m_data = octave_mmap_file_wrapper (fd, 0, &m_size, &m_base,
+                                           &m_map_len);
+
+        // The mapping stays valid after the file is closed.
+        octave_close_wrapper (fd);
+      }
+  }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (mapped_data_file)
+
+  ~mapped_data_file () { octave_munmap_file_wrapper (m_base, m_map_len); }
+
+  const char * data () const { return m_data; }
+
+  std::size_t size () const { return m_size; }
+
+private:
+
+  const char *m_data;
+  std::size_t m_size;
+  void *m_base;
+  std::size_t m_map_len;
+};
+
+// Return the end of the line that starts at P (excluding the newline)
+// and in NEXT the start of the next line.  As with getline, only "\n"
+// ends a line.
+
+static inline const char *
+find_eol (const char *p, const char *end, const char *& next)
+{
+  const char *eol
+    = static_cast<const char *> (std::memchr (p, '\n', end - p));
+
+  if (eol)
+    next = eol + 1;
+  else
+    next = eol = end;
+
+  return eol;
+}
+
+static inline bool
+is_blank_line (const char *p, const char *eol)
+{
+  for (; p < eol; p++)
+    if (*p != ' ' && *p != '\t')
+      return false;
+
+  return true;
+}
+
+// Split the line [P, EOL) into fields in the same way as the general
+// code in Fdlmread and call FCN (J, BEGIN, END) for each of them.
+// Return the number of fields.
+
+template <typename F>
+static octave_idx_type
+split_fields (const char *p, const char *eol, const bool *is_sep,
+              bool merge_seps, F fcn)
+{
+  if (merge_seps)
+    {
+      while (p < eol && (*p == ' ' || *p == '\t'))
+        p++;
+    }
+
+  octave_idx_type j = 0;
+
+  for (;;)
+    {
+      const char *q = p;
+      while (q < eol && ! is_sep[static_cast<unsigned char> (*q)])
+        q++;
+
+      const char *field_end = q;
+      bool last = (q == eol);
+
+      if (merge_seps && ! last)
+        {
+          // Treat consecutive separators as one.
+          while (q < eol && is_sep[static_cast<unsigned char> (*q)])
+            q++;
+          q--;
+        }
+
+      // Separator followed by EOL doesn't generate extra column
+      if (last && field_end == p)
+        break;
+
+      fcn (j++, p, field_end);
+
+      if (last)
+        break;
+
+      p = q + 1;
+    }
+
+  return j;
+}
+
+// Convert the field [P, END) to a double value in VAL with the same
+// result as read_value<double> in the general code.  Return false for
+// fields that the general code handles in a special way (complex values
+// and numbers that are followed by other text).
+
+static bool
+convert_field (const char *p, const char *end, double empty_value,
+               double& val)
+{
+  while (p < end && std::isspace (static_cast<unsigned char> (*p)))
+    p++;
+
+  while (end > p && std::isspace (static_cast<unsigned char> (end[-1])))
+    end--;
+
+  val = empty_value;
+
+  if (p == end)
+    return true;
+
+  bool neg = false;
+  if (*p == '+' || *p == '-')
+    {
+      neg = (*p++ == '-');
+
+      if (p == end || *p == '+' || *p == '-')
+        return false;
+    }
+
+  unsigned char ch = *p;
+
+  if (ch == 'i' || ch == 'I' || ch == 'n' || ch == 'N')
+    {
+      const char *q = p + 1;
+
+      if (q == end || (ch == 'i' || ch == 'I' ? (*q != 'n' && *q != 'N')
+                                              : (*q != 'a' && *q != 'A')))
+        return true;
+
+      q++;
+
+      if (ch == 'i' || ch == 'I')
+        {
+          if (q == end || (*q != 'f' && *q != 'F'))
+            return true;
+
+          val = (neg ? -numeric_limits<double>::Inf ()
+                     : numeric_limits<double>::Inf ());
+          q++;
+        }
+      else if (q < end && (*q == 'n' || *q == 'N'))
+        {
+          val = numeric_limits<double>::NaN ();
+          q++;
+        }
+      else
+        val = numeric_limits<double>::NA ();
+
+      if (q == end)
+        return true;
+
+      // Inf, NaN, or NA followed by text is an empty field, but a
+      // following imaginary unit or number makes a complex value.
+      ch = *q;
+      val = empty_value;
+      return (std::isalpha (ch) && ch != 'i' && ch != 'I'
+              && ch != 'j' && ch != 'J');
+    }
+
+  // Anything else that is not a number is an empty field.
+  if (! std::isdigit (ch) && ch != '.')
+    return true;
+
+  const char *num = p;
+
+  bool have_digits = false;
+  while (p < end && std::isdigit (static_cast<unsigned char> (*p)))
+    {
+      p++;
+      have_digits = true;
+    }
+
+  if (p < end && *p == '.')
+    {
+      p++;
+      while (p < end && std::isdigit (static_cast<unsigned char> (*p)))
+        {
+          p++;
+          have_digits = true;
+        }
+    }
+
+  if (! have_digits)
+    return false;
+
+  if (p < end && (*p == 'e' || *p == 'E'))
+    {
+      p++;
+      if (p < end && (*p == '+' || *p == '-'))
+        p++;
+
+      if (p == end || ! std::isdigit (static_cast<unsigned char> (*p)))
+        return false;
+
+      while (p < end && std::isdigit (static_cast<unsigned char> (*p)))
+        p++;
+    }
+
+  std::size_t len = p - num;
+
+  if (p != end || len >= 128)
+    return false;
+
+  // The C++ streams use strtod for the conversion.  The caller has set
+  // the "C" locale.
+  char buf[128];
+  std::memcpy (buf, num, len);
+  buf[len] = '\0';
+
+  // Numbers that are too large are converted to Inf, as in read_value.
+  double x = std::strtod (buf, nullptr);
+
+  val = (neg ? -x : x);
+
+  return true;
+}
+
+// Read the file NAME from memory if it can be mapped and contains only
+// real values.  The file is split at line boundaries into chunks that
+// are processed in parallel, first to count the rows and columns of the
+// result and then to convert the fields directly into it.  Rows before
+// R0 and after R1 are skipped without splitting them into fields.
+// Return false if the general code has to be used.
+
+static bool
+dlmread_mapped (const std::string& name, std::string sep,
+                octave_idx_type r0, octave_idx_type c0,
+                octave_idx_type r1, octave_idx_type c1,
+                double empty_value, octave_value& retval)
+{
+  mapped_data_file file (name);
+
+  const char *p = file.data ();
+  const char *end = p + file.size ();
+
+  if (! p)
+    return false;
+
+  if (r0 == 0 && end - p >= 3 && p[0] == '\xEF' && p[1] == '\xBB'
+      && p[2] == '\xBF')
+    p += 3;
+
+  // Skip the r0 leading lines
+  for (octave_idx_type k = 0; k < r0; k++)
+    {
+      if (p == end)
+        {
+          // Not enough lines in file to satisfy RANGE
+          retval = Matrix (0, 0);
+          return true;
+        }
+
+      find_eol (p, end, p);
+    }
+
+  bool sep_is_wspace = (sep.find_first_of (" \t") != std::string::npos);
+  bool auto_sep_is_wspace = false;
+
+  if (sep.empty ())
+    {
+      // Infer separator from the first line that is not blank.
+      const char *next;
+      const char *eol = find_eol (p, end, next);
+
+      while (p < end && is_blank_line (p, eol))
+        {
+          p = next;
+          eol = find_eol (p, end, next);
+        }
+
+      if (p == end)
+        {
+          retval = Matrix (0, 0);
+          return true;
+        }
+
+      const char *q = p;
+      while (*q == ' ' || *q == '\t')
+        q++;
+
+      while (q < eol && *q != ',' && *q != ':' && *q != ';' && *q != ' '
+             && *q != '\t')
+        q++;
+
+      if (q == eol || *q == ' ' || *q == '\t')
+        {
+          sep = " \t";
+          auto_sep_is_wspace = true;
+        }
+      else
+        sep = *q;
+    }
+
+  bool skip_blank = (! sep_is_wspace || auto_sep_is_wspace);
+
+  bool is_sep[256] = { };
+  for (unsigned char ch : sep)
+    is_sep[ch] = true;
+
+  // Find the end of the last requested row.
+  if (r1 != idx_max)
+    {
+      const char *q = p;
+
+      for (octave_idx_type k = r1 - r0; k >= 0 && q < end; )
+        {
+          const char *next;
+          const char *eol = find_eol (q, end, next);
+
+          if (! skip_blank || ! is_blank_line (q, eol))
+            k--;
+
+          q = next;
+        }
+
+      end = q;
+    }
+
+  // Split the data into chunks that end at a newline.
+
+  std::size_t nthreads = thread_pool::num_threads ();
+  std::size_t chunk_size = std::max (file.size () / (4 * nthreads),
+                                     std::size_t (1) << 20);
+
+  std::vector<const char *> bounds (1, p);
+  while (bounds.back () < end)
+    {
+      const char *q = bounds.back ();
+
+      if (static_cast<std::size_t> (end - q) <= chunk_size)
+        q = end;
+      else
+        {
+          q = static_cast<const char *>
+              (std::memchr (q + chunk_size, '\n', end - q - chunk_size));
+
+          q = (q ? q + 1 : end);
+        }
+
+      bounds.push_back (q);
+    }
+
+  std::size_t nchunks = bounds.size () - 1;
+
+  // Count the rows and the maximum number of fields in each chunk.
+
+  std::vector<octave_idx_type> first_row (nchunks + 1, 0);
+  std::vector<octave_idx_type> chunk_cols (nchunks, 0);
+
+  auto count_rows = [&] (std::size_t begin, std::size_t end_chunk)
+  {
+    for (std::size_t k = begin; k < end_chunk; k++)
+      {
+        octave_idx_type nrows = 0;
+        octave_idx_type ncols = 0;
+        const char *next;
+
+        for (const char *q = bounds[k]; q < bounds[k+1]; q = next)
+          {
+            const char *eol = find_eol (q, bounds[k+1], next);
+
+            // Skip blank lines for compatibility.
+            if (skip_blank && is_blank_line (q, eol))
+              continue;
+
+            octave_idx_type n
+              = split_fields (q, eol, is_sep, auto_sep_is_wspace,
+                              [] (octave_idx_type, const char *,
+                                  const char *) { });
+
+            ncols = std::max (ncols, n);
+            nrows++;
+          }
+
+        first_row[k+1] = nrows;
+        chunk_cols[k] = ncols;
+      }
+  };
+
+  thread_pool::parallel_for (nchunks, count_rows, 1, 2);
+
+  octave_idx_type ncols = 0;
+  for (std::size_t k = 0; k < nchunks; k++)
+    {
+      first_row[k+1] += first_row[k];
+      ncols = std::max (ncols, chunk_cols[k]);
+    }
+
+  octave_idx_type nrows = first_row[nchunks];
+
+  if (nrows == 0)
+    {
+      retval = Matrix (0, 0);
+      return true;
+    }
+
+  // Leave rows without any fields to the general code.
+  if (ncols == 0)
+    return false;
+
+  // Clip selection indices to actual size of data
+  if (c1 >= ncols)
+    c1 = ncols - 1;
+
+  if (c0 > c1)
+    {
+      retval = Matrix (0, 0);
+      return true;
+    }
+
+  Matrix data (nrows, c1 - c0 + 1, empty_value);
+  double *pdata = data.fortran_vec ();
+
+  std::atomic<bool> failed (false);
+
+  auto convert_rows = [&] (std::size_t begin, std::size_t end_chunk)
+  {
+    for (std::size_t k = begin; k < end_chunk && ! failed; k++)
+      {
+        octave_idx_type row = first_row[k];
+        const char *next;
+
+        for (const char *q = bounds[k]; q < bounds[k+1]; q = next)
+          {
+            const char *eol = find_eol (q, bounds[k+1], next);
+
+            if (skip_blank && is_blank_line (q, eol))
+              continue;
+
+            bool ok = true;
+
+            auto convert = [&] (octave_idx_type j, const char *field,
+                                const char *field_end)
+            {
+              if (j >= c0 && j <= c1 && ok)
+                ok = convert_field (field, field_end, empty_value,
+                                    pdata[(j - c0) * nrows + row]);
+            };
+
+            split_fields (q, eol, is_sep, auto_sep_is_wspace, convert);
+
+            if (! ok)
+              {
+                failed = true;
+                return;
+              }
+
+            row++;
+          }
+      }
+  };
+
+  thread_pool::parallel_for (nchunks, convert_rows, 1, 2);
+
+  if (failed)
+    return false;
+
+  retval = data;
+
+  return true;
+}
+
 DEFMETHOD (dlmread, interp, args, ,
            doc: /* -*- texinfo -*-
 @deftypefn  {} {@var{data} =} dlmread (@var{file})
@@ -221,6 +718,7 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
 
   std::istream *input = nullptr;
   std::ifstream input_file;
+  std::string input_name;
 
   if (args(0).is_string ())
     {
@@ -242,6 +740,7 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
         error ("dlmread: unable to open file '%s'", fname.c_str ());
 
       input = &input_file;
+      input_name = tname;
     }
   else if (args(0).is_scalar_type ())
     {
@@ -293,6 +792,25 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
         return ovl (Matrix (0, 0));
     }
 
+  // Set "C" locale for the remainder of this function to avoid the performance
+  // panelty of frequently switching the locale when reading floating point
+  // values from the stream.
+  char *prev_locale = std::setlocale (LC_ALL, nullptr);
+  std::string old_locale (prev_locale ? prev_locale : "");
+  std::setlocale (LC_ALL, "C");
+  unwind_action act
+  ([old_locale] () { std::setlocale (LC_ALL, old_locale.c_str ()); });
+
+  // Files are read directly from memory if possible.
+  if (! input_name.empty ())
+    {
+      octave_value retval;
+
+      if (dlmread_mapped (input_name, sep, r0, c0, r1, c1, empty_value,
+                          retval))
+        return ovl (retval);
+    }
+
   octave_idx_type i = 0;
   octave_idx_type j = 0;
   octave_idx_type r = 1;
@@ -334,15 +852,6 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
         }
     }
 
-  // Set "C" locale for the remainder of this function to avoid the performance
-  // panelty of frequently switching the locale when reading floating point
-  // values from the stream.
-  char *prev_locale = std::setlocale (LC_ALL, nullptr);
-  std::string old_locale (prev_locale ? prev_locale : "");
-  std::setlocale (LC_ALL, "C");
-  unwind_action act
-  ([old_locale] () { std::setlocale (LC_ALL, old_locale.c_str ()); });
-
   std::string line;
 
   // Skip the r0 leading lines
@@ -749,6 +1258,36 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
 %!   unlink (file);
 %! end_unwind_protect
 
+## Files are read from memory, file ids from the stream.  Both must give
+## the same result.
+%!test
+%! file = tempname ();
+%! unwind_protect
+%!   fid = fopen (file, "wt");
+%!   fprintf (fid, "%d,%.17g,%g\n", [1:3000; rand(1, 3000); -(1:3000)]);
+%!   fprintf (fid, "\n  \n");
+%!   fprintf (fid, "1e400,NaN,NA,-Inf,,text\r\n");
+%!   fprintf (fid, "%d,%d\n", [1:500; 1:500]);
+%!   fclose (fid);
+%!
+%!   fid = fopen (file, "r");
+%!   ref = dlmread (fid);
+%!   fclose (fid);
+%!   assert (size (ref), [3501, 6]);
+%!   assert (dlmread (file), ref);
+%!   assert (dlmread (file, ","), ref);
+%!   assert (dlmread (file, ",", 2999, 1), ref(3000:end,2:end));
+%!   assert (dlmread (file, ",", [10, 1, 2999, 2]), ref(11:3000,2:3));
+%!   assert (dlmread (file, ",", [3000, 2, 3000, Inf]), ref(3001,3:end));
+%!   assert (dlmread (file, "", "B3000.."), ref(3000:end,2:end));
+%!   fid = fopen (file, "r");
+%!   ref = dlmread (fid, "emptyvalue", -1);
+%!   fclose (fid);
+%!   assert (dlmread (file, "emptyvalue", -1), ref);
+%! unwind_protect_cleanup
+%!   unlink (file);
+%! end_unwind_protect
+
 ## Verify UTF-8 Byte Order Mark does not cause problems with reading
 %!test <*58813>
 %! file = tempname ();
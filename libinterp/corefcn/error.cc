@@ -269,6 +269,7 @@ error_system::error_system (interpreter& interp)
     m_last_warning_message (),
     m_last_warning_id (),
     m_last_error_id (),
+    m_warning_count (0),
     m_last_error_stack (init_error_stack (interp))
 {
   initialize_default_warning_state ();
@@ -588,6 +589,8 @@ error_system::error_1 (const char *id, const char *fmt,
 void
 error_system::vwarning (const char *id, const char *fmt, va_list args)
 {
+  m_warning_count++;
+
   int warn_opt = warning_enabled (id);
 
   if (warn_opt == 2)
@@ -219,6 +219,9 @@ public:
   void set_last_warning_id (const std::string& val)
   { m_last_warning_id = val; }
 
+  // Number of warnings raised so far, including disabled warnings.
+  std::size_t warning_count () const { return m_warning_count; }
+
   std::string last_warning_id () const { return m_last_warning_id; }
 
   std::string last_warning_id (const std::string& s)
@@ -389,6 +392,9 @@ private:
   //! The last error message id.
   std::string m_last_error_id;
 
+  //! The number of warnings raised, whether or not they were enabled.
+  std::size_t m_warning_count;
+
   //! The last file in which an error occurred.
   octave_map m_last_error_stack;
 };
@@ -1730,6 +1730,45 @@ as the name of the function when reporting errors.
 %! c = textscan (str, "%f R&D %f", "delimiter", "&", "collectOutput", 1);
 %! assert (c, {[12 7]});
 
+## Files with numeric columns are parsed by a separate, parallel code path.
+## Check that it gives the same results as reading the same text from a
+## string.
+%!function __textscan_file_and_string__ (str, varargin)
+%!  f = tempname ();
+%!  fid = fopen (f, "w+");
+%!  unwind_protect
+%!    fwrite (fid, str);
+%!    fseek (fid, 0, "bof");
+%!    c_file = textscan (fid, varargin{:});
+%!  unwind_protect_cleanup
+%!    fclose (fid);
+%!    unlink (f);
+%!  end_unwind_protect
+%!  c_str = textscan (str, varargin{:});
+%!  assert (c_file, c_str);
+%!endfunction
+
+%!test
+%! str = "0.3,1e-5,-Inf\n12.5, NaN ,-0.1\r\n,7,\n+.5,1d2,3.\n";
+%! __textscan_file_and_string__ (str, "%f %f %f", "delimiter", ",");
+%! __textscan_file_and_string__ (str, "%f %f %f", "delimiter", ",",
+%!                               "CollectOutput", true);
+%! __textscan_file_and_string__ (str, "%f %f %n", "delimiter", ",",
+%!                               "EmptyValue", -1, "HeaderLines", 1);
+%! __textscan_file_and_string__ (str, "", "delimiter", ",");
+%! __textscan_file_and_string__ ("1 2.25\n-3 4e2\n5\t6", "%f %f");
+%! ## Not handled by the fast path.
+%! __textscan_file_and_string__ ("1,2\n3,4i\n5,6\n", "%f %f",
+%!                               "delimiter", ",");
+%! __textscan_file_and_string__ ("1,2\nabc\n5,6\n", "%f %f",
+%!                               "delimiter", ",");
+
+%!test
+%! x = rand (50000, 4);
+%! x(x < 0.01) = NaN;
+%! str = sprintf ("%.17g,%.6g,%g,%d\n", [x(:,1:3), round(1e6*x(:,4))].');
+%! __textscan_file_and_string__ (str, "%f %f %f %f", "delimiter", ",");
+
 ## Check number of lines read, not number of passes through format string
 %!test
 %! f = tempname ();
@@ -1237,6 +1237,11 @@ interpreter::execute_startup_files ()
         }
     }
 
+  // The startup files may have added directories to the load path, for
+  // example by loading packages.
+
+  m_load_path.save_dir_cache ();
+
   if (m_interactive && trace)
     octave_stdout << std::endl;
 
@@ -29,12 +29,23 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <istream>
+#include <list>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
 
 #include "dir-ops.h"
 #include "file-ops.h"
 #include "lo-sysdep.h"
+#include "mkostemp-wrapper.h"
 #include "oct-env.h"
+#include "oct-time.h"
 #include "pathsearch.h"
+#include "unistd-wrappers.h"
 #if ! defined (OCTAVE_USE_WINDOWS_API)
 #  include "file-stat.h"
 #endif
@@ -48,9 +59,11 @@
 #include "ov-usr-fcn.h"
 #include "pager.h"
 #include "parse.h"
+#include "symtab.h"
 #include "sysdep.h"
 #include "unwind-prot.h"
 #include "utils.h"
+#include "version.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
@@ -241,6 +254,443 @@ subdirs_modified (const std::string& d, const sys::file_time& last_checked)
   return false;
 }
 
+// Persistent cache of directory information.
+//
+// If the environment variable OCTAVE_LOAD_PATH_CACHE names a file, the
+// information gathered for the directories in the load path is saved
+// there and reused by later sessions.  An entry remains valid as long
+// as neither the directory nor any of its private, @class, and
+// @class/private subdirectories has been modified since it was read.
+// Checking that requires one call to stat for each of those
+// directories instead of reading the directory and calling stat for
+// each file in it.  Package directories have entries of their own.
+
+static bool
+dir_unmodified (const std::string& d, const sys::file_time& last_checked)
+{
+#if defined (OCTAVE_USE_WINDOWS_API)
+  if (! sys::dir_exists (d))
+    return false;
+
+  sys::file_time mtime (d);
+#else
+  sys::file_stat fs (d);
+
+  if (! (fs && fs.is_dir ()))
+    return false;
+
+  sys::file_time mtime (fs.mtime ().unix_time ());
+#endif
+
+  return mtime + sys::file_time::time_resolution () <= last_checked;
+}
+
+class dir_info_file_cache
+{
+public:
+
+  dir_info_file_cache () = default;
+
+  OCTAVE_DISABLE_COPY_MOVE (dir_info_file_cache)
+
+  ~dir_info_file_cache () = default;
+
+  bool enabled ()
+  {
+    // Follow changes of the environment variable so that the cache may
+    // also be enabled, disabled, or moved in a running session.
+
+    std::string env_file = sys::env::getenv ("OCTAVE_LOAD_PATH_CACHE");
+
+    if (env_file != m_env_file)
+      {
+        m_env_file = env_file;
+
+        m_file = (env_file.empty ()
+                  ? "" : sys::env::make_absolute
+                           (sys::file_ops::tilde_expand (env_file)));
+
+        m_entries.clear ();
+        m_loaded = false;
+        m_modified = false;
+      }
+
+    return ! m_file.empty ();
+  }
+
+  bool lookup (const std::string& abs_name, const sys::file_time& mtime,
+               load_path::dir_info& di);
+
+  void insert (const std::string& abs_name, const load_path::dir_info& di);
+
+  void save ();
+
+private:
+
+  struct entry
+  {
+  public:
+
+    sys::file_time dir_time_last_checked;
+    std::list<std::string> subdirs;
+    std::list<std::string> all_files;
+    std::list<std::string> fcn_files;
+    load_path::dir_info::fcn_file_map_type private_file_map;
+    load_path::dir_info::method_file_map_type method_file_map;
+    std::list<std::string> packages;
+  };
+
+  void load ();
+
+  bool read (std::istream& is);
+
+  void write (std::ostream& os) const;
+
+  static const char *header ()
+  {
+    return "# Octave " OCTAVE_VERSION " load path cache";
+  }
+
+  std::map<std::string, entry> m_entries;
+
+  // The value of OCTAVE_LOAD_PATH_CACHE and the absolute file name.
+  std::string m_env_file;
+  std::string m_file;
+
+  bool m_loaded = false;
+
+  bool m_modified = false;
+};
+
+bool
+dir_info_file_cache::lookup (const std::string& abs_name,
+                             const sys::file_time& mtime,
+                             load_path::dir_info& di)
+{
+  load ();
+
+  auto p = m_entries.find (abs_name);
+
+  if (p == m_entries.end ())
+    return false;
+
+  const entry& e = p->second;
+
+  bool valid = (mtime + sys::file_time::time_resolution ()
+                <= e.dir_time_last_checked);
+
+  for (auto it = e.subdirs.begin (); valid && it != e.subdirs.end (); it++)
+    valid = dir_unmodified (sys::file_ops::concat (abs_name, *it),
+                            e.dir_time_last_checked);
+
+  if (! valid)
+    {
+      m_entries.erase (p);
+      m_modified = true;
+
+      return false;
+    }
+
+  di.dir_time_last_checked = e.dir_time_last_checked;
+  di.all_files = string_vector (e.all_files);
+  di.fcn_files = string_vector (e.fcn_files);
+  di.private_file_map = e.private_file_map;
+  di.method_file_map = e.method_file_map;
+
+  for (const auto& pkg : e.packages)
+    di.package_dir_map[pkg]
+      = load_path::dir_info (sys::file_ops::concat (di.dir_name, '+' + pkg));
+
+  return true;
+}
+
+void
+dir_info_file_cache::insert (const std::string& abs_name,
+                             const load_path::dir_info& di)
+{
+  entry e;
+
+  e.dir_time_last_checked = di.dir_time_last_checked;
+
+  if (sys::dir_exists (sys::file_ops::concat (abs_name, "private")))
+    e.subdirs.push_back ("private");
+
+  for (const auto& cls_ci : di.method_file_map)
+    {
+      std::string cls_dir = '@' + cls_ci.first;
+
+      e.subdirs.push_back (cls_dir);
+
+      std::string priv_dir = sys::file_ops::concat (cls_dir, "private");
+
+      if (sys::dir_exists (sys::file_ops::concat (abs_name, priv_dir)))
+        e.subdirs.push_back (priv_dir);
+    }
+
+  for (octave_idx_type i = 0; i < di.all_files.numel (); i++)
+    e.all_files.push_back (di.all_files[i]);
+
+  for (octave_idx_type i = 0; i < di.fcn_files.numel (); i++)
+    e.fcn_files.push_back (di.fcn_files[i]);
+
+  e.private_file_map = di.private_file_map;
+  e.method_file_map = di.method_file_map;
+
+  for (const auto& pkg_di : di.package_dir_map)
+    e.packages.push_back (pkg_di.first);
+
+  m_entries[abs_name] = e;
+  m_modified = true;
+}
+
+void
+dir_info_file_cache::load ()
+{
+  if (m_loaded)
+    return;
+
+  m_loaded = true;
+
+  std::ifstream is = sys::ifstream (m_file.c_str (), std::ios::in);
+
+  // A missing, outdated, or damaged file is simply ignored and will be
+  // replaced.
+
+  if (is && ! read (is))
+    m_entries.clear ();
+}
+
+// Each entry is a sequence of lines consisting of a keyword followed by
+// a single space and the rest of the line as its value.  Function
+// types are stored as numbers in front of the function name.
+
+static bool
+split_cache_line (const std::string& line, std::string& key,
+                  std::string& val)
+{
+  std::size_t pos = line.find (' ');
+
+  key = line.substr (0, pos);
+  val = (pos == std::string::npos ? "" : line.substr (pos + 1));
+
+  return ! key.empty ();
+}
+
+static bool
+split_cache_fcn (const std::string& val, std::string& name, int& type)
+{
+  std::size_t pos = val.find (' ');
+
+  if (pos == std::string::npos || pos == 0)
+    return false;
+
+  type = std::atoi (val.substr (0, pos).c_str ());
+  name = val.substr (pos + 1);
+
+  return type > 0 && ! name.empty ();
+}
+
+bool
+dir_info_file_cache::read (std::istream& is)
+{
+  std::string line;
+
+  if (! std::getline (is, line) || line != header ())
+    return false;
+
+  entry e;
+  std::string dir;
+  std::string cls;
+
+  while (std::getline (is, line))
+    {
+      std::string key, val, name;
+      int type = 0;
+
+      if (! split_cache_line (line, key, val))
+        return false;
+
+      if (key == "dir")
+        {
+          if (! dir.empty () || val.empty ())
+            return false;
+
+          dir = val;
+          e = entry ();
+          cls = "";
+        }
+      else if (dir.empty ())
+        return false;
+      else if (key == "checked")
+        {
+          std::istringstream buf (val);
+
+          OCTAVE_TIME_T t;
+
+          if (! (buf >> t))
+            return false;
+
+          e.dir_time_last_checked = sys::file_time (t);
+        }
+      else if (key == "subdir")
+        e.subdirs.push_back (val);
+      else if (key == "file")
+        e.all_files.push_back (val);
+      else if (key == "fcn")
+        e.fcn_files.push_back (val);
+      else if (key == "package")
+        e.packages.push_back (val);
+      else if (key == "class")
+        {
+          cls = val;
+          e.method_file_map[cls];
+        }
+      else if (key == "private" || key == "method" || key == "class-private")
+        {
+          if (! split_cache_fcn (val, name, type))
+            return false;
+
+          if (key == "private")
+            e.private_file_map[name] = type;
+          else if (cls.empty ())
+            return false;
+          else if (key == "method")
+            e.method_file_map[cls].method_file_map[name] = type;
+          else
+            e.method_file_map[cls].private_file_map[name] = type;
+        }
+      else if (key == "end")
+        {
+          m_entries[dir] = e;
+          dir = "";
+        }
+      else
+        return false;
+    }
+
+  return dir.empty ();
+}
+
+void
+dir_info_file_cache::write (std::ostream& os) const
+{
+  os << header () << "\n";
+
+  for (const auto& dir_e : m_entries)
+    {
+      const std::string& dir = dir_e.first;
+      const entry& e = dir_e.second;
+
+      // Names that can not be written on a single line are rare enough
+      // that such directories are simply not cached.
+
+      bool ok = dir.find ('\n') == std::string::npos;
+
+      for (const auto& f : e.all_files)
+        ok = ok && f.find ('\n') == std::string::npos;
+
+      for (const auto& s : e.subdirs)
+        ok = ok && s.find ('\n') == std::string::npos;
+
+      for (const auto& pkg : e.packages)
+        ok = ok && pkg.find ('\n') == std::string::npos;
+
+      if (! ok)
+        continue;
+
+      os << "dir " << dir << "\n";
+      os << "checked " << e.dir_time_last_checked.time () << "\n";
+
+      for (const auto& s : e.subdirs)
+        os << "subdir " << s << "\n";
+
+      for (const auto& f : e.all_files)
+        os << "file " << f << "\n";
+
+      for (const auto& f : e.fcn_files)
+        os << "fcn " << f << "\n";
+
+      for (const auto& fcn_type : e.private_file_map)
+        os << "private " << fcn_type.second << ' ' << fcn_type.first << "\n";
+
+      for (const auto& cls_ci : e.method_file_map)
+        {
+          os << "class " << cls_ci.first << "\n";
+
+          for (const auto& fcn_type : cls_ci.second.method_file_map)
+            os << "method " << fcn_type.second << ' ' << fcn_type.first
+               << "\n";
+
+          for (const auto& fcn_type : cls_ci.second.private_file_map)
+            os << "class-private " << fcn_type.second << ' '
+               << fcn_type.first << "\n";
+        }
+
+      for (const auto& pkg : e.packages)
+        os << "package " << pkg << "\n";
+
+      os << "end\n";
+    }
+}
+
+void
+dir_info_file_cache::save ()
+{
+  if (! (m_modified && enabled ()))
+    return;
+
+  // Drop the entries of directories that no longer exist.
+
+  for (auto p = m_entries.begin (); p != m_entries.end (); )
+    {
+      if (sys::dir_exists (p->first))
+        p++;
+      else
+        p = m_entries.erase (p);
+    }
+
+  // Many sessions may start at the same time, possibly on several hosts
+  // that share the cache file, so write a temporary file with a unique
+  // name first and rename it to replace the cache in one step.  Any
+  // failure just means that the next session has to read the
+  // directories again.
+
+  std::string tmp_file = m_file + ".XXXXXX";
+
+  int fd = octave_mkostemp_wrapper (&tmp_file[0]);
+
+  if (fd < 0)
+    return;
+
+  octave_close_wrapper (fd);
+
+  {
+    std::ofstream os = sys::ofstream (tmp_file.c_str (), std::ios::out);
+
+    if (! os)
+      return;
+
+    write (os);
+
+    os.close ();
+
+    if (! os)
+      {
+        sys::unlink (tmp_file);
+        return;
+      }
+  }
+
+  std::string msg;
+
+  if (sys::rename (tmp_file, m_file, msg) < 0)
+    sys::unlink (tmp_file);
+  else
+    m_modified = false;
+}
+
+static dir_info_file_cache s_dir_info_file_cache;
+
 std::string load_path::s_sys_path;
 load_path::abs_dir_cache_type load_path::s_abs_dir_cache;
 
@@ -287,11 +737,21 @@ load_path::initialize (bool set_initial_path)
     xpath = s_sys_path;
 
   set (xpath, false, true);
+
+  save_dir_cache ();
+}
+
+void
+load_path::save_dir_cache () const
+{
+  s_dir_info_file_cache.save ();
 }
 
 void
 load_path::clear ()
 {
+  symbol_table::invalidate_lookup_caches ();
+
   m_dir_info_list.clear ();
 
   m_top_level_package.clear ();
@@ -370,6 +830,8 @@ load_path::prepend (const std::string& dir, bool warn)
 bool
 load_path::remove (const std::string& dir_arg)
 {
+  symbol_table::invalidate_lookup_caches ();
+
   bool retval = false;
 
   if (! dir_arg.empty ())
@@ -411,6 +873,8 @@ load_path::remove (const std::string& dir_arg)
 void
 load_path::update ()
 {
+  symbol_table::invalidate_lookup_caches ();
+
   // I don't see a better way to do this because we need to
   // preserve the correct directory ordering for new files that
   // have appeared.
@@ -1084,6 +1548,8 @@ load_path::move (const dir_info& di, bool at_end, const std::string& pname)
 void
 load_path::add (const std::string& dir_arg, bool at_end, bool warn)
 {
+  symbol_table::invalidate_lookup_caches ();
+
   std::size_t len = dir_arg.length ();
 
   if (len > 1 && dir_arg.substr (len-2) == "//")
@@ -1516,7 +1982,21 @@ load_path::dir_info::initialize ()
 
       dir_time_last_checked = sys::file_time ();
 
-      get_file_list (dir_name);
+      std::string cache_key;
+
+      if (s_dir_info_file_cache.enabled ())
+        {
+          std::string cache_msg;
+
+          cache_key = sys::canonicalize_file_name (dir_name, cache_msg);
+        }
+
+      if (cache_key.empty ()
+          || ! s_dir_info_file_cache.lookup (cache_key, dir_mtime, *this))
+        {
+          if (get_file_list (dir_name) && ! cache_key.empty ())
+            s_dir_info_file_cache.insert (cache_key, *this);
+        }
 
       try
         {
@@ -1547,7 +2027,7 @@ load_path::dir_info::initialize ()
     }
 }
 
-void
+bool
 load_path::dir_info::get_file_list (const std::string& d)
 {
   string_vector flist;
@@ -1556,7 +2036,7 @@ load_path::dir_info::get_file_list (const std::string& d)
   if (! sys::get_dirlist (d, flist, msg))
     {
       warning ("load_path: %s: %s", d.c_str (), msg.c_str ());
-      return;
+      return false;
     }
 
   octave_idx_type len = flist.numel ();
@@ -1605,6 +2085,8 @@ load_path::dir_info::get_file_list (const std::string& d)
 
   all_files.resize (all_files_count);
   fcn_files.resize (fcn_files_count);
+
+  return true;
 }
 
 void
@@ -2844,4 +3326,42 @@ Pretty print Octave path directories and the files within each directory.
   return ovl ();
 }
 
+/*
+## Directories are read again when they change while the load path
+## cache is enabled
+%!test
+%! old_cache_file = getenv ("OCTAVE_LOAD_PATH_CACHE");
+%! fcn_dir = tempname ();
+%! mkdir (fcn_dir);
+%! fid = fopen (fullfile (fcn_dir, "lpc_test_fcn1.m"), "w");
+%! fprintf (fid, "function r = lpc_test_fcn1 ()\n  r = 1;\nendfunction\n");
+%! fclose (fid);
+%! ## Make sure that the directory is older than the time it is checked.
+%! pause (1.1);
+%! unwind_protect
+%!   setenv ("OCTAVE_LOAD_PATH_CACHE", [tempname() ".cache"]);
+%!   addpath (fcn_dir);
+%!   assert (lpc_test_fcn1 (), 1);
+%!   assert (exist ("lpc_test_fcn2"), 0);
+%!   rmpath (fcn_dir);
+%!   fid = fopen (fullfile (fcn_dir, "lpc_test_fcn2.m"), "w");
+%!   fprintf (fid, "function r = lpc_test_fcn2 ()\n  r = 2;\nendfunction\n");
+%!   fclose (fid);
+%!   mkdir (fullfile (fcn_dir, "private"));
+%!   addpath (fcn_dir);
+%!   assert (lpc_test_fcn1 (), 1);
+%!   assert (lpc_test_fcn2 (), 2);
+%! unwind_protect_cleanup
+%!   rmpath (fcn_dir);
+%!   clear lpc_test_fcn1 lpc_test_fcn2;
+%!   if (isempty (old_cache_file))
+%!     unsetenv ("OCTAVE_LOAD_PATH_CACHE");
+%!   else
+%!     setenv ("OCTAVE_LOAD_PATH_CACHE", old_cache_file);
+%!   endif
+%!   confirm_recursive_rmdir (false, "local");
+%!   sts = rmdir (fcn_dir, "s");
+%! end_unwind_protect
+*/
+
 OCTAVE_END_NAMESPACE(octave)
@@ -55,6 +55,10 @@ public:
 
   void initialize (bool set_initial_path = false);
 
+  // Save the information about the directories read so far to the file
+  // named by the environment variable OCTAVE_LOAD_PATH_CACHE (if any).
+  void save_dir_cache () const;
+
   void clear ();
 
   void set (const std::string& p, bool warn = false, bool is_init = false);
@@ -301,7 +305,7 @@ private:
 
     void initialize ();
 
-    void get_file_list (const std::string& d);
+    bool get_file_list (const std::string& d);
 
     void get_private_file_map (const std::string& d);
 
@@ -562,6 +566,8 @@ private:
 
   friend dir_info::fcn_file_map_type get_fcn_files (const std::string& d);
 
+  friend class dir_info_file_cache;
+
   //--------
 
   static std::string s_sys_path;
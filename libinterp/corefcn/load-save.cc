@@ -27,14 +27,17 @@
 #  include "config.h"
 #endif
 
+#include <cctype>
 #include <cstring>
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <list>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "byte-swap.h"
 #include "dMatrix.h"
@@ -113,7 +116,9 @@ matches_patterns (const string_vector& patterns, int pat_idx,
 {
   for (int i = pat_idx; i < num_pat; i++)
     {
-      symbol_match pattern (patterns[i]);
+      // Ignore ranges of indices, which are only allowed for HDF5 files
+      // and which are handled by read_hdf5_data.
+      symbol_match pattern (patterns[i].substr (0, patterns[i].find ('(')));
 
       if (pattern.match (name))
         return true;
@@ -122,6 +127,36 @@ matches_patterns (const string_vector& patterns, int pat_idx,
   return false;
 }
 
+// Check the ranges of indices that may follow the names of variables
+// given to load as in "x(1:10,:)".  They can only be used with HDF5
+// files.
+
+static void
+check_load_ranges (const string_vector& argv, int argv_idx, int argc,
+                   const load_save_format& fmt)
+{
+  for (int i = argv_idx; i < argc; i++)
+    {
+      if (argv[i].find ('(') == std::string::npos)
+        continue;
+
+#if defined (HAVE_HDF5)
+      if (fmt.type () != load_save_system::HDF5)
+        error ("load: ranges of indices can only be read from HDF5 files");
+
+      std::string name;
+      std::vector<std::string> range;
+
+      if (! hdf5_split_load_range (argv[i], name, range))
+        error ("load: invalid range of indices in '%s'", argv[i].c_str ());
+#else
+      octave_unused_parameter (fmt);
+
+      error ("load: ranges of indices can only be read from HDF5 files");
+#endif
+    }
+}
+
 static int
 read_binary_file_header (std::istream& is, bool& swap,
                          mach_info::float_format& flt_fmt,
@@ -525,6 +560,67 @@ load_save_system::load_vars (std::istream& stream,
   return retval;
 }
 
+// Parse the chunk size ARG for HDF5 files, which is given as the
+// dimensions of the chunks separated by "x" or "," as in "1000x100".
+
+static dim_vector
+parse_hdf5_chunk_size (const std::string& arg)
+{
+  std::vector<octave_idx_type> dims;
+  std::size_t beg = 0;
+
+  while (beg <= arg.length ())
+    {
+      std::size_t end = arg.find_first_of ("x,", beg);
+
+      if (end == std::string::npos)
+        end = arg.length ();
+
+      std::string s = arg.substr (beg, end - beg);
+
+      std::size_t pos = 0;
+      long val = 0;
+
+      try
+        {
+          val = std::stol (s, &pos);
+        }
+      catch (const std::exception&)
+        {
+          pos = 0;
+        }
+
+      if (s.empty () || pos != s.length () || val < 1
+          || ! std::isdigit (static_cast<unsigned char> (s[0])))
+        error ("save: invalid chunk size '%s'", arg.c_str ());
+
+      dims.push_back (val);
+
+      beg = end + 1;
+    }
+
+  dim_vector dv;
+  dv.resize (std::max (static_cast<int> (dims.size ()), 2), 1);
+
+  for (std::size_t i = 0; i < dims.size (); i++)
+    dv(i) = dims[i];
+
+  return dv;
+}
+
+// Parse the deflate compression level ARG for HDF5 files.
+
+static int
+parse_hdf5_deflate_level (const std::string& arg)
+{
+  if (arg.length () != 1
+      || ! std::isdigit (static_cast<unsigned char> (arg[0])))
+    error ("save: compression level for -deflate must be an integer "
+           "from 0 to 9");
+
+  return arg[0] - '0';
+}
+
 string_vector
 load_save_system::parse_save_options (const string_vector& argv,
                                       load_save_format& fmt, bool& append,
@@ -539,6 +635,7 @@ load_save_system::parse_save_options (const string_vector& argv,
 
   bool do_double = false;
   bool do_tabs = false;
+  bool do_hdf5_options = false;
 
   for (int i = 0; i < argc; i++)
     {
@@ -616,6 +713,22 @@ load_save_system::parse_save_options (const string_vector& argv,
           use_zlib = true;
         }
 #endif
+      else if (argv[i] == "-chunk")
+        {
+          if (++i == argc)
+            error ("save: missing chunk size for -chunk");
+
+          fmt.set_hdf5_chunk (parse_hdf5_chunk_size (argv[i]));
+          do_hdf5_options = true;
+        }
+      else if (argv[i] == "-deflate")
+        {
+          if (++i == argc)
+            error ("save: missing compression level for -deflate");
+
+          fmt.set_hdf5_deflate (parse_hdf5_deflate_level (argv[i]));
+          do_hdf5_options = true;
+        }
       else if (argv[i] == "-struct")
         {
           retval.append (argv[i]);
@@ -644,6 +757,9 @@ load_save_system::parse_save_options (const string_vector& argv,
         warning (R"(save: "-tabs" option only has an effect with "-ascii")");
     }
 
+  if (do_hdf5_options && fmt.type () != HDF5)
+    warning (R"(save: "-chunk" and "-deflate" options only have an effect with "-hdf5")");
+
   if (append && use_zlib
       && (fmt.type () != TEXT && fmt.type () != MAT_ASCII))
     error ("save: -append and -zip options can only be used together with a text format (-text or -ascii)");
@@ -1272,6 +1388,8 @@ load_save_system::load (const octave_value_list& args, int nargout)
     {
       i++;
 
+      check_load_ranges (argv, i, argc, format);
+
 #if defined (HAVE_HDF5)
       if (format.type () == HDF5)
         error ("load: cannot read HDF5 format from stdin");
@@ -1302,6 +1420,8 @@ load_save_system::load (const octave_value_list& args, int nargout)
       if (format.type () == UNKNOWN)
         format = get_file_format (fname, orig_fname, use_zlib);
 
+      check_load_ranges (argv, i+1, argc, format);
+
 #if defined (HAVE_HDF5)
       if (format.type () == HDF5)
         {
@@ -1517,6 +1637,12 @@ load_save_system::save (const octave_value_list& args, int nargout)
           if (hdf5_file.file_id == -1)
             err_file_open ("save", fname);
 
+          hdf5_set_save_options (format.hdf5_chunk (),
+                                 format.hdf5_deflate ());
+
+          unwind_action reset_hdf5_options
+            ([] () { hdf5_set_save_options (dim_vector (), 0); });
+
           save_vars (argv, i, argc, hdf5_file, format, save_as_floats,
                      write_header_info);
 
@@ -1624,6 +1750,21 @@ detect the type of file and do conversion from different floating point
 formats (currently only IEEE big and little endian, though other formats
 may be added in the future).
 
+When reading an @sc{hdf5} file, only a part of a numeric or logical array
+is read if the variable name is followed by a range of indices for each
+dimension in parentheses, as in
+
+@example
+S = load ("data.h5", "x(1:1000,:)", "y(:,:,end)");
+@end example
+
+@noindent
+Each range is @qcode{":"}, a single index @var{i}, @qcode{"@var{i}:@var{j}"},
+or @qcode{"@var{i}:@var{k}:@var{j}"} with a positive increment @var{k}, and
+@var{i} and @var{j} may be given relative to the last index as
+@qcode{"end"} or @qcode{"end-@var{n}"}.  Only the selected elements are read
+from the file.
+
 Valid options for @code{load} are listed in the following table.
 
 @table @code
@@ -1762,7 +1903,22 @@ available if Octave was built with a link to the @sc{hdf5} libraries.
 @item -float-hdf5
 Save the data in @sc{hdf5} format but using only single precision.  Use this
 format @strong{only} if you know that all the values to be saved can be
-represented in single precision.
+represented in single precision.  Additional options for the @sc{hdf5}
+formats are
+
+@table @code
+@item -chunk @var{size}
+Store numeric and logical arrays in chunks of the given @var{size}, for
+example @qcode{"1000x100"}.  Dimensions of the chunks that are larger than
+those of an array are reduced, and missing trailing dimensions are 1.  Parts
+of an array can be loaded faster when they span only a few chunks.
+
+@item -deflate @var{level}
+Compress numeric and logical arrays with the deflate algorithm.  The
+compression @var{level} is an integer from 0 (no compression) to 9 (best
+compression).  If @option{-chunk} is not given, chunks of whole columns (and
+pages) of about 1@tie{}MB are used.
+@end table
 
 @item -text
 Save the data in Octave's text data format.  (default)
@@ -1934,12 +2090,86 @@ dlmread, csvread, fread}
 %! end_unwind_protect
 %! assert (struc, struc2);
 
+## Save chunked and compressed HDF5 datasets and load parts of them
+%!testif HAVE_HDF5
+%! x = reshape (1:60, 5, 4, 3);
+%! y = int16 (magic (4));
+%! z = logical ([1 0 1; 0 1 1]);
+%! w = complex (rand (3, 4), rand (3, 4));
+%! h5_file = [tempname(), ".h5"];
+%! unwind_protect
+%!   c = {1, 2};
+%!   save ("-hdf5", "-chunk", "2x2", "-deflate", "6", h5_file,
+%!         "x", "y", "z", "w", "c");
+%!   s = load (h5_file);
+%!   assert (s, struct ("c", {{1, 2}}, "w", w, "x", x, "y", y, "z", z));
+%!   s = load (h5_file, "x(2:4,end,1:2:3)", "y(:,2)", "z(end,end-1:end)",
+%!             "w(1:2, 3)");
+%!   assert (s.x, x(2:4,end,1:2:3));
+%!   assert (s.y, y(:,2));
+%!   assert (s.z, z(end,end-1:end));
+%!   assert (s.w, w(1:2,3));
+%!   s = load (h5_file, "x(:,:,2)");
+%!   assert (fieldnames (s), {"x"});
+%!   assert (s.x, x(:,:,2));
+%!   fail ('load (h5_file, "x(1:6,1,1)")',
+%!         "index range '1:6' out of bound for dimension 1 of 'x'");
+%!   fail ('load (h5_file, "x(3:1,1,1)")', "index range '3:1' out of bound");
+%!   fail ('load (h5_file, "x(1,1)")',
+%!         "'x' has 3 dimensions, but 2 ranges of indices were given");
+%!   fail ('load (h5_file, "c(1,2)")',
+%!         "can only be read for numeric and logical arrays, not for 'c'");
+%!   fail ('load (h5_file, "x(1:-1:1,1,1)")', "invalid range of indices");
+%!   fail ('load (h5_file, "x(1:2")', "invalid range of indices");
+%! unwind_protect_cleanup
+%!   unlink (h5_file);
+%! end_unwind_protect
+
+%!testif HAVE_HDF5
+%! x = zeros (500, 400);
+%! h5_file = [tempname(), ".h5"];
+%! h5z_file = [tempname(), ".h5"];
+%! unwind_protect
+%!   save ("-hdf5", h5_file, "x");
+%!   save ("-hdf5", "-deflate", "9", h5z_file, "x");
+%!   [info, err] = stat (h5_file);
+%!   [infoz, errz] = stat (h5z_file);
+%!   assert ([err, errz], [0, 0]);
+%!   assert (infoz.size < info.size / 10);
+%!   s = load (h5z_file);
+%!   assert (s.x, x);
+%! unwind_protect_cleanup
+%!   unlink (h5_file);
+%!   unlink (h5z_file);
+%! end_unwind_protect
+
 ## Test input validation
 %!testif HAVE_ZLIB <*59225>
 %! fname = tempname ();
 %! x = 1;
 %! fail ('save ("-append", "-zip", "-binary", fname, "x")',
 %!       "-append and -zip options .* with a text format");
+%!testif HAVE_HDF5
+%! fname = tempname ();
+%! x = 1;
+%! fail ('save ("-hdf5", "-chunk", "0x2", fname, "x")',
+%!       "invalid chunk size '0x2'");
+%! fail ('save ("-hdf5", "-chunk", "10y10", fname, "x")',
+%!       "invalid chunk size '10y10'");
+%! fail ('save ("-hdf5", "-deflate", "10", fname, "x")',
+%!       "must be an integer from 0 to 9");
+%! fail ('save ("-hdf5", fname, "x", "-deflate")',
+%!       "missing compression level for -deflate");
+%!test
+%! x = 1;
+%! txt_file = tempname ();
+%! unwind_protect
+%!   save ("-text", txt_file, "x");
+%!   fail ('load (txt_file, "x(1,1)")',
+%!         "ranges of indices can only be read from HDF5 files");
+%! unwind_protect_cleanup
+%!   unlink (txt_file);
+%! end_unwind_protect
 */
 
 DEFMETHOD (crash_dumps_octave_core, interp, args, nargout,
@@ -31,6 +31,7 @@
 #include <iosfwd>
 #include <string>
 
+#include "dim-vector.h"
 #include "mach-info.h"
 
 #include "ovl.h"
@@ -270,7 +271,7 @@ public:
 
   load_save_format (load_save_system::format_type type,
                     load_save_system::format_options options = load_save_system::NO_OPTION)
-    : m_type (type), m_options (options)
+    : m_type (type), m_options (options), m_hdf5_chunk (), m_hdf5_deflate (0)
   { }
 
   void set_type (load_save_system::format_type type) { m_type = type; }
@@ -284,10 +285,23 @@ public:
 
   int options () const { return m_options; }
 
+  // HDF5 options.  An empty chunk size means contiguous datasets unless
+  // a deflate level greater than 0 is set.
+
+  void set_hdf5_chunk (const dim_vector& chunk) { m_hdf5_chunk = chunk; }
+
+  const dim_vector& hdf5_chunk () const { return m_hdf5_chunk; }
+
+  void set_hdf5_deflate (int level) { m_hdf5_deflate = level; }
+
+  int hdf5_deflate () const { return m_hdf5_deflate; }
+
 private:
 
   load_save_system::format_type m_type;
   int m_options;
+  dim_vector m_hdf5_chunk;
+  int m_hdf5_deflate;
 };
 
 OCTAVE_END_NAMESPACE(octave)
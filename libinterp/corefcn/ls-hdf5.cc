@@ -29,6 +29,7 @@
 
 #if defined (HAVE_HDF5)
 
+#include <algorithm>
 #include <cctype>
 
 #include <iomanip>
@@ -643,6 +644,148 @@ load_inline_fcn (hid_t loc_id, const char *name, octave_value& retval)
   return -1;
 }
 
+// Chunk dimensions and deflate level for the datasets of numeric and
+// logical arrays that are written by save (see hdf5_set_save_options).
+
+static dim_vector hdf5_save_chunk;
+static int hdf5_save_deflate = 0;
+
+// The name of the variable that is currently read by load and the
+// ranges of indices that were requested for it, if only a part of it
+// should be read (see hdf5_select_load_range).  Errors in the ranges
+// cannot be reported while H5Giterate is running, so the message is
+// kept until read_hdf5_data can throw the error.
+
+static const char *hdf5_load_name = nullptr;
+static const std::vector<std::string> *hdf5_load_range = nullptr;
+static std::string hdf5_load_range_error;
+
+// Parse the index in S for a dimension of length N.  If ALLOW_END is
+// true, S may also be "end" or "end-M".
+
+static bool
+parse_load_index (const std::string& s, octave_idx_type n, bool allow_end,
+                  octave_idx_type& idx)
+{
+  std::size_t pos = 0;
+  bool from_end = false;
+
+  if (allow_end && s.compare (0, 3, "end") == 0)
+    {
+      from_end = true;
+      pos = 3;
+
+      if (pos == s.length ())
+        {
+          idx = n;
+          return true;
+        }
+
+      if (s[pos++] != '-')
+        return false;
+    }
+
+  if (pos == s.length ())
+    return false;
+
+  octave_idx_type val = 0;
+
+  for (; pos < s.length (); pos++)
+    {
+      if (! std::isdigit (static_cast<unsigned char> (s[pos]))
+          || val > (std::numeric_limits<octave_idx_type>::max () - 9) / 10)
+        return false;
+
+      val = 10 * val + (s[pos] - '0');
+    }
+
+  idx = (from_end ? n - val : val);
+
+  return true;
+}
+
+// Parse the range of indices S, which is one of ":", "I", "I:J", or
+// "I:K:J", for a dimension of length N.  The bounds are not checked.
+
+static bool
+parse_load_range (const std::string& s, octave_idx_type n,
+                  octave_idx_type& first, octave_idx_type& step,
+                  octave_idx_type& last)
+{
+  step = 1;
+
+  if (s == ":")
+    {
+      first = 1;
+      last = n;
+      return true;
+    }
+
+  std::size_t p1 = s.find (':');
+
+  if (p1 == std::string::npos)
+    {
+      if (! parse_load_index (s, n, true, first))
+        return false;
+
+      last = first;
+      return true;
+    }
+
+  std::size_t p2 = s.find (':', p1 + 1);
+
+  if (p2 == std::string::npos)
+    return (parse_load_index (s.substr (0, p1), n, true, first)
+            && parse_load_index (s.substr (p1 + 1), n, true, last));
+
+  return (s.find (':', p2 + 1) == std::string::npos
+          && parse_load_index (s.substr (0, p1), n, true, first)
+          && parse_load_index (s.substr (p1 + 1, p2 - p1 - 1), n, false,
+                               step)
+          && parse_load_index (s.substr (p2 + 1), n, true, last));
+}
+
+// Read the value TC from the object NAME in LOC_ID.  If one of the
+// PATTERNS that were given to load matches NAME and includes a range
+// of indices, read only that part of the array.
+
+static bool
+hdf5_load_value (octave_value& tc, hid_t loc_id, const char *name,
+                 const char *var_name, const string_vector& patterns)
+{
+  std::vector<std::string> range;
+
+  for (octave_idx_type i = 0; i < patterns.numel (); i++)
+    {
+      std::string pat_name;
+
+      if (hdf5_split_load_range (patterns[i], pat_name, range)
+          && ! range.empty () && symbol_match (pat_name).match (var_name))
+        break;
+
+      range.clear ();
+    }
+
+  if (range.empty ())
+    return tc.load_hdf5 (loc_id, name);
+
+  if (! tc.is_matrix_type () || tc.issparse ()
+      || ! (tc.isnumeric () || tc.islogical ()))
+    {
+      hdf5_load_range_error
+        = ("a range of indices can only be read for numeric and logical "
+           "arrays, not for '" + std::string (var_name) + "'");
+      return false;
+    }
+
+  octave::unwind_protect_var<const char *>
+    restore_name (hdf5_load_name, var_name);
+  octave::unwind_protect_var<const std::vector<std::string> *>
+    restore_range (hdf5_load_range, &range);
+
+  return tc.load_hdf5 (loc_id, name);
+}
+
 // This function is designed to be passed to H5Giterate, which calls it
 // on each data item in an HDF5 file.  For the item whose name is NAME in
 // the group GROUP_ID, this function sets dv->tc to an Octave representation
@@ -755,7 +898,8 @@ hdf5_read_next_data_internal (hid_t group_id, const char *name, void *dv)
 
               try
                 {
-                  retval = (d->tc.load_hdf5 (subgroup_id, "value") ? 1 : -1);
+                  retval = (hdf5_load_value (d->tc, subgroup_id, "value",
+                                             name, d->patterns) ? 1 : -1);
                 }
               catch (const octave::execution_exception& ee)
                 {
@@ -790,7 +934,8 @@ hdf5_read_next_data_internal (hid_t group_id, const char *name, void *dv)
 
           try
             {
-              retval = (d->tc.load_hdf5 (group_id, name) ? 1 : -1);
+              retval = (hdf5_load_value (d->tc, group_id, name, name,
+                                         d->patterns) ? 1 : -1);
             }
           catch (const octave::execution_exception& ee)
             {
@@ -987,7 +1132,8 @@ hdf5_read_next_data_internal (hid_t group_id, const char *name, void *dv)
 
       try
         {
-          retval = (d->tc.load_hdf5 (group_id, name) ? 1 : -1);
+          retval = (hdf5_load_value (d->tc, group_id, name, name,
+                                     d->patterns) ? 1 : -1);
         }
       catch (const octave::execution_exception& ee)
         {
@@ -1007,7 +1153,7 @@ hdf5_read_next_data_internal (hid_t group_id, const char *name, void *dv)
     }
 
 done:
-  if (retval < 0)
+  if (retval < 0 && hdf5_load_range_error.empty ())
     {
       // Must be warning.  A call to error aborts and leaves H5Giterate in
       // a mangled state that causes segfault on exit (bug #56149).
@@ -1117,7 +1263,11 @@ read_hdf5_data (std::istream& is, const std::string& /* filename */,
 
       for (int i = argv_idx; i < argc; i++)
         {
-          symbol_match pattern (argv[i]);
+          std::string pat_name;
+          std::vector<std::string> range;
+          hdf5_split_load_range (argv[i], pat_name, range);
+
+          symbol_match pattern (pat_name);
           if (pattern.match (std::string (&var_name[0])))
             {
               found = true;
@@ -1131,10 +1281,20 @@ read_hdf5_data (std::istream& is, const std::string& /* filename */,
       hs.current_item++;
     }
 
+  for (int i = argv_idx; i < argc; i++)
+    d.patterns.append (argv[i]);
+
   if (hs.current_item < static_cast<int> (num_obj))
     H5Giterate_retval = H5Giterate (hs.file_id, "/", &hs.current_item,
                                     hdf5_read_next_data_internal, &d);
 
+  if (! hdf5_load_range_error.empty ())
+    {
+      std::string msg = hdf5_load_range_error;
+      hdf5_load_range_error.clear ();
+      error ("load: %s", msg.c_str ());
+    }
+
   if (H5Giterate_retval > 0)
     {
       global = d.global;
@@ -1341,6 +1501,257 @@ load_hdf5_empty (octave_hdf5_id loc_id, const char *name, dim_vector& d)
 #endif
 }
 
+// Set the chunk dimensions CHUNK (in Octave's order) and the deflate
+// compression level DEFLATE (0 to 9) for the datasets of numeric and
+// logical arrays that are written by save.  An empty CHUNK and a level
+// of 0 restore the default of contiguous, uncompressed datasets.
+
+void
+hdf5_set_save_options (const dim_vector& chunk, int deflate)
+{
+  hdf5_save_chunk = chunk;
+  hdf5_save_deflate = deflate;
+}
+
+// Return a new dataset creation property list for an array with
+// dimensions DV and elements of type TYPE_ID that uses the options set
+// by hdf5_set_save_options.  The caller must close it with H5Pclose.
+//
+// If compression is requested without chunk dimensions, the chunks are
+// made of whole columns (and pages) as long as they are not larger than
+// about 1 MB.  Given chunk dimensions are limited to the dimensions of
+// the array, and missing trailing dimensions are taken to be 1.
+
+octave_hdf5_id
+hdf5_dataset_create_plist (const dim_vector& dv, octave_hdf5_id type_id)
+{
+#if defined (HAVE_HDF5)
+
+  static const hsize_t default_chunk_bytes = 1 << 20;
+
+  // HDF5 does not allow chunks of 4 GB or more.
+  static const hsize_t max_chunk_bytes = 0xffffffffu;
+
+  hid_t plist_id = H5Pcreate (H5P_DATASET_CREATE);
+
+  bool have_chunk = hdf5_save_chunk.numel () > 0;
+
+  if (plist_id < 0 || (! have_chunk && hdf5_save_deflate == 0)
+      || dv.any_zero ())
+    return plist_id;
+
+  hid_t new_type_id = check_hdf5_id_value (type_id,
+                                           "hdf5_dataset_create_plist");
+
+  hsize_t elem_size = H5Tget_size (new_type_id);
+
+  int rank = dv.ndims ();
+
+  OCTAVE_LOCAL_BUFFER (hsize_t, chunk, rank);
+
+  if (have_chunk)
+    {
+      hsize_t nbytes = elem_size;
+
+      for (int i = 0; i < rank; i++)
+        {
+          hsize_t n = (i < hdf5_save_chunk.ndims () ? hdf5_save_chunk(i) : 1);
+          chunk[i] = std::min (n, static_cast<hsize_t> (dv(i)));
+          nbytes *= chunk[i];
+        }
+
+      if (nbytes > max_chunk_bytes)
+        {
+          warning ("save: HDF5 chunks must be smaller than 4 GB, using the default chunk size");
+          have_chunk = false;
+        }
+    }
+
+  if (! have_chunk)
+    {
+      hsize_t avail = std::max (default_chunk_bytes / elem_size,
+                                static_cast<hsize_t> (1));
+
+      for (int i = 0; i < rank; i++)
+        {
+          chunk[i] = std::min (avail, static_cast<hsize_t> (dv(i)));
+          avail = std::max (avail / chunk[i], static_cast<hsize_t> (1));
+        }
+    }
+
+  // Octave uses column-major, while HDF5 uses row-major ordering
+  OCTAVE_LOCAL_BUFFER (hsize_t, hchunk, rank);
+
+  for (int i = 0; i < rank; i++)
+    hchunk[i] = chunk[rank-i-1];
+
+  H5Pset_chunk (plist_id, rank, hchunk);
+
+  if (hdf5_save_deflate > 0)
+    {
+      if (H5Zfilter_avail (H5Z_FILTER_DEFLATE) > 0)
+        {
+          // Grouping the bytes of the elements usually improves the
+          // compression of numeric data.
+          H5Pset_shuffle (plist_id);
+          H5Pset_deflate (plist_id, hdf5_save_deflate);
+        }
+      else
+        warning_with_id ("Octave:save-hdf5-no-deflate",
+                         "save: HDF5 library does not support deflate compression, saving uncompressed data");
+    }
+
+  return plist_id;
+
+#else
+  octave_unused_parameter (dv);
+  octave_unused_parameter (type_id);
+
+  err_disabled_feature ("hdf5_dataset_create_plist", "HDF5");
+#endif
+}
+
+// Split ARG, a pattern given to load that may be followed by ranges of
+// indices in parentheses as in "x(1:100,:,end)", into the pattern NAME
+// and the list RANGE of the ranges.  Each range is ":", "I", "I:J", or
+// "I:K:J", where I and J may also be "end" or "end-M".  RANGE is empty
+// if ARG has no ranges.  Return false if the ranges are not valid.
+
+bool
+hdf5_split_load_range (const std::string& arg, std::string& name,
+                       std::vector<std::string>& range)
+{
+  range.clear ();
+
+  std::size_t pos = arg.find ('(');
+
+  name = arg.substr (0, pos);
+
+  if (pos == std::string::npos)
+    return true;
+
+  if (name.empty () || arg.back () != ')')
+    return false;
+
+  std::string ranges;
+
+  for (std::size_t i = pos + 1; i < arg.length () - 1; i++)
+    {
+      if (! std::isspace (static_cast<unsigned char> (arg[i])))
+        ranges.push_back (arg[i]);
+    }
+
+  std::size_t beg = 0;
+
+  while (beg <= ranges.length () && ! ranges.empty ())
+    {
+      std::size_t end = ranges.find (',', beg);
+
+      if (end == std::string::npos)
+        end = ranges.length ();
+
+      range.push_back (ranges.substr (beg, end - beg));
+
+      octave_idx_type first, step, last;
+
+      if (! parse_load_range (range.back (), 1, first, step, last))
+        return false;
+
+      beg = end + 1;
+    }
+
+  return true;
+}
+
+// Select the part of the dataset with dataspace SPACE_ID that was
+// requested for the variable that is currently read by load, if any.
+// DV holds the dimensions of the full array on entry and those of the
+// selected part on return.  Return the dataspace to use for the memory
+// buffer in H5Dread (H5S_ALL if the whole array is read), or a negative
+// value if the requested ranges are not valid for the array.  In that
+// case, read_hdf5_data reports the error when H5Giterate has returned.
+
+octave_hdf5_id
+hdf5_select_load_range (octave_hdf5_id space_id, dim_vector& dv)
+{
+#if defined (HAVE_HDF5)
+
+  if (! hdf5_load_range || hdf5_load_range->empty ())
+    return octave_H5S_ALL;
+
+  hid_t file_space_id = check_hdf5_id_value (space_id,
+                                             "hdf5_select_load_range");
+
+  int nd = dv.ndims ();
+  int nr = hdf5_load_range->size ();
+
+  if (nr != nd)
+    {
+      hdf5_load_range_error
+        = ("'" + std::string (hdf5_load_name) + "' has "
+           + std::to_string (nd) + " dimensions, but "
+           + std::to_string (nr) + " ranges of indices were given");
+      return -1;
+    }
+
+  int rank = H5Sget_simple_extent_ndims (file_space_id);
+
+  if (rank < 1 || rank > nd)
+    return -1;
+
+  OCTAVE_LOCAL_BUFFER (hsize_t, start, rank);
+  OCTAVE_LOCAL_BUFFER (hsize_t, stride, rank);
+  OCTAVE_LOCAL_BUFFER (hsize_t, count, rank);
+
+  dim_vector sel_dv = dv;
+
+  for (int k = 0; k < nd; k++)
+    {
+      const std::string& s = (*hdf5_load_range)[k];
+      octave_idx_type first, step, last;
+
+      if (! parse_load_range (s, dv(k), first, step, last)
+          || first < 1 || step < 1 || first > last || last > dv(k))
+        {
+          hdf5_load_range_error
+            = ("index range '" + s + "' out of bound for dimension "
+               + std::to_string (k+1) + " of '" + hdf5_load_name
+               + "' (dimensions are " + dv.str () + ")");
+          return -1;
+        }
+
+      sel_dv(k) = (last - first) / step + 1;
+
+      // HDF5 uses row-major ordering, and vectors that were not written
+      // by Octave may have only one dimension.
+      int j = nd - 1 - k;
+
+      if (j < rank)
+        {
+          start[j] = first - 1;
+          stride[j] = step;
+          count[j] = sel_dv(k);
+        }
+    }
+
+  if (H5Sselect_hyperslab (file_space_id, H5S_SELECT_SET, start, stride,
+                           count, nullptr) < 0)
+    return -1;
+
+  dv = sel_dv;
+
+  hsize_t nel = dv.numel ();
+
+  return H5Screate_simple (1, &nel, nullptr);
+
+#else
+  octave_unused_parameter (space_id);
+  octave_unused_parameter (dv);
+
+  err_disabled_feature ("hdf5_select_load_range", "HDF5");
+#endif
+}
+
 // save_type_to_hdf5 is not currently used, since hdf5 doesn't yet support
 // automatic float<->integer conversions:
 
@@ -29,6 +29,8 @@
 #include "octave-config.h"
 
 #include <iosfwd>
+#include <string>
+#include <vector>
 
 #include "oct-hdf5-types.h"
 #include "ov.h"
@@ -105,7 +107,7 @@ struct hdf5_callback_data
 public:
 
   hdf5_callback_data ()
-    : name (), global (false), tc (), doc () { }
+    : name (), global (false), tc (), doc (), patterns () { }
 
   OCTAVE_DEFAULT_COPY_MOVE_DELETE (hdf5_callback_data)
 
@@ -122,6 +124,10 @@ public:
 
   // a documentation string (NULL if none)
   std::string doc;
+
+  // the names given to load, possibly with ranges of indices (see
+  // hdf5_split_load_range)
+  string_vector patterns;
 };
 
 extern OCTINTERP_API octave_hdf5_id
@@ -151,6 +157,19 @@ save_hdf5_empty (octave_hdf5_id loc_id, const char *name, const dim_vector& d);
 extern OCTINTERP_API int
 load_hdf5_empty (octave_hdf5_id loc_id, const char *name, dim_vector& d);
 
+extern OCTINTERP_API void
+hdf5_set_save_options (const dim_vector& chunk, int deflate);
+
+extern OCTINTERP_API octave_hdf5_id
+hdf5_dataset_create_plist (const dim_vector& dv, octave_hdf5_id type_id);
+
+extern OCTINTERP_API bool
+hdf5_split_load_range (const std::string& arg, std::string& name,
+                       std::vector<std::string>& range);
+
+extern OCTINTERP_API octave_hdf5_id
+hdf5_select_load_range (octave_hdf5_id space_id, dim_vector& dv);
+
 extern OCTINTERP_API std::string
 read_hdf5_data (std::istream& is,  const std::string& filename, bool& global,
                 octave_value& tc, std::string& doc,
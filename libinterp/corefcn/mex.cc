@@ -1882,34 +1882,34 @@ public:
                 ? fp_to_ov<FloatComplex> (dv) : fp_to_ov<float> (dv));
 
       case mxCHAR_CLASS:
-        return int_to_ov<mxChar, charNDArray, char> (dv);
+        return borrow_int_to_ov<mxChar, charNDArray, char> (dv);
 
       case mxLOGICAL_CLASS:
         return int_to_ov<mxLogical, boolNDArray, bool> (dv);
 
       case mxINT8_CLASS:
-        return int_to_ov<int8_t, int8NDArray, octave_int8> (dv);
+        return borrow_int_to_ov<int8_t, int8NDArray, octave_int8> (dv);
 
       case mxUINT8_CLASS:
-        return int_to_ov<uint8_t, uint8NDArray, octave_uint8> (dv);
+        return borrow_int_to_ov<uint8_t, uint8NDArray, octave_uint8> (dv);
 
       case mxINT16_CLASS:
-        return int_to_ov<int16_t, int16NDArray, octave_int16> (dv);
+        return borrow_int_to_ov<int16_t, int16NDArray, octave_int16> (dv);
 
       case mxUINT16_CLASS:
-        return int_to_ov<uint16_t, uint16NDArray, octave_uint16> (dv);
+        return borrow_int_to_ov<uint16_t, uint16NDArray, octave_uint16> (dv);
 
       case mxINT32_CLASS:
-        return int_to_ov<int32_t, int32NDArray, octave_int32> (dv);
+        return borrow_int_to_ov<int32_t, int32NDArray, octave_int32> (dv);
 
       case mxUINT32_CLASS:
-        return int_to_ov<uint32_t, uint32NDArray, octave_uint32> (dv);
+        return borrow_int_to_ov<uint32_t, uint32NDArray, octave_uint32> (dv);
 
       case mxINT64_CLASS:
-        return int_to_ov<int64_t, int64NDArray, octave_int64> (dv);
+        return borrow_int_to_ov<int64_t, int64NDArray, octave_int64> (dv);
 
       case mxUINT64_CLASS:
-        return int_to_ov<uint64_t, uint64NDArray, octave_uint64> (dv);
+        return borrow_int_to_ov<uint64_t, uint64NDArray, octave_uint64> (dv);
 
       default:
         panic_impossible ();
@@ -1991,6 +1991,43 @@ protected:
 
   }
 
+  // Same as int_to_ov, but for types where the Octave array element
+  // has the same representation as the mxArray element.  The
+  // octave_value object may then borrow the mxArray data instead of
+  // copying it.
+
+  template <typename ELT_T, typename ARRAY_T, typename ARRAY_ELT_T>
+  octave_value
+  borrow_int_to_ov (const dim_vector& dv) const
+  {
+#if defined (OCTAVE_HAVE_STD_PMR_POLYMORPHIC_ALLOCATOR)
+
+    static_assert (sizeof (ELT_T) == sizeof (ARRAY_ELT_T),
+                   "borrow_int_to_ov: element sizes must match");
+
+    if (is_complex ())
+      error ("complex integer types are not supported");
+
+    ARRAY_ELT_T *ppr = reinterpret_cast<ARRAY_ELT_T *> (m_pr);
+
+    if (current_mx_memory_resource == &the_mx_deleting_memory_resource)
+      {
+        octave::unwind_action act ([=] () { maybe_disown_ptr (m_pr); });
+
+        return octave_value (ARRAY_T (Array<ARRAY_ELT_T>
+                                      (ppr, dv, current_mx_memory_resource)));
+      }
+    else
+      return octave_value (ARRAY_T (Array<ARRAY_ELT_T>
+                                    (ppr, dv, current_mx_memory_resource)));
+
+#else
+
+    return int_to_ov<ELT_T, ARRAY_T, ARRAY_ELT_T> (dv);
+
+#endif
+  }
+
 protected:
 
   // If using interleaved complex storage, this is the pointer to data
@@ -69,6 +69,7 @@ COREFCN_INC = \
   %reldir%/oct-hdf5-types.h \
   %reldir%/oct-hist.h \
   %reldir%/oct-iostrm.h \
+  %reldir%/oct-labs.h \
   %reldir%/oct-map.h \
   %reldir%/oct-prcstrm.h \
   %reldir%/oct-procbuf.h \
@@ -76,6 +77,7 @@ COREFCN_INC = \
   %reldir%/oct-stdstrm.h \
   %reldir%/oct-stream.h \
   %reldir%/oct-strstrm.h \
+  %reldir%/oct-workers.h \
   %reldir%/oct.h \
   %reldir%/octave-default-image.h \
   %reldir%/pager.h \
@@ -128,6 +130,7 @@ COREFCN_SRC = \
   %reldir%/__magick_read__.cc \
   %reldir%/__pchip_deriv__.cc \
   %reldir%/__qp__.cc \
+  %reldir%/__unique__.cc \
   %reldir%/amd.cc \
   %reldir%/auto-shlib.cc \
   %reldir%/balance.cc \
@@ -223,6 +226,7 @@ COREFCN_SRC = \
   %reldir%/oct-hdf5-types.cc \
   %reldir%/oct-hist.cc \
   %reldir%/oct-iostrm.cc \
+  %reldir%/oct-labs.cc \
   %reldir%/oct-map.cc \
   %reldir%/oct-prcstrm.cc \
   %reldir%/oct-procbuf.cc \
@@ -232,8 +236,10 @@ COREFCN_SRC = \
   %reldir%/oct-tex-lexer.ll \
   %reldir%/oct-tex-parser.h \
   %reldir%/oct-tex-parser.yy \
+  %reldir%/oct-workers.cc \
   %reldir%/ordqz.cc \
   %reldir%/ordschur.cc \
+  %reldir%/pagemtimes.cc \
   %reldir%/pager.cc \
   %reldir%/perms.cc \
   %reldir%/pinv.cc \
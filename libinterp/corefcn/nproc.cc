@@ -27,7 +27,12 @@
 #  include "config.h"
 #endif
 
+#include <limits>
+
+#include "lo-mappers.h"
+#include "mx-simd.h"
 #include "nproc-wrapper.h"
+#include "oct-thread-pool.h"
 
 #include "defun.h"
 #include "error.h"
@@ -112,4 +117,213 @@ same as @code{current}, but overridable through the
 %!error nproc ("no_valid_option")
 */
 
+DEFUN (maxNumCompThreads, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{n} =} maxNumCompThreads ()
+@deftypefnx {} {@var{lastn} =} maxNumCompThreads (@var{n})
+@deftypefnx {} {@var{lastn} =} maxNumCompThreads ("automatic")
+Query or set the maximum number of threads used for computations.
+
+Element-wise operations on large arrays, such as arithmetic, comparisons,
+and mapper functions, and the sorting of large arrays are split across this
+many threads.  The default is
+the number of processors returned by @code{nproc ()}.
+
+If called with an argument, set the maximum number of threads to @var{n}
+and return the previous value.  The argument @qcode{"automatic"} restores
+the default.  A value of 1 disables multithreading.
+@seealso{nproc}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  if (nargin == 0)
+    return ovl (thread_pool::num_threads ());
+
+  int n = 0;
+
+  if (args(0).is_string ())
+    {
+      std::string arg = args(0).string_value ();
+
+      std::transform (arg.begin (), arg.end (), arg.begin (), tolower);
+
+      if (arg != "automatic")
+        error (R"(maxNumCompThreads: N must be a positive integer or "automatic")");
+    }
+  else
+    {
+      double dval = args(0).xdouble_value ("maxNumCompThreads: N must be a positive integer");
+
+      if (! math::isinteger (dval) || dval < 1
+          || dval > std::numeric_limits<int>::max ())
+        error ("maxNumCompThreads: N must be a positive integer");
+
+      n = static_cast<int> (dval);
+    }
+
+  return ovl (thread_pool::num_threads (n));
+}
+
+/*
+%!assert (maxNumCompThreads () >= 1)
+
+%!test
+%! n = maxNumCompThreads ();
+%! unwind_protect
+%!   assert (maxNumCompThreads (1), n);
+%!   assert (maxNumCompThreads (), 1);
+%!   x = 1:2e5;
+%!   assert (x + x, 2*x);
+%!   maxNumCompThreads (4);
+%!   assert (x + x, 2*x);
+%!   assert (sqrt (x .* x), x);
+%!   assert (x > 1e5, [false(1, 1e5), true(1, 1e5)]);
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (n);
+%! end_unwind_protect
+
+## Sparse matrix products.  Except for sparse matrix times vector, the
+## results do not depend on the number of threads.
+%!test
+%! n = maxNumCompThreads ();
+%! unwind_protect
+%!   A = sprandn (2000, 2000, 0.05);
+%!   B = sprandn (2000, 300, 0.05);
+%!   X = randn (2000, 8);
+%!   x = randn (2000, 1);
+%!   maxNumCompThreads (1);
+%!   r1 = {A*B, A*X, A'*X, X'*A, X'*A', A*x};
+%!   maxNumCompThreads (4);
+%!   r4 = {A*B, A*X, A'*X, X'*A, X'*A', A*x};
+%!   assert (r4(1:5), r1(1:5));
+%!   assert (r4{6}, r1{6}, 1e-10);
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (n);
+%! end_unwind_protect
+
+%!test
+%! n = maxNumCompThreads ();
+%! unwind_protect
+%!   maxNumCompThreads (3);
+%!   maxNumCompThreads ("automatic");
+%!   assert (maxNumCompThreads (), nproc ());
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (n);
+%! end_unwind_protect
+
+%!error maxNumCompThreads (1, 2)
+%!error <N must be a positive integer> maxNumCompThreads (0)
+%!error <N must be a positive integer> maxNumCompThreads (1.5)
+%!error <N must be a positive integer or "automatic"> maxNumCompThreads ("foo")
+*/
+
+DEFUN (__simd_level__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {[@var{level}, @var{max_level}] =} __simd_level__ ()
+@deftypefnx {} {@var{old_level} =} __simd_level__ (@var{level})
+Query or set the instruction set used by the vectorized array loops.
+
+@var{level} is one of @qcode{"none"}, @qcode{"sse2"}, @qcode{"avx2"}, or
+@qcode{"avx512"}.  Levels that are not supported by the processor are
+reduced to @var{max_level}.  This function is intended for testing and
+benchmarking.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  simd::isa_level old_level = simd::level ();
+
+  if (nargin == 1)
+    {
+      std::string arg = args(0).xstring_value ("__simd_level__: LEVEL must be a string");
+
+      std::transform (arg.begin (), arg.end (), arg.begin (), tolower);
+
+      simd::isa_level lvl;
+
+      if (arg == "none")
+        lvl = simd::NONE;
+      else if (arg == "sse2")
+        lvl = simd::SSE2;
+      else if (arg == "avx2")
+        lvl = simd::AVX2;
+      else if (arg == "avx512")
+        lvl = simd::AVX512;
+      else
+        error ("__simd_level__: invalid LEVEL '%s'", arg.c_str ());
+
+      simd::set_level (lvl);
+    }
+
+  return ovl (simd::level_name (old_level),
+              simd::level_name (simd::max_level ()));
+}
+
+/*
+%!test
+%! old = __simd_level__ ();
+%! unwind_protect
+%!   v = [-Inf, -2, -1, -0, 0, 1, 2, Inf, NaN];
+%!   x = v(mod ((1:1001) * 7, 9) + 1);
+%!   y = v(mod ((1:1001) * 5 + 3, 9) + 1);
+%!   i8 = int8 ([-128, -100, -1, 0, 1, 100, 127]);
+%!   a = i8(mod ((1:1001) * 3, 7) + 1);
+%!   b = i8(mod ((1:1001) * 4, 7) + 1);
+%!   u16 = uint16 ([0, 1, 1000, 65534, 65535]);
+%!   c = u16(mod ((1:1001) * 2, 5) + 1);
+%!   d = u16(mod ((1:1001) * 3, 5) + 1);
+%!   f = @() {min(x, y), max(x, y), min(single (x), single (y)), ...
+%!            x < y, x <= 0, 1 > y, x == y, single (x) ~= single (y), ...
+%!            x >= y, a + b, a - b, a + 100, -100 - b, c + d, c - d, ...
+%!            bitshift (int64 (a), 55) + bitshift (int64 (b), 55)};
+%!   __simd_level__ ("none");
+%!   ref = f ();
+%!   for lvl = {"sse2", "avx2", "avx512"}
+%!     __simd_level__ (lvl{1});
+%!     assert (f (), ref);
+%!   endfor
+%! unwind_protect_cleanup
+%!   __simd_level__ (old);
+%! end_unwind_protect
+
+%!test
+%! [lvl, max_lvl] = __simd_level__ ();
+%! assert (any (strcmp (lvl, {"none", "sse2", "avx2", "avx512"})));
+%! assert (any (strcmp (max_lvl, {"none", "sse2", "avx2", "avx512"})));
+
+%!error __simd_level__ (1, 2)
+%!error <invalid LEVEL> __simd_level__ ("mmx")
+
+%!demo
+%! ## Compare the vectorized loops with the scalar loops.
+%! x = rand (1, 1e6);  y = rand (1, 1e6);
+%! a = int8 (100 * x);  b = int8 (100 * y);
+%! [old, max_lvl] = __simd_level__ ();
+%! n = maxNumCompThreads (1);
+%! unwind_protect
+%!   for lvl = unique ({"none", "sse2", "avx2", "avx512", max_lvl}, "stable")
+%!     __simd_level__ (lvl{1});
+%!     if (! strcmp (__simd_level__ (), lvl{1}))
+%!       continue;
+%!     endif
+%!     t = zeros (1, 3);
+%!     tic; for k = 1:20, z = min (x, y); endfor; t(1) = toc;
+%!     tic; for k = 1:20, z = x < y; endfor; t(2) = toc;
+%!     tic; for k = 1:20, z = a + b; endfor; t(3) = toc;
+%!     printf ("%-7s  min %6.3f s   lt %6.3f s   int8 add %6.3f s\n",
+%!             lvl{1}, t);
+%!   endfor
+%! unwind_protect_cleanup
+%!   __simd_level__ (old);
+%!   maxNumCompThreads (n);
+%! end_unwind_protect
+*/
+
 OCTAVE_END_NAMESPACE(octave)
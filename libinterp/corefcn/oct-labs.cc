@@ -0,0 +1,501 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include "unistd-wrappers.h"
+
+#include "defun.h"
+#include "error.h"
+#include "errwarn.h"
+#include "interpreter.h"
+#include "oct-labs.h"
+#include "oct-workers.h"
+#include "ovl.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+std::unique_ptr<lab_context> lab_context::s_current;
+
+// The pipe that carries messages from lab I to lab J (both 0-based)
+// is stored at FDS[2*(I*NUMLABS+J)] (read end) and FDS[2*(I*NUMLABS+J)+1]
+// (write end).
+
+static inline std::size_t
+pipe_index (int from, int to, int numlabs)
+{
+  return 2 * (static_cast<std::size_t> (from) * numlabs + to);
+}
+
+lab_context::lab_context (int labindex, int numlabs)
+  : m_labindex (labindex), m_numlabs (numlabs), m_channels (numlabs),
+    m_pending (numlabs)
+{ }
+
+lab_context::~lab_context () = default;
+
+void
+lab_context::send (const octave_value& val, int dest, int tag)
+{
+  Cell msg (1, 2);
+
+  msg(0) = tag;
+  msg(1) = val;
+
+  channel (dest, "labSend").send (octave_value (msg));
+}
+
+octave_value
+lab_context::receive (int source, int tag, int& actual_tag)
+{
+  std::deque<message>& pending = m_pending[source-1];
+
+  for (auto p = pending.begin (); p != pending.end (); p++)
+    {
+      if (tag == ANY_TAG || p->tag == tag)
+        {
+          octave_value retval = p->data;
+          actual_tag = p->tag;
+          pending.erase (p);
+          return retval;
+        }
+    }
+
+  return receive_message (source, tag, actual_tag);
+}
+
+Cell
+lab_context::gather (const octave_value& val, int target)
+{
+  int me = m_labindex;
+  int n = m_numlabs;
+
+  int tag;
+
+  if (target > 0)
+    {
+      if (me != target)
+        {
+          send (val, target, COLLECTIVE_TAG);
+          return Cell ();
+        }
+
+      Cell retval (1, n);
+
+      for (int k = 1; k <= n; k++)
+        retval(k-1) = (k == me ? val : receive (k, COLLECTIVE_TAG, tag));
+
+      return retval;
+    }
+
+  // Exchange values pairwise.  All labs visit the pairs in the same
+  // order and the lower lab of each pair sends first, so the exchange
+  // can't deadlock even if a message does not fit in the pipe buffer.
+
+  Cell retval (1, n);
+
+  retval(me-1) = val;
+
+  for (int i = 1; i <= n; i++)
+    {
+      for (int j = i + 1; j <= n; j++)
+        {
+          if (me == i)
+            {
+              send (val, j, COLLECTIVE_TAG);
+              retval(j-1) = receive (j, COLLECTIVE_TAG, tag);
+            }
+          else if (me == j)
+            {
+              retval(i-1) = receive (i, COLLECTIVE_TAG, tag);
+              send (val, i, COLLECTIVE_TAG);
+            }
+        }
+    }
+
+  return retval;
+}
+
+void
+lab_context::barrier ()
+{
+  gather (Matrix ());
+}
+
+bool
+lab_context::create_pipes (int numlabs, std::vector<int>& fds)
+{
+  fds.assign (2 * static_cast<std::size_t> (numlabs) * numlabs, -1);
+
+  for (int i = 0; i < numlabs; i++)
+    {
+      for (int j = 0; j < numlabs; j++)
+        {
+          if (i == j)
+            continue;
+
+          if (octave_pipe_wrapper (&fds[pipe_index (i, j, numlabs)]) < 0)
+            {
+              close_pipes (fds);
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+
+void
+lab_context::close_pipes (std::vector<int>& fds)
+{
+  for (int& fd : fds)
+    {
+      if (fd >= 0)
+        octave_close_wrapper (fd);
+
+      fd = -1;
+    }
+}
+
+void
+lab_context::attach (int labindex, int numlabs, std::vector<int>& fds)
+{
+  std::unique_ptr<lab_context> lab (new lab_context (labindex, numlabs));
+
+  int me = labindex - 1;
+
+  for (int j = 0; j < numlabs; j++)
+    {
+      if (j == me)
+        continue;
+
+      int& rfd = fds[pipe_index (j, me, numlabs)];
+      int& wfd = fds[pipe_index (me, j, numlabs) + 1];
+
+      lab->m_channels[j] = std::make_unique<worker_channel> (rfd, wfd);
+
+      rfd = -1;
+      wfd = -1;
+    }
+
+  close_pipes (fds);
+
+  s_current = std::move (lab);
+}
+
+worker_channel&
+lab_context::channel (int lab, const char *who)
+{
+  if (lab < 1 || lab > m_numlabs)
+    error ("%s: lab index %d out of range [1, %d]", who, lab, m_numlabs);
+
+  if (lab == m_labindex)
+    error ("%s: a lab can't communicate with itself", who);
+
+  return *m_channels[lab-1];
+}
+
+octave_value
+lab_context::receive_message (int source, int tag, int& actual_tag)
+{
+  worker_channel& chan = channel (source, "labReceive");
+
+  for (;;)
+    {
+      octave_value tmp;
+
+      if (! chan.try_receive (tmp))
+        error_with_id ("Octave:spmd-lab-exited",
+                       "labReceive: lab %d exited before sending a message",
+                       source);
+
+      Cell msg = tmp.cell_value ();
+
+      int msg_tag = msg(0).int_value ();
+
+      if (tag == ANY_TAG || msg_tag == tag)
+        {
+          actual_tag = msg_tag;
+          return msg(1);
+        }
+
+      m_pending[source-1].push_back ({msg_tag, msg(1)});
+    }
+}
+
+static int
+lab_arg (const octave_value& arg, const char *who, const char *what)
+{
+  double val = arg.xdouble_value ("%s: %s must be a positive integer",
+                                  who, what);
+
+  if (math::x_nint (val) != val || val < 1)
+    error ("%s: %s must be a positive integer", who, what);
+
+  return static_cast<int> (val);
+}
+
+static int
+tag_arg (const octave_value& arg, const char *who)
+{
+  double val = arg.xdouble_value ("%s: TAG must be a nonnegative integer",
+                                  who);
+
+  if (math::x_nint (val) != val || val < 0 || val > 32767)
+    error ("%s: TAG must be an integer in the range [0, 32767]", who);
+
+  return static_cast<int> (val);
+}
+
+DEFUN (labindex, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{idx} =} labindex ()
+Return the index of the lab that executes the current @code{spmd} block.
+
+Labs are numbered from 1 to @code{numlabs ()}.  Outside of an @code{spmd}
+block and when the block is executed serially, the index is 1.
+@seealso{numlabs, spmd_num_workers}
+@end deftypefn */)
+{
+  if (args.length () != 0)
+    print_usage ();
+
+  lab_context *lab = lab_context::current ();
+
+  return ovl (lab ? lab->labindex () : 1);
+}
+
+DEFUN (numlabs, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{n} =} numlabs ()
+Return the number of labs that execute the current @code{spmd} block.
+
+Outside of an @code{spmd} block and when the block is executed serially,
+the number of labs is 1.
+@seealso{labindex, spmd_num_workers}
+@end deftypefn */)
+{
+  if (args.length () != 0)
+    print_usage ();
+
+  lab_context *lab = lab_context::current ();
+
+  return ovl (lab ? lab->numlabs () : 1);
+}
+
+DEFUN (labSend, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {} labSend (@var{data}, @var{dest})
+@deftypefnx {} {} labSend (@var{data}, @var{dest}, @var{tag})
+Send @var{data} to the lab or labs with index @var{dest}.
+
+The optional @var{tag} is an integer between 0 and 32767 (default 0) that
+may be used to select the message in @code{labReceive}.
+
+Messages are transferred through pipes.  A large message may block the
+sender until the destination lab calls @code{labReceive}.
+@seealso{labReceive, labindex, numlabs}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 2 || nargin > 3)
+    print_usage ();
+
+  lab_context *lab = lab_context::current ();
+
+  if (! lab)
+    error ("labSend: no other labs are running");
+
+  int tag = (nargin == 3 ? tag_arg (args(2), "labSend") : 0);
+
+  NDArray dest = args(1).xarray_value ("labSend: DEST must be a lab index");
+
+  for (octave_idx_type k = 0; k < dest.numel (); k++)
+    lab->send (args(0), lab_arg (dest(k), "labSend", "DEST"), tag);
+
+  return ovl ();
+}
+
+DEFUN (labReceive, args, nargout,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{data} =} labReceive (@var{source})
+@deftypefnx {} {@var{data} =} labReceive (@var{source}, @var{tag})
+@deftypefnx {} {[@var{data}, @var{source}, @var{tag}] =} labReceive (@dots{})
+Wait for a message from the lab with index @var{source} and return its
+data.
+
+If @var{tag} is given, only a message with this tag is received.
+Messages with other tags remain available for later calls.
+@seealso{labSend, labindex, numlabs}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 1 || nargin > 2)
+    print_usage ();
+
+  lab_context *lab = lab_context::current ();
+
+  if (! lab)
+    error ("labReceive: no other labs are running");
+
+  int source = lab_arg (args(0), "labReceive", "SOURCE");
+
+  int tag = (nargin == 2 ? tag_arg (args(1), "labReceive")
+             : lab_context::ANY_TAG);
+
+  int actual_tag;
+
+  octave_value data = lab->receive (source, tag, actual_tag);
+
+  if (nargout > 1)
+    return ovl (data, source, actual_tag);
+
+  return ovl (data);
+}
+
+DEFUN (labBarrier, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} labBarrier ()
+Wait until all labs that execute the current @code{spmd} block have
+called @code{labBarrier}.
+@seealso{labindex, numlabs}
+@end deftypefn */)
+{
+  if (args.length () != 0)
+    print_usage ();
+
+  lab_context *lab = lab_context::current ();
+
+  if (lab)
+    lab->barrier ();
+
+  return ovl ();
+}
+
+DEFMETHOD (gcat, interp, args, ,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{y} =} gcat (@var{x})
+@deftypefnx {} {@var{y} =} gcat (@var{x}, @var{dim})
+@deftypefnx {} {@var{y} =} gcat (@var{x}, @var{dim}, @var{targetlab})
+Concatenate the values @var{x} of all labs in lab order along dimension
+@var{dim} (default 2).
+
+If @var{targetlab} is given, the result is only returned on that lab and
+is empty on all other labs.  When called outside of an @code{spmd} block,
+return @var{x}.
+@seealso{gplus, labindex, numlabs}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 1 || nargin > 3)
+    print_usage ();
+
+  int dim = (nargin > 1 ? lab_arg (args(1), "gcat", "DIM") : 2);
+  int target = (nargin > 2 ? lab_arg (args(2), "gcat", "TARGETLAB") : 0);
+
+  lab_context *lab = lab_context::current ();
+
+  if (! lab)
+    return ovl (args(0));
+
+  if (target > lab->numlabs ())
+    error ("gcat: TARGETLAB must be in the range [1, %d]", lab->numlabs ());
+
+  Cell parts = lab->gather (args(0), target);
+
+  if (parts.isempty ())
+    return ovl (Matrix ());
+
+  octave_value_list cat_args (parts.numel () + 1, octave_value ());
+
+  cat_args(0) = dim;
+
+  for (octave_idx_type k = 0; k < parts.numel (); k++)
+    cat_args(k+1) = parts(k);
+
+  return interp.feval ("cat", cat_args, 1);
+}
+
+DEFMETHOD (gplus, interp, args, ,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{y} =} gplus (@var{x})
+@deftypefnx {} {@var{y} =} gplus (@var{x}, @var{targetlab})
+Return the sum of the values @var{x} of all labs.
+
+The values are added in lab order so that the result is identical on all
+labs.  If @var{targetlab} is given, the result is only returned on that lab
+and is empty on all other labs.  When called outside of an @code{spmd}
+block, return @var{x}.
+@seealso{gcat, labindex, numlabs}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 1 || nargin > 2)
+    print_usage ();
+
+  int target = (nargin > 1 ? lab_arg (args(1), "gplus", "TARGETLAB") : 0);
+
+  lab_context *lab = lab_context::current ();
+
+  if (! lab)
+    return ovl (args(0));
+
+  if (target > lab->numlabs ())
+    error ("gplus: TARGETLAB must be in the range [1, %d]", lab->numlabs ());
+
+  Cell parts = lab->gather (args(0), target);
+
+  if (parts.isempty ())
+    return ovl (Matrix ());
+
+  type_info& ti = interp.get_type_info ();
+
+  octave_value retval = parts(0);
+
+  for (octave_idx_type k = 1; k < parts.numel (); k++)
+    retval = binary_op (ti, octave_value::op_add, retval, parts(k));
+
+  return ovl (retval);
+}
+
+/*
+## Outside of an spmd block, there is only one lab.
+%!assert (labindex (), 1)
+%!assert (numlabs (), 1)
+%!assert (gcat ([1, 2]), [1, 2])
+%!assert (gplus (3), 3)
+
+%!error labindex (1)
+%!error <no other labs> labSend (1, 2)
+%!error <no other labs> labReceive (2)
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_oct_labs_h)
+#define octave_oct_labs_h 1
+
+#include "octave-config.h"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "Cell.h"
+#include "ov.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+class worker_channel;
+
+// Communication between the labs (worker processes) that execute an
+// spmd block.  Every pair of labs is connected by a pair of pipes that
+// is created by the client before the workers are forked.  Messages
+// carry a tag so that labReceive can pick out a particular message and
+// so that collective operations do not consume user messages.
+
+class OCTINTERP_API lab_context
+{
+public:
+
+  // Tag that matches any message in receive.
+  static const int ANY_TAG = -1;
+
+  // Tag used internally by collective operations.
+  static const int COLLECTIVE_TAG = -2;
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (lab_context)
+
+  ~lab_context ();
+
+  // LABINDEX is 1-based.
+  int labindex () const { return m_labindex; }
+
+  int numlabs () const { return m_numlabs; }
+
+  void send (const octave_value& val, int dest, int tag);
+
+  // Wait for a message from lab SOURCE with tag TAG (or any tag) and
+  // return its data.  The tag of the message is stored in ACTUAL_TAG.
+  octave_value receive (int source, int tag, int& actual_tag);
+
+  // Collect the values VAL of all labs in lab order.  If TARGET is
+  // positive, only that lab receives the values; the result is empty
+  // on all other labs.
+  Cell gather (const octave_value& val, int target = 0);
+
+  // Wait until all labs have reached this point.
+  void barrier ();
+
+  // Create the pipes that connect NUMLABS labs.  Return false if the
+  // pipes could not be created.
+  static bool create_pipes (int numlabs, std::vector<int>& fds);
+
+  // Close all pipes in the client once the labs have been forked.
+  static void close_pipes (std::vector<int>& fds);
+
+  // Make the current process lab LABINDEX.  Pipes that belong to other
+  // labs are closed.
+  static void attach (int labindex, int numlabs, std::vector<int>& fds);
+
+  // The lab context of the current process or nullptr if the current
+  // process does not execute an spmd block.
+  static lab_context * current () { return s_current.get (); }
+
+private:
+
+  struct message
+  {
+    int tag;
+    octave_value data;
+  };
+
+  lab_context (int labindex, int numlabs);
+
+  worker_channel& channel (int lab, const char *who);
+
+  octave_value receive_message (int source, int tag, int& actual_tag);
+
+  int m_labindex;
+
+  int m_numlabs;
+
+  // Channels to the other labs, indexed by lab number - 1.  The entry
+  // for the current lab is null.
+  std::vector<std::unique_ptr<worker_channel>> m_channels;
+
+  // Messages received while waiting for a different tag.
+  std::vector<std::deque<message>> m_pending;
+
+  static std::unique_ptr<lab_context> s_current;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -47,7 +47,9 @@
 #include "lo-ieee.h"
 #include "lo-mappers.h"
 #include "lo-utils.h"
+#include "mman-wrappers.h"
 #include "oct-locbuf.h"
+#include "oct-thread-pool.h"
 #include "octave-preserve-stream-state.h"
 #include "quit.h"
 #include "str-vec.h"
@@ -1806,17 +1808,23 @@ public:
 
   ~textscan () = default;
 
+  // If FD is not -1, it is the descriptor of the regular file that ISP
+  // reads from.  Files that contain only numeric columns are then
+  // parsed from a memory mapped copy, in parallel.
   octave_value scan (std::istream& isp, const std::string& fmt,
                      octave_idx_type ntimes,
                      const octave_value_list& options,
-                     octave_idx_type& read_count);
+                     octave_idx_type& read_count, int fd = -1);
 
 private:
 
   friend class textscan_format_list;
 
   octave_value do_scan (std::istream& isp, textscan_format_list& fmt_list,
-                        octave_idx_type ntimes);
+                        octave_idx_type ntimes, int fd);
+
+  bool scan_mapped (std::istream& isp, int fd,
+                    textscan_format_list& fmt_list, octave_value& retval);
 
   void parse_options (const octave_value_list& args,
                       textscan_format_list& fmt_list);
@@ -2548,13 +2556,13 @@ textscan::textscan (const std::string& who_arg, const std::string& encoding)
 octave_value
 textscan::scan (std::istream& isp, const std::string& fmt,
                 octave_idx_type ntimes, const octave_value_list& options,
-                octave_idx_type& count)
+                octave_idx_type& count, int fd)
 {
   textscan_format_list fmt_list (fmt);
 
   parse_options (options, fmt_list);
 
-  octave_value result = do_scan (isp, fmt_list, ntimes);
+  octave_value result = do_scan (isp, fmt_list, ntimes, fd);
 
   // FIXME: this is probably not the best way to get count.  The
   // position could easily be larger than octave_idx_type when using
@@ -2570,7 +2578,7 @@ textscan::scan (std::istream& isp, const std::string& fmt,
 
 octave_value
 textscan::do_scan (std::istream& isp, textscan_format_list& fmt_list,
-                   octave_idx_type ntimes)
+                   octave_idx_type ntimes, int fd)
 {
   octave_value retval;
 
@@ -2585,6 +2593,10 @@ textscan::do_scan (std::istream& isp, textscan_format_list& fmt_list,
   for (int i = 0; i < m_header_lines && isp; i++)
     getline (isp, dummy, static_cast<char> (m_eol2));
 
+  if (fd >= 0 && ntimes == -1 && isp
+      && scan_mapped (isp, fd, fmt_list, retval))
+    return retval;
+
   // Create our own buffered stream, for fast get/putback/tell/seek.
 
   // First, see how far ahead it should let us look.
@@ -2767,6 +2779,516 @@ textscan::do_scan (std::istream& isp, textscan_format_list& fmt_list,
   return retval;
 }
 
+// Parser for lines of text that contain only numbers, used by
+// textscan::scan_mapped.  It accepts only input for which it gives
+// exactly the same values as the general code with "%f" conversions
+// (see read_double and scan_complex), and fails for anything else, in
+// which case the general code is used.
+
+class numeric_line_parser
+{
+public:
+
+  numeric_line_parser (const std::string& whitespace_table,
+                       const std::string& delims,
+                       const std::string& exp_chars, double empty_value)
+    : m_whitespace (256, false), m_delim (256, false),
+      m_exp (256, false), m_whitespace_delim (delims.empty ()),
+      m_empty_value (empty_value)
+  {
+    for (int i = 0; i < 256; i++)
+      m_whitespace[i] = whitespace_table[i];
+
+    for (unsigned char c : delims)
+      m_delim[c] = true;
+
+    for (unsigned char c : exp_chars)
+      m_exp[c] = true;
+  }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (numeric_line_parser)
+
+  ~numeric_line_parser () = default;
+
+  // Parse the line [P, END), which does not include the end of line
+  // characters, and call STORE (COL, VALUE) for each field.  Return
+  // the number of fields, or -1 if the line can't be parsed.
+  template <typename F>
+  int parse (const char *p, const char *end, F store) const;
+
+private:
+
+  bool is_whitespace (char c) const
+  { return m_whitespace[static_cast<unsigned char> (c)]; }
+
+  bool is_delim (char c) const
+  { return m_delim[static_cast<unsigned char> (c)]; }
+
+  const char * skip_whitespace (const char *p, const char *end) const
+  {
+    while (p < end && is_whitespace (*p))
+      p++;
+
+    return p;
+  }
+
+  bool read_number (const char *& p, const char *end, double& val) const;
+
+  std::vector<bool> m_whitespace;
+  std::vector<bool> m_delim;
+  std::vector<bool> m_exp;
+
+  bool m_whitespace_delim;
+
+  double m_empty_value;
+};
+
+template <typename F>
+int
+numeric_line_parser::parse (const char *p, const char *end, F store) const
+{
+  // Empty lines are handled differently by the general code.
+  if (p == end)
+    return -1;
+
+  int n = 0;
+
+  if (m_whitespace_delim)
+    {
+      for (;;)
+        {
+          p = skip_whitespace (p, end);
+
+          if (p == end)
+            return n > 0 ? n : -1;
+
+          double val;
+          if (! read_number (p, end, val))
+            return -1;
+
+          store (n++, val);
+
+          if (p < end && ! is_whitespace (*p))
+            return -1;
+        }
+    }
+  else
+    {
+      for (;;)
+        {
+          p = skip_whitespace (p, end);
+
+          double val = m_empty_value;
+          if (p < end && ! is_delim (*p))
+            {
+              if (! read_number (p, end, val))
+                return -1;
+
+              p = skip_whitespace (p, end);
+            }
+
+          store (n++, val);
+
+          if (p == end)
+            return n;
+
+          if (! is_delim (*p))
+            return -1;
+
+          p++;
+        }
+    }
+}
+
+bool
+numeric_line_parser::read_number (const char *& p, const char *end,
+                                  double& val) const
+{
+  const char *q = p;
+
+  int sign = 1;
+
+  if (*q == '+' || *q == '-')
+    {
+      if (*q == '-')
+        sign = -1;
+
+      q++;
+
+      // scan_complex reads "[+-]inf" itself and any other "[+-][ij]" as
+      // an imaginary number.
+      if (q < end && (*q == 'i' || *q == 'j'))
+        {
+          if (end - q >= 3 && q[0] == 'i' && q[1] == 'n' && q[2] == 'f')
+            {
+              val = (sign < 0 ? -numeric_limits<double>::Inf ()
+                     : numeric_limits<double>::Inf ());
+              p = q + 3;
+              return true;
+            }
+
+          return false;
+        }
+    }
+
+  // The arithmetic is the same as in textscan::read_double.
+
+  double retval = 0;
+  bool valid = false;
+
+  if (q < end && *q != '.')
+    {
+      if (*q >= '0' && *q <= '9')
+        valid = true;
+
+      while (q < end && *q >= '0' && *q <= '9')
+        retval = retval * 10 + (*q++ - '0');
+    }
+
+  if (q < end && *q == '.')
+    {
+      double multiplier = 1;
+      int i = 0;
+
+      q++;
+
+      while (q < end && *q >= '0' && *q <= '9')
+        {
+          retval += (*q++ - '0') * (multiplier *= 0.1);
+          i++;
+        }
+
+      if (i > 0)
+        valid = true;
+      else if (! valid)
+        return false;
+    }
+
+  if (valid && q + 1 < end && m_exp[static_cast<unsigned char> (*q)]
+      && (q[1] == '+' || q[1] == '-' || (q[1] >= '0' && q[1] <= '9')))
+    {
+      int exp = 0;
+      int exp_sign = 1;
+
+      q++;
+
+      if (*q == '+')
+        q++;
+      else if (*q == '-')
+        {
+          exp_sign = -1;
+          q++;
+        }
+
+      if (! (q < end && *q >= '0' && *q <= '9'))
+        return false;
+
+      while (q < end && *q >= '0' && *q <= '9')
+        {
+          exp = exp*10 + (*q++ - '0');
+
+          if (exp > 100000)
+            return false;
+        }
+
+      double multiplier = pown (10, exp);
+      if (exp_sign > 0)
+        retval *= multiplier;
+      else
+        retval /= multiplier;
+    }
+
+  if (! valid)
+    {
+      if (end - q < 3)
+        return false;
+
+      if (! octave_strncasecmp (q, "inf", 3))
+        retval = numeric_limits<double>::Inf ();
+      else if (! octave_strncasecmp (q, "nan", 3))
+        retval = numeric_limits<double>::NaN ();
+      else
+        return false;
+
+      q += 3;
+    }
+
+  val = retval * sign;
+  p = q;
+
+  return true;
+}
+
+// Memory mapped file, unmapped on destruction.
+
+class mapped_file
+{
+public:
+
+  mapped_file (int fd, off_t offset)
+    : m_data (nullptr), m_size (0), m_base (nullptr), m_map_len (0)
+  {
+    m_data = octave_mmap_file_wrapper (fd, offset, &m_size, &m_base,
+                                       &m_map_len);
+  }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (mapped_file)
+
+  ~mapped_file () { octave_munmap_file_wrapper (m_base, m_map_len); }
+
+  const char * data () const { return m_data; }
+
+  std::size_t size () const { return m_size; }
+
+private:
+
+  const char *m_data;
+  std::size_t m_size;
+  void *m_base;
+  std::size_t m_map_len;
+};
+
+// Return the end of the line that starts at P, and in NEXT the start
+// of the next line.  Lines end with "\n", "\r\n", or "\r".
+
+static inline const char *
+find_eol (const char *p, const char *end, const char *& next)
+{
+  while (p < end && *p != '\n' && *p != '\r')
+    p++;
+
+  next = p;
+
+  if (next < end)
+    {
+      if (*next == '\r' && next + 1 < end && next[1] == '\n')
+        next++;
+
+      next++;
+    }
+
+  return p;
+}
+
+// Read the rest of the file that ISP reads from, if it contains only
+// numeric columns that are read with "%f" conversions and no options
+// that would require the general code are given.  The file is split
+// at line boundaries into chunks that are parsed in parallel.  Return
+// false, without changing the position of ISP, if the fast path can't
+// be used.
+
+bool
+textscan::scan_mapped (std::istream& isp, int fd,
+                       textscan_format_list& fmt_list, octave_value& retval)
+{
+  if (m_comment_style.numel () > 0 || m_treat_as_empty.numel () > 0
+      || m_multiple_delims_as_one || m_delim_list.numel () > 0
+      || m_eol1 != '\r' || m_eol2 != '\n')
+    return false;
+
+  if (! fmt_list.set_from_first)
+    {
+      if (fmt_list.numel ()
+          != static_cast<std::size_t> (fmt_list.num_conversions ()))
+        return false;
+
+      for (const textscan_format_elt *elt = fmt_list.first (); elt;
+           elt = fmt_list.next (false))
+        {
+          if ((elt->type != 'f' && elt->type != 'n') || elt->bitwidth != 64
+              || elt->discard || elt->prec != -1
+              || elt->width != static_cast<unsigned int> (-1))
+            return false;
+        }
+
+      fmt_list.first ();
+    }
+
+  // Characters that separate fields must not be part of numbers.
+  auto separator_ok = [] (unsigned char c)
+  {
+    return ! (std::isalnum (c) || c == '+' || c == '-' || c == '.'
+              || c == '\r' || c == '\n' || c >= 0x80);
+  };
+
+  for (int c = 0; c < 256; c++)
+    if (m_whitespace_table[c] && ! separator_ok (c))
+      return false;
+
+  for (unsigned char c : m_delims)
+    if (! separator_ok (c) || m_whitespace_table[c])
+      return false;
+
+  std::streamoff pos = isp.tellg ();
+  if (pos < 0)
+    return false;
+
+  mapped_file file (fd, pos);
+
+  const char *data = file.data ();
+  const char *data_end = data + file.size ();
+
+  if (! data)
+    return false;
+
+  numeric_line_parser parser (m_whitespace_table, m_delims, m_exp_chars,
+                              m_empty_value.double_value ());
+
+  int ncols;
+  if (fmt_list.set_from_first)
+    {
+      const char *next;
+      const char *eol = find_eol (data, data_end, next);
+
+      ncols = parser.parse (data, eol, [] (int, double) { });
+    }
+  else
+    ncols = fmt_list.num_conversions ();
+
+  if (ncols <= 0)
+    return false;
+
+  // If the file does not end with a newline, the general code treats
+  // an empty last field differently.
+  if (data_end[-1] != '\n' && data_end[-1] != '\r' && ! m_delims.empty ())
+    {
+      const char *p = data_end;
+      while (p > data && m_whitespace_table[static_cast<unsigned char> (p[-1])])
+        p--;
+
+      if (p > data && m_delims.find (p[-1]) != std::string::npos)
+        return false;
+    }
+
+  // Split the data into chunks that end at a newline.
+
+  std::size_t nthreads = thread_pool::num_threads ();
+  std::size_t chunk_size = std::max (file.size () / (4 * nthreads),
+                                     std::size_t (1) << 20);
+
+  std::vector<const char *> bounds (1, data);
+  while (bounds.back () < data_end)
+    {
+      const char *p = bounds.back ();
+
+      if (static_cast<std::size_t> (data_end - p) <= chunk_size)
+        p = data_end;
+      else
+        {
+          p = static_cast<const char *>
+              (std::memchr (p + chunk_size, '\n',
+                            data_end - p - chunk_size));
+
+          p = (p ? p + 1 : data_end);
+        }
+
+      bounds.push_back (p);
+    }
+
+  std::size_t nchunks = bounds.size () - 1;
+
+  // Count the lines in each chunk to find the rows where the chunks
+  // start.
+
+  std::vector<std::size_t> first_row (nchunks + 1, 0);
+
+  auto count_lines = [&] (std::size_t begin, std::size_t end)
+  {
+    for (std::size_t k = begin; k < end; k++)
+      {
+        std::size_t nlines = 0;
+
+        for (const char *p = bounds[k]; p < bounds[k+1]; nlines++)
+          find_eol (p, bounds[k+1], p);
+
+        first_row[k+1] = nlines;
+      }
+  };
+
+  thread_pool::parallel_for (nchunks, count_lines, 1, 2);
+
+  for (std::size_t k = 0; k < nchunks; k++)
+    first_row[k+1] += first_row[k];
+
+  std::size_t nrows = first_row[nchunks];
+
+  if (nrows > static_cast<std::size_t> (dim_vector::dim_max ()))
+    return false;
+
+  // Parse the chunks directly into the result.
+
+  Matrix collected;
+  std::vector<ColumnVector> columns;
+  std::vector<double *> cols (ncols);
+
+  if (m_collect_output)
+    {
+      collected.resize (nrows, ncols);
+      double *base = collected.fortran_vec ();
+      for (int j = 0; j < ncols; j++)
+        cols[j] = base + j * nrows;
+    }
+  else
+    {
+      columns.reserve (ncols);
+      for (int j = 0; j < ncols; j++)
+        {
+          columns.emplace_back (nrows);
+          cols[j] = columns[j].fortran_vec ();
+        }
+    }
+
+  std::atomic<bool> failed (false);
+
+  auto parse_lines = [&] (std::size_t begin, std::size_t end)
+  {
+    for (std::size_t k = begin; k < end && ! failed; k++)
+      {
+        std::size_t row = first_row[k];
+        const char *next;
+
+        for (const char *p = bounds[k]; p < bounds[k+1]; p = next, row++)
+          {
+            const char *eol = find_eol (p, bounds[k+1], next);
+
+            auto store = [&] (int j, double val)
+            {
+              if (j < ncols)
+                cols[j][row] = val;
+            };
+
+            if (parser.parse (p, eol, store) != ncols)
+              {
+                failed = true;
+                return;
+              }
+          }
+      }
+  };
+
+  thread_pool::parallel_for (nchunks, parse_lines, 1, 2);
+
+  if (failed)
+    return false;
+
+  if (m_collect_output)
+    retval = Cell (octave_value (collected));
+  else
+    {
+      Cell c (1, ncols);
+      for (int j = 0; j < ncols; j++)
+        c(j) = columns[j];
+      retval = c;
+    }
+
+  // Leave the stream at the end of the file, as the general code does.
+  isp.clear ();
+  isp.seekg (0, std::ios::end);
+  isp.setstate (std::ios::eofbit);
+
+  return true;
+}
+
 // Read a double considering the "precision" field of FMT and the
 // EXP_CHARS option of OPTIONS.
 
@@ -5443,7 +5965,19 @@ base_stream::do_textscan (const std::string& fmt,
     {
       textscan scanner (who, encoding ());
 
-      retval = scanner.scan (*isp, fmt, ntimes, options, read_count);
+      // Only plain files can be memory mapped.
+      int fd = -1;
+      if (encoding () == "utf-8" && dynamic_cast<stdiostream *> (this))
+        {
+          fd = file_number ();
+
+          // Data that was written but not flushed would not be seen.
+          std::ostream *os = output_stream ();
+          if (os)
+            os->flush ();
+        }
+
+      retval = scanner.scan (*isp, fmt, ntimes, options, read_count, fd);
     }
 
   return retval;
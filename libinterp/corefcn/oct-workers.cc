@@ -0,0 +1,328 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <cerrno>
+#include <cstdint>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+#include "mach-info.h"
+#include "nproc-wrapper.h"
+#include "oct-syscalls.h"
+#include "quit.h"
+#include "signal-wrappers.h"
+#include "unistd-wrappers.h"
+
+#include "error.h"
+#include "ls-oct-binary.h"
+#include "oct-workers.h"
+#include "ov.h"
+#include "pager.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+bool worker_process::s_in_worker = false;
+
+// Parent ends of the pipes of all running workers.  A new child
+// process closes them so that it does not keep the channels of its
+// siblings open.
+
+static std::set<int> parent_fds;
+
+static void
+close_fd (int fd)
+{
+  if (fd >= 0)
+    {
+      parent_fds.erase (fd);
+      octave_close_wrapper (fd);
+    }
+}
+
+void
+worker_channel::reset (int rfd, int wfd)
+{
+  close ();
+
+  m_rfd = rfd;
+  m_wfd = wfd;
+}
+
+void
+worker_channel::send (const octave_value& val)
+{
+  std::ostringstream buf;
+
+  if (val.is_undefined ()
+      || ! save_binary_data (buf, val, "value", "", false, false))
+    error ("worker: unable to send value of type '%s'",
+           val.type_name ().c_str ());
+
+  std::string data = buf.str ();
+
+  uint64_t len = data.length ();
+
+  write_bytes (reinterpret_cast<const char *> (&len), sizeof (len));
+  write_bytes (data.data (), data.length ());
+}
+
+octave_value
+worker_channel::receive ()
+{
+  octave_value retval;
+
+  if (! try_receive (retval))
+    error ("worker: process exited unexpectedly");
+
+  return retval;
+}
+
+bool
+worker_channel::try_receive (octave_value& val)
+{
+  uint64_t len = 0;
+
+  if (! read_bytes (reinterpret_cast<char *> (&len), sizeof (len)))
+    return false;
+
+  std::string data (len, '\0');
+
+  if (! read_bytes (&data[0], len))
+    return false;
+
+  std::istringstream is (data);
+
+  bool global = false;
+  std::string doc;
+
+  std::string name = read_binary_data (is, false,
+                                       mach_info::native_float_format (),
+                                       "", global, val, doc);
+
+  if (name.empty ())
+    error ("worker: invalid data received from process");
+
+  return true;
+}
+
+void
+worker_channel::close ()
+{
+  close_fd (m_rfd);
+  close_fd (m_wfd);
+
+  m_rfd = -1;
+  m_wfd = -1;
+}
+
+void
+worker_channel::write_bytes (const char *buf, std::size_t n)
+{
+  while (n > 0)
+    {
+      ssize_t status = octave_write_wrapper (m_wfd, buf, n);
+
+      if (status < 0)
+        {
+          if (errno == EINTR)
+            {
+              octave_quit ();
+              continue;
+            }
+
+          error ("worker: unable to write to channel");
+        }
+
+      buf += status;
+      n -= status;
+    }
+}
+
+// Return false if the other end was closed before N bytes were read.
+
+bool
+worker_channel::read_bytes (char *buf, std::size_t n)
+{
+  while (n > 0)
+    {
+      ssize_t status = octave_read_wrapper (m_rfd, buf, n);
+
+      if (status < 0)
+        {
+          if (errno == EINTR)
+            {
+              octave_quit ();
+              continue;
+            }
+
+          error ("worker: unable to read from channel");
+        }
+      else if (status == 0)
+        return false;
+
+      buf += status;
+      n -= status;
+    }
+
+  return true;
+}
+
+worker_process::~worker_process ()
+{
+  if (running ())
+    terminate ();
+}
+
+bool
+worker_process::start (const std::function<int (worker_channel&)>& fcn)
+{
+  int to_child[2];
+  int from_child[2];
+
+  if (octave_pipe_wrapper (to_child) < 0)
+    return false;
+
+  if (octave_pipe_wrapper (from_child) < 0)
+    {
+      octave_close_wrapper (to_child[0]);
+      octave_close_wrapper (to_child[1]);
+      return false;
+    }
+
+  // Don't let the child repeat output that is still buffered.
+
+  flush_stdout ();
+  std::cout.flush ();
+  std::cerr.flush ();
+
+  pid_t pid = octave_fork_wrapper ();
+
+  if (pid < 0)
+    {
+      octave_close_wrapper (to_child[0]);
+      octave_close_wrapper (to_child[1]);
+      octave_close_wrapper (from_child[0]);
+      octave_close_wrapper (from_child[1]);
+      return false;
+    }
+
+  if (pid == 0)
+    {
+      // Child.  Never return to the caller.
+
+      s_in_worker = true;
+
+      for (int fd : parent_fds)
+        octave_close_wrapper (fd);
+
+      parent_fds.clear ();
+
+      octave_close_wrapper (to_child[1]);
+      octave_close_wrapper (from_child[0]);
+
+      int status = 1;
+
+      try
+        {
+          worker_channel chan (to_child[0], from_child[1]);
+
+          status = fcn (chan);
+        }
+      catch (...)
+        {
+          // Errors are reported by FCN.  Anything else simply ends
+          // the worker.
+        }
+
+      flush_stdout ();
+      std::cout.flush ();
+      std::cerr.flush ();
+
+      octave__exit_wrapper (status);
+    }
+
+  octave_close_wrapper (to_child[0]);
+  octave_close_wrapper (from_child[1]);
+
+  m_channel.reset (from_child[0], to_child[1]);
+
+  parent_fds.insert (from_child[0]);
+  parent_fds.insert (to_child[1]);
+
+  m_pid = pid;
+
+  return true;
+}
+
+int
+worker_process::wait ()
+{
+  if (! running ())
+    return -1;
+
+  m_channel.close ();
+
+  int status = 0;
+
+  while (sys::waitpid (m_pid, &status, 0) < 0 && errno == EINTR)
+    ;
+
+  m_pid = -1;
+
+  return sys::wifexited (status) ? sys::wexitstatus (status) : -1;
+}
+
+void
+worker_process::terminate ()
+{
+  if (! running ())
+    return;
+
+  int sig;
+
+  if (octave_get_sig_number ("SIGKILL", &sig))
+    sys::kill (m_pid, sig);
+
+  wait ();
+}
+
+bool
+worker_process::available ()
+{
+  return octave_have_fork ();
+}
+
+int
+worker_process::num_processors ()
+{
+  return octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT_OVERRIDABLE);
+}
+
+OCTAVE_END_NAMESPACE(octave)
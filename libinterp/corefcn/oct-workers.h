@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_oct_workers_h)
+#define octave_oct_workers_h 1
+
+#include "octave-config.h"
+
+#include <functional>
+#include <string>
+
+#include <sys/types.h>
+
+class octave_value;
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// A pair of pipes for exchanging values with a worker process.  Values
+// are serialized in Octave's binary format and framed with their
+// length, so any number of values may be sent in either direction.
+
+class OCTINTERP_API worker_channel
+{
+public:
+
+  worker_channel () : m_rfd (-1), m_wfd (-1) { }
+
+  worker_channel (int rfd, int wfd) : m_rfd (rfd), m_wfd (wfd) { }
+
+  OCTAVE_DISABLE_COPY_MOVE (worker_channel)
+
+  ~worker_channel () { close (); }
+
+  void reset (int rfd, int wfd);
+
+  void send (const octave_value& val);
+
+  octave_value receive ();
+
+  // Like receive, but return false if the other end of the channel was
+  // closed before a value was sent.
+  bool try_receive (octave_value& val);
+
+  void close ();
+
+  int read_fd () const { return m_rfd; }
+
+  int write_fd () const { return m_wfd; }
+
+private:
+
+  void write_bytes (const char *buf, std::size_t n);
+
+  bool read_bytes (char *buf, std::size_t n);
+
+  int m_rfd;
+  int m_wfd;
+};
+
+// A forked copy of the interpreter.  The child process inherits the
+// complete state of the parent, so the workspace does not have to be
+// transferred explicitly.  Results are sent back over the channel.
+
+class OCTINTERP_API worker_process
+{
+public:
+
+  worker_process () : m_pid (-1), m_channel () { }
+
+  OCTAVE_DISABLE_COPY_MOVE (worker_process)
+
+  ~worker_process ();
+
+  // Fork a child process that calls FCN with its end of the channel
+  // and then exits with the status returned by FCN.  In the parent,
+  // return false if the process could not be created.
+  bool start (const std::function<int (worker_channel&)>& fcn);
+
+  worker_channel& channel () { return m_channel; }
+
+  pid_t pid () const { return m_pid; }
+
+  bool running () const { return m_pid > 0; }
+
+  // Close the channel and wait for the child to exit.  Return the exit
+  // status of the child or -1 if it did not exit normally.
+  int wait ();
+
+  // Kill the child process and wait for it to exit.
+  void terminate ();
+
+  // TRUE if worker processes can be created on this system.
+  static bool available ();
+
+  // TRUE if the current process is a worker.
+  static bool in_worker () { return s_in_worker; }
+
+  // Number of processors available for worker processes.
+  static int num_processors ();
+
+private:
+
+  pid_t m_pid;
+
+  worker_channel m_channel;
+
+  static bool s_in_worker;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
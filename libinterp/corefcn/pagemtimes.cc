@@ -0,0 +1,950 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "f77-fcn.h"
+#include "lo-array-errwarn.h"
+#include "lo-blas-proto.h"
+#include "lo-mappers.h"
+#include "mx-base.h"
+#include "oct-thread-pool.h"
+
+#include "defun.h"
+#include "error.h"
+#include "ovl.h"
+#include "xdiv.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Pages with no dimension larger than this are handled by the simple
+// kernels below instead of BLAS and LAPACK.
+
+static const octave_idx_type SMALL_PAGE = 16;
+
+enum page_op
+{
+  PAGE_NONE,
+  PAGE_TRANSPOSE,
+  PAGE_CTRANSPOSE
+};
+
+static page_op
+get_page_op (const octave_value& arg, const char *who, const char *name)
+{
+  std::string op = arg.xstring_value ("%s: %s must be a string", who, name);
+
+  if (op == "none")
+    return PAGE_NONE;
+  else if (op == "transpose")
+    return PAGE_TRANSPOSE;
+  else if (op == "ctranspose")
+    return PAGE_CTRANSPOSE;
+
+  error (R"(%s: %s must be "none", "transpose", or "ctranspose")",
+         who, name);
+}
+
+// The page dimensions of the result and the pages of X and Y that are
+// combined for each of its pages.  Dimensions 3 and higher of X and Y
+// must either be equal or 1, in which case the page is reused.
+
+class page_layout
+{
+public:
+
+  page_layout (const char *who, const dim_vector& dx, const dim_vector& dy,
+               octave_idx_type rows, octave_idx_type cols)
+  {
+    int nd = std::max (dx.ndims (), dy.ndims ());
+
+    dim_vector xd = dx.redim (nd);
+    dim_vector yd = dy.redim (nd);
+
+    m_dims = dim_vector::alloc (nd);
+    m_dims(0) = rows;
+    m_dims(1) = cols;
+
+    for (int i = 2; i < nd; i++)
+      {
+        if (xd(i) == yd(i) || yd(i) == 1)
+          m_dims(i) = xd(i);
+        else if (xd(i) == 1)
+          m_dims(i) = yd(i);
+        else
+          error ("%s: dimensions 3 and higher of X and Y must be equal or 1",
+                 who);
+      }
+
+    octave_idx_type np = m_dims.numel (2);
+
+    m_xpage.resize (np);
+    m_ypage.resize (np);
+
+    // Step through the pages of the result, keeping track of the
+    // corresponding pages of X and Y.
+
+    std::vector<octave_idx_type> idx (nd, 0);
+    octave_idx_type xp = 0;
+    octave_idx_type yp = 0;
+
+    for (octave_idx_type p = 0; p < np; p++)
+      {
+        m_xpage[p] = xp;
+        m_ypage[p] = yp;
+
+        octave_idx_type xstride = 1;
+        octave_idx_type ystride = 1;
+
+        for (int i = 2; i < nd; i++)
+          {
+            bool carry = (++idx[i] == m_dims(i));
+
+            if (carry)
+              idx[i] = 0;
+
+            if (xd(i) != 1)
+              xp += (carry ? 1 - xd(i) : 1) * xstride;
+            if (yd(i) != 1)
+              yp += (carry ? 1 - yd(i) : 1) * ystride;
+
+            if (! carry)
+              break;
+
+            xstride *= xd(i);
+            ystride *= yd(i);
+          }
+      }
+  }
+
+  OCTAVE_DEFAULT_COPY_MOVE (page_layout)
+
+  ~page_layout () = default;
+
+  const dim_vector& dims () const { return m_dims; }
+
+  octave_idx_type npages () const { return m_xpage.size (); }
+
+  octave_idx_type xpage (octave_idx_type p) const { return m_xpage[p]; }
+
+  octave_idx_type ypage (octave_idx_type p) const { return m_ypage[p]; }
+
+private:
+
+  dim_vector m_dims;
+
+  std::vector<octave_idx_type> m_xpage;
+  std::vector<octave_idx_type> m_ypage;
+};
+
+template <typename T>
+struct page_real_type
+{
+  typedef T type;
+};
+
+template <typename T>
+struct page_real_type<std::complex<T>>
+{
+  typedef T type;
+};
+
+template <typename NDA>
+struct page_matrix_type;
+
+template <>
+struct page_matrix_type<NDArray>
+{
+  typedef Matrix type;
+};
+
+template <>
+struct page_matrix_type<FloatNDArray>
+{
+  typedef FloatMatrix type;
+};
+
+template <>
+struct page_matrix_type<ComplexNDArray>
+{
+  typedef ComplexMatrix type;
+};
+
+template <>
+struct page_matrix_type<FloatComplexNDArray>
+{
+  typedef FloatComplexMatrix type;
+};
+
+// Copy the R-by-C page A to the contiguous buffer B with OP applied.
+
+template <typename T>
+static inline void
+pack_page (const T *a, octave_idx_type r, octave_idx_type c, page_op op,
+           T *b)
+{
+  if (op == PAGE_NONE)
+    std::copy (a, a + r*c, b);
+  else
+    {
+      for (octave_idx_type j = 0; j < c; j++)
+        for (octave_idx_type i = 0; i < r; i++)
+          b[j + i*c] = (op == PAGE_CTRANSPOSE ? math::conj (a[i + j*r])
+                                              : a[i + j*r]);
+    }
+}
+
+// Z = X*Y for small pages.  The loops for the most common sizes have
+// fixed bounds so that they are unrolled completely.
+
+template <typename T, int M, int N, int K>
+static inline void
+small_page_mtimes (const T *x, const T *y, T *z)
+{
+  for (int j = 0; j < N; j++)
+    {
+      T acc[M] = { };
+
+      for (int l = 0; l < K; l++)
+        {
+          T b = y[l + j*K];
+          for (int i = 0; i < M; i++)
+            acc[i] += x[i + l*M] * b;
+        }
+
+      for (int i = 0; i < M; i++)
+        z[i + j*M] = acc[i];
+    }
+}
+
+template <typename T>
+static inline void
+small_page_mtimes (const T *x, const T *y, T *z, octave_idx_type m,
+                   octave_idx_type n, octave_idx_type k)
+{
+  for (octave_idx_type j = 0; j < n; j++)
+    {
+      T acc[SMALL_PAGE] = { };
+
+      for (octave_idx_type l = 0; l < k; l++)
+        {
+          T b = y[l + j*k];
+          for (octave_idx_type i = 0; i < m; i++)
+            acc[i] += x[i + l*m] * b;
+        }
+
+      std::copy (acc, acc + m, z + j*m);
+    }
+}
+
+template <typename T>
+static void
+small_page_mtimes_dispatch (const T *x, const T *y, T *z, octave_idx_type m,
+                            octave_idx_type n, octave_idx_type k)
+{
+  if (m == n && n == k)
+    {
+      switch (m)
+        {
+        case 2:
+          small_page_mtimes<T, 2, 2, 2> (x, y, z);
+          return;
+
+        case 3:
+          small_page_mtimes<T, 3, 3, 3> (x, y, z);
+          return;
+
+        case 4:
+          small_page_mtimes<T, 4, 4, 4> (x, y, z);
+          return;
+
+        case 6:
+          small_page_mtimes<T, 6, 6, 6> (x, y, z);
+          return;
+
+        default:
+          break;
+        }
+    }
+  else if (n == 1 && m == k)
+    {
+      switch (m)
+        {
+        case 3:
+          small_page_mtimes<T, 3, 1, 3> (x, y, z);
+          return;
+
+        case 6:
+          small_page_mtimes<T, 6, 1, 6> (x, y, z);
+          return;
+
+        default:
+          break;
+        }
+    }
+
+  small_page_mtimes (x, y, z, m, n, k);
+}
+
+static inline char
+blas_op (page_op op)
+{
+  return (op == PAGE_NONE ? 'N' : (op == PAGE_TRANSPOSE ? 'T' : 'C'));
+}
+
+static void
+gemm_page (char ta, char tb, F77_INT m, F77_INT n, F77_INT k,
+           const double *a, F77_INT lda, const double *b, F77_INT ldb,
+           double *c)
+{
+  F77_XFCN (dgemm, DGEMM, (F77_CONST_CHAR_ARG2 (&ta, 1),
+                           F77_CONST_CHAR_ARG2 (&tb, 1),
+                           m, n, k, 1.0, a, lda, b, ldb, 0.0, c, m
+                           F77_CHAR_ARG_LEN (1)
+                           F77_CHAR_ARG_LEN (1)));
+}
+
+static void
+gemm_page (char ta, char tb, F77_INT m, F77_INT n, F77_INT k,
+           const float *a, F77_INT lda, const float *b, F77_INT ldb,
+           float *c)
+{
+  F77_XFCN (sgemm, SGEMM, (F77_CONST_CHAR_ARG2 (&ta, 1),
+                           F77_CONST_CHAR_ARG2 (&tb, 1),
+                           m, n, k, 1.0f, a, lda, b, ldb, 0.0f, c, m
+                           F77_CHAR_ARG_LEN (1)
+                           F77_CHAR_ARG_LEN (1)));
+}
+
+static void
+gemm_page (char ta, char tb, F77_INT m, F77_INT n, F77_INT k,
+           const Complex *a, F77_INT lda, const Complex *b, F77_INT ldb,
+           Complex *c)
+{
+  F77_XFCN (zgemm, ZGEMM, (F77_CONST_CHAR_ARG2 (&ta, 1),
+                           F77_CONST_CHAR_ARG2 (&tb, 1),
+                           m, n, k, 1.0, F77_CONST_DBLE_CMPLX_ARG (a), lda,
+                           F77_CONST_DBLE_CMPLX_ARG (b), ldb, 0.0,
+                           F77_DBLE_CMPLX_ARG (c), m
+                           F77_CHAR_ARG_LEN (1)
+                           F77_CHAR_ARG_LEN (1)));
+}
+
+static void
+gemm_page (char ta, char tb, F77_INT m, F77_INT n, F77_INT k,
+           const FloatComplex *a, F77_INT lda, const FloatComplex *b,
+           F77_INT ldb, FloatComplex *c)
+{
+  F77_XFCN (cgemm, CGEMM, (F77_CONST_CHAR_ARG2 (&ta, 1),
+                           F77_CONST_CHAR_ARG2 (&tb, 1),
+                           m, n, k, 1.0f, F77_CONST_CMPLX_ARG (a), lda,
+                           F77_CONST_CMPLX_ARG (b), ldb, 0.0f,
+                           F77_CMPLX_ARG (c), m
+                           F77_CHAR_ARG_LEN (1)
+                           F77_CHAR_ARG_LEN (1)));
+}
+
+// Split a loop over NP pages into chunks of roughly equal work for the
+// thread pool.  WORK is the number of operations per page.
+
+template <typename F>
+static void
+parallel_pages (octave_idx_type np, octave_idx_type work, F fcn)
+{
+  std::size_t w = std::max (work, octave_idx_type (1));
+
+  std::size_t grain = std::max (thread_pool::GRAIN / w, std::size_t (1));
+  std::size_t min_pages = std::max (thread_pool::MIN_ELEMENTS / w,
+                                    std::size_t (2));
+
+  thread_pool::parallel_for (np, fcn, grain, min_pages);
+}
+
+template <typename NDA>
+static NDA
+page_mtimes (const NDA& x, page_op opx, const NDA& y, page_op opy)
+{
+  typedef typename NDA::element_type T;
+
+  const dim_vector& dx = x.dims ();
+  const dim_vector& dy = y.dims ();
+
+  octave_idx_type m = (opx == PAGE_NONE ? dx(0) : dx(1));
+  octave_idx_type k = (opx == PAGE_NONE ? dx(1) : dx(0));
+  octave_idx_type ky = (opy == PAGE_NONE ? dy(0) : dy(1));
+  octave_idx_type n = (opy == PAGE_NONE ? dy(1) : dy(0));
+
+  if (k != ky)
+    err_nonconformant ("pagemtimes", m, k, ky, n);
+
+  page_layout layout ("pagemtimes", dx, dy, m, n);
+
+  octave_idx_type np = layout.npages ();
+
+  if (m == 0 || n == 0 || np == 0)
+    return NDA (layout.dims ());
+
+  if (k == 0)
+    return NDA (layout.dims (), T (0));
+
+  NDA z (layout.dims ());
+
+  const T *px = x.data ();
+  const T *py = y.data ();
+  T *pz = z.rwdata ();
+
+  octave_idx_type xsize = dx(0) * dx(1);
+  octave_idx_type ysize = dy(0) * dy(1);
+  octave_idx_type zsize = m * n;
+
+  if (m <= SMALL_PAGE && n <= SMALL_PAGE && k <= SMALL_PAGE)
+    {
+      auto multiply_pages = [&] (std::size_t begin, std::size_t end)
+      {
+        T xbuf[SMALL_PAGE * SMALL_PAGE];
+        T ybuf[SMALL_PAGE * SMALL_PAGE];
+
+        for (std::size_t p = begin; p < end; p++)
+          {
+            const T *xp = px + layout.xpage (p) * xsize;
+            const T *yp = py + layout.ypage (p) * ysize;
+
+            if (opx != PAGE_NONE)
+              {
+                pack_page (xp, dx(0), dx(1), opx, xbuf);
+                xp = xbuf;
+              }
+
+            if (opy != PAGE_NONE)
+              {
+                pack_page (yp, dy(0), dy(1), opy, ybuf);
+                yp = ybuf;
+              }
+
+            small_page_mtimes_dispatch (xp, yp, pz + p * zsize, m, n, k);
+          }
+      };
+
+      parallel_pages (np, m * n * k, multiply_pages);
+    }
+  else
+    {
+      // BLAS uses multiple threads for large pages itself.
+
+      F77_INT f_m = to_f77_int (m);
+      F77_INT f_n = to_f77_int (n);
+      F77_INT f_k = to_f77_int (k);
+      F77_INT ldx = to_f77_int (dx(0));
+      F77_INT ldy = to_f77_int (dy(0));
+
+      for (octave_idx_type p = 0; p < np; p++)
+        {
+          octave_quit ();
+
+          gemm_page (blas_op (opx), blas_op (opy), f_m, f_n, f_k,
+                     px + layout.xpage (p) * xsize, ldx,
+                     py + layout.ypage (p) * ysize, ldy, pz + p * zsize);
+        }
+    }
+
+  return z;
+}
+
+template <typename T>
+static inline double
+pivot_abs (const T& x)
+{
+  return std::abs (x);
+}
+
+template <typename T>
+static inline double
+pivot_abs (const std::complex<T>& x)
+{
+  return std::abs (x.real ()) + std::abs (x.imag ());
+}
+
+// Solve op(A)*X = B for a small square page A of order N by LU
+// factorization with partial pivoting.  X overwrites B, which has NRHS
+// columns.  Return false without changing B if A is singular to machine
+// precision, that is, if the reciprocal condition number in the
+// 1-norm is smaller than EPS or NaN.
+
+template <typename T>
+static bool
+small_page_solve (const T *a, page_op op, octave_idx_type n, T *b,
+                  octave_idx_type nrhs)
+{
+  typedef typename page_real_type<T>::type R;
+
+  T lu[SMALL_PAGE * SMALL_PAGE];
+  octave_idx_type ipvt[SMALL_PAGE];
+
+  pack_page (a, n, n, op, lu);
+
+  R anorm = 0;
+  for (octave_idx_type j = 0; j < n; j++)
+    {
+      R s = 0;
+      for (octave_idx_type i = 0; i < n; i++)
+        s += std::abs (lu[i + j*n]);
+      anorm = std::max (anorm, s);
+    }
+
+  for (octave_idx_type j = 0; j < n; j++)
+    {
+      octave_idx_type p = j;
+      for (octave_idx_type i = j + 1; i < n; i++)
+        if (pivot_abs (lu[i + j*n]) > pivot_abs (lu[p + j*n]))
+          p = i;
+
+      ipvt[j] = p;
+
+      if (lu[p + j*n] == T (0))
+        return false;
+
+      if (p != j)
+        for (octave_idx_type c = 0; c < n; c++)
+          std::swap (lu[j + c*n], lu[p + c*n]);
+
+      T d = lu[j + j*n];
+      for (octave_idx_type i = j + 1; i < n; i++)
+        lu[i + j*n] /= d;
+
+      for (octave_idx_type c = j + 1; c < n; c++)
+        {
+          T t = lu[j + c*n];
+          for (octave_idx_type i = j + 1; i < n; i++)
+            lu[i + c*n] -= lu[i + j*n] * t;
+        }
+    }
+
+  auto solve = [&] (T *x)
+  {
+    for (octave_idx_type i = 0; i < n; i++)
+      if (ipvt[i] != i)
+        std::swap (x[i], x[ipvt[i]]);
+
+    for (octave_idx_type j = 0; j < n; j++)
+      for (octave_idx_type i = j + 1; i < n; i++)
+        x[i] -= lu[i + j*n] * x[j];
+
+    for (octave_idx_type j = n - 1; j >= 0; j--)
+      {
+        x[j] /= lu[j + j*n];
+        for (octave_idx_type i = 0; i < j; i++)
+          x[i] -= lu[i + j*n] * x[j];
+      }
+  };
+
+  // The pages are small enough to compute the norm of the inverse
+  // exactly instead of estimating it.
+
+  R ainvnorm = 0;
+  for (octave_idx_type j = 0; j < n; j++)
+    {
+      T e[SMALL_PAGE] = { };
+      e[j] = T (1);
+
+      solve (e);
+
+      R s = 0;
+      for (octave_idx_type i = 0; i < n; i++)
+        s += std::abs (e[i]);
+      ainvnorm = std::max (ainvnorm, s);
+    }
+
+  R rcond = R (1) / (anorm * ainvnorm);
+
+  if (! (rcond >= std::numeric_limits<R>::epsilon ()))
+    return false;
+
+  for (octave_idx_type j = 0; j < nrhs; j++)
+    solve (b + j*n);
+
+  return true;
+}
+
+template <typename NDA>
+static NDA
+page_mldivide (const NDA& x, page_op opx, const NDA& y)
+{
+  typedef typename NDA::element_type T;
+  typedef typename page_matrix_type<NDA>::type MT;
+
+  const dim_vector& dx = x.dims ();
+  const dim_vector& dy = y.dims ();
+
+  octave_idx_type xr = (opx == PAGE_NONE ? dx(0) : dx(1));
+  octave_idx_type xc = (opx == PAGE_NONE ? dx(1) : dx(0));
+  octave_idx_type n = dy(1);
+
+  if (xr != dy(0))
+    err_nonconformant ("pagemldivide", xr, xc, dy(0), n);
+
+  page_layout layout ("pagemldivide", dx, dy, xc, n);
+
+  octave_idx_type np = layout.npages ();
+
+  NDA z (layout.dims (), T (0));
+
+  if (z.isempty ())
+    return z;
+
+  const T *px = x.data ();
+  const T *py = y.data ();
+  T *pz = z.rwdata ();
+
+  octave_idx_type xsize = dx(0) * dx(1);
+  octave_idx_type ysize = dy(0) * dy(1);
+  octave_idx_type zsize = xc * n;
+
+  // Pages that are left to the general solver.
+  std::vector<char> general (np, true);
+
+  if (xr == xc && xr <= SMALL_PAGE)
+    {
+      auto solve_pages = [&] (std::size_t begin, std::size_t end)
+      {
+        for (std::size_t p = begin; p < end; p++)
+          {
+            const T *yp = py + layout.ypage (p) * ysize;
+            T *zp = pz + p * zsize;
+
+            std::copy (yp, yp + ysize, zp);
+
+            general[p] = ! small_page_solve (px + layout.xpage (p) * xsize,
+                                             opx, xr, zp, n);
+          }
+      };
+
+      parallel_pages (np, xr * xr * (xr + n), solve_pages);
+    }
+
+  // Large, rectangular, and (nearly) singular pages are solved as with
+  // the backslash operator, including its warnings and the fallback to
+  // a least squares solution.
+
+  blas_trans_type transt = (opx == PAGE_NONE ? blas_no_trans
+                            : (opx == PAGE_TRANSPOSE ? blas_trans
+                                                     : blas_conj_trans));
+
+  for (octave_idx_type p = 0; p < np; p++)
+    {
+      if (! general[p])
+        continue;
+
+      octave_quit ();
+
+      MT a (x.page (layout.xpage (p)));
+      MT b (y.page (layout.ypage (p)));
+
+      MatrixType typ;
+      MT r = xleftdiv (a, b, typ, transt);
+
+      std::copy (r.data (), r.data () + zsize, pz + p * zsize);
+    }
+
+  return z;
+}
+
+class mtimes_fcn
+{
+public:
+
+  mtimes_fcn (page_op opx, page_op opy) : m_opx (opx), m_opy (opy) { }
+
+  template <typename NDA>
+  octave_value operator () (const NDA& x, const NDA& y) const
+  {
+    return page_mtimes (x, m_opx, y, m_opy);
+  }
+
+private:
+
+  page_op m_opx;
+  page_op m_opy;
+};
+
+class mldivide_fcn
+{
+public:
+
+  mldivide_fcn (page_op opx) : m_opx (opx) { }
+
+  template <typename NDA>
+  octave_value operator () (const NDA& x, const NDA& y) const
+  {
+    return page_mldivide (x, m_opx, y);
+  }
+
+private:
+
+  page_op m_opx;
+};
+
+// Convert the arguments to a common type and call FCN with them.
+
+template <typename FCN>
+static octave_value
+dispatch_pages (const char *who, const octave_value& x,
+                const octave_value& y, FCN fcn)
+{
+  if (! (x.isnumeric () || x.islogical ())
+      || ! (y.isnumeric () || y.islogical ()))
+    error ("%s: X and Y must be numeric", who);
+
+  if (x.isinteger () || y.isinteger ())
+    error ("%s: X and Y must be single or double", who);
+
+  if (x.iscomplex () || y.iscomplex ())
+    {
+      if (x.is_single_type () || y.is_single_type ())
+        return fcn (x.float_complex_array_value (),
+                    y.float_complex_array_value ());
+      else
+        return fcn (x.complex_array_value (), y.complex_array_value ());
+    }
+  else
+    {
+      if (x.is_single_type () || y.is_single_type ())
+        return fcn (x.float_array_value (), y.float_array_value ());
+      else
+        return fcn (x.array_value (), y.array_value ());
+    }
+}
+
+DEFUN (pagemtimes, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{Z} =} pagemtimes (@var{X}, @var{Y})
+@deftypefnx {} {@var{Z} =} pagemtimes (@var{X}, @var{transpX}, @var{Y}, @var{transpY})
+Compute the page-wise matrix product of @var{X} and @var{Y}.
+
+Each page @code{@var{Z}(:,:,@var{i},@dots{})} of the result is the matrix
+product of the corresponding pages of @var{X} and @var{Y}:
+
+@example
+@var{Z}(:,:,@var{i}) = @var{X}(:,:,@var{i}) * @var{Y}(:,:,@var{i})
+@end example
+
+The optional arguments @var{transpX} and @var{transpY} select an operation
+that is applied to each page of @var{X} and @var{Y} before the
+multiplication.  They may be @qcode{"none"} (the default),
+@qcode{"transpose"}, or @qcode{"ctranspose"}.
+
+Dimensions 3 and higher of @var{X} and @var{Y} must either be equal or 1.
+A dimension of size 1 is expanded to match the other argument, so that, for
+example, a single matrix can be multiplied with every page of an array.
+
+Small pages are multiplied with simple loops on multiple threads rather than
+with one call to the BLAS library per page.
+@seealso{pagemldivide, mtimes, blkmm, pagetranspose}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin != 2 && nargin != 4)
+    print_usage ();
+
+  octave_value x = args(0);
+  octave_value y = args(nargin == 2 ? 1 : 2);
+
+  page_op opx = PAGE_NONE;
+  page_op opy = PAGE_NONE;
+
+  if (nargin == 4)
+    {
+      opx = get_page_op (args(1), "pagemtimes", "TRANSPX");
+      opy = get_page_op (args(3), "pagemtimes", "TRANSPY");
+    }
+
+  return dispatch_pages ("pagemtimes", x, y, mtimes_fcn (opx, opy));
+}
+
+/*
+%!shared x, y, z
+%! x = reshape (1:12, [2, 3, 2]);
+%! y = reshape (1:18, [3, 3, 2]);
+%! z = cat (3, x(:,:,1) * y(:,:,1), x(:,:,2) * y(:,:,2));
+
+%!assert (pagemtimes (x, y), z)
+%!assert (pagemtimes (single (x), y), single (z))
+%!assert (pagemtimes (x, "none", y, "none"), z)
+%!assert (pagemtimes (permute (x, [2, 1, 3]), "transpose", y, "none"), z)
+%!assert (pagemtimes (x, "none", permute (y, [2, 1, 3]), "ctranspose"), z)
+%!assert (pagemtimes (x, i*y), i*z)
+%!assert (pagemtimes (i*permute (x, [2, 1, 3]), "ctranspose", y, "none"), -i*z)
+%!assert (pagemtimes (i*permute (x, [2, 1, 3]), "transpose", y, "none"), i*z)
+
+## Expansion of dimensions 3 and higher
+%!test
+%! a = rand (3, 3, 1, 4);
+%! b = rand (3, 2, 5);
+%! c = pagemtimes (a, b);
+%! assert (size (c), [3, 2, 5, 4]);
+%! for j = 1:5
+%!   for k = 1:4
+%!     assert (c(:,:,j,k), a(:,:,1,k) * b(:,:,j), 2*eps);
+%!   endfor
+%! endfor
+%! assert (pagemtimes (a(:,:,1,1), b), pagemtimes (repmat (a(:,:,1,1), [1, 1, 5]), b));
+
+## Small pages with fixed size kernels and large pages with BLAS
+%!test
+%! for n = [1, 2, 3, 4, 6, 7, 16, 17, 40]
+%!   a = rand (n, n, 50) + i*rand (n, n, 50);
+%!   b = rand (n, 1, 50);
+%!   c = pagemtimes (a, a);
+%!   d = pagemtimes (a, "ctranspose", b, "none");
+%!   for k = 1:50
+%!     assert (c(:,:,k), a(:,:,k) * a(:,:,k), 32*n*eps);
+%!     assert (d(:,:,k), a(:,:,k)' * b(:,:,k), 32*n*eps);
+%!   endfor
+%! endfor
+
+## Large number of pages that are handled on multiple threads
+%!test
+%! a = rand (3, 3, 100000);
+%! b = rand (3, 1, 100000);
+%! c = pagemtimes (a, b);
+%! assert (c, sum (a .* permute (b, [2, 1, 3]), 2), 8*eps);
+
+## Empty pages
+%!assert (pagemtimes (zeros (2, 0, 3), zeros (0, 4, 3)), zeros (2, 4, 3))
+%!assert (pagemtimes (zeros (0, 2, 3), zeros (2, 4)), zeros (0, 4, 3))
+%!assert (pagemtimes (zeros (2, 2, 0), zeros (2, 2)), zeros (2, 2, 0))
+
+## Test input validation
+%!error <Invalid call> pagemtimes ()
+%!error <Invalid call> pagemtimes (1)
+%!error <Invalid call> pagemtimes (1, "none", 2)
+%!error <X and Y must be numeric> pagemtimes ({1}, 2)
+%!error <X and Y must be single or double> pagemtimes (int8 (1), 2)
+%!error <TRANSPX must be "none"> pagemtimes (1, "foo", 2, "none")
+%!error <TRANSPY must be a string> pagemtimes (1, "none", 2, 3)
+%!error <nonconformant> pagemtimes (ones (2, 3), ones (2, 3))
+%!error <must be equal or 1> pagemtimes (ones (2, 2, 2), ones (2, 2, 3))
+*/
+
+DEFUN (pagemldivide, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{Z} =} pagemldivide (@var{X}, @var{Y})
+@deftypefnx {} {@var{Z} =} pagemldivide (@var{X}, @var{transpX}, @var{Y})
+Compute the page-wise left division of @var{Y} by @var{X}.
+
+Each page @code{@var{Z}(:,:,@var{i},@dots{})} of the result is the solution
+of the linear system given by the corresponding pages of @var{X} and
+@var{Y}:
+
+@example
+@var{Z}(:,:,@var{i}) = @var{X}(:,:,@var{i}) \ @var{Y}(:,:,@var{i})
+@end example
+
+The optional argument @var{transpX} may be @qcode{"none"} (the default),
+@qcode{"transpose"}, or @qcode{"ctranspose"} to solve the systems with the
+transposed pages of @var{X}.  Dimensions 3 and higher of @var{X} and
+@var{Y} are expanded as for @code{pagemtimes}.
+
+Small square pages are solved by LU@tie{}factorization with partial pivoting
+on multiple threads.  All other pages, and pages that are singular to
+machine precision, are solved as with the backslash operator, including the
+warnings and the least squares solution for singular systems.
+@seealso{pagemtimes, mldivide}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin != 2 && nargin != 3)
+    print_usage ();
+
+  octave_value x = args(0);
+  octave_value y = args(nargin - 1);
+
+  page_op opx = PAGE_NONE;
+
+  if (nargin == 3)
+    opx = get_page_op (args(1), "pagemldivide", "TRANSPX");
+
+  return dispatch_pages ("pagemldivide", x, y, mldivide_fcn (opx));
+}
+
+/*
+%!test
+%! a = rand (3, 3, 4) + 3*eye (3);
+%! b = rand (3, 2, 4);
+%! c = pagemldivide (a, b);
+%! d = pagemldivide (a, "transpose", b);
+%! for k = 1:4
+%!   assert (c(:,:,k), a(:,:,k) \ b(:,:,k), 1e-12);
+%!   assert (d(:,:,k), a(:,:,k).' \ b(:,:,k), 1e-12);
+%! endfor
+
+%!test
+%! a = rand (4, 4, 2, 3) + i*rand (4, 4, 2, 3) + 4*eye (4);
+%! b = single (rand (4, 1, 2));
+%! c = pagemldivide (a, "ctranspose", b);
+%! assert (class (c), "single");
+%! assert (size (c), [4, 1, 2, 3]);
+%! for j = 1:2
+%!   for k = 1:3
+%!     assert (c(:,:,j,k), single (a(:,:,j,k))' \ b(:,:,j), 1e-5);
+%!   endfor
+%! endfor
+
+## Large and rectangular pages use the general solver
+%!test
+%! a = rand (20, 20, 3) + 20*eye (20);
+%! b = rand (20, 2, 3);
+%! c = pagemldivide (a, b);
+%! assert (c(:,:,2), a(:,:,2) \ b(:,:,2));
+%! a = rand (5, 3, 2);
+%! c = pagemldivide (a, b(1:5,:,:));
+%! assert (c(:,:,2), a(:,:,2) \ b(1:5,:,2));
+
+## Singular pages give the same result and warning as backslash
+%!test
+%! a = cat (3, [2, 1; 1, 2], [1, 1; 1, 1]);
+%! b = [1; 1];
+%! warning ("off", "Octave:singular-matrix", "local");
+%! c = pagemldivide (a, b);
+%! assert (c(:,:,1), [1; 1] / 3, eps);
+%! assert (c(:,:,2), a(:,:,2) \ b);
+%!warning <singular to machine precision> pagemldivide ([1, 1; 1, 1], [1; 1]);
+
+%!error <Invalid call> pagemldivide ()
+%!error <Invalid call> pagemldivide (1, "none", 2, "none")
+%!error <nonconformant> pagemldivide (ones (2, 2), ones (3, 1))
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -159,6 +159,8 @@ do_rand (const octave_value_list& args, int nargin, const char *fcn,
               retval = rand::seed ();
             else if (s_arg == "state" || s_arg == "twister")
               retval = rand::state (fcn);
+            else if (s_arg == "philox")
+              retval = rand::philox_state (fcn);
             else if (s_arg == "uniform")
               rand::uniform_distribution ();
             else if (s_arg == "normal")
@@ -277,6 +279,45 @@ do_rand (const octave_value_list& args, int nargin, const char *fcn,
                     rand::state (s, fcn);
                   }
               }
+            else if (ts == "philox")
+              {
+                octave_value arg = args(idx+1);
+
+                if (arg.is_string () && arg.string_value () == "reset")
+                  rand::philox_reset (fcn);
+                else
+                  {
+                    ColumnVector s
+                      = ColumnVector (arg.vector_value (false, true));
+
+                    octave_idx_type n = s.numel ();
+
+                    if (n == philox_stream::STATE_SIZE)
+                      rand::philox_state (arg.uint32_array_value (), fcn);
+                    else if (n == 1 || n == 2)
+                      {
+                        double key = s(0);
+                        double substream = (n == 2 ? s(1) : 0);
+
+                        if (! math::isinteger (key) || key < 0
+                            || key >= 18446744073709551616.0)
+                          error ("%s: Philox seed must be a non-negative "
+                                 "integer", fcn);
+
+                        if (! math::isinteger (substream) || substream < 0
+                            || substream > 4294967295.0)
+                          error ("%s: Philox substream must be an integer "
+                                 "between 0 and 2^32-1", fcn);
+
+                        rand::philox_seed (static_cast<uint64_t> (key),
+                                           static_cast<uint32_t> (substream),
+                                           fcn);
+                      }
+                    else
+                      error ("%s: Philox seed must be a scalar, a vector "
+                             "[SEED, SUBSTREAM], or a state vector", fcn);
+                  }
+              }
             else
               error ("%s: unrecognized string argument", fcn);
           }
@@ -368,6 +409,11 @@ DEFUN (rand, args, ,
 @deftypefnx {} {@var{v} =} rand ("seed")
 @deftypefnx {} {} rand ("seed", @var{v})
 @deftypefnx {} {} rand ("seed", "reset")
+@deftypefnx {} {@var{v} =} rand ("philox")
+@deftypefnx {} {} rand ("philox", @var{seed})
+@deftypefnx {} {} rand ("philox", [@var{seed}, @var{substream}])
+@deftypefnx {} {} rand ("philox", @var{v})
+@deftypefnx {} {} rand ("philox", "reset")
 Return a matrix with random elements uniformly distributed on the
 interval (0, 1).
 
@@ -437,6 +483,36 @@ However, it should be noted that querying the seed will not cause
 @code{rand} to once again use the new generators, the keyword
 @qcode{"state"} should be used to reset the state of the @code{rand}.
 
+The keyword @qcode{"philox"} selects the counter-based Philox4x32-10
+generator instead of the Mersenne Twister
+(See @nospell{J. K. Salmon, M. A. Moraes, R. O. Dror, and D. E. Shaw},
+@cite{Parallel random numbers: As easy as 1, 2, 3}, Proceedings of the
+International Conference for High Performance Computing, Networking,
+Storage and Analysis, 2011).  The generator is initialized with a
+non-negative integer @var{seed} and an optional @var{substream} number
+between 0 and @math{2^{32}-1}.  Different substreams with the same seed are
+independent of each other, which is useful to give each of several parallel
+jobs its own sequence.  Each element of the result is computed from its
+position in the stream alone, so
+
+@example
+@group
+rand ("philox", 42);
+x = rand (1, 3);
+@end group
+@end example
+
+@noindent
+returns the same values as three calls to @code{rand ()}, and large arrays
+are filled on multiple threads
+(@pxref{XREFmaxNumCompThreads,,@code{maxNumCompThreads}}) with results that
+do not depend on the number of threads.  @code{rand ("philox")} returns
+the seed, substream, and position of the generator as a vector @var{v} of 5 @code{uint32} values that can be
+restored with @code{rand ("philox", @var{v})}, or an empty array if the
+Mersenne Twister is used.  The Philox generator is available for
+@code{rand}, @code{randn}, and @code{rande}.  Setting the @qcode{"state"}
+returns to the Mersenne Twister.
+
 The state or seed of the generator can be reset to a new random value using
 the @qcode{"reset"} keyword.
 
@@ -498,6 +574,49 @@ classes.
 %! rand ("seed", 1);
 %! assert (rand (1,6), [0.8668024251237512 0.9126510815694928 0.09366085007786751 0.1664607301354408 0.7408077004365623 0.7615650338120759], 1e-6);
 %!test
+%! ## Test a known fixed Philox seed
+%! rand ("philox", 0);
+%! assert (rand (1,6), [0.3990464723148957 0.9722412032044762 0.01944942265336036 0.7873677716784704 0.934536179107902 0.4503261970560954], eps);
+%! rand ("state", 1);
+%! assert (isempty (rand ("philox")));
+%! assert (rand (1,6), [0.1343642441124013 0.8474337369372327 0.763774618976614 0.2550690257394218 0.495435087091941 0.4494910647887382], eps);
+%!test  # elements do not depend on how they are requested
+%! rand ("philox", [42, 7]);
+%! x = rand (1, 100);
+%! rand ("philox", [42, 7]);
+%! y = [rand(1, 30), arrayfun(@(i) rand (), 1:20), rand(5, 10)(:)'];
+%! assert (y, x);
+%!test  # or on the number of threads
+%! rand ("philox", 42);
+%! old_nthreads = maxNumCompThreads (1);
+%! unwind_protect
+%!   x = rand (3e5, 1);
+%!   xs = rand (3e5, 1, "single");
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (old_nthreads);
+%! end_unwind_protect
+%! rand ("philox", 42);
+%! assert (rand (3e5, 1), x);
+%! assert (rand (3e5, 1, "single"), xs);
+%!test  # querying "philox" returns a state which can be used later
+%! rand ("philox", [5, 1]);
+%! rand (1, 10);
+%! s = rand ("philox");
+%! assert (class (s), "uint32");
+%! assert (numel (s), 5);
+%! x = rand (1, 4);
+%! rand ("philox", s);
+%! assert (rand (1, 4), x);
+%!test  # substreams are different
+%! rand ("philox", [5, 0]);  x = rand (1, 4);
+%! rand ("philox", [5, 1]);  y = rand (1, 4);
+%! assert (! any (x == y));
+%!error <Philox seed must be a non-negative integer> rand ("philox", -1)
+%!error <Philox seed must be a non-negative integer> rand ("philox", 1.5)
+%!error <Philox substream must be an integer> rand ("philox", [1, 2^32])
+%!error <Philox seed must be a scalar> rand ("philox", [1, 2, 3])
+%!error <only available for rand, randn, and rande> randg ("philox", 1)
+%!test
 %! if (__random_statistical_tests__)
 %!   ## statistical tests may fail occasionally.
 %!   rand ("state", 12);
@@ -594,6 +713,22 @@ J. Statistical Software, vol 5, 2000,
 %! randn ("seed", 1);
 %! assert (randn (1, 6), [-1.039402365684509 -1.25938892364502 0.1968704611063004 0.3874166905879974 -0.5976632833480835 -0.6615074276924133], 1e-6);
 %!test
+%! ## Test a known fixed Philox seed
+%! randn ("philox", 0);
+%! assert (randn (1, 6), [-0.9057432538097129 0.9571460410870321 -0.1882622796854794 -0.1165396724459533 0.5727877981599263 -1.379287108423303], 14*eps);
+%!test
+%! randn ("philox", 3);
+%! old_nthreads = maxNumCompThreads (1);
+%! unwind_protect
+%!   x = randn (3e5, 1);
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (old_nthreads);
+%! end_unwind_protect
+%! randn ("philox", 3);
+%! assert (randn (3e5, 1), x);
+%! randn ("philox", 3);
+%! assert ([randn(1, 2), randn()], x(1:3)');
+%!test
 %! if (__random_statistical_tests__)
 %!   ## statistical tests may fail occasionally.
 %!   randn ("state", 12);
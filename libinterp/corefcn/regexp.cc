@@ -1605,4 +1605,97 @@ function.
 %!                 "\nabc"));
 */
 
+DEFUN (__regexp_cache__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{stats} =} __regexp_cache__ ()
+@deftypefnx {} {} __regexp_cache__ ("clear")
+@deftypefnx {} {} __regexp_cache__ ("capacity", @var{n})
+Undocumented internal function.
+
+Query or control the cache of compiled patterns used by @code{regexp},
+@code{regexpi}, and @code{regexprep}.
+
+Without arguments, return a structure with the fields @code{hits},
+@code{misses}, @code{evictions}, @code{entries}, and @code{capacity}.
+The option @qcode{"clear"} empties the cache and resets the counters.
+The option @qcode{"capacity"} sets the maximum number of cached patterns;
+a capacity of 0 disables the cache.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 2)
+    print_usage ();
+
+  if (nargin == 0)
+    {
+      regexp::cache_statistics st = regexp::cache_stats ();
+
+      octave_scalar_map m;
+
+      m.assign ("hits", static_cast<double> (st.hits));
+      m.assign ("misses", static_cast<double> (st.misses));
+      m.assign ("evictions", static_cast<double> (st.evictions));
+      m.assign ("entries", static_cast<double> (st.entries));
+      m.assign ("capacity", static_cast<double> (st.capacity));
+
+      return ovl (m);
+    }
+
+  std::string opt = args(0).xstring_value ("__regexp_cache__: OPTION must be a string");
+
+  if (opt == "clear" && nargin == 1)
+    regexp::clear_cache ();
+  else if (opt == "capacity" && nargin == 2)
+    {
+      double n = args(1).xdouble_value ("__regexp_cache__: N must be a nonnegative integer");
+
+      if (math::x_nint (n) != n || n < 0)
+        error ("__regexp_cache__: N must be a nonnegative integer");
+
+      regexp::cache_capacity (static_cast<std::size_t> (n));
+    }
+  else
+    print_usage ();
+
+  return ovl ();
+}
+
+/*
+%!test
+%! old = __regexp_cache__ ();
+%! unwind_protect
+%!   __regexp_cache__ ("clear");
+%!   __regexp_cache__ ("capacity", 2);
+%!   for i = 1:5
+%!     regexp ("abc123", '\d+', "match");
+%!   endfor
+%!   st = __regexp_cache__ ();
+%!   assert (st.misses, 1);
+%!   assert (st.hits, 4);
+%!   assert (st.entries, 1);
+%!   ## Options that change compilation are part of the key
+%!   regexpi ("ABC123", '[a-c]+', "match");
+%!   regexp ("ABC123", '[a-c]+', "match");
+%!   st = __regexp_cache__ ();
+%!   assert (st.misses, 3);
+%!   assert (st.entries, 2);
+%!   assert (st.evictions, 1);
+%! unwind_protect_cleanup
+%!   __regexp_cache__ ("capacity", old.capacity);
+%! end_unwind_protect
+
+## Cached patterns give the same results, including named tokens
+%!test
+%! for i = 1:2
+%!   [tok, names] = regexp ("short test string", '(?<word1>\w*t)\s*(?<word2>\w*t)', "tokens", "names");
+%!   assert (tok, {{"short", "test"}});
+%!   assert (names.word1, "short");
+%!   assert (names.word2, "test");
+%! endfor
+
+%!error __regexp_cache__ ("capacity", -1)
+%!error __regexp_cache__ ("foo")
+*/
+
 OCTAVE_END_NAMESPACE(octave)
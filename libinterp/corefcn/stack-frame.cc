@@ -28,6 +28,9 @@
 #endif
 
 #include <iostream>
+#include <memory>
+#include <new>
+#include <vector>
 
 #include "lo-regexp.h"
 #include "str-vec.h"
@@ -79,6 +82,161 @@ static void display_scope (std::ostream& os, const symbol_scope& scope)
     }
 }
 
+// Storage for stack frames and for the arrays of variable values in
+// them.  Frames are created and destroyed in LIFO order by function
+// calls, so blocks that are freed are kept on per-thread free lists and
+// the most recently freed block of the right size is handed out again
+// for the next frame.  This avoids going through the general heap for
+// each call and tends to reuse memory that is still in the cache.
+//
+// Blocks are grouped in size classes that are powers of two.  Larger
+// requests are passed on to operator new.  Frames that are captured by
+// handles to nested or anonymous functions live as long as needed and
+// return their blocks when the last reference disappears.
+
+class frame_arena
+{
+public:
+
+  static const std::size_t MIN_SIZE = 64;
+
+  static const std::size_t NUM_SIZE_CLASSES = 7;
+
+  static const std::size_t MAX_SIZE = MIN_SIZE << (NUM_SIZE_CLASSES - 1);
+
+  // Limit on the number of free blocks kept for each size class.
+  static const std::size_t MAX_FREE_BLOCKS = 128;
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (frame_arena)
+
+  ~frame_arena () = delete;
+
+  static void * allocate (std::size_t size);
+
+  static void deallocate (void *p, std::size_t size) noexcept;
+
+private:
+
+  struct arena_block
+  {
+    arena_block *next;
+  };
+
+  // Trivially destructible so that frames that are destroyed late
+  // during exit may still be returned.
+
+  struct size_class_state
+  {
+    arena_block *free_list;
+    std::size_t free_blocks;
+  };
+
+  static thread_local size_class_state s_state[NUM_SIZE_CLASSES];
+
+  static std::size_t size_class (std::size_t size)
+  {
+    std::size_t idx = 0;
+
+    for (std::size_t block_size = MIN_SIZE; block_size < size;
+         block_size <<= 1)
+      idx++;
+
+    return idx;
+  }
+};
+
+thread_local frame_arena::size_class_state
+frame_arena::s_state[frame_arena::NUM_SIZE_CLASSES];
+
+void *
+frame_arena::allocate (std::size_t size)
+{
+  if (size == 0 || size > MAX_SIZE)
+    return ::operator new (size);
+
+  std::size_t idx = size_class (size);
+
+  size_class_state& st = s_state[idx];
+
+  arena_block *blk = st.free_list;
+
+  if (! blk)
+    return ::operator new (MIN_SIZE << idx);
+
+  st.free_list = blk->next;
+  st.free_blocks--;
+
+  return blk;
+}
+
+void
+frame_arena::deallocate (void *p, std::size_t size) noexcept
+{
+  if (! p)
+    return;
+
+  if (size == 0 || size > MAX_SIZE)
+    {
+      ::operator delete (p);
+      return;
+    }
+
+  size_class_state& st = s_state[size_class (size)];
+
+  if (st.free_blocks >= MAX_FREE_BLOCKS)
+    {
+      ::operator delete (p);
+      return;
+    }
+
+  arena_block *blk = static_cast<arena_block *> (p);
+
+  blk->next = st.free_list;
+  st.free_list = blk;
+  st.free_blocks++;
+}
+
+// Standard allocator interface for frame_arena, used for the frames
+// themselves (with std::allocate_shared, which places the reference
+// counts in the same block) and for the vectors they contain.
+
+template <typename T>
+class frame_allocator
+{
+public:
+
+  typedef T value_type;
+
+  frame_allocator () = default;
+
+  template <typename U>
+  frame_allocator (const frame_allocator<U>&) { }
+
+  T * allocate (std::size_t n)
+  {
+    return static_cast<T *> (frame_arena::allocate (n * sizeof (T)));
+  }
+
+  void deallocate (T *p, std::size_t n) noexcept
+  {
+    frame_arena::deallocate (p, n * sizeof (T));
+  }
+};
+
+template <typename T, typename U>
+bool
+operator == (const frame_allocator<T>&, const frame_allocator<U>&)
+{
+  return true;
+}
+
+template <typename T, typename U>
+bool
+operator != (const frame_allocator<T>&, const frame_allocator<U>&)
+{
+  return false;
+}
+
 class compiled_fcn_stack_frame;
 class script_stack_frame;
 class user_fcn_stack_frame;
@@ -451,7 +609,7 @@ protected:
   // Variable values.  This array is indexed by the data_offset
   // value stored in the symbol_record objects of the scope
   // associated with this stack frame.
-  std::vector<octave_value> m_values;
+  std::vector<octave_value, frame_allocator<octave_value>> m_values;
 
   // The type of each variable (local, global, persistent) of each
   // value.  This array is indexed by the data_offset value stored
@@ -460,12 +618,12 @@ protected:
   // Global values are stored in the tree_evaluator object that contains
   // the stack frame.  Persistent values are stored in the function
   // scope corresponding to the stack frame.
-  std::vector<scope_flags> m_flags;
+  std::vector<scope_flags, frame_allocator<scope_flags>> m_flags;
 
   // A fixed list of Automatic variables created for this function.
   // The elements of this vector correspond to the auto_var_type
   // enum.
-  std::vector<octave_value> m_auto_vars;
+  std::vector<octave_value, frame_allocator<octave_value>> m_auto_vars;
 };
 
 // User-defined functions have a symbol_scope object to store the set
@@ -1076,38 +1234,42 @@ private:
   std::set<std::string> m_found_names;
 };
 
-stack_frame *
+std::shared_ptr<stack_frame>
 stack_frame::create (tree_evaluator& tw, octave_function *fcn,
                      std::size_t index,
                      const std::shared_ptr<stack_frame>& parent_link,
                      const std::shared_ptr<stack_frame>& static_link)
 {
-  return new compiled_fcn_stack_frame (tw, fcn, index,
-                                       parent_link, static_link);
+  return std::allocate_shared<compiled_fcn_stack_frame>
+           (frame_allocator<compiled_fcn_stack_frame> (), tw, fcn, index,
+            parent_link, static_link);
 }
 
-stack_frame *
+std::shared_ptr<stack_frame>
 stack_frame::create (tree_evaluator& tw,
                      octave_user_script *script,
                      std::size_t index,
                      const std::shared_ptr<stack_frame>& parent_link,
                      const std::shared_ptr<stack_frame>& static_link)
 {
-  return new script_stack_frame (tw, script, index, parent_link, static_link);
+  return std::allocate_shared<script_stack_frame>
+           (frame_allocator<script_stack_frame> (), tw, script, index,
+            parent_link, static_link);
 }
 
-stack_frame *
+std::shared_ptr<stack_frame>
 stack_frame::create (tree_evaluator& tw,
                      octave_user_function *fcn, std::size_t index,
                      const std::shared_ptr<stack_frame>& parent_link,
                      const std::shared_ptr<stack_frame>& static_link,
                      const std::shared_ptr<stack_frame>& access_link)
 {
-  return new user_fcn_stack_frame (tw, fcn, index,
-                                   parent_link, static_link, access_link);
+  return std::allocate_shared<user_fcn_stack_frame>
+           (frame_allocator<user_fcn_stack_frame> (), tw, fcn, index,
+            parent_link, static_link, access_link);
 }
 
-stack_frame *
+std::shared_ptr<stack_frame>
 stack_frame::create (tree_evaluator& tw,
                      octave_user_function *fcn, std::size_t index,
                      const std::shared_ptr<stack_frame>& parent_link,
@@ -1115,18 +1277,20 @@ stack_frame::create (tree_evaluator& tw,
                      const local_vars_map& local_vars,
                      const std::shared_ptr<stack_frame>& access_link)
 {
-  return new user_fcn_stack_frame (tw, fcn, index,
-                                   parent_link, static_link, local_vars,
-                                   access_link);
+  return std::allocate_shared<user_fcn_stack_frame>
+           (frame_allocator<user_fcn_stack_frame> (), tw, fcn, index,
+            parent_link, static_link, local_vars, access_link);
 }
 
-stack_frame *
+std::shared_ptr<stack_frame>
 stack_frame::create (tree_evaluator& tw,
                      const symbol_scope& scope, std::size_t index,
                      const std::shared_ptr<stack_frame>& parent_link,
                      const std::shared_ptr<stack_frame>& static_link)
 {
-  return new scope_stack_frame (tw, scope, index, parent_link, static_link);
+  return std::allocate_shared<scope_stack_frame>
+           (frame_allocator<scope_stack_frame> (), tw, scope, index,
+            parent_link, static_link);
 }
 
 // This function is only implemented and should only be called for
@@ -2619,3 +2783,31 @@ scope_stack_frame::accept (stack_frame_walker& sfw)
 }
 
 OCTAVE_END_NAMESPACE(octave)
+
+/*
+## Frames are reused after they are popped, but frames that are captured
+## by handles must keep their values.
+
+%!function r = __fib__ (n)
+%!  if (n < 2)
+%!    r = n;
+%!  else
+%!    r = __fib__ (n-1) + __fib__ (n-2);
+%!  endif
+%!endfunction
+
+%!function h = __make_counter__ (k)
+%!  h = @() k + 1;
+%!endfunction
+
+%!test
+%! assert (__fib__ (15), 610);
+
+%!test
+%! h = cell (1, 10);
+%! for i = 1:10
+%!   h{i} = __make_counter__ (i);
+%! endfor
+%! assert (__fib__ (10), 55);
+%! assert (cellfun (@(f) f (), h), 2:11);
+*/
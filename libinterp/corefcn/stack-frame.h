@@ -150,26 +150,26 @@ public:
   { }
 
   // Compiled function.
-  static stack_frame *
+  static std::shared_ptr<stack_frame>
   create (tree_evaluator& tw, octave_function *fcn, std::size_t index,
           const std::shared_ptr<stack_frame>& parent_link,
           const std::shared_ptr<stack_frame>& static_link);
 
   // Script.
-  static stack_frame *
+  static std::shared_ptr<stack_frame>
   create (tree_evaluator& tw, octave_user_script *script, std::size_t index,
           const std::shared_ptr<stack_frame>& parent_link,
           const std::shared_ptr<stack_frame>& static_link);
 
   // User-defined function.
-  static stack_frame *
+  static std::shared_ptr<stack_frame>
   create (tree_evaluator& tw, octave_user_function *fcn, std::size_t index,
           const std::shared_ptr<stack_frame>& parent_link,
           const std::shared_ptr<stack_frame>& static_link,
           const std::shared_ptr<stack_frame>& access_link = std::shared_ptr<stack_frame> ());
 
   // Anonymous user-defined function with init vars.
-  static stack_frame *
+  static std::shared_ptr<stack_frame>
   create (tree_evaluator& tw, octave_user_function *fcn, std::size_t index,
           const std::shared_ptr<stack_frame>& parent_link,
           const std::shared_ptr<stack_frame>& static_link,
@@ -177,7 +177,7 @@ public:
           const std::shared_ptr<stack_frame>& access_link = std::shared_ptr<stack_frame> ());
 
   // Scope.
-  static stack_frame *
+  static std::shared_ptr<stack_frame>
   create (tree_evaluator& tw, const symbol_scope& scope, std::size_t index,
           const std::shared_ptr<stack_frame>& parent_link,
           const std::shared_ptr<stack_frame>& static_link);
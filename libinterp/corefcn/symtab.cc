@@ -36,6 +36,7 @@
 #include "bp-table.h"
 #include "defun.h"
 #include "fcn-info.h"
+#include "input.h"
 #include "interpreter-private.h"
 #include "interpreter.h"
 #include "load-path.h"
@@ -50,6 +51,8 @@
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+std::size_t symbol_table::s_lookup_generation = 0;
+
 symbol_table::symbol_table (interpreter& interp)
   : m_interpreter (interp), m_fcn_table (), m_class_precedence_table (),
     m_parent_map ()
@@ -339,6 +342,8 @@ void
 symbol_table::install_cmdline_function (const std::string& name,
                                         const octave_value& fcn)
 {
+  invalidate_lookup_caches ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -365,6 +370,8 @@ symbol_table::install_local_function (const std::string& name,
                                       const octave_value& fcn,
                                       const std::string& file_name)
 {
+  invalidate_lookup_caches ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -387,6 +394,8 @@ void
 symbol_table::install_user_function (const std::string& name,
                                      const octave_value& fcn)
 {
+  invalidate_lookup_caches ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -411,6 +420,8 @@ void
 symbol_table::install_built_in_function (const std::string& name,
     const octave_value& fcn)
 {
+  invalidate_lookup_caches ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -436,6 +447,8 @@ symbol_table::install_built_in_function (const std::string& name,
 void
 symbol_table::clear_functions (bool force)
 {
+  invalidate_lookup_caches ();
+
   auto p = m_fcn_table.begin ();
 
   while (p != m_fcn_table.end ())
@@ -451,6 +464,8 @@ symbol_table::clear_function (const std::string& name)
 void
 symbol_table::clear_function_pattern (const std::string& pat)
 {
+  invalidate_lookup_caches ();
+
   symbol_match pattern (pat);
 
   auto p = m_fcn_table.begin ();
@@ -467,6 +482,8 @@ symbol_table::clear_function_pattern (const std::string& pat)
 void
 symbol_table::clear_function_regexp (const std::string& pat)
 {
+  invalidate_lookup_caches ();
+
   regexp pattern (pat);
 
   auto p = m_fcn_table.begin ();
@@ -483,6 +500,8 @@ symbol_table::clear_function_regexp (const std::string& pat)
 void
 symbol_table::clear_user_function (const std::string& name)
 {
+  invalidate_lookup_caches ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -500,6 +519,8 @@ symbol_table::clear_user_function (const std::string& name)
 void
 symbol_table::clear_dld_function (const std::string& name)
 {
+  invalidate_lookup_caches ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -514,6 +535,8 @@ symbol_table::clear_dld_function (const std::string& name)
 void
 symbol_table::clear_mex_functions ()
 {
+  invalidate_lookup_caches ();
+
   auto p = m_fcn_table.begin ();
 
   while (p != m_fcn_table.end ())
@@ -528,6 +551,8 @@ bool
 symbol_table::set_class_relationship (const std::string& sup_class,
                                       const std::string& inf_class)
 {
+  invalidate_lookup_caches ();
+
   if (is_superiorto (inf_class, sup_class))
     return false;
 
@@ -569,6 +594,8 @@ void
 symbol_table::alias_built_in_function (const std::string& alias,
                                        const std::string& name)
 {
+  invalidate_lookup_caches ();
+
   octave_value fcn = find_built_in_function (name);
 
   if (fcn.is_defined ())
@@ -587,6 +614,8 @@ void
 symbol_table::install_built_in_dispatch (const std::string& name,
     const std::string& klass)
 {
+  invalidate_lookup_caches ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -690,6 +719,8 @@ void
 symbol_table::add_to_parent_map (const std::string& classname,
                                  const std::list<std::string>& parent_list)
 {
+  invalidate_lookup_caches ();
+
   m_parent_map[classname] = parent_list;
 }
 
@@ -721,6 +752,8 @@ symbol_table::parent_classes (const std::string& dispatch_type)
 void
 symbol_table::cleanup ()
 {
+  invalidate_lookup_caches ();
+
   clear_functions ();
 
   m_fcn_table.clear ();
@@ -735,6 +768,42 @@ symbol_table::get_fcn_info (const std::string& name)
   return p != m_fcn_table.end () ? &p->second : nullptr;
 }
 
+octave_value
+fcn_lookup_cache::find (symbol_table& symtab, const std::string& name,
+                        const octave_value_list& args)
+{
+  std::shared_ptr<symbol_scope_rep> scope
+    = symtab.current_scope ().get_rep ();
+
+  std::string dispatch_type = (args.empty () ? "" : get_dispatch_type (args));
+
+  if (m_fcn && m_generation == symbol_table::lookup_generation ()
+      && m_prompt_time == Vlast_prompt_time
+      && m_chdir_time == Vlast_chdir_time
+      && ! m_scope.owner_before (scope) && ! scope.owner_before (m_scope)
+      && m_dispatch_type == dispatch_type)
+    return octave_value (m_fcn, true);
+
+  m_fcn = nullptr;
+
+  octave_value fcn = symtab.find_function (name, args);
+
+  // If nothing else refers to the function, it would be deleted when
+  // FCN goes out of scope.
+
+  if (fcn.is_function () && fcn.get_count () > 1)
+    {
+      m_fcn = fcn.internal_rep ();
+      m_generation = symbol_table::lookup_generation ();
+      m_prompt_time = Vlast_prompt_time;
+      m_chdir_time = Vlast_chdir_time;
+      m_scope = scope;
+      m_dispatch_type = dispatch_type;
+    }
+
+  return fcn;
+}
+
 octave_value
 symbol_table::dump_fcn_table_map () const
 {
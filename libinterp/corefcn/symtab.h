@@ -31,12 +31,14 @@
 #include <deque>
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 
 #include "glob-match.h"
 #include "lo-regexp.h"
 #include "oct-refcount.h"
+#include "oct-time.h"
 
 class tree_argument_list;
 class octave_user_function;
@@ -181,10 +183,20 @@ public:
 
   fcn_info * get_fcn_info (const std::string& name);
 
+  // Incremented whenever the result of a function lookup may change,
+  // for example when functions are installed or cleared or when the
+  // load path changes.
+
+  static std::size_t lookup_generation () { return s_lookup_generation; }
+
+  static void invalidate_lookup_caches () { s_lookup_generation++; }
+
 private:
 
   interpreter& m_interpreter;
 
+  static std::size_t s_lookup_generation;
+
   typedef std::map<std::string, octave_value>::const_iterator
     global_symbols_const_iterator;
   typedef std::map<std::string, octave_value>::iterator
@@ -224,6 +236,50 @@ private:
   void install_builtins ();
 };
 
+// Cache for the result of a function lookup at a call site.  The
+// cached function is reused as long as the lookup generation of the
+// symbol table, the search scope, the dispatch type of the arguments,
+// and the times that trigger checks for out-of-date functions are the
+// same as for the previous lookup.
+//
+// Only a pointer to the function is kept.  This avoids reference
+// cycles between recursive functions and the call sites in their
+// bodies.  Functions that are not owned by the symbol table (or a
+// scope) are not cached.
+
+class OCTINTERP_API fcn_lookup_cache
+{
+public:
+
+  fcn_lookup_cache ()
+    : m_fcn (nullptr), m_generation (0), m_prompt_time (0.0),
+      m_chdir_time (0.0), m_scope (), m_dispatch_type ()
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (fcn_lookup_cache)
+
+  ~fcn_lookup_cache () = default;
+
+  octave_value find (symbol_table& symtab, const std::string& name,
+                     const octave_value_list& args = octave_value_list ());
+
+  void clear () { m_fcn = nullptr; }
+
+private:
+
+  octave_base_value *m_fcn;
+
+  std::size_t m_generation;
+
+  sys::time m_prompt_time;
+
+  sys::time m_chdir_time;
+
+  std::weak_ptr<symbol_scope_rep> m_scope;
+
+  std::string m_dispatch_type;
+};
+
 OCTAVE_END_NAMESPACE(octave)
 
 #endif
@@ -49,6 +49,7 @@ DEFUN_DLD (fftw, args, ,
 @deftypefnx {} {} fftw ("planner", @var{method})
 @deftypefnx {} {@var{wisdom} =} fftw ("dwisdom")
 @deftypefnx {} {} fftw ("dwisdom", @var{wisdom})
+@deftypefnx {} {} fftw ("savewisdom")
 @deftypefnx {} {@var{nthreads} =} fftw ("threads")
 @deftypefnx {} {} fftw ("threads", @var{nthreads})
 
@@ -122,10 +123,19 @@ or set by using
 fftw ("planner", @var{method})
 @end example
 
-Note that calculated wisdom will be lost when restarting Octave.  However,
-the wisdom data can be reloaded if it is saved to a file as described
-above.  Saved wisdom files should not be used on different platforms since
-they will not be efficient and the point of calculating the wisdom is lost.
+When one of the measuring methods has been used, the calculated wisdom is
+saved when Octave exits and read again when the @sc{fftw} libraries are
+initialized in a later session.  The wisdom is stored in the files
+@file{fftw-wisdom} (double precision) and @file{fftwf-wisdom} (single
+precision) in the @file{octave} subdirectory of the user data directory.
+The environment variables @w{@env{OCTAVE_FFTW_WISDOM_FILE}} and
+@w{@env{OCTAVE_FFTWF_WISDOM_FILE}} can be used to select different files.
+The wisdom can also be saved immediately with @code{fftw ("savewisdom")}.
+Wisdom files should not be used on different platforms since they will not be
+efficient and the point of calculating the wisdom is lost.
+
+Octave keeps the plans for the most recently used transforms, so alternating
+between transforms of a few different sizes does not require new plans.
 
 The number of threads used for computing the plans and executing the
 transforms can be set with
@@ -136,7 +146,9 @@ fftw ("threads", @var{NTHREADS})
 
 Note that Octave must be compiled with multi-threaded @sc{fftw} support for
 this feature.  By default, the number of (logical) processors available to the
-current process or @var{3} is used (whichever is smaller).
+current process or @var{3} is used (whichever is smaller).  Small transforms
+use fewer threads than that, since the overhead of starting threads is larger
+than the gain in that case.
 
 @seealso{fft, ifft, fft2, ifft2, fftn, ifftn}
 @end deftypefn */)
@@ -297,6 +309,14 @@ current process or @var{3} is used (whichever is smaller).
           retval = octave_value (wisdom_str);
         }
     }
+  else if (arg0 == "savewisdom")
+    {
+      if (nargin != 1)
+        print_usage ();
+
+      fftw_planner::save_wisdom ();
+      float_fftw_planner::save_wisdom ();
+    }
   else if (arg0 == "threads")
     {
       if (nargin == 2)  //threads setter
@@ -389,6 +409,116 @@ current process or @var{3} is used (whichever is smaller).
 %!   fftw ("threads", n);
 %! end_unwind_protect
 
+## Alternate between more transforms than the planner keeps plans for,
+## including in-place transforms (fft2) and single precision
+%!testif HAVE_FFTW
+%! F = @(n) exp (-2i*pi*(0:n-1)' * (0:n-1) / n);
+%! sizes = [8, 13, 64, 100, 7, 31, 128, 97, 20, 45, 16, 81, 3, 250, 60, ...
+%!          127, 11, 200];
+%! for k = 1:2
+%!   for n = sizes
+%!     x = rand (1, n);
+%!     z = complex (rand (1, n), rand (1, n));
+%!     A = rand (5, n);
+%!     tol = 1e-12 * n;
+%!     assert (fft (x), x * F(n), tol);
+%!     assert (fft (z.'), (z * F(n)).', tol);
+%!     assert (ifft (z * F(n)), z, tol);
+%!     assert (fft (A, [], 2), A * F(n), tol);
+%!     assert (fft2 (A), F(5) * A * F(n), tol);
+%!     assert (fft (single (z)), single (z * F(n)), single (1e-5 * n));
+%!   endfor
+%! endfor
+
+## Change the number of threads and the planner between transforms
+%!testif HAVE_FFTW3_THREADS
+%! old_threads = fftw ("threads");
+%! old_method = fftw ("planner");
+%! old_dfile = getenv ("OCTAVE_FFTW_WISDOM_FILE");
+%! old_sfile = getenv ("OCTAVE_FFTWF_WISDOM_FILE");
+%! dfile = tempname ();
+%! sfile = tempname ();
+%! unwind_protect
+%!   ## Keep the wisdom of this test out of the user's wisdom files.
+%!   setenv ("OCTAVE_FFTW_WISDOM_FILE", dfile);
+%!   setenv ("OCTAVE_FFTWF_WISDOM_FILE", sfile);
+%!   x = rand (1, 3*2^15);
+%!   z = complex (rand (2^16, 1), rand (2^16, 1));
+%!   fftw ("threads", 1);
+%!   fftw ("planner", "estimate");
+%!   y0 = fft (x);
+%!   yz0 = fft (z);
+%!   for nt = [2, 3, 1]
+%!     for method = {"measure", "estimate"}
+%!       fftw ("threads", nt);
+%!       fftw ("planner", method{1});
+%!       assert (fftw ("threads"), nt);
+%!       assert (fft (x), y0, 1e-9 * max (abs (y0)));
+%!       assert (fft (z), yz0, 1e-9 * max (abs (yz0)));
+%!       assert (ifft (yz0), z, 1e-12);
+%!     endfor
+%!   endfor
+%! unwind_protect_cleanup
+%!   fftw ("threads", old_threads);
+%!   fftw ("planner", old_method);
+%!   fftw ("savewisdom");
+%!   if (isempty (old_dfile))
+%!     unsetenv ("OCTAVE_FFTW_WISDOM_FILE");
+%!   else
+%!     setenv ("OCTAVE_FFTW_WISDOM_FILE", old_dfile);
+%!   endif
+%!   if (isempty (old_sfile))
+%!     unsetenv ("OCTAVE_FFTWF_WISDOM_FILE");
+%!   else
+%!     setenv ("OCTAVE_FFTWF_WISDOM_FILE", old_sfile);
+%!   endif
+%!   sts = unlink (dfile);
+%!   sts = unlink (sfile);
+%! end_unwind_protect
+
+## Round trip of wisdom through the files named by OCTAVE_FFTW_WISDOM_FILE
+## and OCTAVE_FFTWF_WISDOM_FILE
+%!testif HAVE_FFTW
+%! old_method = fftw ("planner");
+%! old_dwisdom = fftw ("dwisdom");
+%! old_dfile = getenv ("OCTAVE_FFTW_WISDOM_FILE");
+%! old_sfile = getenv ("OCTAVE_FFTWF_WISDOM_FILE");
+%! dfile = tempname ();
+%! sfile = tempname ();
+%! unwind_protect
+%!   setenv ("OCTAVE_FFTW_WISDOM_FILE", dfile);
+%!   setenv ("OCTAVE_FFTWF_WISDOM_FILE", sfile);
+%!   fftw ("dwisdom", "");
+%!   no_wisdom = fftw ("dwisdom");
+%!   fftw ("planner", "measure");
+%!   x = rand (1, 97);
+%!   y = fft (x);
+%!   fftw ("savewisdom");
+%!   assert (exist (dfile, "file"), 2);
+%!   assert (exist (sfile, "file"), 2);
+%!   wisdom = fileread (dfile);
+%!   assert (numel (wisdom) > numel (no_wisdom));
+%!   fftw ("dwisdom", "");
+%!   fftw ("dwisdom", wisdom);
+%!   assert (numel (fftw ("dwisdom")) > numel (no_wisdom));
+%!   assert (fft (x), y, 1e-10);
+%! unwind_protect_cleanup
+%!   fftw ("planner", old_method);
+%!   fftw ("dwisdom", old_dwisdom);
+%!   if (isempty (old_dfile))
+%!     unsetenv ("OCTAVE_FFTW_WISDOM_FILE");
+%!   else
+%!     setenv ("OCTAVE_FFTW_WISDOM_FILE", old_dfile);
+%!   endif
+%!   if (isempty (old_sfile))
+%!     unsetenv ("OCTAVE_FFTWF_WISDOM_FILE");
+%!   else
+%!     setenv ("OCTAVE_FFTWF_WISDOM_FILE", old_sfile);
+%!   endif
+%!   sts = unlink (dfile);
+%!   sts = unlink (sfile);
+%! end_unwind_protect
+
 %!error <Invalid call to fftw|was unavailable or disabled> fftw ()
 %!error <Invalid call to fftw|was unavailable or disabled> fftw ("planner", "estimate", "measure")
 %!error fftw (3)
@@ -399,6 +529,7 @@ current process or @var{3} is used (whichever is smaller).
 %!error fftw ("swisdom", "invalid")
 %!error fftw ("threads", "invalid")
 %!error fftw ("threads", -3)
+%!error <Invalid call to fftw|was unavailable or disabled> fftw ("savewisdom", 1)
  */
 
 OCTAVE_END_NAMESPACE(octave)
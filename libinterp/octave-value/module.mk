@@ -15,7 +15,8 @@ OV_SPARSE_INC = \
   %reldir%/ov-base-sparse.h \
   %reldir%/ov-bool-sparse.h \
   %reldir%/ov-cx-sparse.h \
-  %reldir%/ov-re-sparse.h
+  %reldir%/ov-re-sparse.h \
+  %reldir%/ov-sparse-asm.h
 
 OCTAVE_VALUE_INC = \
   %reldir%/cdef-class.h \
@@ -51,6 +52,7 @@ OCTAVE_VALUE_INC = \
   %reldir%/ov-flt-cx-mat.h \
   %reldir%/ov-flt-re-diag.h \
   %reldir%/ov-flt-re-mat.h \
+  %reldir%/ov-hash-map.h \
   %reldir%/ov-inline.h \
   %reldir%/ov-java.h \
   %reldir%/ov-lazy-idx.h \
@@ -87,7 +89,8 @@ OV_INTTYPE_SRC = \
 OV_SPARSE_SRC = \
   %reldir%/ov-bool-sparse.cc \
   %reldir%/ov-cx-sparse.cc \
-  %reldir%/ov-re-sparse.cc
+  %reldir%/ov-re-sparse.cc \
+  %reldir%/ov-sparse-asm.cc
 
 OCTAVE_VALUE_SRC = \
   %reldir%/cdef-class.cc \
@@ -119,6 +122,7 @@ OCTAVE_VALUE_SRC = \
   %reldir%/ov-flt-cx-mat.cc \
   %reldir%/ov-flt-re-diag.cc \
   %reldir%/ov-flt-re-mat.cc \
+  %reldir%/ov-hash-map.cc \
   %reldir%/ov-java.cc \
   %reldir%/ov-lazy-idx.cc \
   %reldir%/ov-legacy-range.cc \
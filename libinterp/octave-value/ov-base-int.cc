@@ -451,14 +451,14 @@ octave_base_int_matrix<T>::save_hdf5_internal (octave_hdf5_id loc_id,
   space_hid = H5Screate_simple (rank, hdims, nullptr);
 
   if (space_hid < 0) return false;
+  hid_t plist_hid = hdf5_dataset_create_plist (dv, save_type_hid);
 #if defined (HAVE_HDF5_18)
   data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid,
-                        octave_H5P_DEFAULT, octave_H5P_DEFAULT,
-                        octave_H5P_DEFAULT);
+                        octave_H5P_DEFAULT, plist_hid, octave_H5P_DEFAULT);
 #else
-  data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid,
-                        octave_H5P_DEFAULT);
+  data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid, plist_hid);
 #endif
+  H5Pclose (plist_hid);
   if (data_hid < 0)
     {
       H5Sclose (space_hid);
@@ -535,14 +535,25 @@ octave_base_int_matrix<T>::load_hdf5_internal (octave_hdf5_id loc_id,
         dv(j) = hdims[i];
     }
 
+  hid_t mem_space_id = hdf5_select_load_range (space_id, dv);
+
+  if (mem_space_id < 0)
+    {
+      H5Sclose (space_id);
+      H5Dclose (data_hid);
+      return false;
+    }
+
   T m (dv);
-  if (H5Dread (data_hid, save_type_hid, octave_H5S_ALL, octave_H5S_ALL,
+  if (H5Dread (data_hid, save_type_hid, mem_space_id, space_id,
                octave_H5P_DEFAULT, m.rwdata ()) >= 0)
     {
       retval = true;
       this->m_matrix = m;
     }
 
+  if (mem_space_id != octave_H5S_ALL)
+    H5Sclose (mem_space_id);
   H5Sclose (space_id);
   H5Dclose (data_hid);
 
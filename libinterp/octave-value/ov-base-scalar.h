@@ -35,6 +35,7 @@
 
 #include "lo-mappers.h"
 #include "lo-utils.h"
+#include "oct-alloc.h"
 #include "str-vec.h"
 #include "MatrixType.h"
 
@@ -61,6 +62,10 @@ public:
 
   ~octave_base_scalar () = default;
 
+  // Scalar values are created for nearly every operation, so allocate
+  // them from a pool instead of the general heap.
+  OCTAVE_SMALL_OBJECT_ALLOCATOR
+
   octave_value squeeze () const { return scalar; }
 
   octave_value full_value () const { return scalar; }
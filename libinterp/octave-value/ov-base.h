@@ -365,6 +365,14 @@ public:
                   const std::list<octave_value_list>& idx,
                   const octave_value& rhs);
 
+  // Add RHS to (or subtract it from, if NEGATE is true) the elements
+  // selected by TYPE and IDX in place for A(IDX) += RHS and
+  // A(IDX) -= RHS.  Return false if the general code must be used.
+  virtual bool
+  subsasgn_add (const std::string&, const std::list<octave_value_list>&,
+                const octave_value&, bool)
+  { return false; }
+
   virtual octave::idx_vector index_vector (bool require_integers = false) const;
 
   virtual dim_vector dims () const { return dim_vector (); }
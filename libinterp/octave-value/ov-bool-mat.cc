@@ -447,14 +447,14 @@ octave_bool_matrix::save_hdf5 (octave_hdf5_id loc_id, const char *name,
 
   space_hid = H5Screate_simple (rank, hdims, nullptr);
   if (space_hid < 0) return false;
+  hid_t plist_hid = hdf5_dataset_create_plist (dv, H5T_NATIVE_HBOOL);
 #if defined (HAVE_HDF5_18)
   data_hid = H5Dcreate (loc_id, name, H5T_NATIVE_HBOOL, space_hid,
-                        octave_H5P_DEFAULT, octave_H5P_DEFAULT,
-                        octave_H5P_DEFAULT);
+                        octave_H5P_DEFAULT, plist_hid, octave_H5P_DEFAULT);
 #else
-  data_hid = H5Dcreate (loc_id, name, H5T_NATIVE_HBOOL, space_hid,
-                        octave_H5P_DEFAULT);
+  data_hid = H5Dcreate (loc_id, name, H5T_NATIVE_HBOOL, space_hid, plist_hid);
 #endif
+  H5Pclose (plist_hid);
   if (data_hid < 0)
     {
       H5Sclose (space_hid);
@@ -528,9 +528,18 @@ octave_bool_matrix::load_hdf5 (octave_hdf5_id loc_id, const char *name)
         dv(j) = hdims[i];
     }
 
+  hid_t mem_space_id = hdf5_select_load_range (space_id, dv);
+
+  if (mem_space_id < 0)
+    {
+      H5Sclose (space_id);
+      H5Dclose (data_hid);
+      return false;
+    }
+
   octave_idx_type nel = dv.numel ();
   OCTAVE_LOCAL_BUFFER (hbool_t, htmp, nel);
-  if (H5Dread (data_hid, H5T_NATIVE_HBOOL, octave_H5S_ALL, octave_H5S_ALL,
+  if (H5Dread (data_hid, H5T_NATIVE_HBOOL, mem_space_id, space_id,
                octave_H5P_DEFAULT, htmp)
       >= 0)
     {
@@ -543,6 +552,8 @@ octave_bool_matrix::load_hdf5 (octave_hdf5_id loc_id, const char *name)
       m_matrix = btmp;
     }
 
+  if (mem_space_id != octave_H5S_ALL)
+    H5Sclose (mem_space_id);
   H5Dclose (data_hid);
 
 #else
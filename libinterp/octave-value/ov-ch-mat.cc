@@ -27,6 +27,7 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <cctype>
 #include <ostream>
 
@@ -232,8 +233,7 @@ octave_char_matrix::as_mxArray (bool interleaved) const
 
   const char *pdata = m_matrix.data ();
 
-  for (mwIndex i = 0; i < nel; i++)
-    pd[i] = pdata[i];
+  std::copy (pdata, pdata + nel, pd);
 
   return retval;
 }
@@ -550,13 +550,14 @@ octave_float_complex_matrix::save_hdf5 (octave_hdf5_id loc_id, const char *name,
       H5Sclose (space_hid);
       return false;
     }
+  hid_t plist_hid = hdf5_dataset_create_plist (dv, type_hid);
 #if defined (HAVE_HDF5_18)
   data_hid = H5Dcreate (loc_id, name, type_hid, space_hid,
-                        octave_H5P_DEFAULT, octave_H5P_DEFAULT,
-                        octave_H5P_DEFAULT);
+                        octave_H5P_DEFAULT, plist_hid, octave_H5P_DEFAULT);
 #else
-  data_hid = H5Dcreate (loc_id, name, type_hid, space_hid, octave_H5P_DEFAULT);
+  data_hid = H5Dcreate (loc_id, name, type_hid, space_hid, plist_hid);
 #endif
+  H5Pclose (plist_hid);
   if (data_hid < 0)
     {
       H5Sclose (space_hid);
@@ -655,9 +656,19 @@ octave_float_complex_matrix::load_hdf5 (octave_hdf5_id loc_id, const char *name)
         dv(j) = hdims[i];
     }
 
+  hid_t mem_space_id = hdf5_select_load_range (space_id, dv);
+
+  if (mem_space_id < 0)
+    {
+      H5Tclose (complex_type);
+      H5Sclose (space_id);
+      H5Dclose (data_hid);
+      return false;
+    }
+
   FloatComplexNDArray m (dv);
   FloatComplex *reim = m.rwdata ();
-  if (H5Dread (data_hid, complex_type, octave_H5S_ALL, octave_H5S_ALL,
+  if (H5Dread (data_hid, complex_type, mem_space_id, space_id,
                octave_H5P_DEFAULT, reim)
       >= 0)
     {
@@ -666,6 +677,8 @@ octave_float_complex_matrix::load_hdf5 (octave_hdf5_id loc_id, const char *name)
     }
 
   H5Tclose (complex_type);
+  if (mem_space_id != octave_H5S_ALL)
+    H5Sclose (mem_space_id);
   H5Sclose (space_id);
   H5Dclose (data_hid);
 
@@ -27,6 +27,7 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <clocale>
 #include <istream>
 #include <limits>
@@ -617,14 +618,14 @@ octave_float_matrix::save_hdf5 (octave_hdf5_id loc_id, const char *name, bool)
           = save_type_to_hdf5 (octave::get_save_type (max_val, min_val));
     }
 #endif
+  hid_t plist_hid = hdf5_dataset_create_plist (dv, save_type_hid);
 #if defined (HAVE_HDF5_18)
   data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid,
-                        octave_H5P_DEFAULT, octave_H5P_DEFAULT,
-                        octave_H5P_DEFAULT);
+                        octave_H5P_DEFAULT, plist_hid, octave_H5P_DEFAULT);
 #else
-  data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid,
-                        octave_H5P_DEFAULT);
+  data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid, plist_hid);
 #endif
+  H5Pclose (plist_hid);
   if (data_hid < 0)
     {
       H5Sclose (space_hid);
@@ -697,15 +698,26 @@ octave_float_matrix::load_hdf5 (octave_hdf5_id loc_id, const char *name)
         dv(j) = hdims[i];
     }
 
+  hid_t mem_space_id = hdf5_select_load_range (space_id, dv);
+
+  if (mem_space_id < 0)
+    {
+      H5Sclose (space_id);
+      H5Dclose (data_hid);
+      return false;
+    }
+
   FloatNDArray m (dv);
   float *re = m.rwdata ();
-  if (H5Dread (data_hid, H5T_NATIVE_FLOAT, octave_H5S_ALL, octave_H5S_ALL,
+  if (H5Dread (data_hid, H5T_NATIVE_FLOAT, mem_space_id, space_id,
                octave_H5P_DEFAULT, re) >= 0)
     {
       retval = true;
       m_matrix = m;
     }
 
+  if (mem_space_id != octave_H5S_ALL)
+    H5Sclose (mem_space_id);
   H5Sclose (space_id);
   H5Dclose (data_hid);
 
@@ -738,8 +750,7 @@ octave_float_matrix::as_mxArray (bool interleaved) const
 
   const float *pdata = m_matrix.data ();
 
-  for (mwIndex i = 0; i < nel; i++)
-    pd[i] = pdata[i];
+  std::copy (pdata, pdata + nel, pd);
 
   return retval;
 }
@@ -0,0 +1,829 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <ostream>
+
+#include "boolNDArray.h"
+#include "dNDArray.h"
+#include "fNDArray.h"
+#include "int32NDArray.h"
+#include "int64NDArray.h"
+#include "lo-ieee.h"
+#include "uint32NDArray.h"
+#include "uint64NDArray.h"
+
+#include "Cell.h"
+#include "defun.h"
+#include "error.h"
+#include "ov-hash-map.h"
+#include "ovl.h"
+
+DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_hash_map, "hash map", "hash map");
+
+std::size_t
+octave_hash_map::byte_size () const
+{
+  std::size_t retval = (m_entries.capacity () * sizeof (entry)
+                        + m_slots.capacity () * sizeof (octave_idx_type));
+
+  for (const auto& e : m_entries)
+    {
+      if (e.live)
+        retval += e.key.str.size () + e.value.byte_size ();
+    }
+
+  return retval;
+}
+
+static uint64_t
+float_key_bits (double d)
+{
+  uint64_t bits;
+
+  if (d == 0)
+    d = 0;
+  else if (std::isnan (d))
+    d = octave::numeric_limits<double>::NaN ();
+
+  std::memcpy (&bits, &d, sizeof (bits));
+
+  return bits;
+}
+
+static double
+float_key_value (uint64_t bits)
+{
+  double d;
+
+  std::memcpy (&d, &bits, sizeof (d));
+
+  return d;
+}
+
+void
+octave_hash_map::convert_numeric_keys (const octave_value& arg,
+                                       std::vector<key_type>& keys) const
+{
+  octave_idx_type n = arg.numel ();
+
+  std::size_t k = keys.size ();
+  keys.resize (k + n);
+
+  switch (m_key_class)
+    {
+    case DOUBLE_KEYS:
+      {
+        NDArray a = arg.array_value ();
+        for (octave_idx_type i = 0; i < n; i++)
+          keys[k+i].num = float_key_bits (a(i));
+      }
+      break;
+
+    case SINGLE_KEYS:
+      {
+        FloatNDArray a = arg.float_array_value ();
+        for (octave_idx_type i = 0; i < n; i++)
+          keys[k+i].num = float_key_bits (a(i));
+      }
+      break;
+
+    case INT32_KEYS:
+      {
+        int32NDArray a = arg.int32_array_value ();
+        for (octave_idx_type i = 0; i < n; i++)
+          keys[k+i].num = static_cast<int64_t> (a(i).value ());
+      }
+      break;
+
+    case UINT32_KEYS:
+      {
+        uint32NDArray a = arg.uint32_array_value ();
+        for (octave_idx_type i = 0; i < n; i++)
+          keys[k+i].num = a(i).value ();
+      }
+      break;
+
+    case INT64_KEYS:
+      {
+        int64NDArray a = arg.int64_array_value ();
+        for (octave_idx_type i = 0; i < n; i++)
+          keys[k+i].num = a(i).value ();
+      }
+      break;
+
+    case UINT64_KEYS:
+      {
+        uint64NDArray a = arg.uint64_array_value ();
+        for (octave_idx_type i = 0; i < n; i++)
+          keys[k+i].num = a(i).value ();
+      }
+      break;
+
+    default:
+      error ("containers.Map: internal error: invalid key class");
+    }
+}
+
+bool
+octave_hash_map::convert_key (const octave_value& val, key_type& key) const
+{
+  if (m_key_class == CHAR_KEYS)
+    {
+      if (! val.is_string () || val.rows () > 1)
+        return false;
+
+      key.str = val.string_value ();
+    }
+  else
+    {
+      if (! (val.isnumeric () || val.islogical ()) || ! val.isreal ()
+          || val.numel () != 1)
+        return false;
+
+      std::vector<key_type> tmp;
+      convert_numeric_keys (val, tmp);
+      key.num = tmp[0].num;
+    }
+
+  return true;
+}
+
+dim_vector
+octave_hash_map::convert_keys (const octave_value& arg,
+                               std::vector<key_type>& keys,
+                               std::vector<bool>& valid) const
+{
+  dim_vector dv (1, 1);
+
+  keys.clear ();
+  valid.clear ();
+
+  if (arg.iscell ())
+    {
+      Cell c = arg.cell_value ();
+
+      dv = c.dims ();
+
+      octave_idx_type n = c.numel ();
+
+      keys.resize (n);
+      valid.resize (n);
+
+      for (octave_idx_type i = 0; i < n; i++)
+        valid[i] = convert_key (c(i), keys[i]);
+    }
+  else if (m_key_class == CHAR_KEYS)
+    {
+      if (arg.is_string ())
+        {
+          keys.resize (1);
+          valid.push_back (convert_key (arg, keys[0]));
+        }
+      else
+        {
+          dv = arg.dims ();
+          keys.resize (dv.numel ());
+          valid.resize (dv.numel (), false);
+        }
+    }
+  else if ((arg.isnumeric () || arg.islogical ()) && arg.isreal ())
+    {
+      dv = arg.dims ();
+      convert_numeric_keys (arg, keys);
+      valid.resize (keys.size (), true);
+    }
+  else
+    {
+      keys.resize (1);
+      valid.push_back (false);
+    }
+
+  return dv;
+}
+
+std::size_t
+octave_hash_map::hash (const key_type& key) const
+{
+  if (m_key_class == CHAR_KEYS)
+    return std::hash<std::string> () (key.str);
+
+  // Finalizer of the SplitMix64 generator.  Integer keys are often
+  // consecutive and the bits of floating point keys mostly differ in
+  // the high bits, so the bits need to be mixed before they are used as
+  // an index.
+  uint64_t h = key.num;
+  h = (h ^ (h >> 30)) * UINT64_C (0xbf58476d1ce4e5b9);
+  h = (h ^ (h >> 27)) * UINT64_C (0x94d049bb133111eb);
+  h = h ^ (h >> 31);
+
+  return static_cast<std::size_t> (h);
+}
+
+bool
+octave_hash_map::key_less (const key_type& a, const key_type& b) const
+{
+  switch (m_key_class)
+    {
+    case CHAR_KEYS:
+      return a.str < b.str;
+
+    case DOUBLE_KEYS:
+    case SINGLE_KEYS:
+      {
+        // NaN is sorted last, as by sort.
+        double x = float_key_value (a.num);
+        double y = float_key_value (b.num);
+        return x < y || (std::isnan (y) && ! std::isnan (x));
+      }
+
+    case INT32_KEYS:
+    case INT64_KEYS:
+      return static_cast<int64_t> (a.num) < static_cast<int64_t> (b.num);
+
+    default:
+      return a.num < b.num;
+    }
+}
+
+octave_idx_type
+octave_hash_map::find_slot (const key_type& key) const
+{
+  if (m_slots.empty ())
+    return -1;
+
+  std::size_t mask = m_slots.size () - 1;
+  std::size_t i = hash (key) & mask;
+
+  bool char_keys = (m_key_class == CHAR_KEYS);
+
+  for (;;)
+    {
+      octave_idx_type k = m_slots[i];
+
+      if (k == EMPTY_SLOT)
+        return -1;
+
+      if (k >= 0)
+        {
+          const key_type& ek = m_entries[k].key;
+
+          if (char_keys ? ek.str == key.str : ek.num == key.num)
+            return i;
+        }
+
+      i = (i + 1) & mask;
+    }
+}
+
+void
+octave_hash_map::rehash (std::size_t nslots)
+{
+  // Drop the deleted entries.
+  if (static_cast<octave_idx_type> (m_entries.size ()) != m_count)
+    {
+      m_entries.erase (std::remove_if (m_entries.begin (), m_entries.end (),
+                                       [] (const entry& e)
+                                       { return ! e.live; }),
+                       m_entries.end ());
+    }
+
+  m_slots.assign (nslots, static_cast<octave_idx_type> (EMPTY_SLOT));
+
+  std::size_t mask = nslots - 1;
+
+  for (std::size_t k = 0; k < m_entries.size (); k++)
+    {
+      std::size_t i = hash (m_entries[k].key) & mask;
+
+      while (m_slots[i] != EMPTY_SLOT)
+        i = (i + 1) & mask;
+
+      m_slots[i] = k;
+    }
+
+  m_used = m_count;
+  m_sorted_ok = false;
+}
+
+void
+octave_hash_map::reserve (octave_idx_type n)
+{
+  // Keep the table at most half full, counting deleted slots.
+  std::size_t nslots = m_slots.size ();
+
+  if (2 * static_cast<std::size_t> (m_used + n) <= nslots)
+    return;
+
+  std::size_t need = 2 * static_cast<std::size_t> (m_count + n);
+
+  nslots = 16;
+  while (nslots < need)
+    nslots *= 2;
+
+  rehash (nslots);
+}
+
+void
+octave_hash_map::insert (const key_type& key, const octave_value& val)
+{
+  std::size_t mask = m_slots.size () - 1;
+  std::size_t i = hash (key) & mask;
+
+  bool char_keys = (m_key_class == CHAR_KEYS);
+
+  octave_idx_type free_slot = -1;
+
+  for (;;)
+    {
+      octave_idx_type k = m_slots[i];
+
+      if (k == EMPTY_SLOT)
+        break;
+
+      if (k == DELETED_SLOT)
+        {
+          if (free_slot < 0)
+            free_slot = i;
+        }
+      else
+        {
+          entry& e = m_entries[k];
+
+          if (char_keys ? e.key.str == key.str : e.key.num == key.num)
+            {
+              e.value = val;
+              return;
+            }
+        }
+
+      i = (i + 1) & mask;
+    }
+
+  if (free_slot < 0)
+    {
+      free_slot = i;
+      m_used++;
+    }
+
+  m_slots[free_slot] = m_entries.size ();
+  m_entries.push_back ({key, val, true});
+
+  m_count++;
+  m_sorted_ok = false;
+}
+
+void
+octave_hash_map::erase (const key_type& key)
+{
+  octave_idx_type i = find_slot (key);
+
+  if (i < 0)
+    return;
+
+  entry& e = m_entries[m_slots[i]];
+
+  e.live = false;
+  e.key.str = std::string ();
+  e.value = octave_value ();
+
+  m_slots[i] = DELETED_SLOT;
+
+  m_count--;
+  m_sorted_ok = false;
+
+  // Reclaim the space of the deleted entries once they are the majority.
+  if (m_entries.size () > 2 * static_cast<std::size_t> (m_count) + 16)
+    rehash (m_slots.size ());
+}
+
+void
+octave_hash_map::assign (const octave_value& arg, const Cell& vals)
+{
+  std::vector<key_type> keys;
+  std::vector<bool> valid;
+
+  convert_keys (arg, keys, valid);
+
+  octave_idx_type n = keys.size ();
+
+  if (vals.numel () != n)
+    error ("containers.Map: the number of keys and values must match");
+
+  for (octave_idx_type i = 0; i < n; i++)
+    {
+      if (! valid[i])
+        error ("containers.Map: specified key type does not match the type of this container");
+    }
+
+  reserve (n);
+
+  for (octave_idx_type i = 0; i < n; i++)
+    insert (keys[i], vals(i));
+}
+
+Cell
+octave_hash_map::lookup (const octave_value& arg,
+                         octave_idx_type& missing) const
+{
+  std::vector<key_type> keys;
+  std::vector<bool> valid;
+
+  dim_vector dv = convert_keys (arg, keys, valid);
+
+  Cell retval (dv);
+
+  missing = -1;
+
+  octave_idx_type n = keys.size ();
+
+  for (octave_idx_type i = 0; i < n; i++)
+    {
+      octave_idx_type slot = (valid[i] ? find_slot (keys[i]) : -1);
+
+      if (slot < 0)
+        {
+          missing = i;
+          break;
+        }
+
+      retval(i) = m_entries[m_slots[slot]].value;
+    }
+
+  return retval;
+}
+
+boolNDArray
+octave_hash_map::contains (const octave_value& arg) const
+{
+  std::vector<key_type> keys;
+  std::vector<bool> valid;
+
+  dim_vector dv = convert_keys (arg, keys, valid);
+
+  boolNDArray retval (dv, false);
+
+  octave_idx_type n = keys.size ();
+
+  for (octave_idx_type i = 0; i < n; i++)
+    retval(i) = valid[i] && find_slot (keys[i]) >= 0;
+
+  return retval;
+}
+
+void
+octave_hash_map::remove (const octave_value& arg)
+{
+  std::vector<key_type> keys;
+  std::vector<bool> valid;
+
+  convert_keys (arg, keys, valid);
+
+  octave_idx_type n = keys.size ();
+
+  for (octave_idx_type i = 0; i < n; i++)
+    {
+      if (valid[i])
+        erase (keys[i]);
+    }
+}
+
+void
+octave_hash_map::make_sorted () const
+{
+  if (m_sorted_ok)
+    return;
+
+  m_sorted.clear ();
+  m_sorted.reserve (m_count);
+
+  for (std::size_t k = 0; k < m_entries.size (); k++)
+    {
+      if (m_entries[k].live)
+        m_sorted.push_back (k);
+    }
+
+  std::sort (m_sorted.begin (), m_sorted.end (),
+             [this] (octave_idx_type a, octave_idx_type b)
+             { return key_less (m_entries[a].key, m_entries[b].key); });
+
+  m_sorted_ok = true;
+}
+
+Cell
+octave_hash_map::sorted_keys () const
+{
+  make_sorted ();
+
+  Cell retval (1, m_count);
+
+  for (octave_idx_type i = 0; i < m_count; i++)
+    {
+      const key_type& key = m_entries[m_sorted[i]].key;
+
+      switch (m_key_class)
+        {
+        case CHAR_KEYS:
+          retval(i) = key.str;
+          break;
+
+        case DOUBLE_KEYS:
+          retval(i) = float_key_value (key.num);
+          break;
+
+        case SINGLE_KEYS:
+          retval(i) = static_cast<float> (float_key_value (key.num));
+          break;
+
+        case INT32_KEYS:
+          retval(i) = octave_int32 (static_cast<int64_t> (key.num));
+          break;
+
+        case UINT32_KEYS:
+          retval(i) = octave_uint32 (key.num);
+          break;
+
+        case INT64_KEYS:
+          retval(i) = octave_int64 (static_cast<int64_t> (key.num));
+          break;
+
+        case UINT64_KEYS:
+          retval(i) = octave_uint64 (key.num);
+          break;
+        }
+    }
+
+  return retval;
+}
+
+Cell
+octave_hash_map::sorted_values () const
+{
+  make_sorted ();
+
+  Cell retval (1, m_count);
+
+  for (octave_idx_type i = 0; i < m_count; i++)
+    retval(i) = m_entries[m_sorted[i]].value;
+
+  return retval;
+}
+
+void
+octave_hash_map::print (std::ostream& os, bool pr_as_read_syntax)
+{
+  print_raw (os, pr_as_read_syntax);
+  newline (os);
+}
+
+void
+octave_hash_map::print_raw (std::ostream& os, bool) const
+{
+  os << "<hash map with " << m_count << " entries>";
+}
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+static octave_hash_map&
+get_hash_map (const octave_value& val, const char *who)
+{
+  const octave_base_value& rep = val.get_rep ();
+
+  octave_base_value *ncrep = const_cast<octave_base_value *> (&rep);
+
+  octave_hash_map *map = dynamic_cast<octave_hash_map *> (ncrep);
+  if (! map)
+    error ("%s: argument must be a hash map", who);
+
+  return *map;
+}
+
+DEFUN (__containers_map_new__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{h} =} __containers_map_new__ (@var{keytype})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  std::string kt
+    = args(0).xstring_value ("__containers_map_new__: KEYTYPE must be a string");
+
+  octave_hash_map::key_class kc;
+
+  if (kt == "char")
+    kc = octave_hash_map::CHAR_KEYS;
+  else if (kt == "double")
+    kc = octave_hash_map::DOUBLE_KEYS;
+  else if (kt == "single")
+    kc = octave_hash_map::SINGLE_KEYS;
+  else if (kt == "int32")
+    kc = octave_hash_map::INT32_KEYS;
+  else if (kt == "uint32")
+    kc = octave_hash_map::UINT32_KEYS;
+  else if (kt == "int64")
+    kc = octave_hash_map::INT64_KEYS;
+  else if (kt == "uint64")
+    kc = octave_hash_map::UINT64_KEYS;
+  else
+    error ("__containers_map_new__: unsupported key type '%s'", kt.c_str ());
+
+  return ovl (octave_value (new octave_hash_map (kc)));
+}
+
+DEFUN (__containers_map_set__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} __containers_map_set__ (@var{h}, @var{keys}, @var{vals})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 3)
+    print_usage ();
+
+  octave_hash_map& map = get_hash_map (args(0), "__containers_map_set__");
+
+  Cell vals
+    = args(2).xcell_value ("__containers_map_set__: VALS must be a cell array");
+
+  map.assign (args(1), vals);
+
+  return ovl ();
+}
+
+DEFUN (__containers_map_get__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{vals}, @var{missing}] =} __containers_map_get__ (@var{h}, @var{keys})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 2)
+    print_usage ();
+
+  const octave_hash_map& map
+    = get_hash_map (args(0), "__containers_map_get__");
+
+  octave_idx_type missing;
+
+  Cell vals = map.lookup (args(1), missing);
+
+  return ovl (vals, static_cast<double> (missing + 1));
+}
+
+DEFUN (__containers_map_iskey__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{tf} =} __containers_map_iskey__ (@var{h}, @var{keys})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 2)
+    print_usage ();
+
+  const octave_hash_map& map
+    = get_hash_map (args(0), "__containers_map_iskey__");
+
+  return ovl (map.contains (args(1)));
+}
+
+DEFUN (__containers_map_remove__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} __containers_map_remove__ (@var{h}, @var{keys})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 2)
+    print_usage ();
+
+  octave_hash_map& map = get_hash_map (args(0), "__containers_map_remove__");
+
+  map.remove (args(1));
+
+  return ovl ();
+}
+
+DEFUN (__containers_map_keys__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{keys} =} __containers_map_keys__ (@var{h})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  const octave_hash_map& map
+    = get_hash_map (args(0), "__containers_map_keys__");
+
+  return ovl (map.sorted_keys ());
+}
+
+DEFUN (__containers_map_values__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{vals} =} __containers_map_values__ (@var{h})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  const octave_hash_map& map
+    = get_hash_map (args(0), "__containers_map_values__");
+
+  return ovl (map.sorted_values ());
+}
+
+DEFUN (__containers_map_count__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{n} =} __containers_map_count__ (@var{h})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  const octave_hash_map& map
+    = get_hash_map (args(0), "__containers_map_count__");
+
+  return ovl (static_cast<double> (map.count ()));
+}
+
+/*
+%!test
+%! h = __containers_map_new__ ("char");
+%! __containers_map_set__ (h, {"b", "a", "c"}, {2, 1, 3});
+%! assert (__containers_map_count__ (h), 3);
+%! assert (__containers_map_keys__ (h), {"a", "b", "c"});
+%! assert (__containers_map_values__ (h), {1, 2, 3});
+%! __containers_map_set__ (h, "a", {10});
+%! [v, missing] = __containers_map_get__ (h, {"a"; "c"});
+%! assert (v, {10; 3});
+%! assert (missing, 0);
+%! [~, missing] = __containers_map_get__ (h, {"a", "z", "c"});
+%! assert (missing, 2);
+%! assert (__containers_map_iskey__ (h, {"a", "z"; 1, "b"}),
+%!         [true, false; false, true]);
+%! __containers_map_remove__ (h, {"b", "z"});
+%! assert (__containers_map_keys__ (h), {"a", "c"});
+
+## Copies refer to the same table
+%!test
+%! h = __containers_map_new__ ("double");
+%! g = h;
+%! __containers_map_set__ (g, [3, -1, NaN, 2], {"c", "a", "n", "b"});
+%! assert (__containers_map_keys__ (h), {-1, 2, 3, NaN});
+%! assert (__containers_map_iskey__ (h, [2, 5; -0, NaN]),
+%!         [true, false; false, true]);
+
+%!test
+%! h = __containers_map_new__ ("int64");
+%! k = intmax ("int64") - int64 ([0, 1, 2]);
+%! __containers_map_set__ (h, k, {1, 2, 3});
+%! assert (__containers_map_keys__ (h), num2cell (fliplr (k)));
+%! assert (__containers_map_iskey__ (h, {double(k(1)), k(2)}), [true, true]);
+
+## Growing and shrinking the table
+%!test
+%! h = __containers_map_new__ ("uint32");
+%! __containers_map_set__ (h, 1:1000, num2cell (1:1000));
+%! __containers_map_remove__ (h, 1:2:1000);
+%! assert (__containers_map_count__ (h), 500);
+%! __containers_map_set__ (h, 1:3:1000, num2cell (-(1:3:1000)));
+%! k = cell2mat (__containers_map_keys__ (h));
+%! assert (k, unique (uint32 ([2:2:1000, 1:3:1000])));
+%! v = __containers_map_get__ (h, {uint32(4), uint32(7)});
+%! assert (v, {-4, -7});
+
+%!error <unsupported key type> __containers_map_new__ ("cell")
+%!error <does not match>
+%! __containers_map_set__ (__containers_map_new__ ("char"), {1}, {1});
+*/
+
+OCTAVE_END_NAMESPACE(octave)
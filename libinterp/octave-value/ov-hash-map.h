@@ -0,0 +1,191 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_ov_hash_map_h)
+#define octave_ov_hash_map_h 1
+
+#include "octave-config.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "ov-base.h"
+#include "ov.h"
+
+// Hash table that stores the keys and values of containers.Map
+// objects.  The keys are either character strings or numeric scalars of
+// a single class.  The table uses open addressing with linear probing.
+// Entries are kept in the order in which they were inserted and the
+// table only stores their indices.  The list of keys in sorted order is
+// built when it is first needed after a modification.
+//
+// containers.Map is a handle class, so all copies of a value of this
+// type refer to the same table and the __containers_map_*__ functions
+// modify it in place.
+
+class OCTINTERP_API octave_hash_map : public octave_base_value
+{
+public:
+
+  enum key_class
+  {
+    CHAR_KEYS,
+    DOUBLE_KEYS,
+    SINGLE_KEYS,
+    INT32_KEYS,
+    UINT32_KEYS,
+    INT64_KEYS,
+    UINT64_KEYS
+  };
+
+  octave_hash_map ()
+    : octave_base_value (), m_key_class (CHAR_KEYS), m_entries (),
+      m_slots (), m_count (0), m_used (0), m_sorted (), m_sorted_ok (false)
+  { }
+
+  octave_hash_map (key_class kc)
+    : octave_base_value (), m_key_class (kc), m_entries (), m_slots (),
+      m_count (0), m_used (0), m_sorted (), m_sorted_ok (false)
+  { }
+
+  octave_hash_map (const octave_hash_map&) = default;
+
+  ~octave_hash_map () = default;
+
+  octave_base_value * clone () const { return new octave_hash_map (*this); }
+  octave_base_value * empty_clone () const
+  { return new octave_hash_map (m_key_class); }
+
+  bool is_defined () const { return true; }
+
+  bool is_constant () const { return true; }
+
+  dim_vector dims () const
+  {
+    static dim_vector dv (1, 1);
+    return dv;
+  }
+
+  std::size_t byte_size () const;
+
+  key_class get_key_class () const { return m_key_class; }
+
+  octave_idx_type count () const { return m_count; }
+
+  // Store the values VALS, a cell array, under the keys KEYS.
+  void assign (const octave_value& keys, const Cell& vals);
+
+  // Return the values for KEYS.  If a key is not found, set MISSING to
+  // its (zero-based) index and stop.  Otherwise MISSING is -1.
+  Cell lookup (const octave_value& keys, octave_idx_type& missing) const;
+
+  boolNDArray contains (const octave_value& keys) const;
+
+  void remove (const octave_value& keys);
+
+  // The keys and values in the order of the keys.
+  Cell sorted_keys () const;
+
+  Cell sorted_values () const;
+
+  void print (std::ostream& os, bool pr_as_read_syntax = false);
+
+  void print_raw (std::ostream& os, bool pr_as_read_syntax = false) const;
+
+private:
+
+  // Numeric keys are stored as 64-bit patterns: the bits of the double
+  // value for floating point keys (with -0 replaced by 0 and a single
+  // NaN) and the two's complement value for integer keys.
+
+  struct key_type
+  {
+    std::string str;
+    uint64_t num;
+  };
+
+  struct entry
+  {
+    key_type key;
+    octave_value value;
+    bool live;
+  };
+
+  static const octave_idx_type EMPTY_SLOT = -1;
+  static const octave_idx_type DELETED_SLOT = -2;
+
+  // Convert the keys in ARG to KEYS.  VALID is false for keys that can
+  // not be keys of this map.  Return the dimensions of the array of
+  // keys.
+  dim_vector convert_keys (const octave_value& arg,
+                           std::vector<key_type>& keys,
+                           std::vector<bool>& valid) const;
+
+  bool convert_key (const octave_value& val, key_type& key) const;
+
+  void convert_numeric_keys (const octave_value& arg,
+                             std::vector<key_type>& keys) const;
+
+  std::size_t hash (const key_type& key) const;
+
+  bool key_less (const key_type& a, const key_type& b) const;
+
+  // Return the slot that holds KEY or, if there is none, -1.
+  octave_idx_type find_slot (const key_type& key) const;
+
+  void insert (const key_type& key, const octave_value& val);
+
+  void erase (const key_type& key);
+
+  // Make room for N more entries.
+  void reserve (octave_idx_type n);
+
+  void rehash (std::size_t nslots);
+
+  void make_sorted () const;
+
+  key_class m_key_class;
+
+  std::vector<entry> m_entries;
+
+  std::vector<octave_idx_type> m_slots;
+
+  // Number of live entries.
+  octave_idx_type m_count;
+
+  // Number of slots that are not empty, including deleted ones.
+  octave_idx_type m_used;
+
+  // Indices of the live entries in the order of their keys.
+  mutable std::vector<octave_idx_type> m_sorted;
+
+  mutable bool m_sorted_ok;
+
+  DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
+};
+
+#endif
@@ -0,0 +1,456 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+
+#include "idx-vector.h"
+#include "lo-array-errwarn.h"
+
+#include "defun.h"
+#include "error.h"
+#include "ls-oct-binary.h"
+#include "ls-oct-text.h"
+#include "ov-sparse-asm.h"
+#include "ovl.h"
+
+DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_sparse_assembly,
+                                     "sparse assembly", "double");
+
+octave_sparse_assembly::octave_sparse_assembly (octave_idx_type nr,
+                                                octave_idx_type nc,
+                                                octave_idx_type nz)
+  : octave_base_value (), m_rows (nr), m_cols (nc), m_ridx (), m_cidx (),
+    m_data (), m_value ()
+{
+  if (nz > 0)
+    {
+      m_ridx.reserve (nz);
+      m_cidx.reserve (nz);
+      m_data.reserve (nz);
+    }
+}
+
+static octave_base_value *
+default_numeric_conversion_function (const octave_base_value& a)
+{
+  const octave_sparse_assembly& v
+    = dynamic_cast<const octave_sparse_assembly&> (a);
+
+  return new octave_sparse_matrix (v.sparse_matrix_value ());
+}
+
+octave_base_value::type_conv_info
+octave_sparse_assembly::numeric_conversion_function () const
+{
+  return octave_base_value::type_conv_info
+           (default_numeric_conversion_function,
+            octave_sparse_matrix::static_type_id ());
+}
+
+std::size_t
+octave_sparse_assembly::byte_size () const
+{
+  if (m_value.is_defined ())
+    return m_value.byte_size ();
+
+  return (m_data.size () * (2 * sizeof (octave_idx_type) + sizeof (double)));
+}
+
+const octave_value&
+octave_sparse_assembly::make_value () const
+{
+  if (m_value.is_undefined ())
+    {
+      octave_idx_type n = m_data.size ();
+
+      if (n == 0)
+        m_value = SparseMatrix (m_rows, m_cols);
+      else
+        {
+          Array<double> vals (dim_vector (n, 1));
+          Array<octave_idx_type> ri (dim_vector (n, 1));
+          Array<octave_idx_type> ci (dim_vector (n, 1));
+
+          std::copy (m_data.begin (), m_data.end (), vals.fortran_vec ());
+          std::copy (m_ridx.begin (), m_ridx.end (), ri.fortran_vec ());
+          std::copy (m_cidx.begin (), m_cidx.end (), ci.fortran_vec ());
+
+          // Repeated elements are summed and zeros are removed, just
+          // like sparse (I, J, V) does.
+          m_value = SparseMatrix (vals, octave::idx_vector (ri),
+                                  octave::idx_vector (ci), m_rows, m_cols);
+        }
+
+      std::vector<octave_idx_type> ().swap (m_ridx);
+      std::vector<octave_idx_type> ().swap (m_cidx);
+      std::vector<double> ().swap (m_data);
+    }
+
+  return m_value;
+}
+
+void
+octave_sparse_assembly::make_triplets ()
+{
+  if (m_value.is_undefined ())
+    return;
+
+  SparseMatrix sm = m_value.sparse_matrix_value ();
+
+  m_value = octave_value ();
+
+  octave_idx_type nz = sm.nnz ();
+
+  m_ridx.reserve (2 * nz);
+  m_cidx.reserve (2 * nz);
+  m_data.reserve (2 * nz);
+
+  for (octave_idx_type j = 0; j < m_cols; j++)
+    {
+      for (octave_idx_type k = sm.cidx (j); k < sm.cidx (j+1); k++)
+        {
+          m_ridx.push_back (sm.ridx (k));
+          m_cidx.push_back (j);
+          m_data.push_back (sm.data (k));
+        }
+    }
+}
+
+// True if IDX selects some element more than once.  The elements of
+// A(I,J) += X would then be incremented only once by the general code.
+
+static bool
+has_repeated_elements (const octave::idx_vector& idx, octave_idx_type ext)
+{
+  octave_idx_type len = idx.length (ext);
+
+  if (len <= 1 || idx.is_colon ()
+      || (idx.is_range () && idx.increment () != 0))
+    return false;
+
+  return idx.sorted (true).length (ext) != len;
+}
+
+bool
+octave_sparse_assembly::subsasgn_add (const std::string& type,
+                                      const std::list<octave_value_list>& idx,
+                                      const octave_value& rhs, bool negate)
+{
+  if (type != "(" || idx.size () != 1 || idx.front ().length () != 2)
+    return false;
+
+  if (! (rhs.isnumeric () && rhs.is_double_type ())
+      || rhs.iscomplex () || rhs.issparse () || rhs.ndims () != 2)
+    return false;
+
+  const octave_value_list& args = idx.front ();
+
+  octave::idx_vector i, j;
+
+  try
+    {
+      i = args(0).index_vector ();
+      j = args(1).index_vector ();
+    }
+  catch (const octave::index_exception&)
+    {
+      // Let the general code report the error.
+      return false;
+    }
+
+  if (i.extent (m_rows) > m_rows || j.extent (m_cols) > m_cols)
+    return false;
+
+  octave_idx_type ni = i.length (m_rows);
+  octave_idx_type nj = j.length (m_cols);
+
+  if (ni == 0 || nj == 0)
+    return false;
+
+  bool scalar_rhs = (rhs.numel () == 1);
+
+  if (! scalar_rhs && (rhs.rows () != ni || rhs.columns () != nj))
+    return false;
+
+  if (has_repeated_elements (i, m_rows) || has_repeated_elements (j, m_cols))
+    return false;
+
+  make_triplets ();
+
+  if (scalar_rhs)
+    {
+      double val = rhs.double_value ();
+
+      if (val != 0)
+        {
+          if (negate)
+            val = -val;
+
+          for (octave_idx_type jj = 0; jj < nj; jj++)
+            for (octave_idx_type ii = 0; ii < ni; ii++)
+              {
+                m_ridx.push_back (i.xelem (ii));
+                m_cidx.push_back (j.xelem (jj));
+                m_data.push_back (val);
+              }
+        }
+    }
+  else
+    {
+      const NDArray vals = rhs.array_value ();
+      const double *pv = vals.data ();
+
+      for (octave_idx_type jj = 0; jj < nj; jj++)
+        for (octave_idx_type ii = 0; ii < ni; ii++)
+          {
+            double val = *pv++;
+
+            if (val != 0)
+              {
+                m_ridx.push_back (i.xelem (ii));
+                m_cidx.push_back (j.xelem (jj));
+                m_data.push_back (negate ? -val : val);
+              }
+          }
+    }
+
+  return true;
+}
+
+static const std::string value_save_tag ("assembly_value");
+
+bool
+octave_sparse_assembly::save_ascii (std::ostream& os)
+{
+  return save_text_data (os, make_value (), value_save_tag, false, 0);
+}
+
+bool
+octave_sparse_assembly::load_ascii (std::istream& is)
+{
+  bool dummy;
+
+  std::string nm = read_text_data (is, "", dummy, m_value, 0);
+
+  load_value (nm);
+
+  return true;
+}
+
+bool
+octave_sparse_assembly::save_binary (std::ostream& os, bool save_as_floats)
+{
+  return save_binary_data (os, make_value (), value_save_tag,
+                           "", false, save_as_floats);
+}
+
+bool
+octave_sparse_assembly::load_binary (std::istream& is, bool swap,
+                                     octave::mach_info::float_format fmt)
+{
+  bool dummy;
+  std::string doc;
+
+  std::string nm = read_binary_data (is, swap, fmt, "", dummy, m_value, doc);
+
+  load_value (nm);
+
+  return true;
+}
+
+void
+octave_sparse_assembly::load_value (const std::string& nm)
+{
+  if (nm != value_save_tag || ! m_value.issparse ()
+      || m_value.iscomplex () || m_value.ndims () != 2)
+    error ("sparse assembly: corrupted data on load");
+
+  m_value = m_value.sparse_matrix_value ();
+
+  m_rows = m_value.rows ();
+  m_cols = m_value.columns ();
+
+  m_ridx.clear ();
+  m_cidx.clear ();
+  m_data.clear ();
+}
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+DEFUN (spassemble, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{S} =} spassemble (@var{m}, @var{n})
+@deftypefnx {} {@var{S} =} spassemble (@var{m}, @var{n}, @var{nz})
+Create an @var{m}-by-@var{n} sparse matrix of zeros that is built efficiently
+by indexed additions.
+
+Assignments of the forms
+
+@example
+@group
+@var{S}(@var{i}, @var{j}) += @var{x}
+@var{S}(@var{i}, @var{j}) -= @var{x}
+@end group
+@end example
+
+@noindent
+only record the new values, which takes constant time per value.  The same
+assignments to an ordinary sparse matrix have to move the existing elements
+of the matrix to make room for new ones, so a loop that assembles a matrix
+one element or one block at a time is quadratic in the number of nonzero
+elements.  The indices @var{i} and @var{j} must be within the bounds of
+@var{S} and must not contain repeated values, and @var{x} must be a real
+double scalar or a matrix of size
+@code{numel (@var{i})}-by-@code{numel (@var{j})}.  Other assignments are done
+in the usual way.
+
+In all other respects @var{S} behaves like a sparse double matrix.  The first
+operation that needs the value of @var{S} converts the recorded values to an
+ordinary sparse matrix, summing the values that were added to the same
+element, just like @code{sparse (@var{i}, @var{j}, @var{v})} does.
+Interleaving additions with other operations is possible, but each
+conversion takes time proportional to the number of nonzero elements.
+Assignments other than the ones above turn @var{S} into an ordinary sparse
+matrix.
+
+The optional argument @var{nz} is the expected number of added values.  It
+is used to pre-allocate memory.
+
+For example, the stiffness matrix of a finite element model can be
+assembled with
+
+@example
+@group
+K = spassemble (nnodes, nnodes);
+for e = 1:nelems
+  k = elems(e,:);
+  K(k,k) += element_stiffness (e);
+endfor
+@end group
+@end example
+
+@seealso{sparse, spalloc, accumarray}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 2 || nargin > 3)
+    print_usage ();
+
+  octave_idx_type m = args(0).idx_type_value ();
+  octave_idx_type n = args(1).idx_type_value ();
+
+  octave_idx_type nz = 0;
+  if (nargin == 3)
+    nz = args(2).idx_type_value ();
+
+  if (m < 0 || n < 0 || nz < 0)
+    error ("spassemble: M, N, and NZ must be non-negative");
+
+  return ovl (octave_value (new octave_sparse_assembly (m, n, nz)));
+}
+
+/*
+%!test
+%! S = spassemble (3, 4);
+%! assert (typeinfo (S), "sparse assembly");
+%! assert (class (S), "double");
+%! assert (issparse (S));
+%! assert (size (S), [3, 4]);
+%! assert (nnz (S), 0);
+%! assert (S, sparse (3, 4));
+
+%!test
+%! i = [1, 2, 3, 1, 2, 3, 1];
+%! j = [1, 2, 3, 1, 4, 4, 1];
+%! v = [1, 2, 3, 4, 5, 6, 7];
+%! S = spassemble (3, 4, numel (v));
+%! for k = 1:numel (v)
+%!   S(i(k),j(k)) += v(k);
+%! endfor
+%! assert (typeinfo (S), "sparse assembly");
+%! assert (S, sparse (i, j, v, 3, 4));
+
+## Assembly of a 1-D Laplacian, compared with an ordinary sparse matrix
+%!test
+%! n = 10;
+%! S = spassemble (n, n);
+%! T = sparse (n, n);
+%! for e = 1:n-1
+%!   k = [e, e+1];
+%!   S(k,k) += [1, -1; -1, 1];
+%!   T(k,k) += [1, -1; -1, 1];
+%! endfor
+%! S(1,:) -= 1;
+%! T(1,:) -= 1;
+%! assert (typeinfo (S), "sparse assembly");
+%! assert (S, T);
+%! assert (nnz (S), nnz (T));
+
+## Cancellation and additions after a conversion
+%!test
+%! S = spassemble (2, 2);
+%! S(1,1) += 5;
+%! S(1,1) -= 5;
+%! S(2,:) += [1, 2];
+%! assert (nnz (S), 2);
+%! assert (full (S), [0, 0; 1, 2]);
+%! S(1,2) += 3;
+%! S(2,1) -= 1;
+%! assert (typeinfo (S), "sparse assembly");
+%! assert (nnz (S), 2);
+%! assert (full (S), [0, 3; 0, 2]);
+
+## Repeated indices and other assignments use the general code
+%!test
+%! S = spassemble (2, 2);
+%! S([1, 1],1) += [1; 2];
+%! assert (full (S), [2, 0; 0, 0]);
+%! S = spassemble (2, 2);
+%! S(2,2) = 4;
+%! assert (typeinfo (S), "sparse matrix");
+%! assert (S, sparse (2, 2, 4));
+
+%!test
+%! S = spassemble (2, 2);
+%! S(1,2) += 1;
+%! T = S;
+%! T(1,2) += 1;
+%! assert (full (S), [0, 1; 0, 0]);
+%! assert (full (T), [0, 2; 0, 0]);
+%! assert (full (S * [1; 1]), [1; 0]);
+
+%!error <out of bound> S = spassemble (2, 2); S(3,1) += 1;
+%!error spassemble ()
+%!error spassemble (1)
+%!error spassemble (1, 2, 3, 4)
+%!error <M, N, and NZ must be non-negative> spassemble (-1, 1)
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,283 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_ov_sparse_asm_h)
+#define octave_ov_sparse_asm_h 1
+
+#include "octave-config.h"
+
+#include <vector>
+
+#include "ov-re-sparse.h"
+
+// Real sparse matrices that are being assembled by indexed assignments
+// of the form A(I,J) += X and A(I,J) -= X.  These assignments append
+// (row, column, value) triplets in amortized constant time.  The
+// triplets are converted to compressed column form, summing repeated
+// entries like sparse (I, J, V), as soon as any other operation needs
+// the value of the matrix.
+
+class OCTINTERP_API octave_sparse_assembly : public octave_base_value
+{
+public:
+
+  octave_sparse_assembly ()
+    : octave_base_value (), m_rows (0), m_cols (0), m_ridx (), m_cidx (),
+      m_data (), m_value () { }
+
+  octave_sparse_assembly (octave_idx_type nr, octave_idx_type nc,
+                          octave_idx_type nz = 0);
+
+  octave_sparse_assembly (const octave_sparse_assembly& a)
+    : octave_base_value (), m_rows (a.m_rows), m_cols (a.m_cols),
+      m_ridx (a.m_ridx), m_cidx (a.m_cidx), m_data (a.m_data),
+      m_value (a.m_value) { }
+
+  ~octave_sparse_assembly () = default;
+
+  octave_base_value * clone () const
+  { return new octave_sparse_assembly (*this); }
+  octave_base_value * empty_clone () const
+  { return new octave_sparse_matrix (); }
+
+  type_conv_info numeric_conversion_function () const;
+
+  std::size_t byte_size () const;
+
+  octave_value full_value () const { return make_value ().full_value (); }
+
+  builtin_type_t builtin_type () const { return btyp_double; }
+
+  bool is_real_matrix () const { return true; }
+
+  bool isreal () const { return true; }
+
+  bool is_double_type () const { return true; }
+
+  bool isfloat () const { return true; }
+
+  // We don't need to override all three forms of subsref.  The using
+  // declaration will avoid warnings about partially-overloaded virtual
+  // functions.
+  using octave_base_value::subsref;
+
+  octave_value subsref (const std::string& type,
+                        const std::list<octave_value_list>& idx)
+  { return make_value ().subsref (type, idx); }
+
+  octave_value_list subsref (const std::string& type,
+                             const std::list<octave_value_list>& idx, int)
+  { return subsref (type, idx); }
+
+  octave_value do_index_op (const octave_value_list& idx,
+                            bool resize_ok = false)
+  { return make_value ().index_op (idx, resize_ok); }
+
+  bool subsasgn_add (const std::string& type,
+                     const std::list<octave_value_list>& idx,
+                     const octave_value& rhs, bool negate);
+
+  dim_vector dims () const { return dim_vector (m_rows, m_cols); }
+
+  octave_idx_type nnz () const { return make_value ().nnz (); }
+
+  octave_idx_type nzmax () const { return make_value ().nzmax (); }
+
+  octave_value reshape (const dim_vector& new_dims) const
+  { return make_value ().reshape (new_dims); }
+
+  octave_value permute (const Array<int>& vec, bool inv = false) const
+  { return make_value ().permute (vec, inv); }
+
+  octave_value resize (const dim_vector& dv, bool fill = false) const
+  { return make_value ().resize (dv, fill); }
+
+  octave_value squeeze () const { return make_value ().squeeze (); }
+
+  octave_value all (int dim = 0) const { return make_value ().all (dim); }
+  octave_value any (int dim = 0) const { return make_value ().any (dim); }
+
+  MatrixType matrix_type () const { return make_value ().matrix_type (); }
+  MatrixType matrix_type (const MatrixType& _typ) const
+  { return make_value ().matrix_type (_typ); }
+
+  octave_value sort (octave_idx_type dim = 0, sortmode mode = ASCENDING) const
+  { return make_value ().sort (dim, mode); }
+
+  octave_value sort (Array<octave_idx_type>& sidx, octave_idx_type dim = 0,
+                     sortmode mode = ASCENDING) const
+  { return make_value ().sort (sidx, dim, mode); }
+
+  sortmode issorted (sortmode mode = UNSORTED) const
+  { return make_value ().issorted (mode); }
+
+  Array<octave_idx_type> sort_rows_idx (sortmode mode = ASCENDING) const
+  { return make_value ().sort_rows_idx (mode); }
+
+  sortmode is_sorted_rows (sortmode mode = UNSORTED) const
+  { return make_value ().is_sorted_rows (mode); }
+
+  bool is_matrix_type () const { return true; }
+
+  bool isnumeric () const { return true; }
+
+  bool issparse () const { return true; }
+
+  bool is_defined () const { return true; }
+
+  bool is_constant () const { return true; }
+
+  bool is_true () const
+  { return make_value ().is_true (); }
+
+  bool print_as_scalar () const
+  { return make_value ().print_as_scalar (); }
+
+  void print (std::ostream& os, bool pr_as_read_syntax = false)
+  { make_value ().print (os, pr_as_read_syntax); }
+
+  void print_info (std::ostream& os, const std::string& prefix) const
+  { make_value ().print_info (os, prefix); }
+
+  void short_disp (std::ostream& os) const
+  { make_value ().short_disp (os); }
+
+#define FORWARD_VALUE_QUERY1(TYPE, NAME)        \
+  TYPE NAME (bool flag = false) const           \
+  {                                             \
+    return make_value ().NAME (flag);           \
+  }
+
+  FORWARD_VALUE_QUERY1 (double, double_value)
+  FORWARD_VALUE_QUERY1 (double, scalar_value)
+  FORWARD_VALUE_QUERY1 (Matrix, matrix_value)
+  FORWARD_VALUE_QUERY1 (Complex, complex_value)
+  FORWARD_VALUE_QUERY1 (ComplexMatrix, complex_matrix_value)
+  FORWARD_VALUE_QUERY1 (ComplexNDArray, complex_array_value)
+  FORWARD_VALUE_QUERY1 (boolNDArray, bool_array_value)
+  FORWARD_VALUE_QUERY1 (charNDArray, char_array_value)
+  FORWARD_VALUE_QUERY1 (NDArray, array_value)
+  FORWARD_VALUE_QUERY1 (SparseMatrix, sparse_matrix_value)
+  FORWARD_VALUE_QUERY1 (SparseComplexMatrix, sparse_complex_matrix_value)
+  FORWARD_VALUE_QUERY1 (SparseBoolMatrix, sparse_bool_matrix_value)
+
+#undef FORWARD_VALUE_QUERY1
+
+  // We don't need to override both forms of the diag method.  The using
+  // declaration will avoid warnings about partially-overloaded virtual
+  // functions.
+  using octave_base_value::diag;
+
+  octave_value diag (octave_idx_type k = 0) const
+  {
+    return make_value ().diag (k);
+  }
+
+  octave_value convert_to_str_internal (bool pad, bool force, char type) const
+  {
+    return make_value ().convert_to_str_internal (pad, force, type);
+  }
+
+  octave_value as_double () const { return make_value (); }
+
+  void print_raw (std::ostream& os, bool pr_as_read_syntax = false) const
+  {
+    return make_value ().print_raw (os, pr_as_read_syntax);
+  }
+
+  bool save_ascii (std::ostream& os);
+
+  bool load_ascii (std::istream& is);
+
+  bool save_binary (std::ostream& os, bool save_as_floats);
+
+  bool load_binary (std::istream& is, bool swap,
+                    octave::mach_info::float_format fmt);
+
+  int write (octave::stream& os, int block_size,
+             oct_data_conv::data_type output_type, int skip,
+             octave::mach_info::float_format flt_fmt) const
+  {
+    return make_value ().write (os, block_size, output_type, skip, flt_fmt);
+  }
+
+  // This function exists to support the MEX interface.
+  // You should not use it anywhere else.
+  const void * mex_get_data () const
+  {
+    return make_value ().mex_get_data ();
+  }
+
+  const octave_idx_type * mex_get_ir () const
+  {
+    return make_value ().mex_get_ir ();
+  }
+
+  const octave_idx_type * mex_get_jc () const
+  {
+    return make_value ().mex_get_jc ();
+  }
+
+  mxArray * as_mxArray (bool interleaved) const
+  {
+    return make_value ().as_mxArray (interleaved);
+  }
+
+  octave_value map (unary_mapper_t umap) const
+  {
+    return make_value ().map (umap);
+  }
+
+private:
+
+  // Convert the triplets to a sparse matrix.  The triplets are
+  // released once the conversion is done.
+  const octave_value& make_value () const;
+
+  octave_value& make_value ()
+  {
+    static_cast<const octave_sparse_assembly *> (this)->make_value ();
+
+    return m_value;
+  }
+
+  // Convert the sparse matrix back to triplets before appending.
+  void make_triplets ();
+
+  void load_value (const std::string& nm);
+
+  octave_idx_type m_rows;
+  octave_idx_type m_cols;
+
+  mutable std::vector<octave_idx_type> m_ridx;
+  mutable std::vector<octave_idx_type> m_cidx;
+  mutable std::vector<double> m_data;
+
+  mutable octave_value m_value;
+
+  DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
+};
+
+#endif
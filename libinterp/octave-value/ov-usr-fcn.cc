@@ -221,7 +221,8 @@ octave_user_function::octave_user_function
     m_num_named_args (m_param_list ? m_param_list->size () : 0),
     m_subfunction (false), m_inline_function (false),
     m_anonymous_function (false), m_nested_function (false),
-    m_class_constructor (none), m_class_method (none)
+    m_class_constructor (none), m_class_method (none),
+    m_vm_opt_in (false), m_bytecode ()
 {
   if (m_cmd_list)
     m_cmd_list->mark_as_function_body ();
@@ -28,6 +28,7 @@
 
 #include "octave-config.h"
 
+#include <memory>
 #include <string>
 
 #include "comment-list.h"
@@ -43,6 +44,7 @@ class octave_value;
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+class bytecode;
 class file_info;
 class stack_frame;
 class tree_parameter_list;
@@ -365,6 +367,29 @@ public:
             ? (cname.empty () ? true : cname == dispatch_class ()) : false);
   }
 
+  // Execute the body of this function with the bytecode VM even if
+  // the VM is not enabled globally.
+
+  void mark_for_vm (bool flag = true)
+  {
+    m_vm_opt_in = flag;
+
+    if (! flag)
+      m_bytecode.reset ();
+  }
+
+  bool is_marked_for_vm () const { return m_vm_opt_in; }
+
+  std::shared_ptr<octave::bytecode> get_bytecode () const
+  {
+    return m_bytecode;
+  }
+
+  void stash_bytecode (const std::shared_ptr<octave::bytecode>& code)
+  {
+    m_bytecode = code;
+  }
+
   // We must overload the call method so that we call the proper
   // push_stack_frame method, which is overloaded for pointers to
   // octave_function, octave_user_function, and octave_user_script
@@ -453,6 +478,13 @@ private:
   // Enum describing whether this function is a method for a class.
   class_method_type m_class_method;
 
+  // TRUE means the body of this function is executed with the
+  // bytecode VM.
+  bool m_vm_opt_in;
+
+  // Compiled body of this function, if any.
+  std::shared_ptr<octave::bytecode> m_bytecode;
+
   void maybe_relocate_end_internal ();
 
   void print_code_function_header (const std::string& prefix);
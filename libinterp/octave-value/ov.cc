@@ -32,6 +32,7 @@
 #include <type_traits>
 
 #include "data-conv.h"
+#include "oct-alloc.h"
 #include "quit.h"
 #include "str-vec.h"
 
@@ -73,6 +74,7 @@
 #include "ov-struct.h"
 #include "ov-class.h"
 #include "ov-classdef.h"
+#include "ov-hash-map.h"
 #include "ov-oncleanup.h"
 #include "ov-cs-list.h"
 #include "ov-colon.h"
@@ -84,6 +86,7 @@
 #include "ov-magic-int.h"
 #include "ov-null-mat.h"
 #include "ov-lazy-idx.h"
+#include "ov-sparse-asm.h"
 #include "ov-java.h"
 
 #include "defun.h"
@@ -1560,6 +1563,10 @@ octave_value::assign (assign_op op, const std::string& type,
       if (! is_defined ())
         error ("in computed assignment A(index) OP= X, A must be defined first");
 
+      if ((op == op_add_eq || op == op_sub_eq)
+          && m_rep->subsasgn_add (type, idx, rhs, op == op_sub_eq))
+        return *this;
+
       octave_value t = subsref (type, idx);
 
       binary_op binop = op_eq_to_binary_op (op);
@@ -3584,7 +3591,9 @@ install_types (octave::type_info& ti)
   octave_null_str::register_type (ti);
   octave_null_sq_str::register_type (ti);
   octave_lazy_index::register_type (ti);
+  octave_sparse_assembly::register_type (ti);
   octave_oncleanup::register_type (ti);
+  octave_hash_map::register_type (ti);
   octave_java::register_type (ti);
   octave_trivial_range::register_type (ti);
 }
@@ -4015,4 +4024,79 @@ setting is restored when exiting the function.
 %!assert (typeinfo (__test_dr__ (false)), "matrix")
 */
 
+DEFUN (__small_object_pool_stats__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{stats} =} __small_object_pool_stats__ ()
+@deftypefnx {} {} __small_object_pool_stats__ ("reset")
+Undocumented internal function.
+
+Return a struct array with the counters of the pool allocator that is used
+for scalar values, one element for each size class.  With the argument
+@qcode{"reset"}, reset the allocation and deallocation counters.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  if (nargin == 1)
+    {
+      std::string opt = args(0).xstring_value ("__small_object_pool_stats__: argument must be a string");
+
+      if (opt != "reset")
+        error (R"(__small_object_pool_stats__: argument must be "reset")");
+
+      small_object_pool::reset_stats ();
+
+      return ovl ();
+    }
+
+  octave_idx_type n = small_object_pool::NUM_SIZE_CLASSES;
+
+  Cell block_size (n, 1);
+  Cell allocations (n, 1);
+  Cell deallocations (n, 1);
+  Cell chunks (n, 1);
+  Cell free_blocks (n, 1);
+
+  for (octave_idx_type k = 0; k < n; k++)
+    {
+      small_object_pool::statistics st = small_object_pool::stats (k);
+
+      block_size(k) = static_cast<double> (st.block_size);
+      allocations(k) = static_cast<double> (st.allocations);
+      deallocations(k) = static_cast<double> (st.deallocations);
+      chunks(k) = static_cast<double> (st.chunks);
+      free_blocks(k) = static_cast<double> (st.free_blocks);
+    }
+
+  octave_map m (dim_vector (n, 1));
+
+  m.assign ("block_size", block_size);
+  m.assign ("allocations", allocations);
+  m.assign ("deallocations", deallocations);
+  m.assign ("chunks", chunks);
+  m.assign ("free_blocks", free_blocks);
+
+  return ovl (m);
+}
+
+/*
+%!test
+%! __small_object_pool_stats__ ("reset");
+%! x = 0;
+%! for i = 1:100
+%!   x = x + i;
+%! endfor
+%! s = __small_object_pool_stats__ ();
+%! assert (isstruct (s));
+%! assert (fieldnames (s), {"block_size"; "allocations"; "deallocations";
+%!                          "chunks"; "free_blocks"});
+%! assert (sum ([s.allocations]) >= 100);
+
+%!error __small_object_pool_stats__ (1, 2)
+%!error <argument must be "reset"> __small_object_pool_stats__ ("foo")
+*/
+
 OCTAVE_END_NAMESPACE(octave)
@@ -15,6 +15,8 @@ PARSE_TREE_INC = \
   %reldir%/pt-assign.h \
   %reldir%/pt-binop.h \
   %reldir%/pt-bp.h \
+  %reldir%/pt-bytecode.h \
+  %reldir%/pt-cache.h \
   %reldir%/pt-cbinop.h \
   %reldir%/pt-cell.h \
   %reldir%/pt-check.h \
@@ -27,12 +29,14 @@ PARSE_TREE_INC = \
   %reldir%/pt-except.h \
   %reldir%/pt-exp.h \
   %reldir%/pt-fcn-handle.h \
+  %reldir%/pt-fused.h \
   %reldir%/pt-id.h \
   %reldir%/pt-idx.h \
   %reldir%/pt-jump.h \
   %reldir%/pt-loop.h \
   %reldir%/pt-mat.h \
   %reldir%/pt-misc.h \
+  %reldir%/pt-parfor.h \
   %reldir%/pt-pr-code.h \
   %reldir%/pt-select.h \
   %reldir%/pt-spmd.h \
@@ -64,6 +68,9 @@ PARSE_TREE_SRC = \
   %reldir%/pt-assign.cc \
   %reldir%/pt-binop.cc \
   %reldir%/pt-bp.cc \
+  %reldir%/pt-bytecode-vm.cc \
+  %reldir%/pt-bytecode-walk.cc \
+  %reldir%/pt-cache.cc \
   %reldir%/pt-cbinop.cc \
   %reldir%/pt-cell.cc \
   %reldir%/pt-check.cc \
@@ -75,11 +82,13 @@ PARSE_TREE_SRC = \
   %reldir%/pt-except.cc \
   %reldir%/pt-exp.cc \
   %reldir%/pt-fcn-handle.cc \
+  %reldir%/pt-fused.cc \
   %reldir%/pt-id.cc \
   %reldir%/pt-idx.cc \
   %reldir%/pt-loop.cc \
   %reldir%/pt-mat.cc \
   %reldir%/pt-misc.cc \
+  %reldir%/pt-parfor.cc \
   %reldir%/pt-pr-code.cc \
   %reldir%/pt-select.cc \
   %reldir%/pt-spmd.cc \
@@ -73,6 +73,7 @@
 #include "pager.h"
 #include "parse.h"
 #include "pt-all.h"
+#include "pt-cache.h"
 #include "pt-eval.h"
 #include "symtab.h"
 #include "token.h"
@@ -5831,7 +5832,38 @@ OCTAVE_BEGIN_NAMESPACE(octave)
 
     // get the encoding for this folder
     input_system& input_sys = interp.get_input_system ();
-    parser parser (ffile, interp, input_sys.dir_encoding (dir_name));
+    std::string encoding = input_sys.dir_encoding (dir_name);
+
+    parse_tree_cache cache (full_file, file, dir_name, dispatch_type,
+                            package_name, encoding, force_script, autoload,
+                            relative_lookup);
+
+    // Take the status of the file before it is parsed so that the
+    // cache entry is outdated if the file is modified while it is
+    // parsed.
+
+    sys::file_stat fs;
+
+    if (cache.enabled ())
+      {
+        fs = sys::file_stat (full_file);
+
+        octave_value cached_fcn = cache.load (interp, fs);
+
+        if (cached_fcn.is_defined ())
+          return cached_fcn;
+      }
+
+    // Files that produce warnings while they are parsed are not cached
+    // so that the warnings are shown each time they are read.  Count
+    // all warnings, including disabled ones, because they may be
+    // enabled again when the file is later restored from the cache.
+
+    error_system& es = interp.get_error_system ();
+
+    std::size_t warning_count = es.warning_count ();
+
+    parser parser (ffile, interp, encoding);
 
     parser.m_curr_class_name = dispatch_type;
     parser.m_curr_package_name = package_name;
@@ -5885,6 +5917,9 @@ OCTAVE_BEGIN_NAMESPACE(octave)
             fcn->stash_subfunction_names (parser.m_subfunction_names);
           }
 
+        if (cache.enabled () && es.warning_count () == warning_count)
+          cache.save (ov_fcn, fs);
+
         return ov_fcn;
       }
 
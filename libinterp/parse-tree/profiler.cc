@@ -27,6 +27,13 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <sstream>
+
+#include "signal-wrappers.h"
+
 #include "defun.h"
 #include "event-manager.h"
 #include "interpreter.h"
@@ -37,6 +44,161 @@
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+// Call stack and sample storage for the sampling profiler.
+//
+// The interpreter thread pushes and pops functions on a shadow stack
+// and stores the line that is executed in its top entry.  The SIGPROF
+// handler copies the shadow stack into a free slot of a fixed ring
+// buffer without allocating memory or taking locks.  Filled slots are
+// later moved into the call tree by the interpreter thread.  If no
+// slot is free, the sample is dropped.
+
+class profiler::sample_buffer
+{
+public:
+
+  static const int MAX_DEPTH = 128;
+
+  static const int NUM_SLOTS = 256;
+
+  sample_buffer ()
+    : m_depth (0), m_next (0), m_collected (0)
+  {
+    for (auto& e : m_stack)
+      e = 0;
+
+    for (auto& s : m_slots)
+      s.m_state = FREE;
+  }
+
+  OCTAVE_DISABLE_COPY_MOVE (sample_buffer)
+
+  ~sample_buffer () = default;
+
+  void push (octave_idx_type fcn_idx)
+  {
+    int d = m_depth.load (std::memory_order_relaxed);
+
+    if (d < MAX_DEPTH)
+      m_stack[d].store (line_key (fcn_idx, 0), std::memory_order_relaxed);
+
+    m_depth.store (d + 1, std::memory_order_release);
+  }
+
+  void pop (octave_idx_type fcn_idx)
+  {
+    int d = m_depth.load (std::memory_order_relaxed);
+
+    if (d == 0)
+      return;
+
+    // Ignore functions that were entered before the profiler was
+    // switched to this mode.
+    if (d <= MAX_DEPTH
+        && (m_stack[d-1].load (std::memory_order_relaxed) >> 32)
+           != static_cast<uint64_t> (fcn_idx))
+      return;
+
+    m_depth.store (d - 1, std::memory_order_release);
+  }
+
+  void set_line (int line)
+  {
+    int d = m_depth.load (std::memory_order_relaxed);
+
+    if (d > 0 && d <= MAX_DEPTH)
+      {
+        uint64_t e = m_stack[d-1].load (std::memory_order_relaxed);
+
+        m_stack[d-1].store ((e & ~uint64_t (0xFFFFFFFF))
+                            | static_cast<uint32_t> (line),
+                            std::memory_order_relaxed);
+      }
+  }
+
+  // Called from the signal handler.
+  void take ()
+  {
+    unsigned k = m_next.fetch_add (1, std::memory_order_relaxed) % NUM_SLOTS;
+
+    slot& s = m_slots[k];
+
+    int expected = FREE;
+    if (! s.m_state.compare_exchange_strong (expected, WRITING,
+                                             std::memory_order_acquire))
+      return;
+
+    int d = std::min (m_depth.load (std::memory_order_acquire), MAX_DEPTH);
+
+    for (int i = 0; i < d; i++)
+      s.m_frames[i] = m_stack[i].load (std::memory_order_relaxed);
+
+    s.m_depth = d;
+
+    s.m_state.store (FULL, std::memory_order_release);
+  }
+
+  bool pending () const
+  {
+    return m_next.load (std::memory_order_relaxed) != m_collected;
+  }
+
+  template <typename F>
+  void collect (F fcn)
+  {
+    m_collected = m_next.load (std::memory_order_relaxed);
+
+    for (auto& s : m_slots)
+      {
+        if (s.m_state.load (std::memory_order_acquire) == FULL)
+          {
+            fcn (s.m_frames, s.m_depth);
+
+            s.m_state.store (FREE, std::memory_order_release);
+          }
+      }
+  }
+
+  // Forget the call stack and all samples.  Only valid while no
+  // samples are taken.
+  void clear ()
+  {
+    m_depth = 0;
+
+    for (auto& s : m_slots)
+      s.m_state = FREE;
+
+    m_collected = m_next;
+  }
+
+private:
+
+  enum { FREE, WRITING, FULL };
+
+  struct slot
+  {
+    std::atomic<int> m_state;
+    int m_depth;
+    uint64_t m_frames[MAX_DEPTH];
+  };
+
+  std::atomic<uint64_t> m_stack[MAX_DEPTH];
+
+  std::atomic<int> m_depth;
+
+  slot m_slots[NUM_SLOTS];
+
+  std::atomic<unsigned> m_next;
+
+  // Value of m_next when samples were last collected.
+  unsigned m_collected;
+};
+
+// The buffer that receives samples while the sampling profiler is
+// running.
+
+static std::atomic<void *> s_sample_target (nullptr);
+
 profiler::stats::stats ()
   : m_time (0.0), m_calls (0), m_recursive (false),
     m_parents (), m_children ()
@@ -83,6 +245,17 @@ profiler::tree_node::enter (octave_idx_type fcn)
   return retval;
 }
 
+profiler::tree_node *
+profiler::tree_node::child (octave_idx_type fcn)
+{
+  tree_node *& retval = m_children[fcn];
+
+  if (! retval)
+    retval = new tree_node (this, fcn);
+
+  return retval;
+}
+
 profiler::tree_node *
 profiler::tree_node::exit (octave_idx_type /* fcn */)
 {
@@ -172,35 +345,116 @@ profiler::tree_node::get_hierarchical (double *total) const
   return retval;
 }
 
+void
+profiler::tree_node::write_collapsed (std::ostream& os,
+                                      const std::string& prefix,
+                                      const function_set& names) const
+{
+  std::string path = prefix;
+
+  if (m_fcn_id != 0)
+    {
+      // Semicolons separate the frames.
+      std::string name = names[m_fcn_id - 1];
+      std::replace (name.begin (), name.end (), ';', ':');
+
+      if (! path.empty ())
+        path += ';';
+
+      path += name;
+
+      long long usec = std::llround (m_time * 1e6);
+
+      if (usec > 0)
+        os << path << ' ' << usec << "\n";
+    }
+
+  for (const auto& idx_tnode : m_children)
+    idx_tnode.second->write_collapsed (os, path, names);
+}
+
 profiler::profiler ()
   : m_known_functions (), m_fcn_index (),
-    m_enabled (false), m_call_tree (new tree_node (nullptr, 0)),
-    m_active_fcn (nullptr), m_last_time (-1.0)
+    m_enabled (false), m_mode (FUNCTIONS), m_sample_interval (0.0),
+    m_call_tree (new tree_node (nullptr, 0)),
+    m_active_fcn (nullptr), m_last_time (-1.0), m_frames (), m_lines (),
+    m_samples ()
 { }
 
 profiler::~profiler ()
 {
+  if (m_enabled && m_mode == SAMPLES)
+    stop_sampling ();
+
   delete m_call_tree;
 }
 
 void
 profiler::set_active (bool value)
 {
+  if (value == m_enabled)
+    return;
+
+  if (m_mode == SAMPLES)
+    {
+      if (value)
+        start_sampling ();
+      else
+        stop_sampling ();
+    }
+  else if (m_mode == LINES && ! value)
+    {
+      // Account for the lines that are currently executed.  They are
+      // not continued when the profiler is resumed.
+      double now = query_time ();
+
+      for (auto& f : m_frames)
+        {
+          if (f.m_line)
+            f.m_line->m_time += now - f.m_line_start;
+
+          f.m_line = nullptr;
+        }
+    }
+
   m_enabled = value;
 }
 
 void
-profiler::enter_function (const std::string& fcn)
+profiler::set_mode (mode m, double interval)
 {
-  // The enter class will check and only call us if the profiler is active.
-  panic_unless (enabled ());
-  panic_unless (m_call_tree);
+  if (m == m_mode && (m != SAMPLES || interval == m_sample_interval))
+    return;
 
-  // If there is already an active function, add to its time before
-  // pushing the new one.
-  if (m_active_fcn && m_active_fcn != m_call_tree)
-    add_current_time ();
+  if (enabled ())
+    error ("profile: can't change mode of active profiler");
+
+  if (m == SAMPLES)
+    {
+      if (! sampling_available ())
+        error ("profile: sampling is not supported on this system");
+
+      if (! (interval > 0))
+        error ("profile: sampling interval must be positive");
+
+      if (! m_samples)
+        m_samples.reset (new sample_buffer ());
+
+      m_sample_interval = interval;
+    }
+
+  m_mode = m;
+}
+
+bool
+profiler::sampling_available ()
+{
+  return octave_have_profiling_timer ();
+}
 
+octave_idx_type
+profiler::function_index (const std::string& fcn)
+{
   // Map the function's name to its index.
   octave_idx_type fcn_idx;
   fcn_index_map::iterator pos = m_fcn_index.find (fcn);
@@ -213,6 +467,36 @@ profiler::enter_function (const std::string& fcn)
   else
     fcn_idx = pos->second;
 
+  return fcn_idx;
+}
+
+octave_idx_type
+profiler::enter_function (const std::string& fcn)
+{
+  // The enter class will check and only call us if the profiler is active.
+  panic_unless (enabled ());
+  panic_unless (m_call_tree);
+
+  if (m_mode == SAMPLES)
+    {
+      // No timing here, the call tree is built from the samples.
+      octave_idx_type fcn_idx = function_index (fcn);
+
+      m_samples->push (fcn_idx);
+
+      if (m_samples->pending ())
+        collect_samples ();
+
+      return fcn_idx;
+    }
+
+  // If there is already an active function, add to its time before
+  // pushing the new one.
+  if (m_active_fcn && m_active_fcn != m_call_tree)
+    add_current_time ();
+
+  octave_idx_type fcn_idx = function_index (fcn);
+
   if (! m_active_fcn)
     m_active_fcn = m_call_tree;
 
@@ -220,11 +504,34 @@ profiler::enter_function (const std::string& fcn)
 
   m_last_time = query_time ();
 
+  if (m_mode == LINES)
+    m_frames.push_back ({fcn_idx, nullptr, m_last_time});
+
+  return fcn_idx;
 }
 
 void
-profiler::exit_function (const std::string& fcn)
+profiler::exit_function (octave_idx_type fcn_idx)
 {
+  // The stacks are also popped if the mode was changed after the
+  // function was entered.
+
+  if (m_samples)
+    m_samples->pop (fcn_idx);
+
+  if (m_mode == SAMPLES)
+    return;
+
+  if (! m_frames.empty () && m_frames.back ().m_fcn_idx == fcn_idx)
+    {
+      frame& f = m_frames.back ();
+
+      if (enabled () && f.m_line)
+        f.m_line->m_time += query_time () - f.m_line_start;
+
+      m_frames.pop_back ();
+    }
+
   if (m_active_fcn)
     {
       panic_unless (m_call_tree);
@@ -239,12 +546,7 @@ profiler::exit_function (const std::string& fcn)
       if (enabled ())
         add_current_time ();
 
-      fcn_index_map::iterator pos = m_fcn_index.find (fcn);
-      // FIXME: This panic_unless statements doesn't make sense if profile()
-      //        is called from within a function hierarchy to begin with.
-      //        See bug #39587.
-      // panic_unless (pos != m_fcn_index.end ());
-      m_active_fcn = m_active_fcn->exit (pos->second);
+      m_active_fcn = m_active_fcn->exit (fcn_idx);
 
       // If this was an "inner call", we resume executing the parent function
       // up the stack.  So note the start-time for this!
@@ -261,6 +563,14 @@ profiler::reset ()
   m_known_functions.clear ();
   m_fcn_index.clear ();
 
+  // The indices of the functions that are currently executing are no
+  // longer valid.
+  m_frames.clear ();
+  m_lines.clear ();
+
+  if (m_samples)
+    m_samples->clear ();
+
   if (m_call_tree)
     {
       delete m_call_tree;
@@ -271,6 +581,114 @@ profiler::reset ()
   m_last_time = -1.0;
 }
 
+void
+profiler::record_statement (int line)
+{
+  if (m_mode == SAMPLES)
+    {
+      m_samples->set_line (line);
+
+      if (m_samples->pending ())
+        collect_samples ();
+
+      return;
+    }
+
+  // Statements that are executed at the command line don't belong to
+  // a function.
+  if (m_frames.empty ())
+    return;
+
+  frame& f = m_frames.back ();
+
+  double now = query_time ();
+
+  if (f.m_line)
+    f.m_line->m_time += now - f.m_line_start;
+
+  // Entries of an unordered_map stay at the same address when other
+  // entries are inserted.
+  line_stats& entry = m_lines[line_key (f.m_fcn_idx, line)];
+
+  entry.m_calls++;
+
+  f.m_line = &entry;
+  f.m_line_start = now;
+}
+
+void
+profiler::start_sampling ()
+{
+  int sig;
+
+  if (! octave_get_sig_number ("SIGPROF", &sig))
+    error ("profile: sampling is not supported on this system");
+
+  s_sample_target = m_samples.get ();
+
+  octave_set_signal_handler_internal (sig, sample_handler, true);
+
+  if (! octave_set_profiling_timer (m_sample_interval))
+    {
+      s_sample_target = nullptr;
+
+      error ("profile: unable to start sampling timer");
+    }
+}
+
+void
+profiler::stop_sampling ()
+{
+  octave_set_profiling_timer (0.0);
+
+  s_sample_target = nullptr;
+
+  collect_samples ();
+}
+
+void
+profiler::sample_handler (int)
+{
+  sample_buffer *samples
+    = static_cast<sample_buffer *> (s_sample_target.load ());
+
+  if (samples)
+    samples->take ();
+}
+
+void
+profiler::collect_samples ()
+{
+  if (m_samples)
+    m_samples->collect ([this] (const uint64_t *frames, int depth)
+                        { add_sample (frames, depth); });
+}
+
+void
+profiler::add_sample (const uint64_t *frames, int depth)
+{
+  if (depth == 0)
+    return;
+
+  tree_node *node = m_call_tree;
+
+  for (int i = 0; i < depth; i++)
+    node = node->child (frames[i] >> 32);
+
+  node->add_time (m_sample_interval);
+
+  // Add the time once to each line on the stack.  A line appears more
+  // than once for recursive calls.
+  for (int i = 0; i < depth; i++)
+    {
+      if (static_cast<uint32_t> (frames[i]) == 0
+          || std::find (frames, frames + i, frames[i]) != frames + i)
+        continue;
+
+      m_lines[frames[i]].m_time += m_sample_interval;
+    }
+}
+
 octave_value
 profiler::get_flat () const
 {
@@ -359,6 +777,52 @@ profiler::get_hierarchical () const
   return retval;
 }
 
+octave_value
+profiler::get_lines () const
+{
+  std::vector<std::pair<uint64_t, line_stats>> lines (m_lines.begin (),
+                                                      m_lines.end ());
+
+  std::sort (lines.begin (), lines.end (),
+             [] (const std::pair<uint64_t, line_stats>& a,
+                 const std::pair<uint64_t, line_stats>& b)
+             { return a.first < b.first; });
+
+  const octave_idx_type n = lines.size ();
+
+  Cell rv_names (n, 1);
+  Cell rv_lines (n, 1);
+  Cell rv_calls (n, 1);
+  Cell rv_times (n, 1);
+
+  for (octave_idx_type i = 0; i != n; ++i)
+    {
+      octave_idx_type fcn_idx = lines[i].first >> 32;
+      uint32_t line = static_cast<uint32_t> (lines[i].first);
+
+      rv_names(i) = octave_value (m_known_functions[fcn_idx - 1]);
+      rv_lines(i) = octave_value (static_cast<double> (line));
+      rv_calls(i) = octave_value (lines[i].second.m_calls);
+      rv_times(i) = octave_value (lines[i].second.m_time);
+    }
+
+  octave_map retval (dim_vector (n, 1));
+
+  retval.assign ("FunctionName", rv_names);
+  retval.assign ("Line", rv_lines);
+  retval.assign ("NumCalls", rv_calls);
+  retval.assign ("TotalTime", rv_times);
+
+  return retval;
+}
+
+void
+profiler::write_collapsed (std::ostream& os) const
+{
+  if (m_call_tree)
+    m_call_tree->write_collapsed (os, "", m_known_functions);
+}
+
 double
 profiler::query_time () const
 {
@@ -411,6 +875,69 @@ Undocumented internal function.
   return ovl (profiler.enabled ());
 }
 
+// Select what the profiler records.
+DEFMETHOD (__profiler_mode__, interp, args, ,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {[@var{mode}, @var{interval}] =} __profiler_mode__ ()
+@deftypefnx {} {} __profiler_mode__ (@var{mode})
+@deftypefnx {} {} __profiler_mode__ ("samples", @var{interval})
+Query or set the mode of the profiler.
+
+@var{mode} is one of @qcode{"functions"}, @qcode{"lines"}, or
+@qcode{"samples"}.  @var{interval} is the sampling period in seconds of
+CPU time.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 2)
+    print_usage ();
+
+  profiler& profiler = interp.get_profiler ();
+
+  static const double default_interval = 0.005;
+
+  if (nargin > 0)
+    {
+      std::string mode
+        = args(0).xstring_value ("__profiler_mode__: MODE must be a string");
+
+      double interval = default_interval;
+      if (nargin > 1)
+        interval = args(1).xdouble_value ("__profiler_mode__: INTERVAL must be a number");
+
+      if (mode == "functions")
+        profiler.set_mode (profiler::FUNCTIONS);
+      else if (mode == "lines")
+        profiler.set_mode (profiler::LINES);
+      else if (mode == "samples")
+        profiler.set_mode (profiler::SAMPLES, interval);
+      else
+        error (R"(__profiler_mode__: MODE must be "functions", "lines", or "samples")");
+
+      return ovl ();
+    }
+
+  std::string mode;
+
+  switch (profiler.get_mode ())
+    {
+    case profiler::LINES:
+      mode = "lines";
+      break;
+
+    case profiler::SAMPLES:
+      mode = "samples";
+      break;
+
+    default:
+      mode = "functions";
+      break;
+    }
+
+  return ovl (mode, profiler.sample_interval ());
+}
+
 // Clear all collected profiling data.
 DEFMETHOD (__profiler_reset__, interp, args, ,
            doc: /* -*- texinfo -*-
@@ -440,10 +967,50 @@ Undocumented internal function.
 
   profiler& profiler = interp.get_profiler ();
 
+  profiler.collect_samples ();
+
   if (nargout > 1)
     return ovl (profiler.get_flat (), profiler.get_hierarchical ());
   else
     return ovl (profiler.get_flat ());
 }
 
+// Query the line profile.
+DEFMETHOD (__profiler_lines__, interp, args, ,
+           doc: /* -*- texinfo -*-
+@deftypefn {} {@var{lines} =} __profiler_lines__ ()
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 0)
+    print_usage ();
+
+  profiler& profiler = interp.get_profiler ();
+
+  profiler.collect_samples ();
+
+  return ovl (profiler.get_lines ());
+}
+
+// Return the call tree in the collapsed stack format.
+DEFMETHOD (__profiler_collapsed__, interp, args, ,
+           doc: /* -*- texinfo -*-
+@deftypefn {} {@var{str} =} __profiler_collapsed__ ()
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 0)
+    print_usage ();
+
+  profiler& profiler = interp.get_profiler ();
+
+  profiler.collect_samples ();
+
+  std::ostringstream buf;
+
+  profiler.write_collapsed (buf);
+
+  return ovl (buf.str ());
+}
+
 OCTAVE_END_NAMESPACE(octave)
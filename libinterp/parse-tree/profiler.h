@@ -29,9 +29,13 @@
 #include "octave-config.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <iosfwd>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class octave_value;
@@ -49,28 +53,26 @@ public:
   private:
 
     profiler& m_profiler;
-    std::string m_fcn;
-    bool m_enabled;
+
+    // Index of the function in the profiler, or 0 if this block is
+    // not active.
+    octave_idx_type m_fcn_idx;
 
   public:
 
-    enter (profiler& p, const T& t) : m_profiler (p)
+    enter (profiler& p, const T& t) : m_profiler (p), m_fcn_idx (0)
     {
       // A profiling block cannot be active if the profiler is not
-      m_enabled = m_profiler.enabled ();
-
-      if (m_enabled)
+      if (m_profiler.enabled ())
         {
-          m_fcn = t.profiler_name ();
+          std::string fcn = t.profiler_name ();
 
           // NOTE: The test f != "" must be kept to prevent a blank
           // line showing up in profiler statistics.  See bug
           // #39524.  The root cause is that the function name is
           // not set for the recurring readline hook function.
-          if (m_fcn == "")
-            m_enabled = false;  // Inactive profiling block
-          else
-            m_profiler.enter_function (m_fcn);
+          if (! fcn.empty ())
+            m_fcn_idx = m_profiler.enter_function (fcn);
         }
     }
 
@@ -78,11 +80,24 @@ public:
 
     ~enter ()
     {
-      if (m_enabled)
-        m_profiler.exit_function (m_fcn);
+      if (m_fcn_idx != 0)
+        m_profiler.exit_function (m_fcn_idx);
     }
   };
 
+  // What is recorded while the profiler is enabled.
+  enum mode
+  {
+    // Time and number of calls of each function.
+    FUNCTIONS,
+
+    // In addition, time and number of executions of each line.
+    LINES,
+
+    // Periodic snapshots of the call stack.
+    SAMPLES
+  };
+
   profiler ();
 
   OCTAVE_DISABLE_COPY_MOVE (profiler)
@@ -92,11 +107,45 @@ public:
   bool enabled () const { return m_enabled; }
   void set_active (bool);
 
+  mode get_mode () const { return m_mode; }
+
+  // Select what is recorded.  INTERVAL is the sampling period in
+  // seconds of CPU time.  The mode can only be changed while the
+  // profiler is not active.
+  void set_mode (mode m, double interval = 0.0);
+
+  double sample_interval () const { return m_sample_interval; }
+
+  // True if the system supports the SAMPLES mode.
+  static bool sampling_available ();
+
+  // Called by the evaluator before each statement of user code.
+  void statement (int line)
+  {
+    if (m_mode != FUNCTIONS)
+      record_statement (line);
+  }
+
   void reset ();
 
+  // Move samples that were taken since the last call into the
+  // collected data.
+  void collect_samples ();
+
   octave_value get_flat () const;
   octave_value get_hierarchical () const;
 
+  // Line profile as a struct array with fields FunctionName, Line,
+  // NumCalls, and TotalTime.  The time of a line includes the time of
+  // the functions that it calls.
+  octave_value get_lines () const;
+
+  // Write the call tree in the "collapsed stack" format that is read
+  // by flame graph tools.  Each line holds the names of the functions
+  // on a call stack separated by semicolons, followed by the time in
+  // microseconds spent in the innermost function.
+  void write_collapsed (std::ostream& os) const;
+
 private:
 
   // One entry in the flat profile (i.e., a collection of data for a single
@@ -128,6 +177,8 @@ private:
 
   typedef std::vector<stats> flat_profile;
 
+  typedef std::vector<std::string> function_set;
+
   // Store data for one node in the call-tree of the hierarchical profiler
   // data we collect.
   class tree_node
@@ -146,6 +197,9 @@ private:
     // wasn't already there.  The now-active child node is returned.
     tree_node * enter (octave_idx_type);
 
+    // Like enter, but without counting a call.
+    tree_node * child (octave_idx_type);
+
     // Exit function.  As a sanity-check, it is verified that the currently
     // active function actually is the one handed in here.  Returned is the
     // then-active node, which is our parent.
@@ -158,6 +212,9 @@ private:
     // additional return value.
     octave_value get_hierarchical (double *total = nullptr) const;
 
+    void write_collapsed (std::ostream& os, const std::string& prefix,
+                          const function_set& names) const;
+
   private:
 
     tree_node *m_parent;
@@ -177,14 +234,17 @@ private:
   // those indices.  For all other stuff, we identify functions by their
   // index.
 
-  typedef std::vector<std::string> function_set;
-  typedef std::map<std::string, octave_idx_type> fcn_index_map;
+  typedef std::unordered_map<std::string, octave_idx_type> fcn_index_map;
 
   function_set m_known_functions;
   fcn_index_map m_fcn_index;
 
   bool m_enabled;
 
+  mode m_mode;
+
+  double m_sample_interval;
+
   tree_node *m_call_tree;
   tree_node *m_active_fcn;
 
@@ -192,10 +252,58 @@ private:
   // called.
   double m_last_time;
 
+  // Functions that are executing, with the line that is currently
+  // executed and the time when it was started.  Only used in the
+  // LINES mode.
+  struct line_stats
+  {
+    double m_time;
+    std::size_t m_calls;
+  };
+
+  struct frame
+  {
+    octave_idx_type m_fcn_idx;
+
+    // The entry of the current line, or nullptr.
+    line_stats *m_line;
+
+    double m_line_start;
+  };
+
+  std::vector<frame> m_frames;
+
+  // Line statistics, keyed by function index and line number (see
+  // line_key).
+  std::unordered_map<uint64_t, line_stats> m_lines;
+
+  static uint64_t line_key (octave_idx_type fcn_idx, int line)
+  {
+    return ((static_cast<uint64_t> (fcn_idx) << 32)
+            | static_cast<uint32_t> (line));
+  }
+
+  // Call stack and samples for the SAMPLES mode.  These are shared
+  // with the signal handler.
+  class sample_buffer;
+
+  std::unique_ptr<sample_buffer> m_samples;
+
+  static void sample_handler (int);
+
   // These are private as only the unwind-protecting inner class enter
   // should be allowed to call them.
-  void enter_function (const std::string&);
-  void exit_function (const std::string&);
+  octave_idx_type enter_function (const std::string&);
+  void exit_function (octave_idx_type);
+
+  octave_idx_type function_index (const std::string&);
+
+  void record_statement (int line);
+
+  void add_sample (const uint64_t *frames, int depth);
+
+  void start_sampling ();
+  void stop_sampling ();
 
   // Query a timestamp, used for timing calls (obviously).
   // This is not static because in the future, maybe we want a flag
@@ -69,6 +69,32 @@ tree_binary_expression::dup (symbol_scope& scope) const
 octave_value
 tree_binary_expression::evaluate (tree_evaluator& tw, int)
 {
+  if (! m_fused_checked)
+    {
+      m_fused_checked = true;
+
+      m_fused = fused_elementwise_expression::create (*this);
+    }
+
+  if (m_fused)
+    {
+      profiler::enter<tree_binary_expression>
+        block (tw.get_profiler (), *this);
+
+      octave_value val = m_fused->evaluate (tw);
+
+      if (val.is_defined ())
+        return val;
+
+      // Stop trying if the operands have never been suitable.
+
+      if (! m_fused->used ())
+        {
+          delete m_fused;
+          m_fused = nullptr;
+        }
+    }
+
   if (m_lhs)
     {
       // Evaluate with unknown number of output arguments
@@ -35,6 +35,7 @@ class octave_value_list;
 
 #include "ov.h"
 #include "pt-exp.h"
+#include "pt-fused.h"
 #include "pt-walk.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
@@ -51,7 +52,7 @@ public:
                           octave_value::binary_op t
                           = octave_value::unknown_binary_op)
     : tree_expression (l, c), m_lhs (nullptr), m_rhs (nullptr), m_etype (t),
-      m_preserve_operands (false)
+      m_preserve_operands (false), m_fused_checked (false), m_fused (nullptr)
   { }
 
   tree_binary_expression (tree_expression *a, tree_expression *b,
@@ -59,13 +60,15 @@ public:
                           octave_value::binary_op t
                           = octave_value::unknown_binary_op)
     : tree_expression (l, c), m_lhs (a), m_rhs (b), m_etype (t),
-      m_preserve_operands (false)
+      m_preserve_operands (false), m_fused_checked (false), m_fused (nullptr)
   { }
 
   OCTAVE_DISABLE_COPY_MOVE (tree_binary_expression)
 
   ~tree_binary_expression ()
   {
+    delete m_fused;
+
     if (! m_preserve_operands)
       {
         delete m_lhs;
@@ -108,6 +111,9 @@ public:
   void matlab_style_short_circuit_warning (const char *op);
 
   virtual bool is_braindead () const { return false; }
+
+  virtual bool is_compound_binary_expression () const { return false; }
+
 protected:
 
   // The operands for the expression.
@@ -121,6 +127,13 @@ private:
 
   // If TRUE, don't delete m_lhs and m_rhs in destructor;
   bool m_preserve_operands;
+
+  // TRUE once the expression has been checked for element-wise
+  // operators that can be evaluated in one pass.
+  bool m_fused_checked;
+
+  // The fused form of the expression, if any.
+  fused_elementwise_expression *m_fused;
 };
 
 class tree_braindead_shortcircuit_binary_expression
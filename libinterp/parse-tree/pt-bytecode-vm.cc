@@ -0,0 +1,745 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <list>
+#include <new>
+#include <string>
+
+#include "lo-array-errwarn.h"
+#include "lo-mappers.h"
+#include "quit.h"
+#include "unwind-prot.h"
+
+#include "defun.h"
+#include "error.h"
+#include "interpreter.h"
+#include "ov-typeinfo.h"
+#include "ov-usr-fcn.h"
+#include "ovl.h"
+#include "pager.h"
+#include "pt-all.h"
+#include "pt-bytecode.h"
+#include "pt-eval.h"
+#include "stack-frame.h"
+#include "symtab.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+static const char *
+cond_kind_name (int kind)
+{
+  switch (kind)
+    {
+    case BC_COND_WHILE:
+      return "while";
+
+    case BC_COND_DO_UNTIL:
+      return "do-until";
+
+    default:
+      return "if";
+    }
+}
+
+bytecode_vm::bytecode_vm (tree_evaluator& tw, const bytecode& code)
+  : m_tw (tw), m_code (code), m_frame (*tw.get_current_stack_frame ()),
+    m_ti (tw.get_interpreter ().get_type_info ()),
+    m_registers (code.num_registers ()), m_for_states (code.num_loops ()),
+    m_in_loop_command (tw.in_loop_command ())
+{ }
+
+void
+bytecode_vm::execute ()
+{
+  unwind_action act ([this] (bool flag)
+  {
+    m_tw.in_loop_command (flag);
+  }, m_in_loop_command);
+
+  const std::vector<bc_instr>& code = m_code.code ();
+
+  int pc = 0;
+
+  try
+    {
+      for (;;)
+        {
+          const bc_instr& instr = code[pc++];
+
+          switch (instr.op)
+            {
+            case bc_opcode::STMT:
+              m_frame.line (instr.a);
+              m_frame.column (instr.b);
+              octave_quit ();
+              break;
+
+            case bc_opcode::LOCATION:
+              m_frame.line (instr.a);
+              m_frame.column (instr.b);
+              break;
+
+            case bc_opcode::LOAD_CONST:
+              m_registers[instr.a] = m_code.constant (instr.b);
+              break;
+
+            case bc_opcode::LOAD_VAR:
+              {
+                octave_value val = m_frame.varval (m_code.symbol (instr.b));
+
+                // The tree evaluator also handles variables that hold
+                // function objects, which are called rather than
+                // returned.
+
+                if (val.is_defined () && ! val.is_function ())
+                  m_registers[instr.a] = val;
+                else
+                  m_registers[instr.a]
+                    = m_code.expression (instr.c)->evaluate (m_tw, instr.d);
+              }
+              break;
+
+            case bc_opcode::LOAD_INDEXABLE:
+              {
+                octave_value val = m_frame.varval (m_code.symbol (instr.b));
+
+                if (val.is_defined () && ! val.isobject ()
+                    && (val.isnumeric () || val.islogical ()
+                        || val.is_string () || val.iscell ()
+                        || val.isstruct ()))
+                  m_registers[instr.a] = val;
+                else
+                  pc = instr.c;
+              }
+              break;
+
+            case bc_opcode::INDEX:
+              index (instr);
+              break;
+
+            case bc_opcode::EVAL_EXPR:
+              m_registers[instr.a]
+                = m_code.expression (instr.b)->evaluate (m_tw, instr.c);
+              break;
+
+            case bc_opcode::EVAL_STMT:
+              if (! eval_statement (instr, pc))
+                return;
+              break;
+
+            case bc_opcode::BINARY_OP:
+              {
+                octave_value a = take (instr.b);
+                octave_value b = take (instr.c);
+
+                if (a.is_defined () && b.is_defined ())
+                  m_registers[instr.a]
+                    = binary_op (m_ti,
+                                 static_cast<octave_value::binary_op> (instr.d),
+                                 a, b);
+              }
+              break;
+
+            case bc_opcode::UNARY_OP:
+              {
+                octave_value val = take (instr.b);
+
+                if (val.is_defined ())
+                  {
+                    octave_value::unary_op op
+                      = static_cast<octave_value::unary_op> (instr.c);
+
+                    // Attempt to do the operation in-place if it is
+                    // unshared (a temporary expression).
+
+                    if (instr.d && val.get_count () == 1)
+                      {
+                        val.non_const_unary_op (op);
+                        m_registers[instr.a] = std::move (val);
+                      }
+                    else
+                      m_registers[instr.a] = unary_op (m_ti, op, val);
+                  }
+              }
+              break;
+
+            case bc_opcode::TO_BOOL:
+              m_registers[instr.a] = octave_value (take (instr.a).is_true ());
+              break;
+
+            case bc_opcode::JMP:
+              pc = instr.a;
+              break;
+
+            case bc_opcode::LOOP_JMP:
+              octave_quit ();
+              pc = instr.a;
+              break;
+
+            case bc_opcode::JMP_IF_FALSE:
+              if (! m_registers[instr.a].is_true ())
+                pc = instr.b;
+              break;
+
+            case bc_opcode::JMP_IF_TRUE:
+              if (m_registers[instr.a].is_true ())
+                pc = instr.b;
+              break;
+
+            case bc_opcode::JMP_IF_UNDEF:
+              if (m_registers[instr.a].is_undefined ())
+                pc = instr.b;
+              break;
+
+            case bc_opcode::COND:
+              {
+                octave_value val = take (instr.a);
+
+                if (val.is_undefined ())
+                  error ("%s: undefined value used in conditional expression",
+                         cond_kind_name (instr.c));
+
+                if (val.is_true () == static_cast<bool> (instr.d))
+                  pc = instr.b;
+              }
+              break;
+
+            case bc_opcode::ASSIGN:
+              assign (instr);
+              break;
+
+            case bc_opcode::ASSIGN_INDEX:
+              assign_index (instr);
+              break;
+
+            case bc_opcode::LOOP_ENTER:
+              m_tw.in_loop_command (true);
+              break;
+
+            case bc_opcode::LOOP_EXIT:
+              m_tw.in_loop_command (instr.a ? true : m_in_loop_command);
+              break;
+
+            case bc_opcode::FOR_SETUP:
+              if (! for_setup (instr))
+                pc = instr.c;
+              break;
+
+            case bc_opcode::FOR_NEXT:
+              if (! for_next (instr))
+                pc = instr.c;
+              break;
+
+            case bc_opcode::CLEAR:
+              m_registers[instr.a] = octave_value ();
+              break;
+
+            case bc_opcode::RETURN:
+              return;
+            }
+        }
+    }
+  catch (const std::bad_alloc&)
+    {
+      error_with_id ("Octave:bad-alloc",
+                     "out of memory or dimension too large for Octave's index type");
+    }
+}
+
+// Collect the indices in registers FIRST ... FIRST+N-1 the same way
+// tree_evaluator::make_value_list does.
+
+static octave_value_list
+make_index_list (std::vector<octave_value>& registers, int first, int n)
+{
+  std::list<octave_value> arg_vals;
+
+  for (int k = first; k < first + n; k++)
+    {
+      octave_value tmp = std::move (registers[k]);
+      registers[k] = octave_value ();
+
+      if (tmp.is_cs_list ())
+        {
+          octave_value_list tmp_ovl = tmp.list_value ();
+
+          for (octave_idx_type i = 0; i < tmp_ovl.length (); i++)
+            arg_vals.push_back (tmp_ovl(i));
+        }
+      else if (tmp.is_defined ())
+        arg_vals.push_back (tmp);
+    }
+
+  return octave_value_list (arg_vals);
+}
+
+void
+bytecode_vm::index (const bc_instr& instr)
+{
+  octave_value_list idx = make_index_list (m_registers, instr.a + 1,
+                                           instr.b);
+
+  octave_value base = take (instr.a);
+
+  tree_index_expression *expr
+    = dynamic_cast<tree_index_expression *> (m_code.expression (instr.c));
+
+  try
+    {
+      m_registers[instr.a] = base.index_op (idx);
+    }
+  catch (index_exception& ie)
+    {
+      m_tw.final_index_error (ie, expr->expression ());
+    }
+}
+
+bool
+bytecode_vm::eval_statement (const bc_instr& instr, int& pc)
+{
+  octave_quit ();
+
+  m_code.statement (instr.a)->accept (m_tw);
+
+  // BREAK, CONTINUE, and RETURN executed by the tree evaluator are
+  // reported through the evaluator state.  Pass them on to the
+  // enclosing compiled loop or leave the VM if there is none.
+
+  if (m_tw.returning ())
+    return false;
+
+  if (m_tw.breaking ())
+    {
+      if (instr.b < 0)
+        return false;
+
+      m_tw.breaking (m_tw.breaking () - 1);
+      pc = instr.b;
+    }
+  else if (m_tw.continuing ())
+    {
+      if (instr.c < 0)
+        return false;
+
+      m_tw.continuing (m_tw.continuing () - 1);
+      pc = instr.c;
+    }
+
+  return true;
+}
+
+static void
+check_assignment_rhs (octave_value& rhs)
+{
+  if (rhs.is_undefined ())
+    error ("value on right hand side of assignment is undefined");
+
+  if (rhs.is_cs_list ())
+    {
+      const octave_value_list lst = rhs.list_value ();
+
+      if (lst.empty ())
+        error ("invalid number of elements on RHS of assignment");
+
+      rhs = lst(0);
+    }
+}
+
+void
+bytecode_vm::assign (const bc_instr& instr)
+{
+  const symbol_record& sym = m_code.symbol (instr.a);
+
+  octave_value rhs = take (instr.b);
+
+  tree_simple_assignment *expr
+    = dynamic_cast<tree_simple_assignment *> (m_code.expression (instr.c));
+
+  check_assignment_rhs (rhs);
+
+  octave_value::assign_op op = expr->op_type ();
+
+  try
+    {
+      if (op == octave_value::op_asn_eq)
+        m_frame.assign (sym, rhs);
+      else
+        m_frame.varref (sym).assign (op, rhs);
+    }
+  catch (index_exception& ie)
+    {
+      ie.set_var (expr->left_hand_side ()->name ());
+      std::string msg = ie.message ();
+      error_with_id (ie.err_id (), "%s", msg.c_str ());
+    }
+}
+
+void
+bytecode_vm::assign_index (const bc_instr& instr)
+{
+  const symbol_record& sym = m_code.symbol (instr.a);
+
+  octave_value_list idx = make_index_list (m_registers, instr.b, instr.c);
+
+  octave_value rhs = take (instr.b + instr.c);
+
+  tree_simple_assignment *expr
+    = dynamic_cast<tree_simple_assignment *> (m_code.expression (instr.d));
+
+  check_assignment_rhs (rhs);
+
+  try
+    {
+      m_frame.assign (expr->op_type (), sym, "(",
+                      std::list<octave_value_list> (1, idx), rhs);
+    }
+  catch (index_exception& ie)
+    {
+      ie.set_var (expr->left_hand_side ()->name ());
+      std::string msg = ie.message ();
+      error_with_id (ie.err_id (), "%s", msg.c_str ());
+    }
+}
+
+// Set up iteration over the value in the register.  The value stays
+// in the register until the loop is finished.  Return false if the
+// loop body should not be executed at all.
+
+bool
+bytecode_vm::for_setup (const bc_instr& instr)
+{
+  octave_value& rhs = m_registers[instr.a];
+
+  if (rhs.is_undefined ())
+    return false;
+
+  for_state& st = m_for_states[instr.b];
+
+  st.m_count = 0;
+
+  if (rhs.is_range () && rhs.is_double_type ())
+    {
+      st.m_kind = for_state::RANGE;
+      st.m_range = rhs.range_value ();
+      st.m_steps = st.m_range.numel ();
+
+      if (math::isinf (st.m_range.limit ())
+          || math::isinf (st.m_range.base ()))
+        warning_with_id ("Octave:infinite-loop",
+                         "FOR loop limit is infinite, will stop after %"
+                         OCTAVE_IDX_TYPE_FORMAT " steps", st.m_steps);
+
+      return st.m_steps > 0;
+    }
+
+  if (rhs.is_scalar_type ())
+    {
+      st.m_kind = for_state::SCALAR;
+      st.m_steps = 1;
+
+      return true;
+    }
+
+  if (rhs.is_range () || rhs.is_matrix_type () || rhs.iscell ()
+      || rhs.is_string () || rhs.isstruct ())
+    {
+      // A matrix or cell is reshaped to 2 dimensions and iterated by
+      // columns.
+
+      const dim_vector& dv = rhs.dims ().redim (2);
+
+      octave_idx_type nrows = dv(0);
+
+      if (rhs.ndims () > 2)
+        rhs = rhs.reshape (dv);
+
+      st.m_kind = for_state::COLUMNS;
+      st.m_steps = dv(1);
+
+      if (st.m_steps <= 0)
+        {
+          // Handle empty cases, while still assigning to loop var.
+          m_frame.assign (m_code.symbol (instr.d), rhs);
+
+          return false;
+        }
+
+      // For row vectors, use single index to speed things up.
+      if (nrows == 1)
+        {
+          st.m_idx.resize (1);
+          st.m_iidx = 0;
+        }
+      else
+        {
+          st.m_idx.resize (2);
+          st.m_idx(0) = octave_value::magic_colon_t;
+          st.m_iidx = 1;
+        }
+
+      return true;
+    }
+
+  error ("invalid type in for loop expression near line %d, column %d",
+         m_frame.line (), m_frame.column ());
+}
+
+// Assign the next value to the loop variable.  Return false when the
+// loop is finished.
+
+bool
+bytecode_vm::for_next (const bc_instr& instr)
+{
+  for_state& st = m_for_states[instr.b];
+
+  if (st.m_count >= st.m_steps)
+    return false;
+
+  octave_idx_type i = st.m_count++;
+
+  const symbol_record& sym = m_code.symbol (instr.d);
+
+  switch (st.m_kind)
+    {
+    case for_state::RANGE:
+      m_frame.assign (sym, octave_value (st.m_range.elem (i)));
+      break;
+
+    case for_state::SCALAR:
+      m_frame.assign (sym, m_registers[instr.a]);
+      break;
+
+    case for_state::COLUMNS:
+      {
+        // index_op expects one-based indices.
+        st.m_idx(st.m_iidx) = i + 1;
+
+        m_frame.assign (sym, m_registers[instr.a].index_op (st.m_idx));
+      }
+      break;
+    }
+
+  return true;
+}
+
+DEFMETHOD (__vm_enable__, interp, args, nargout,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{val} =} __vm_enable__ ()
+@deftypefnx {} {@var{old_val} =} __vm_enable__ (@var{new_val})
+@deftypefnx {} {@var{old_val} =} __vm_enable__ (@var{new_val}, "local")
+Query or set the internal variable that controls whether the bodies of
+user functions are compiled to bytecode and executed by the bytecode VM.
+
+Constructs that the compiler does not handle are still evaluated by the
+tree evaluator, so the results do not depend on this setting.  The VM is
+not used while debugging, echoing commands, or profiling.
+
+When called from inside a function with the @qcode{"local"} option, the
+variable is changed locally for the function and any subroutines it calls.
+The original variable value is restored when exiting the function.
+@seealso{__vm_compile__}
+@end deftypefn */)
+{
+  tree_evaluator& tw = interp.get_evaluator ();
+
+  return tw.vm_enable (args, nargout);
+}
+
+DEFMETHOD (__vm_compile__, interp, args, ,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{status} =} __vm_compile__ (@var{fcn_name})
+@deftypefnx {} {@var{status} =} __vm_compile__ (@var{fcn_name}, "print")
+@deftypefnx {} {@var{status} =} __vm_compile__ (@var{fcn_name}, "clear")
+Compile the user function @var{fcn_name} to bytecode and execute it with the
+bytecode VM even if @code{__vm_enable__} is false.
+
+Return true if the function could be compiled.  With the option
+@qcode{"print"}, also display the bytecode.  With the option
+@qcode{"clear"}, discard the bytecode and execute the function with the tree
+evaluator again.
+@seealso{__vm_enable__}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 1 || nargin > 2)
+    print_usage ();
+
+  std::string name
+    = args(0).xstring_value ("__vm_compile__: FCN_NAME must be a string");
+
+  std::string opt;
+
+  if (nargin == 2)
+    {
+      opt = args(1).xstring_value ("__vm_compile__: OPTION must be a string");
+
+      if (opt != "print" && opt != "clear")
+        error (R"(__vm_compile__: OPTION must be "print" or "clear")");
+    }
+
+  symbol_table& symtab = interp.get_symbol_table ();
+
+  octave_value fcn = symtab.find_function (name);
+
+  octave_user_function *ufcn
+    = fcn.is_defined () ? fcn.user_function_value (true) : nullptr;
+
+  if (! ufcn)
+    error ("__vm_compile__: '%s' is not a user function", name.c_str ());
+
+  if (opt == "clear")
+    {
+      ufcn->mark_for_vm (false);
+
+      return ovl (true);
+    }
+
+  if (! bytecode_compiler::can_compile (*ufcn))
+    return ovl (false);
+
+  std::shared_ptr<bytecode> code = ufcn->get_bytecode ();
+
+  if (! code)
+    {
+      code = bytecode_compiler::compile (*ufcn);
+
+      ufcn->stash_bytecode (code);
+    }
+
+  ufcn->mark_for_vm (true);
+
+  if (opt == "print")
+    code->print (octave_stdout);
+
+  return ovl (true);
+}
+
+/*
+%!function r = __vm_test_loops__ (n)
+%!  r = 0;
+%!  for i = 1:n
+%!    if (mod (i, 2) == 0)
+%!      continue;
+%!    elseif (r > 50)
+%!      break;
+%!    endif
+%!    r += i;
+%!  endfor
+%!  k = 0;
+%!  while (true)
+%!    k++;
+%!    if (k >= n || ! (k < 100 && r > 0))
+%!      break;
+%!    endif
+%!  endwhile
+%!  do
+%!    k -= 3;
+%!  until (k < 0)
+%!  for c = [1, 2; 3, 4]
+%!    r(end+1) = c(2) - c(1);
+%!  endfor
+%!  for s = {"a", "b"}
+%!    switch (s{1})
+%!      case "a"
+%!        continue;
+%!      otherwise
+%!        break;
+%!    endswitch
+%!  endfor
+%!  r = [r, k, -i, numel(s)];
+%!endfunction
+
+%!function y = __vm_test_index__ (x)
+%!  y = zeros (size (x));
+%!  for i = 1:numel (x)
+%!    y(i) = x(i) * 2 + x(end) - x(numel (x) - i + 1);
+%!  endfor
+%!  c = {1, 2};
+%!  y(end+1) = c{2};
+%!  y(1,1) = y(1) + y(2);
+%!endfunction
+
+%!function __vm_test_oob__ (x)
+%!  y = x(10);
+%!endfunction
+
+%!function __vm_test_noval__ ()
+%!endfunction
+
+%!function __vm_test_cond__ ()
+%!  if (__vm_test_noval__ ())
+%!  endif
+%!endfunction
+
+%!test
+%! x = [3, -1, 4, 1, 5];
+%! old_state = __vm_enable__ (false);
+%! unwind_protect
+%!   r1 = __vm_test_loops__ (20);
+%!   y1 = __vm_test_index__ (x);
+%!   __vm_enable__ (true);
+%!   r2 = __vm_test_loops__ (20);
+%!   y2 = __vm_test_index__ (x);
+%! unwind_protect_cleanup
+%!   __vm_enable__ (old_state);
+%! end_unwind_protect
+%! assert (r2, r1);
+%! assert (y2, y1);
+
+%!test
+%! assert (__vm_compile__ ("__vm_test_loops__"));
+%! unwind_protect
+%!   assert (__vm_test_loops__ (5), [9, 2, 2, -1, -5, 1]);
+%! unwind_protect_cleanup
+%!   __vm_compile__ ("__vm_test_loops__", "clear");
+%! end_unwind_protect
+
+%!error <x\(10\): out of bound 3>
+%! __vm_compile__ ("__vm_test_oob__");
+%! __vm_test_oob__ ([1, 2, 3]);
+
+%!error <if: undefined value used in conditional expression>
+%! __vm_compile__ ("__vm_test_cond__");
+%! __vm_test_cond__ ();
+
+%!error <Invalid call> __vm_compile__ ()
+%!error <not a user function> __vm_compile__ ("sin")
+%!error <OPTION must be> __vm_compile__ ("__vm_test_loops__", "foo")
+
+%!test
+%! orig_val = __vm_enable__ ();
+%! old_val = __vm_enable__ (! orig_val);
+%! assert (orig_val, old_val);
+%! assert (__vm_enable__ (), ! orig_val);
+%! __vm_enable__ (orig_val);
+%! assert (__vm_enable__ (), orig_val);
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,953 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <ostream>
+
+#include "ov-usr-fcn.h"
+#include "pt-all.h"
+#include "pt-bytecode.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+static const char *
+opcode_name (bc_opcode op)
+{
+  switch (op)
+    {
+    case bc_opcode::STMT: return "STMT";
+    case bc_opcode::LOCATION: return "LOCATION";
+    case bc_opcode::LOAD_CONST: return "LOAD_CONST";
+    case bc_opcode::LOAD_VAR: return "LOAD_VAR";
+    case bc_opcode::LOAD_INDEXABLE: return "LOAD_INDEXABLE";
+    case bc_opcode::INDEX: return "INDEX";
+    case bc_opcode::EVAL_EXPR: return "EVAL_EXPR";
+    case bc_opcode::EVAL_STMT: return "EVAL_STMT";
+    case bc_opcode::BINARY_OP: return "BINARY_OP";
+    case bc_opcode::UNARY_OP: return "UNARY_OP";
+    case bc_opcode::TO_BOOL: return "TO_BOOL";
+    case bc_opcode::JMP: return "JMP";
+    case bc_opcode::LOOP_JMP: return "LOOP_JMP";
+    case bc_opcode::JMP_IF_FALSE: return "JMP_IF_FALSE";
+    case bc_opcode::JMP_IF_TRUE: return "JMP_IF_TRUE";
+    case bc_opcode::JMP_IF_UNDEF: return "JMP_IF_UNDEF";
+    case bc_opcode::COND: return "COND";
+    case bc_opcode::ASSIGN: return "ASSIGN";
+    case bc_opcode::ASSIGN_INDEX: return "ASSIGN_INDEX";
+    case bc_opcode::LOOP_ENTER: return "LOOP_ENTER";
+    case bc_opcode::LOOP_EXIT: return "LOOP_EXIT";
+    case bc_opcode::FOR_SETUP: return "FOR_SETUP";
+    case bc_opcode::FOR_NEXT: return "FOR_NEXT";
+    case bc_opcode::CLEAR: return "CLEAR";
+    case bc_opcode::RETURN: return "RETURN";
+    }
+
+  return "<unknown>";
+}
+
+void
+bytecode::print (std::ostream& os) const
+{
+  os << "bytecode for " << m_name << ": "
+     << m_code.size () << " instructions, "
+     << m_num_registers << " registers\n";
+
+  for (std::size_t i = 0; i < m_code.size (); i++)
+    {
+      const bc_instr& instr = m_code[i];
+
+      os << "  " << i << ": " << opcode_name (instr.op)
+         << ' ' << instr.a << ' ' << instr.b
+         << ' ' << instr.c << ' ' << instr.d;
+
+      switch (instr.op)
+        {
+        case bc_opcode::LOAD_VAR:
+        case bc_opcode::LOAD_INDEXABLE:
+          os << "  # " << m_symbols[instr.b].name ();
+          break;
+
+        case bc_opcode::ASSIGN:
+        case bc_opcode::ASSIGN_INDEX:
+        case bc_opcode::FOR_SETUP:
+        case bc_opcode::FOR_NEXT:
+          os << "  # "
+             << m_symbols[instr.op == bc_opcode::ASSIGN
+                          || instr.op == bc_opcode::ASSIGN_INDEX
+                          ? instr.a : instr.d].name ();
+          break;
+
+        case bc_opcode::EVAL_STMT:
+          os << "  # line " << m_stmts[instr.a]->line ();
+          break;
+
+        default:
+          break;
+        }
+
+      os << "\n";
+    }
+}
+
+bytecode_compiler::bytecode_compiler (bytecode& code)
+  : m_code (code), m_stmt (nullptr), m_dst (0), m_nargout (1),
+    m_next_register (0), m_loops ()
+{ }
+
+bool
+bytecode_compiler::can_compile (octave_user_function& fcn)
+{
+  // Nested functions and their parents share variables through access
+  // links and anonymous functions are single expressions, so leave
+  // them to the tree evaluator.
+
+  return (fcn.body () && ! fcn.is_special_expr ()
+          && ! fcn.is_nested_function () && ! fcn.is_parent_function ());
+}
+
+std::shared_ptr<bytecode>
+bytecode_compiler::compile (octave_user_function& fcn)
+{
+  std::shared_ptr<bytecode> code (new bytecode (fcn.name ()));
+
+  bytecode_compiler compiler (*code);
+
+  compiler.compile_statements (fcn.body ());
+
+  compiler.emit (bc_opcode::RETURN);
+
+  return code;
+}
+
+void
+bytecode_compiler::visit_statement_list (tree_statement_list& lst)
+{
+  for (tree_statement *elt : lst)
+    {
+      if (! elt)
+        error ("invalid statement found in statement list!");
+
+      elt->accept (*this);
+    }
+}
+
+void
+bytecode_compiler::visit_statement (tree_statement& stmt)
+{
+  m_stmt = &stmt;
+
+  tree_command *cmd = stmt.command ();
+  tree_expression *expr = stmt.expression ();
+
+  if (cmd)
+    cmd->accept (*this);
+  else if (expr)
+    {
+      // Assignments are the only expression statements that are
+      // compiled.  All others may need to bind ANS or print results
+      // and are left to the tree evaluator.
+
+      tree_simple_assignment *asgn
+        = dynamic_cast<tree_simple_assignment *> (expr);
+
+      if (! (asgn && ! asgn->print_result () && compile_assignment (*asgn)))
+        compile_delegated_statement ();
+    }
+}
+
+void
+bytecode_compiler::visit_if_command (tree_if_command& cmd)
+{
+  emit (bc_opcode::STMT, m_stmt->line (), m_stmt->column ());
+
+  std::vector<int> end_jumps;
+
+  tree_if_command_list *lst = cmd.cmd_list ();
+
+  if (lst)
+    {
+      for (tree_if_clause *tic : *lst)
+        {
+          if (tic->is_else_clause ())
+            {
+              compile_statements (tic->commands ());
+              break;
+            }
+
+          std::vector<int> next_clause;
+
+          compile_condition (tic->condition (), BC_COND_IF, false,
+                             next_clause);
+
+          compile_statements (tic->commands ());
+
+          end_jumps.push_back (emit (bc_opcode::JMP, -1));
+
+          for (int j : next_clause)
+            m_code.m_code[j].b = here ();
+        }
+    }
+
+  for (int j : end_jumps)
+    m_code.m_code[j].a = here ();
+}
+
+void
+bytecode_compiler::visit_while_command (tree_while_command& cmd)
+{
+  emit (bc_opcode::STMT, m_stmt->line (), m_stmt->column ());
+
+  emit (bc_opcode::LOOP_ENTER);
+
+  begin_loop ();
+
+  int top = here ();
+
+  std::vector<int> exit_jumps;
+
+  compile_condition (cmd.condition (), BC_COND_WHILE, false, exit_jumps);
+
+  compile_statements (cmd.body ());
+
+  emit (bc_opcode::LOOP_JMP, top);
+
+  int end = here ();
+
+  for (int j : exit_jumps)
+    m_code.m_code[j].b = end;
+
+  end_loop (top, end);
+
+  emit (bc_opcode::LOOP_EXIT, ! m_loops.empty ());
+}
+
+void
+bytecode_compiler::visit_do_until_command (tree_do_until_command& cmd)
+{
+  emit (bc_opcode::STMT, m_stmt->line (), m_stmt->column ());
+
+  emit (bc_opcode::LOOP_ENTER);
+
+  begin_loop ();
+
+  int top = here ();
+
+  compile_statements (cmd.body ());
+
+  int cond = here ();
+
+  std::vector<int> repeat_jumps;
+
+  compile_condition (cmd.condition (), BC_COND_DO_UNTIL, false,
+                     repeat_jumps);
+
+  for (int j : repeat_jumps)
+    m_code.m_code[j].b = top;
+
+  int end = here ();
+
+  end_loop (cond, end);
+
+  emit (bc_opcode::LOOP_EXIT, ! m_loops.empty ());
+}
+
+void
+bytecode_compiler::visit_simple_for_command (tree_simple_for_command& cmd)
+{
+  tree_expression *lhs = cmd.left_hand_side ();
+
+  tree_identifier *id = (lhs && lhs->is_identifier ()
+                         ? dynamic_cast<tree_identifier *> (lhs) : nullptr);
+
+  symbol_record sym;
+
+  if (cmd.in_parallel () || ! id || id->is_black_hole ()
+      || ! local_symbol (id, sym) || sym.is_added_static ())
+    {
+      compile_delegated_statement ();
+      return;
+    }
+
+  emit (bc_opcode::STMT, m_stmt->line (), m_stmt->column ());
+
+  emit (bc_opcode::LOOP_ENTER);
+
+  int reg = alloc_register ();
+
+  compile_expression (cmd.control_expr (), reg);
+
+  int loop = m_code.m_num_loops++;
+  int slot = add_symbol (sym);
+
+  int setup = emit (bc_opcode::FOR_SETUP, reg, loop, -1, slot);
+
+  begin_loop ();
+
+  int next = emit (bc_opcode::FOR_NEXT, reg, loop, -1, slot);
+
+  compile_statements (cmd.body ());
+
+  emit (bc_opcode::LOOP_JMP, next);
+
+  int end = here ();
+
+  m_code.m_code[setup].c = end;
+  m_code.m_code[next].c = end;
+
+  end_loop (next, end);
+
+  emit (bc_opcode::LOOP_EXIT, ! m_loops.empty ());
+
+  emit (bc_opcode::CLEAR, reg);
+
+  free_register (reg);
+}
+
+void
+bytecode_compiler::visit_break_command (tree_break_command&)
+{
+  if (m_loops.empty ())
+    compile_delegated_statement ();
+  else
+    {
+      emit (bc_opcode::STMT, m_stmt->line (), m_stmt->column ());
+
+      m_loops.back ().break_jumps.push_back (emit (bc_opcode::JMP, -1));
+    }
+}
+
+void
+bytecode_compiler::visit_continue_command (tree_continue_command&)
+{
+  if (m_loops.empty ())
+    compile_delegated_statement ();
+  else
+    {
+      emit (bc_opcode::STMT, m_stmt->line (), m_stmt->column ());
+
+      m_loops.back ().continue_jumps.push_back (emit (bc_opcode::JMP, -1));
+    }
+}
+
+void
+bytecode_compiler::visit_return_command (tree_return_command&)
+{
+  emit (bc_opcode::STMT, m_stmt->line (), m_stmt->column ());
+
+  emit (bc_opcode::RETURN);
+}
+
+void
+bytecode_compiler::visit_arguments_block (tree_arguments_block&)
+{
+  compile_delegated_statement ();
+}
+
+void
+bytecode_compiler::visit_complex_for_command (tree_complex_for_command&)
+{
+  compile_delegated_statement ();
+}
+
+void
+bytecode_compiler::visit_decl_command (tree_decl_command&)
+{
+  compile_delegated_statement ();
+}
+
+void
+bytecode_compiler::visit_function_def (tree_function_def&)
+{
+  compile_delegated_statement ();
+}
+
+void
+bytecode_compiler::visit_no_op_command (tree_no_op_command&)
+{
+  compile_delegated_statement ();
+}
+
+void
+bytecode_compiler::visit_spmd_command (tree_spmd_command&)
+{
+  compile_delegated_statement ();
+}
+
+void
+bytecode_compiler::visit_switch_command (tree_switch_command&)
+{
+  compile_delegated_statement ();
+}
+
+void
+bytecode_compiler::visit_try_catch_command (tree_try_catch_command&)
+{
+  compile_delegated_statement ();
+}
+
+void
+bytecode_compiler::visit_unwind_protect_command (tree_unwind_protect_command&)
+{
+  compile_delegated_statement ();
+}
+
+void
+bytecode_compiler::visit_constant (tree_constant& expr)
+{
+  emit (bc_opcode::LOAD_CONST, m_dst, add_constant (expr.value ()));
+}
+
+void
+bytecode_compiler::visit_identifier (tree_identifier& expr)
+{
+  symbol_record sym;
+
+  // Identifiers that are not known to be variables are most likely
+  // function calls.  The tree evaluator checks for a variable first
+  // anyway, so it is safe to hand them over.
+
+  if (expr.is_black_hole () || ! local_symbol (&expr, sym)
+      || ! sym.is_variable ())
+    compile_delegated_expression (expr);
+  else
+    emit (bc_opcode::LOAD_VAR, m_dst, add_symbol (sym),
+          add_expression (&expr), m_nargout);
+}
+
+void
+bytecode_compiler::visit_binary_expression (tree_binary_expression& expr)
+{
+  tree_expression *op_lhs = expr.lhs ();
+  tree_expression *op_rhs = expr.rhs ();
+
+  if (expr.is_braindead () || ! op_lhs || ! op_rhs)
+    {
+      compile_delegated_expression (expr);
+      return;
+    }
+
+  int dst = m_dst;
+
+  compile_expression (op_lhs, dst, -1);
+
+  // The right hand side is not evaluated if the left hand side is
+  // undefined.
+
+  int skip = -1;
+
+  if (! op_lhs->is_constant ())
+    skip = emit (bc_opcode::JMP_IF_UNDEF, dst, -1);
+
+  int reg = alloc_register ();
+
+  compile_expression (op_rhs, reg, -1);
+
+  emit (bc_opcode::BINARY_OP, dst, dst, reg, expr.op_type ());
+
+  free_register (reg);
+
+  if (skip >= 0)
+    m_code.m_code[skip].b = here ();
+}
+
+void
+bytecode_compiler::visit_boolean_expression (tree_boolean_expression& expr)
+{
+  tree_expression *op_lhs = expr.lhs ();
+  tree_expression *op_rhs = expr.rhs ();
+
+  if (! op_lhs || ! op_rhs)
+    {
+      compile_delegated_expression (expr);
+      return;
+    }
+
+  int dst = m_dst;
+
+  compile_expression (op_lhs, dst);
+
+  emit (bc_opcode::TO_BOOL, dst);
+
+  int skip = emit (expr.op_type () == tree_boolean_expression::bool_or
+                   ? bc_opcode::JMP_IF_TRUE : bc_opcode::JMP_IF_FALSE,
+                   dst, -1);
+
+  compile_expression (op_rhs, dst);
+
+  emit (bc_opcode::TO_BOOL, dst);
+
+  m_code.m_code[skip].b = here ();
+}
+
+void
+bytecode_compiler::visit_prefix_expression (tree_prefix_expression& expr)
+{
+  octave_value::unary_op op = expr.op_type ();
+
+  tree_expression *operand = expr.operand ();
+
+  if (op == octave_value::op_incr || op == octave_value::op_decr
+      || ! operand)
+    compile_delegated_expression (expr);
+  else
+    {
+      int dst = m_dst;
+
+      compile_expression (operand, dst, -1);
+
+      emit (bc_opcode::UNARY_OP, dst, dst, op, true);
+    }
+}
+
+void
+bytecode_compiler::visit_postfix_expression (tree_postfix_expression& expr)
+{
+  octave_value::unary_op op = expr.op_type ();
+
+  tree_expression *operand = expr.operand ();
+
+  if (op == octave_value::op_incr || op == octave_value::op_decr
+      || ! operand)
+    compile_delegated_expression (expr);
+  else
+    {
+      int dst = m_dst;
+
+      compile_expression (operand, dst, -1);
+
+      emit (bc_opcode::UNARY_OP, dst, dst, op, false);
+    }
+}
+
+void
+bytecode_compiler::visit_index_expression (tree_index_expression& expr)
+{
+  symbol_record sym;
+
+  if (! simple_index_expression (expr, sym))
+    {
+      compile_delegated_expression (expr);
+      return;
+    }
+
+  // If the variable does not hold plain data at run time (it may be
+  // undefined, an object with its own subsref method, or a function
+  // handle), jump to the tree evaluator instead.
+
+  int dst = m_dst;
+  int nargout = m_nargout;
+
+  int check = emit (bc_opcode::LOAD_INDEXABLE, dst, add_symbol (sym), -1);
+
+  tree_argument_list *args = expr.arg_lists ().front ();
+
+  int first = m_next_register;
+
+  for (tree_expression *arg : *args)
+    compile_expression (arg, alloc_register ());
+
+  emit (bc_opcode::INDEX, dst, first, args->size (), add_expression (&expr));
+
+  free_register (first);
+
+  int done = emit (bc_opcode::JMP, -1);
+
+  m_code.m_code[check].c = here ();
+
+  emit (bc_opcode::EVAL_EXPR, dst, add_expression (&expr), nargout);
+
+  m_code.m_code[done].a = here ();
+}
+
+void
+bytecode_compiler::visit_anon_fcn_handle (tree_anon_fcn_handle& expr)
+{
+  compile_delegated_expression (expr);
+}
+
+void
+bytecode_compiler::visit_cell (tree_cell& expr)
+{
+  compile_delegated_expression (expr);
+}
+
+void
+bytecode_compiler::visit_colon_expression (tree_colon_expression& expr)
+{
+  compile_delegated_expression (expr);
+}
+
+void
+bytecode_compiler::visit_compound_binary_expression
+  (tree_compound_binary_expression& expr)
+{
+  compile_delegated_expression (expr);
+}
+
+void
+bytecode_compiler::visit_fcn_handle (tree_fcn_handle& expr)
+{
+  compile_delegated_expression (expr);
+}
+
+void
+bytecode_compiler::visit_matrix (tree_matrix& expr)
+{
+  compile_delegated_expression (expr);
+}
+
+void
+bytecode_compiler::visit_metaclass_query (tree_metaclass_query& expr)
+{
+  compile_delegated_expression (expr);
+}
+
+void
+bytecode_compiler::visit_multi_assignment (tree_multi_assignment& expr)
+{
+  compile_delegated_expression (expr);
+}
+
+void
+bytecode_compiler::visit_simple_assignment (tree_simple_assignment& expr)
+{
+  compile_delegated_expression (expr);
+}
+
+void
+bytecode_compiler::visit_superclass_ref (tree_superclass_ref& expr)
+{
+  compile_delegated_expression (expr);
+}
+
+int
+bytecode_compiler::emit (bc_opcode op, int a, int b, int c, int d)
+{
+  int retval = here ();
+
+  m_code.m_code.push_back ({op, a, b, c, d});
+
+  return retval;
+}
+
+int
+bytecode_compiler::add_constant (const octave_value& val)
+{
+  m_code.m_constants.push_back (val);
+
+  return m_code.m_constants.size () - 1;
+}
+
+int
+bytecode_compiler::add_expression (tree_expression *expr)
+{
+  m_code.m_exprs.push_back (expr);
+
+  return m_code.m_exprs.size () - 1;
+}
+
+int
+bytecode_compiler::add_statement (tree_statement *stmt)
+{
+  m_code.m_stmts.push_back (stmt);
+
+  return m_code.m_stmts.size () - 1;
+}
+
+int
+bytecode_compiler::add_symbol (const symbol_record& sym)
+{
+  std::size_t slot = sym.data_offset ();
+
+  if (slot >= m_code.m_symbols.size ())
+    m_code.m_symbols.resize (slot+1);
+
+  m_code.m_symbols[slot] = sym;
+
+  return slot;
+}
+
+int
+bytecode_compiler::alloc_register ()
+{
+  int retval = m_next_register++;
+
+  if (m_next_register > m_code.m_num_registers)
+    m_code.m_num_registers = m_next_register;
+
+  return retval;
+}
+
+// Registers are allocated in stack order.  Release REG and all
+// registers allocated after it.
+
+void
+bytecode_compiler::free_register (int reg)
+{
+  m_next_register = reg;
+}
+
+void
+bytecode_compiler::compile_statements (tree_statement_list *lst)
+{
+  if (lst)
+    lst->accept (*this);
+}
+
+void
+bytecode_compiler::compile_expression (tree_expression *expr, int dst,
+                                       int nargout)
+{
+  int saved_dst = m_dst;
+  int saved_nargout = m_nargout;
+
+  m_dst = dst;
+  m_nargout = nargout;
+
+  expr->accept (*this);
+
+  m_dst = saved_dst;
+  m_nargout = saved_nargout;
+}
+
+void
+bytecode_compiler::compile_delegated_statement ()
+{
+  int idx = emit (bc_opcode::EVAL_STMT, add_statement (m_stmt), -1, -1);
+
+  if (! m_loops.empty ())
+    m_loops.back ().delegated.push_back (idx);
+}
+
+void
+bytecode_compiler::compile_delegated_expression (tree_expression& expr)
+{
+  emit (bc_opcode::EVAL_EXPR, m_dst, add_expression (&expr), m_nargout);
+}
+
+void
+bytecode_compiler::compile_condition (tree_expression *expr, int kind,
+                                      bool jump_sense,
+                                      std::vector<int>& jumps)
+{
+  emit (bc_opcode::LOCATION, expr->line (), expr->column ());
+
+  int reg = alloc_register ();
+
+  compile_expression (expr, reg);
+
+  jumps.push_back (emit (bc_opcode::COND, reg, -1, kind, jump_sense));
+
+  free_register (reg);
+}
+
+void
+bytecode_compiler::begin_loop ()
+{
+  m_loops.push_back (loop_context ());
+}
+
+void
+bytecode_compiler::end_loop (int continue_target, int break_target)
+{
+  loop_context& ctx = m_loops.back ();
+
+  for (int j : ctx.break_jumps)
+    m_code.m_code[j].a = break_target;
+
+  for (int j : ctx.continue_jumps)
+    m_code.m_code[j].a = continue_target;
+
+  for (int j : ctx.delegated)
+    {
+      m_code.m_code[j].b = break_target;
+      m_code.m_code[j].c = continue_target;
+    }
+
+  m_loops.pop_back ();
+}
+
+bool
+bytecode_compiler::compile_assignment (tree_simple_assignment& expr)
+{
+  tree_expression *lhs = expr.left_hand_side ();
+  tree_expression *rhs = expr.right_hand_side ();
+
+  if (! lhs || ! rhs)
+    return false;
+
+  symbol_record sym;
+
+  if (lhs->is_identifier ())
+    {
+      tree_identifier *id = dynamic_cast<tree_identifier *> (lhs);
+
+      if (id->is_black_hole () || ! local_symbol (id, sym)
+          || sym.is_added_static ())
+        return false;
+
+      emit (bc_opcode::STMT, m_stmt->line (), m_stmt->column ());
+
+      int reg = alloc_register ();
+
+      compile_expression (rhs, reg);
+
+      emit (bc_opcode::ASSIGN, add_symbol (sym), reg, add_expression (&expr));
+
+      free_register (reg);
+
+      return true;
+    }
+  else if (lhs->is_index_expression ())
+    {
+      tree_index_expression *idx_expr
+        = dynamic_cast<tree_index_expression *> (lhs);
+
+      if (! simple_index_expression (*idx_expr, sym)
+          || sym.is_added_static ())
+        return false;
+
+      emit (bc_opcode::STMT, m_stmt->line (), m_stmt->column ());
+
+      // As in the tree evaluator, the indices are evaluated before
+      // the right hand side.
+
+      tree_argument_list *args = idx_expr->arg_lists ().front ();
+
+      int first = m_next_register;
+
+      for (tree_expression *arg : *args)
+        compile_expression (arg, alloc_register ());
+
+      compile_expression (rhs, alloc_register ());
+
+      emit (bc_opcode::ASSIGN_INDEX, add_symbol (sym), first, args->size (),
+            add_expression (&expr));
+
+      free_register (first);
+
+      return true;
+    }
+
+  return false;
+}
+
+bool
+bytecode_compiler::local_symbol (tree_identifier *id,
+                                 symbol_record& sym) const
+{
+  sym = id->symbol ();
+
+  return sym.is_valid () && sym.frame_offset () == 0;
+}
+
+// TRUE if EXPR may be evaluated as an argument of a compiled index
+// expression.  The magic END identifier needs the context of the
+// indexed object, so any argument that contains it is rejected.
+
+bool
+bytecode_compiler::simple_index_arg (tree_expression *expr) const
+{
+  if (! expr)
+    return false;
+
+  if (expr->is_constant ())
+    return true;
+
+  if (expr->is_identifier ())
+    {
+      tree_identifier *id = dynamic_cast<tree_identifier *> (expr);
+
+      return ! id->is_black_hole () && id->name () != "end";
+    }
+
+  if (expr->is_binary_expression ())
+    {
+      tree_binary_expression *be
+        = dynamic_cast<tree_binary_expression *> (expr);
+
+      return simple_index_arg (be->lhs ()) && simple_index_arg (be->rhs ());
+    }
+
+  if (expr->is_unary_expression ())
+    {
+      tree_unary_expression *ue
+        = dynamic_cast<tree_unary_expression *> (expr);
+
+      return simple_index_arg (ue->operand ());
+    }
+
+  if (expr->is_index_expression ())
+    {
+      tree_index_expression *ie
+        = dynamic_cast<tree_index_expression *> (expr);
+
+      symbol_record sym;
+
+      return simple_index_expression (*ie, sym);
+    }
+
+  return false;
+}
+
+// TRUE if EXPR is of the form VAR(ARGS) with a single level of
+// parenthesis indexing applied to a local variable.
+
+bool
+bytecode_compiler::simple_index_expression (tree_index_expression& expr,
+                                            symbol_record& sym) const
+{
+  if (expr.is_word_list_cmd () || expr.type_tags () != "(")
+    return false;
+
+  tree_expression *base = expr.expression ();
+
+  if (! base || ! base->is_identifier ())
+    return false;
+
+  tree_identifier *id = dynamic_cast<tree_identifier *> (base);
+
+  if (id->is_black_hole () || ! local_symbol (id, sym)
+      || ! sym.is_variable ())
+    return false;
+
+  tree_argument_list *args = expr.arg_lists ().front ();
+
+  if (! args || args->empty ())
+    return false;
+
+  for (tree_expression *arg : *args)
+    {
+      if (! simple_index_arg (arg))
+        return false;
+    }
+
+  return true;
+}
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,479 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_pt_bytecode_h)
+#define octave_pt_bytecode_h 1
+
+#include "octave-config.h"
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Range.h"
+
+#include "ov.h"
+#include "ovl.h"
+#include "pt-walk.h"
+#include "symrec.h"
+
+class octave_user_function;
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+class stack_frame;
+class tree_evaluator;
+class tree_expression;
+class tree_statement;
+class tree_statement_list;
+class type_info;
+
+// Instruction set of the bytecode VM.
+//
+// The VM is register based.  Registers hold temporary values and
+// every value stored in a register is consumed exactly once by the
+// instruction that uses it, so registers never hold extra references
+// to variables that are about to be modified.  Variables are not
+// copied into registers but live in the stack frame, where they are
+// addressed by slot.  The slot of a variable is the data offset of
+// its symbol record.
+//
+// Anything the compiler does not handle natively is evaluated by the
+// tree evaluator, either one expression (EVAL_EXPR) or one complete
+// statement (EVAL_STMT) at a time.
+
+enum class bc_opcode : unsigned char
+{
+  // Set the current location, then check for interrupts.
+  // a: line, b: column
+  STMT,
+
+  // Set the current location.
+  // a: line, b: column
+  LOCATION,
+
+  // a: dst register, b: constant index
+  LOAD_CONST,
+
+  // Load a variable.  If the variable is undefined, evaluate the
+  // identifier with the tree evaluator (which may call a function).
+  // a: dst register, b: slot, c: expression index, d: nargout
+  LOAD_VAR,
+
+  // Load a variable that is about to be indexed.  Jump to the target
+  // if the variable is undefined or is not plain data (numeric,
+  // logical, char, cell, or struct).
+  // a: dst register, b: slot, c: jump target
+  LOAD_INDEXABLE,
+
+  // Index the value in register a with the values in registers
+  // a+1 ... a+b and store the result in register a.
+  // a: register, b: number of indices, c: expression index
+  INDEX,
+
+  // Evaluate an expression with the tree evaluator.
+  // a: dst register, b: expression index, c: nargout
+  EVAL_EXPR,
+
+  // Execute a statement with the tree evaluator.
+  // a: statement index, b: break target, c: continue target
+  // (-1 if the statement is not in a compiled loop)
+  EVAL_STMT,
+
+  // a: dst register, b: lhs register, c: rhs register,
+  // d: octave_value::binary_op
+  BINARY_OP,
+
+  // a: dst register, b: operand register, c: octave_value::unary_op,
+  // d: nonzero for prefix operators
+  UNARY_OP,
+
+  // Replace the value in register a by its logical value.
+  // a: register
+  TO_BOOL,
+
+  // a: jump target
+  JMP,
+
+  // Jump target and check for interrupts.  Used for loop back edges.
+  // a: jump target
+  LOOP_JMP,
+
+  // a: register, b: jump target
+  JMP_IF_FALSE,
+
+  // a: register, b: jump target
+  JMP_IF_TRUE,
+
+  // a: register, b: jump target
+  JMP_IF_UNDEF,
+
+  // Evaluate the condition of an if, while, or do-until command.
+  // Jump if the value of the condition matches d.
+  // a: register, b: jump target, c: command kind, d: jump sense
+  COND,
+
+  // a: slot, b: rhs register, c: expression index
+  ASSIGN,
+
+  // Indexed assignment, VAR(IDX...) OP= RHS.  The indices are in
+  // registers b ... b+c-1, the right hand side in register b+c.
+  // a: slot, b: first register, c: number of indices,
+  // d: expression index
+  ASSIGN_INDEX,
+
+  // Start executing a compiled loop.
+  LOOP_ENTER,
+
+  // Finish executing a compiled loop.
+  // a: nonzero if still inside an enclosing compiled loop
+  LOOP_EXIT,
+
+  // Prepare iteration over the value in register a.  Jump to the end
+  // of the loop if there is nothing to do.
+  // a: register, b: loop index, c: jump target, d: slot
+  FOR_SETUP,
+
+  // Assign the next value to the loop variable or jump to the end of
+  // the loop.
+  // a: register, b: loop index, c: jump target, d: slot
+  FOR_NEXT,
+
+  // a: register
+  CLEAR,
+
+  RETURN
+};
+
+// Kind of command for the COND instruction.
+
+enum bc_cond_kind
+{
+  BC_COND_IF,
+  BC_COND_WHILE,
+  BC_COND_DO_UNTIL
+};
+
+struct bc_instr
+{
+  bc_opcode op;
+  int a;
+  int b;
+  int c;
+  int d;
+};
+
+class bytecode
+{
+public:
+
+  friend class bytecode_compiler;
+
+  bytecode (const std::string& name)
+    : m_name (name), m_code (), m_constants (), m_symbols (),
+      m_exprs (), m_stmts (), m_num_registers (0), m_num_loops (0)
+  { }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (bytecode)
+
+  ~bytecode () = default;
+
+  std::string name () const { return m_name; }
+
+  const std::vector<bc_instr>& code () const { return m_code; }
+
+  const octave_value& constant (int k) const { return m_constants[k]; }
+
+  const symbol_record& symbol (int slot) const { return m_symbols[slot]; }
+
+  tree_expression * expression (int k) const { return m_exprs[k]; }
+
+  tree_statement * statement (int k) const { return m_stmts[k]; }
+
+  int num_registers () const { return m_num_registers; }
+
+  int num_loops () const { return m_num_loops; }
+
+  void print (std::ostream& os) const;
+
+private:
+
+  std::string m_name;
+
+  std::vector<bc_instr> m_code;
+
+  std::vector<octave_value> m_constants;
+
+  // Symbol records indexed by slot (data offset).
+  std::vector<symbol_record> m_symbols;
+
+  // Parse tree nodes that are handed to the tree evaluator.  They are
+  // owned by the function that the bytecode was compiled from.
+  std::vector<tree_expression *> m_exprs;
+  std::vector<tree_statement *> m_stmts;
+
+  int m_num_registers;
+
+  int m_num_loops;
+};
+
+// Translate the body of a user function to bytecode.
+
+class bytecode_compiler : public tree_walker
+{
+public:
+
+  OCTAVE_DISABLE_COPY_MOVE (bytecode_compiler)
+
+  ~bytecode_compiler () = default;
+
+  // TRUE if the function body may be executed by the VM.
+  static bool can_compile (octave_user_function& fcn);
+
+  static std::shared_ptr<bytecode> compile (octave_user_function& fcn);
+
+  void visit_statement_list (tree_statement_list&);
+
+  void visit_statement (tree_statement&);
+
+  void visit_if_command (tree_if_command&);
+
+  void visit_while_command (tree_while_command&);
+
+  void visit_do_until_command (tree_do_until_command&);
+
+  void visit_simple_for_command (tree_simple_for_command&);
+
+  void visit_break_command (tree_break_command&);
+
+  void visit_continue_command (tree_continue_command&);
+
+  void visit_return_command (tree_return_command&);
+
+  // Commands executed by the tree evaluator.
+
+  void visit_arguments_block (tree_arguments_block&);
+
+  void visit_complex_for_command (tree_complex_for_command&);
+
+  void visit_decl_command (tree_decl_command&);
+
+  void visit_function_def (tree_function_def&);
+
+  void visit_no_op_command (tree_no_op_command&);
+
+  void visit_spmd_command (tree_spmd_command&);
+
+  void visit_switch_command (tree_switch_command&);
+
+  void visit_try_catch_command (tree_try_catch_command&);
+
+  void visit_unwind_protect_command (tree_unwind_protect_command&);
+
+  // Expressions.
+
+  void visit_constant (tree_constant&);
+
+  void visit_identifier (tree_identifier&);
+
+  void visit_binary_expression (tree_binary_expression&);
+
+  void visit_boolean_expression (tree_boolean_expression&);
+
+  void visit_prefix_expression (tree_prefix_expression&);
+
+  void visit_postfix_expression (tree_postfix_expression&);
+
+  void visit_index_expression (tree_index_expression&);
+
+  // Expressions evaluated by the tree evaluator.
+
+  void visit_anon_fcn_handle (tree_anon_fcn_handle&);
+
+  void visit_cell (tree_cell&);
+
+  void visit_colon_expression (tree_colon_expression&);
+
+  void visit_compound_binary_expression (tree_compound_binary_expression&);
+
+  void visit_fcn_handle (tree_fcn_handle&);
+
+  void visit_matrix (tree_matrix&);
+
+  void visit_metaclass_query (tree_metaclass_query&);
+
+  void visit_multi_assignment (tree_multi_assignment&);
+
+  void visit_simple_assignment (tree_simple_assignment&);
+
+  void visit_superclass_ref (tree_superclass_ref&);
+
+private:
+
+  // Jump targets of the innermost compiled loop.  Break and continue
+  // jumps and delegated statements (which may execute BREAK or
+  // CONTINUE) are recorded so they can be patched once the loop is
+  // complete.
+
+  struct loop_context
+  {
+    std::vector<int> break_jumps;
+    std::vector<int> continue_jumps;
+    std::vector<int> delegated;
+  };
+
+  bytecode_compiler (bytecode& code);
+
+  int emit (bc_opcode op, int a = 0, int b = 0, int c = 0, int d = 0);
+
+  int here () const { return m_code.m_code.size (); }
+
+  int add_constant (const octave_value& val);
+
+  int add_expression (tree_expression *expr);
+
+  int add_statement (tree_statement *stmt);
+
+  int add_symbol (const symbol_record& sym);
+
+  int alloc_register ();
+
+  void free_register (int reg);
+
+  void compile_statements (tree_statement_list *lst);
+
+  void compile_expression (tree_expression *expr, int dst, int nargout = 1);
+
+  void compile_delegated_statement ();
+
+  void compile_delegated_expression (tree_expression& expr);
+
+  void compile_condition (tree_expression *expr, int kind,
+                          bool jump_sense, std::vector<int>& jumps);
+
+  void begin_loop ();
+
+  void end_loop (int continue_target, int break_target);
+
+  bool compile_assignment (tree_simple_assignment& expr);
+
+  bool local_symbol (tree_identifier *id, symbol_record& sym) const;
+
+  bool simple_index_arg (tree_expression *expr) const;
+
+  bool simple_index_expression (tree_index_expression& expr,
+                                symbol_record& sym) const;
+
+  bytecode& m_code;
+
+  // The statement currently being compiled.
+  tree_statement *m_stmt;
+
+  // Destination register and number of outputs for the expression
+  // currently being compiled.
+  int m_dst;
+  int m_nargout;
+
+  int m_next_register;
+
+  std::vector<loop_context> m_loops;
+};
+
+// Execute bytecode in the current stack frame.
+
+class bytecode_vm
+{
+public:
+
+  bytecode_vm (tree_evaluator& tw, const bytecode& code);
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (bytecode_vm)
+
+  ~bytecode_vm () = default;
+
+  void execute ();
+
+private:
+
+  // Iteration state for a compiled FOR loop.
+
+  struct for_state
+  {
+  public:
+
+    enum kind_type { RANGE, SCALAR, COLUMNS };
+
+    for_state ()
+      : m_kind (SCALAR), m_count (0), m_steps (0), m_range (),
+        m_idx (), m_iidx (0)
+    { }
+
+    kind_type m_kind;
+    octave_idx_type m_count;
+    octave_idx_type m_steps;
+    range<double> m_range;
+    octave_value_list m_idx;
+    octave_idx_type m_iidx;
+  };
+
+  octave_value take (int reg)
+  {
+    octave_value retval = std::move (m_registers[reg]);
+    m_registers[reg] = octave_value ();
+    return retval;
+  }
+
+  bool for_setup (const bc_instr& instr);
+
+  bool for_next (const bc_instr& instr);
+
+  void assign (const bc_instr& instr);
+
+  void assign_index (const bc_instr& instr);
+
+  void index (const bc_instr& instr);
+
+  bool eval_statement (const bc_instr& instr, int& pc);
+
+  tree_evaluator& m_tw;
+
+  const bytecode& m_code;
+
+  stack_frame& m_frame;
+
+  type_info& m_ti;
+
+  std::vector<octave_value> m_registers;
+
+  std::vector<for_state> m_for_states;
+
+  // Value of the in-loop flag of the evaluator when the VM started.
+  bool m_in_loop_command;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
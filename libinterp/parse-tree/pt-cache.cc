@@ -0,0 +1,2646 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <list>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "file-ops.h"
+#include "file-stat.h"
+#include "lo-sysdep.h"
+#include "mach-info.h"
+#include "mkostemp-wrapper.h"
+#include "oct-env.h"
+#include "oct-time.h"
+#include "unistd-wrappers.h"
+
+#include "comment-list.h"
+#include "error.h"
+#include "interpreter.h"
+#include "interpreter-private.h"
+#include "ov-magic-int.h"
+#include "ov-null-mat.h"
+#include "ov-typeinfo.h"
+#include "ov-usr-fcn.h"
+#include "pt-all.h"
+#include "pt-cache.h"
+#include "symscope.h"
+#include "version.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// The cache file starts with a header that identifies the format and
+// the source file, followed by the parse tree of the script or of the
+// primary function and its subfunctions.
+//
+// Integers are stored as variable length sequences of 7-bit groups
+// (signed values are zigzag encoded first) and strings as their length
+// followed by the characters.  Each node of the tree starts with a tag
+// byte, with 0 standing for a null pointer.  Constant values other than
+// a few special cases are stored in the format of Octave's binary data
+// files.  Identifiers are stored by name and refer to the symbol table
+// of the enclosing function, which is stored first.
+
+static const char *s_magic = "Octave parse tree cache";
+
+static const uint64_t s_format_version = 1;
+
+static const uint32_t s_byte_order_mark = 0x01020304;
+
+enum parse_tree_cache_tag
+{
+  ptc_null = 0,
+
+  // Expressions.
+  ptc_anon_fcn_handle,
+  ptc_binary,
+  ptc_black_hole,
+  ptc_boolean,
+  ptc_braindead_binary,
+  ptc_cell,
+  ptc_colon,
+  ptc_constant,
+  ptc_fcn_handle,
+  ptc_identifier,
+  ptc_index,
+  ptc_matrix,
+  ptc_metaclass_query,
+  ptc_multi_assignment,
+  ptc_postfix,
+  ptc_prefix,
+  ptc_simple_assignment,
+  ptc_superclass_ref,
+
+  // Commands.
+  ptc_arguments_block,
+  ptc_break,
+  ptc_complex_for,
+  ptc_continue,
+  ptc_decl,
+  ptc_do_until,
+  ptc_if,
+  ptc_no_op,
+  ptc_return,
+  ptc_simple_for,
+  ptc_spmd,
+  ptc_switch,
+  ptc_try_catch,
+  ptc_unwind_protect,
+  ptc_while
+};
+
+enum parse_tree_cache_value
+{
+  ptc_binary_data = 0,
+  ptc_magic_colon,
+  ptc_null_matrix,
+  ptc_null_str,
+  ptc_null_sq_str,
+  ptc_magic_int,
+  ptc_magic_uint
+};
+
+enum parse_tree_cache_code
+{
+  ptc_function_file = 'F',
+  ptc_script_file = 'S'
+};
+
+// Write parse trees.  Anything that can not be represented in the cache
+// clears the OK flag and the result is discarded.
+
+class tree_cache_writer : public tree_walker
+{
+public:
+
+  tree_cache_writer (std::ostream& os)
+    : m_os (os), m_ok (true), m_scopes ()
+  { }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (tree_cache_writer)
+
+  ~tree_cache_writer () = default;
+
+  bool ok () const { return m_ok && m_os.good (); }
+
+  void write_header (const std::string& key, const sys::file_stat& fs);
+
+  void write_fcn_file (octave_user_function& fcn);
+
+  void write_script_file (octave_user_script& script);
+
+  void visit_anon_fcn_handle (tree_anon_fcn_handle&);
+
+  void visit_arguments_block (tree_arguments_block&);
+
+  void visit_binary_expression (tree_binary_expression&);
+
+  void visit_boolean_expression (tree_boolean_expression&);
+
+  void visit_compound_binary_expression (tree_compound_binary_expression&);
+
+  void visit_break_command (tree_break_command&);
+
+  void visit_colon_expression (tree_colon_expression&);
+
+  void visit_continue_command (tree_continue_command&);
+
+  void visit_decl_command (tree_decl_command&);
+
+  void visit_simple_for_command (tree_simple_for_command&);
+
+  void visit_complex_for_command (tree_complex_for_command&);
+
+  void visit_spmd_command (tree_spmd_command&);
+
+  void visit_function_def (tree_function_def&) { m_ok = false; }
+
+  void visit_identifier (tree_identifier&);
+
+  void visit_if_command (tree_if_command&);
+
+  void visit_switch_command (tree_switch_command&);
+
+  void visit_index_expression (tree_index_expression&);
+
+  void visit_matrix (tree_matrix&);
+
+  void visit_cell (tree_cell&);
+
+  void visit_multi_assignment (tree_multi_assignment&);
+
+  void visit_no_op_command (tree_no_op_command&);
+
+  void visit_constant (tree_constant&);
+
+  void visit_fcn_handle (tree_fcn_handle&);
+
+  void visit_postfix_expression (tree_postfix_expression&);
+
+  void visit_prefix_expression (tree_prefix_expression&);
+
+  void visit_return_command (tree_return_command&);
+
+  void visit_simple_assignment (tree_simple_assignment&);
+
+  void visit_statement (tree_statement&);
+
+  void visit_try_catch_command (tree_try_catch_command&);
+
+  void visit_unwind_protect_command (tree_unwind_protect_command&);
+
+  void visit_while_command (tree_while_command&);
+
+  void visit_do_until_command (tree_do_until_command&);
+
+  void visit_superclass_ref (tree_superclass_ref&);
+
+  void visit_metaclass_query (tree_metaclass_query&);
+
+  void visit_classdef (tree_classdef&) { m_ok = false; }
+
+private:
+
+  void put_byte (unsigned char c) { m_os.put (static_cast<char> (c)); }
+
+  void put_uint (uint64_t val)
+  {
+    while (val >= 0x80)
+      {
+        put_byte (static_cast<unsigned char> (val | 0x80));
+        val >>= 7;
+      }
+
+    put_byte (static_cast<unsigned char> (val));
+  }
+
+  void put_int (int64_t val)
+  {
+    uint64_t uval = static_cast<uint64_t> (val);
+
+    put_uint (val < 0 ? ~(uval << 1) : uval << 1);
+  }
+
+  void put_bool (bool val) { put_byte (val ? 1 : 0); }
+
+  void put_string (const std::string& s)
+  {
+    put_uint (s.length ());
+    m_os.write (s.data (), s.length ());
+  }
+
+  void put_expr_header (parse_tree_cache_tag tag, tree_expression& expr);
+
+  void put_cmd_header (parse_tree_cache_tag tag, tree_command& cmd);
+
+  void put_expr (tree_expression *expr);
+
+  void put_statement_list (tree_statement_list *lst);
+
+  void put_argument_list (tree_argument_list *lst);
+
+  void put_parameter_list (tree_parameter_list *lst);
+
+  void put_decl_elt (tree_decl_elt *elt);
+
+  void put_comment_list (comment_list *lst);
+
+  void put_scope (const symbol_scope& scope);
+
+  void put_value (const octave_value& val);
+
+  void put_function (octave_user_function& fcn);
+
+  std::ostream& m_os;
+
+  bool m_ok;
+
+  // The scopes of the functions that are being written.  Identifiers
+  // refer to the innermost one.
+  std::vector<symbol_scope> m_scopes;
+};
+
+void
+tree_cache_writer::write_header (const std::string& key,
+                                 const sys::file_stat& fs)
+{
+  put_string (s_magic);
+  put_uint (s_format_version);
+
+  put_byte (static_cast<unsigned char> (mach_info::native_float_format ()));
+  m_os.write (reinterpret_cast<const char *> (&s_byte_order_mark),
+              sizeof (s_byte_order_mark));
+
+  put_string (key);
+  put_int (fs.mtime ().unix_time ());
+  put_int (fs.size ());
+}
+
+void
+tree_cache_writer::write_fcn_file (octave_user_function& fcn)
+{
+  put_byte (ptc_function_file);
+
+  put_function (fcn);
+
+  // Nested functions are also stored with the subfunctions of the
+  // primary function, but only subfunctions are listed by name.
+
+  std::map<std::string, octave_value> subfcns = fcn.subfunctions ();
+  std::list<std::string> names = fcn.subfunction_names ();
+
+  if (names.size () != subfcns.size ())
+    {
+      m_ok = false;
+      return;
+    }
+
+  put_uint (names.size ());
+
+  for (const auto& nm : names)
+    {
+      auto p = subfcns.find (nm);
+
+      if (p == subfcns.end () || ! p->second.is_user_function ())
+        {
+          m_ok = false;
+          return;
+        }
+
+      put_function (*(p->second.user_function_value ()));
+    }
+}
+
+void
+tree_cache_writer::write_script_file (octave_user_script& script)
+{
+  put_byte (ptc_script_file);
+
+  put_string (script.doc_string ());
+
+  symbol_scope scope = script.scope ();
+
+  put_scope (scope);
+
+  m_scopes.push_back (scope);
+
+  put_statement_list (script.body ());
+
+  m_scopes.pop_back ();
+}
+
+void
+tree_cache_writer::put_function (octave_user_function& fcn)
+{
+  if (fcn.is_nested_function () || fcn.is_anonymous_function ()
+      || fcn.is_inline_function ())
+    {
+      m_ok = false;
+      return;
+    }
+
+  put_string (fcn.name ());
+  put_string (fcn.doc_string ());
+
+  symbol_scope scope = fcn.scope ();
+
+  put_scope (scope);
+
+  m_scopes.push_back (scope);
+
+  put_parameter_list (fcn.parameter_list ());
+  put_parameter_list (fcn.return_list ());
+  put_statement_list (fcn.body ());
+
+  m_scopes.pop_back ();
+
+  put_comment_list (fcn.leading_comment ());
+  put_comment_list (fcn.trailing_comment ());
+
+  put_int (fcn.beginning_line ());
+  put_int (fcn.beginning_column ());
+  put_int (fcn.ending_line ());
+  put_int (fcn.ending_column ());
+
+  put_bool (fcn.is_subfunction ());
+  put_bool (fcn.is_legacy_constructor ());
+  put_bool (fcn.is_legacy_method ());
+  put_bool (fcn.is_classdef_constructor ());
+  put_bool (fcn.is_classdef_method ());
+  put_string (fcn.dispatch_class ());
+}
+
+void
+tree_cache_writer::put_expr_header (parse_tree_cache_tag tag,
+                                    tree_expression& expr)
+{
+  put_byte (tag);
+  put_int (expr.line ());
+  put_int (expr.column ());
+  put_uint (expr.paren_count ());
+  put_byte (static_cast<unsigned char> (expr.postfix_index ()));
+  put_bool (expr.is_for_cmd_expr ());
+  put_bool (expr.print_result ());
+}
+
+void
+tree_cache_writer::put_cmd_header (parse_tree_cache_tag tag,
+                                   tree_command& cmd)
+{
+  put_byte (tag);
+  put_int (cmd.line ());
+  put_int (cmd.column ());
+}
+
+void
+tree_cache_writer::put_expr (tree_expression *expr)
+{
+  if (expr)
+    expr->accept (*this);
+  else
+    put_byte (ptc_null);
+}
+
+void
+tree_cache_writer::put_statement_list (tree_statement_list *lst)
+{
+  put_bool (lst);
+
+  if (! lst)
+    return;
+
+  put_bool (lst->is_function_body ());
+  put_bool (lst->is_anon_function_body ());
+  put_bool (lst->is_script_body ());
+
+  put_uint (lst->size ());
+
+  for (tree_statement *stmt : *lst)
+    {
+      if (! stmt)
+        {
+          m_ok = false;
+          return;
+        }
+
+      stmt->accept (*this);
+    }
+}
+
+void
+tree_cache_writer::put_argument_list (tree_argument_list *lst)
+{
+  put_bool (lst);
+
+  if (! lst)
+    return;
+
+  put_bool (lst->is_simple_assign_lhs ());
+
+  put_uint (lst->size ());
+
+  for (tree_expression *elt : *lst)
+    put_expr (elt);
+}
+
+void
+tree_cache_writer::put_parameter_list (tree_parameter_list *lst)
+{
+  put_bool (lst);
+
+  if (! lst)
+    return;
+
+  put_bool (lst->is_input_list ());
+  put_int (lst->varargs_only () ? -1 : (lst->takes_varargs () ? 1 : 0));
+
+  put_uint (lst->size ());
+
+  for (tree_decl_elt *elt : *lst)
+    put_decl_elt (elt);
+}
+
+void
+tree_cache_writer::put_decl_elt (tree_decl_elt *elt)
+{
+  if (! elt)
+    {
+      m_ok = false;
+      return;
+    }
+
+  put_byte (elt->is_global () ? 1 : (elt->is_persistent () ? 2 : 0));
+
+  put_expr (elt->ident ());
+  put_expr (elt->expression ());
+}
+
+void
+tree_cache_writer::put_comment_list (comment_list *lst)
+{
+  put_bool (lst);
+
+  if (! lst)
+    return;
+
+  put_uint (lst->size ());
+
+  for (const auto& elt : *lst)
+    {
+      put_string (elt.text ());
+      put_uint (elt.type ());
+      put_bool (elt.uses_hash_char ());
+    }
+}
+
+void
+tree_cache_writer::put_scope (const symbol_scope& scope)
+{
+  // Symbols are stored in the order of their offsets so that inserting
+  // them into a new scope reproduces the offsets.  Scopes that share
+  // symbols with other scopes (those of nested functions) can not be
+  // stored.
+
+  std::list<symbol_record> symbols = scope.symbol_list ();
+
+  std::vector<symbol_record> by_offset (symbols.size ());
+
+  for (const auto& sr : symbols)
+    {
+      std::size_t offset = sr.data_offset ();
+
+      if (offset >= by_offset.size () || sr.frame_offset () != 0
+          || by_offset[offset])
+        {
+          m_ok = false;
+          return;
+        }
+
+      by_offset[offset] = sr;
+    }
+
+  // The first symbol is always "ans", which is created with the scope.
+  if (by_offset.empty () || by_offset[0].name () != "ans")
+    {
+      m_ok = false;
+      return;
+    }
+
+  put_string (scope.name ());
+  put_bool (scope.is_static ());
+  put_bool (scope.is_primary_fcn_scope ());
+
+  put_uint (by_offset.size ());
+
+  for (const auto& sr : by_offset)
+    {
+      put_string (sr.name ());
+      put_bool (sr.is_local ());
+      put_bool (sr.is_formal ());
+      put_bool (sr.is_added_static ());
+      put_bool (sr.is_variable ());
+    }
+}
+
+void
+tree_cache_writer::put_value (const octave_value& val)
+{
+  int type_id = val.type_id ();
+
+  if (val.is_magic_colon ())
+    put_byte (ptc_magic_colon);
+  else if (type_id == octave_null_matrix::static_type_id ())
+    put_byte (ptc_null_matrix);
+  else if (type_id == octave_null_str::static_type_id ())
+    put_byte (ptc_null_str);
+  else if (type_id == octave_null_sq_str::static_type_id ())
+    put_byte (ptc_null_sq_str);
+  else if (type_id == octave_magic_int::static_type_id ())
+    {
+      // The binary data format would store these as doubles.
+      const octave_magic_int& rep
+        = dynamic_cast<const octave_magic_int&> (val.get_rep ());
+
+      put_byte (ptc_magic_int);
+      put_int (rep.scalar_ref ().value ());
+    }
+  else if (type_id == octave_magic_uint::static_type_id ())
+    {
+      const octave_magic_uint& rep
+        = dynamic_cast<const octave_magic_uint&> (val.get_rep ());
+
+      put_byte (ptc_magic_uint);
+      put_uint (rep.scalar_ref ().value ());
+    }
+  else
+    {
+      put_byte (ptc_binary_data);
+      put_string (val.type_name ());
+
+      octave_value tmp = val;
+
+      if (! tmp.save_binary (m_os, false))
+        m_ok = false;
+    }
+}
+
+void
+tree_cache_writer::visit_anon_fcn_handle (tree_anon_fcn_handle& afh)
+{
+  put_expr_header (ptc_anon_fcn_handle, afh);
+
+  // The parent of the scope of an anonymous function is the scope in
+  // which it is defined.
+
+  if (m_scopes.empty () || afh.parent_scope () != m_scopes.back ())
+    {
+      m_ok = false;
+      return;
+    }
+
+  symbol_scope scope = afh.scope ();
+
+  put_scope (scope);
+
+  m_scopes.push_back (scope);
+
+  put_parameter_list (afh.parameter_list ());
+  put_expr (afh.expression ());
+
+  m_scopes.pop_back ();
+}
+
+void
+tree_cache_writer::visit_arguments_block (tree_arguments_block& blk)
+{
+  put_cmd_header (ptc_arguments_block, blk);
+
+  tree_args_block_attribute_list *attr_list = blk.attribute_list ();
+
+  put_bool (attr_list);
+
+  if (attr_list)
+    put_expr (attr_list->attribute ());
+
+  tree_args_block_validation_list *validation_list = blk.validation_list ();
+
+  put_bool (validation_list);
+
+  if (! validation_list)
+    return;
+
+  put_uint (validation_list->size ());
+
+  for (tree_arg_validation *elt : *validation_list)
+    {
+      if (! elt)
+        {
+          m_ok = false;
+          return;
+        }
+
+      put_expr (elt->identifier_expression ());
+
+      tree_arg_size_spec *size_spec = elt->size_spec ();
+
+      put_bool (size_spec);
+
+      if (size_spec)
+        put_argument_list (size_spec->size_args ());
+
+      put_expr (elt->class_name ());
+
+      tree_arg_validation_fcns *validation_fcns = elt->validation_fcns ();
+
+      put_bool (validation_fcns);
+
+      if (validation_fcns)
+        put_argument_list (validation_fcns->fcn_args ());
+
+      put_expr (elt->initializer_expression ());
+    }
+}
+
+void
+tree_cache_writer::visit_binary_expression (tree_binary_expression& expr)
+{
+  put_expr_header (expr.is_braindead () ? ptc_braindead_binary : ptc_binary,
+                   expr);
+
+  put_int (expr.op_type ());
+  put_expr (expr.lhs ());
+  put_expr (expr.rhs ());
+}
+
+void
+tree_cache_writer::visit_boolean_expression (tree_boolean_expression& expr)
+{
+  put_expr_header (ptc_boolean, expr);
+
+  put_int (expr.op_type ());
+  put_expr (expr.lhs ());
+  put_expr (expr.rhs ());
+}
+
+// Compound operators are stored as the binary expression they were
+// created from and are recreated when the tree is read.
+
+void
+tree_cache_writer::visit_compound_binary_expression
+  (tree_compound_binary_expression& expr)
+{
+  visit_binary_expression (expr);
+}
+
+void
+tree_cache_writer::visit_break_command (tree_break_command& cmd)
+{
+  put_cmd_header (ptc_break, cmd);
+}
+
+void
+tree_cache_writer::visit_colon_expression (tree_colon_expression& expr)
+{
+  put_expr_header (ptc_colon, expr);
+
+  put_expr (expr.base ());
+  put_expr (expr.limit ());
+  put_expr (expr.increment ());
+}
+
+void
+tree_cache_writer::visit_continue_command (tree_continue_command& cmd)
+{
+  put_cmd_header (ptc_continue, cmd);
+}
+
+void
+tree_cache_writer::visit_decl_command (tree_decl_command& cmd)
+{
+  put_cmd_header (ptc_decl, cmd);
+
+  put_string (cmd.name ());
+
+  tree_decl_init_list *init_list = cmd.initializer_list ();
+
+  put_bool (init_list);
+
+  if (! init_list)
+    return;
+
+  put_uint (init_list->size ());
+
+  for (tree_decl_elt *elt : *init_list)
+    put_decl_elt (elt);
+}
+
+void
+tree_cache_writer::visit_simple_for_command (tree_simple_for_command& cmd)
+{
+  put_cmd_header (ptc_simple_for, cmd);
+
+  put_bool (cmd.in_parallel ());
+  put_expr (cmd.left_hand_side ());
+  put_expr (cmd.control_expr ());
+  put_expr (cmd.maxproc_expr ());
+  put_statement_list (cmd.body ());
+  put_comment_list (cmd.leading_comment ());
+  put_comment_list (cmd.trailing_comment ());
+}
+
+void
+tree_cache_writer::visit_complex_for_command (tree_complex_for_command& cmd)
+{
+  put_cmd_header (ptc_complex_for, cmd);
+
+  put_argument_list (cmd.left_hand_side ());
+  put_expr (cmd.control_expr ());
+  put_statement_list (cmd.body ());
+  put_comment_list (cmd.leading_comment ());
+  put_comment_list (cmd.trailing_comment ());
+}
+
+void
+tree_cache_writer::visit_spmd_command (tree_spmd_command& cmd)
+{
+  put_cmd_header (ptc_spmd, cmd);
+
+  put_statement_list (cmd.body ());
+  put_comment_list (cmd.leading_comment ());
+  put_comment_list (cmd.trailing_comment ());
+}
+
+void
+tree_cache_writer::visit_identifier (tree_identifier& id)
+{
+  if (id.is_black_hole ())
+    {
+      put_expr_header (ptc_black_hole, id);
+      return;
+    }
+
+  put_expr_header (ptc_identifier, id);
+
+  std::string nm = id.name ();
+
+  put_string (nm);
+
+  // The symbol is looked up by name when the tree is read, so it must
+  // be the one in the current scope.
+
+  symbol_record sr = id.symbol ();
+
+  symbol_record scope_sr = (m_scopes.empty () ? symbol_record ()
+                            : m_scopes.back ().lookup_symbol (nm));
+
+  if (! scope_sr || sr.frame_offset () != 0
+      || sr.data_offset () != scope_sr.data_offset ())
+    m_ok = false;
+}
+
+void
+tree_cache_writer::visit_if_command (tree_if_command& cmd)
+{
+  put_cmd_header (ptc_if, cmd);
+
+  put_comment_list (cmd.leading_comment ());
+  put_comment_list (cmd.trailing_comment ());
+
+  tree_if_command_list *lst = cmd.cmd_list ();
+
+  put_bool (lst);
+
+  if (! lst)
+    return;
+
+  put_uint (lst->size ());
+
+  for (tree_if_clause *elt : *lst)
+    {
+      if (! elt)
+        {
+          m_ok = false;
+          return;
+        }
+
+      put_int (elt->line ());
+      put_int (elt->column ());
+      put_expr (elt->condition ());
+      put_statement_list (elt->commands ());
+      put_comment_list (elt->leading_comment ());
+    }
+}
+
+void
+tree_cache_writer::visit_switch_command (tree_switch_command& cmd)
+{
+  put_cmd_header (ptc_switch, cmd);
+
+  put_expr (cmd.switch_value ());
+  put_comment_list (cmd.leading_comment ());
+  put_comment_list (cmd.trailing_comment ());
+
+  tree_switch_case_list *lst = cmd.case_list ();
+
+  put_bool (lst);
+
+  if (! lst)
+    return;
+
+  put_uint (lst->size ());
+
+  for (tree_switch_case *elt : *lst)
+    {
+      if (! elt)
+        {
+          m_ok = false;
+          return;
+        }
+
+      put_int (elt->line ());
+      put_int (elt->column ());
+      put_expr (elt->case_label ());
+      put_statement_list (elt->commands ());
+      put_comment_list (elt->leading_comment ());
+    }
+}
+
+void
+tree_cache_writer::visit_index_expression (tree_index_expression& expr)
+{
+  put_expr_header (ptc_index, expr);
+
+  put_bool (expr.is_word_list_cmd ());
+  put_expr (expr.expression ());
+
+  std::string type_tags = expr.type_tags ();
+  std::list<tree_argument_list *> arg_lists = expr.arg_lists ();
+  std::list<string_vector> arg_names = expr.arg_names ();
+  std::list<tree_expression *> dyn_fields = expr.dyn_fields ();
+
+  put_string (type_tags);
+
+  auto p_arg_list = arg_lists.begin ();
+  auto p_arg_nm = arg_names.begin ();
+  auto p_dyn_field = dyn_fields.begin ();
+
+  for (char type : type_tags)
+    {
+      if (type == '.')
+        {
+          tree_expression *df = *p_dyn_field;
+
+          put_bool (df);
+
+          if (df)
+            put_expr (df);
+          else
+            put_string (p_arg_nm->numel () > 0 ? (*p_arg_nm)(0) : "");
+        }
+      else
+        put_argument_list (*p_arg_list);
+
+      p_arg_list++;
+      p_arg_nm++;
+      p_dyn_field++;
+    }
+}
+
+void
+tree_cache_writer::visit_matrix (tree_matrix& mat)
+{
+  put_expr_header (ptc_matrix, mat);
+
+  put_uint (mat.size ());
+
+  for (tree_argument_list *row : mat)
+    put_argument_list (row);
+}
+
+void
+tree_cache_writer::visit_cell (tree_cell& cell)
+{
+  put_expr_header (ptc_cell, cell);
+
+  put_uint (cell.size ());
+
+  for (tree_argument_list *row : cell)
+    put_argument_list (row);
+}
+
+void
+tree_cache_writer::visit_multi_assignment (tree_multi_assignment& expr)
+{
+  put_expr_header (ptc_multi_assignment, expr);
+
+  put_argument_list (expr.left_hand_side ());
+  put_expr (expr.right_hand_side ());
+}
+
+void
+tree_cache_writer::visit_no_op_command (tree_no_op_command& cmd)
+{
+  put_cmd_header (ptc_no_op, cmd);
+
+  put_string (cmd.original_command ());
+  put_bool (cmd.is_end_of_file ());
+}
+
+void
+tree_cache_writer::visit_constant (tree_constant& val)
+{
+  put_expr_header (ptc_constant, val);
+
+  put_string (val.original_text ());
+  put_value (val.value ());
+}
+
+void
+tree_cache_writer::visit_fcn_handle (tree_fcn_handle& fh)
+{
+  put_expr_header (ptc_fcn_handle, fh);
+
+  put_string (fh.name ());
+}
+
+void
+tree_cache_writer::visit_postfix_expression (tree_postfix_expression& expr)
+{
+  put_expr_header (ptc_postfix, expr);
+
+  put_int (expr.op_type ());
+  put_expr (expr.operand ());
+}
+
+void
+tree_cache_writer::visit_prefix_expression (tree_prefix_expression& expr)
+{
+  put_expr_header (ptc_prefix, expr);
+
+  put_int (expr.op_type ());
+  put_expr (expr.operand ());
+}
+
+void
+tree_cache_writer::visit_return_command (tree_return_command& cmd)
+{
+  put_cmd_header (ptc_return, cmd);
+}
+
+void
+tree_cache_writer::visit_simple_assignment (tree_simple_assignment& expr)
+{
+  put_expr_header (ptc_simple_assignment, expr);
+
+  put_int (expr.op_type ());
+  put_expr (expr.left_hand_side ());
+  put_expr (expr.right_hand_side ());
+}
+
+void
+tree_cache_writer::visit_statement (tree_statement& stmt)
+{
+  tree_command *cmd = stmt.command ();
+  tree_expression *expr = stmt.expression ();
+
+  if (cmd)
+    {
+      put_byte (1);
+      cmd->accept (*this);
+    }
+  else if (expr)
+    {
+      put_byte (2);
+      expr->accept (*this);
+    }
+  else
+    put_byte (0);
+
+  put_comment_list (stmt.comment_text ());
+}
+
+void
+tree_cache_writer::visit_try_catch_command (tree_try_catch_command& cmd)
+{
+  put_cmd_header (ptc_try_catch, cmd);
+
+  put_statement_list (cmd.body ());
+  put_statement_list (cmd.cleanup ());
+  put_expr (cmd.identifier ());
+  put_comment_list (cmd.leading_comment ());
+  put_comment_list (cmd.middle_comment ());
+  put_comment_list (cmd.trailing_comment ());
+}
+
+void
+tree_cache_writer::visit_unwind_protect_command
+  (tree_unwind_protect_command& cmd)
+{
+  put_cmd_header (ptc_unwind_protect, cmd);
+
+  put_statement_list (cmd.body ());
+  put_statement_list (cmd.cleanup ());
+  put_comment_list (cmd.leading_comment ());
+  put_comment_list (cmd.middle_comment ());
+  put_comment_list (cmd.trailing_comment ());
+}
+
+void
+tree_cache_writer::visit_while_command (tree_while_command& cmd)
+{
+  put_cmd_header (ptc_while, cmd);
+
+  put_expr (cmd.condition ());
+  put_statement_list (cmd.body ());
+  put_comment_list (cmd.leading_comment ());
+  put_comment_list (cmd.trailing_comment ());
+}
+
+void
+tree_cache_writer::visit_do_until_command (tree_do_until_command& cmd)
+{
+  put_cmd_header (ptc_do_until, cmd);
+
+  put_expr (cmd.condition ());
+  put_statement_list (cmd.body ());
+  put_comment_list (cmd.leading_comment ());
+  put_comment_list (cmd.trailing_comment ());
+}
+
+void
+tree_cache_writer::visit_superclass_ref (tree_superclass_ref& expr)
+{
+  put_expr_header (ptc_superclass_ref, expr);
+
+  put_string (expr.method_name ());
+  put_string (expr.class_name ());
+}
+
+void
+tree_cache_writer::visit_metaclass_query (tree_metaclass_query& expr)
+{
+  put_expr_header (ptc_metaclass_query, expr);
+
+  put_string (expr.class_name ());
+}
+
+// Thrown if the contents of a cache file are invalid.
+
+class tree_cache_format_error
+{
+};
+
+// Read parse trees written by tree_cache_writer.  Nodes are owned by
+// unique_ptr objects until they are attached to their parent, so
+// nothing leaks if a damaged file is detected in the middle of a tree.
+
+class tree_cache_reader
+{
+public:
+
+  tree_cache_reader (std::istream& is, const std::string& full_file,
+                     const std::string& file, const std::string& dir_name,
+                     const std::string& package_name, bool relative_lookup)
+    : m_is (is), m_full_file (full_file), m_file (file),
+      m_dir_name (dir_name), m_package_name (package_name),
+      m_relative_lookup (relative_lookup), m_scopes ()
+  { }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (tree_cache_reader)
+
+  ~tree_cache_reader () = default;
+
+  bool read_header (const std::string& key, const sys::file_stat& fs);
+
+  octave_value read_code ();
+
+private:
+
+  OCTAVE_NORETURN static void format_error ()
+  {
+    throw tree_cache_format_error ();
+  }
+
+  unsigned char get_byte ()
+  {
+    int c = m_is.get ();
+
+    if (c == std::istream::traits_type::eof ())
+      format_error ();
+
+    return static_cast<unsigned char> (c);
+  }
+
+  uint64_t get_uint ()
+  {
+    uint64_t val = 0;
+
+    for (int shift = 0; shift < 64; shift += 7)
+      {
+        unsigned char c = get_byte ();
+
+        val |= static_cast<uint64_t> (c & 0x7f) << shift;
+
+        if (! (c & 0x80))
+          return val;
+      }
+
+    format_error ();
+  }
+
+  int64_t get_int ()
+  {
+    uint64_t uval = get_uint ();
+
+    return static_cast<int64_t> (uval & 1 ? ~(uval >> 1) : uval >> 1);
+  }
+
+  // Element counts and string lengths.  The limit only guards against
+  // huge allocations for damaged files.
+  std::size_t get_count ()
+  {
+    uint64_t val = get_uint ();
+
+    if (val > (static_cast<uint64_t> (1) << 30))
+      format_error ();
+
+    return static_cast<std::size_t> (val);
+  }
+
+  bool get_bool () { return get_byte () != 0; }
+
+  std::string get_string ()
+  {
+    std::size_t len = get_count ();
+
+    std::string s (len, '\0');
+
+    if (len > 0 && ! m_is.read (&s[0], len))
+      format_error ();
+
+    return s;
+  }
+
+  void get_expr_flags (tree_expression& expr, int num_parens,
+                       char postfix_index, bool for_cmd_expr,
+                       bool print_flag);
+
+  std::unique_ptr<tree_expression> get_expr ();
+
+  std::unique_ptr<tree_identifier> get_identifier ();
+
+  std::unique_ptr<tree_command> get_command ();
+
+  std::unique_ptr<tree_statement> get_statement ();
+
+  std::unique_ptr<tree_statement_list> get_statement_list ();
+
+  std::unique_ptr<tree_argument_list> get_argument_list ();
+
+  std::unique_ptr<tree_parameter_list> get_parameter_list ();
+
+  std::unique_ptr<tree_decl_elt> get_decl_elt ();
+
+  std::unique_ptr<comment_list> get_comment_list ();
+
+  symbol_scope get_scope ();
+
+  octave_value get_value ();
+
+  octave_value get_function (const symbol_scope& primary_scope);
+
+  std::istream& m_is;
+
+  std::string m_full_file;
+  std::string m_file;
+  std::string m_dir_name;
+  std::string m_package_name;
+
+  bool m_relative_lookup;
+
+  std::vector<symbol_scope> m_scopes;
+};
+
+bool
+tree_cache_reader::read_header (const std::string& key,
+                                const sys::file_stat& fs)
+{
+  if (get_string () != s_magic || get_uint () != s_format_version)
+    return false;
+
+  if (get_byte () != static_cast<unsigned char> (mach_info::native_float_format ()))
+    return false;
+
+  uint32_t byte_order_mark = 0;
+
+  if (! m_is.read (reinterpret_cast<char *> (&byte_order_mark),
+                   sizeof (byte_order_mark))
+      || byte_order_mark != s_byte_order_mark)
+    return false;
+
+  if (get_string () != key)
+    return false;
+
+  int64_t mtime = get_int ();
+  int64_t size = get_int ();
+
+  return (mtime == static_cast<int64_t> (fs.mtime ().unix_time ())
+          && size == static_cast<int64_t> (fs.size ()));
+}
+
+octave_value
+tree_cache_reader::read_code ()
+{
+  unsigned char code_type = get_byte ();
+
+  if (code_type == ptc_function_file)
+    {
+      octave_value ov_fcn = get_function (symbol_scope::invalid ());
+
+      octave_user_function *fcn = ov_fcn.user_function_value ();
+
+      symbol_scope primary_scope = fcn->scope ();
+
+      std::size_t nsub = get_count ();
+
+      std::list<std::string> subfunction_names;
+
+      for (std::size_t i = 0; i < nsub; i++)
+        {
+          octave_value ov_subfcn = get_function (primary_scope);
+
+          subfunction_names.push_back (ov_subfcn.function_value ()->name ());
+        }
+
+      fcn->stash_subfunction_names (subfunction_names);
+
+      return ov_fcn;
+    }
+  else if (code_type == ptc_script_file)
+    {
+      std::string doc_string = get_string ();
+
+      symbol_scope scope = get_scope ();
+
+      m_scopes.push_back (scope);
+
+      std::unique_ptr<tree_statement_list> body = get_statement_list ();
+
+      m_scopes.pop_back ();
+
+      if (! body)
+        format_error ();
+
+      // As in base_parser::make_script.
+
+      scope.cache_fcn_file_name (m_full_file);
+      scope.cache_dir_name (m_dir_name);
+
+      octave_user_script *script
+        = new octave_user_script (m_full_file, m_file, scope,
+                                  body.release (), doc_string);
+
+      octave_value retval (script);
+
+      sys::time now;
+
+      script->stash_fcn_file_time (now);
+      script->stash_dir_name (m_dir_name);
+
+      return retval;
+    }
+
+  format_error ();
+}
+
+// Create a function in the same way as base_parser::start_function and
+// base_parser::finish_function.  PRIMARY_SCOPE is invalid for the
+// primary function.
+
+octave_value
+tree_cache_reader::get_function (const symbol_scope& primary_scope)
+{
+  std::string name = get_string ();
+  std::string doc_string = get_string ();
+
+  symbol_scope scope = get_scope ();
+
+  m_scopes.push_back (scope);
+
+  std::unique_ptr<tree_parameter_list> param_list = get_parameter_list ();
+  std::unique_ptr<tree_parameter_list> ret_list = get_parameter_list ();
+  std::unique_ptr<tree_statement_list> body = get_statement_list ();
+
+  m_scopes.pop_back ();
+
+  std::unique_ptr<comment_list> lead_comm = get_comment_list ();
+  std::unique_ptr<comment_list> trail_comm = get_comment_list ();
+
+  int line = get_int ();
+  int column = get_int ();
+  int end_line = get_int ();
+  int end_column = get_int ();
+
+  bool is_subfunction = get_bool ();
+  bool is_legacy_constructor = get_bool ();
+  bool is_legacy_method = get_bool ();
+  bool is_classdef_constructor = get_bool ();
+  bool is_classdef_method = get_bool ();
+
+  std::string dispatch_class = get_string ();
+
+  if (! ret_list || ! body || is_subfunction != primary_scope.is_valid ())
+    format_error ();
+
+  octave_user_function *fcn
+    = new octave_user_function (scope, param_list.release (), nullptr,
+                                body.release ());
+
+  octave_value ov_fcn (fcn);
+
+  fcn->stash_trailing_comment (trail_comm.release ());
+  fcn->stash_fcn_location (line, column);
+  fcn->stash_fcn_end_location (end_line, end_column);
+
+  sys::time now;
+
+  fcn->stash_fcn_file_name (m_full_file);
+  fcn->stash_fcn_file_time (now);
+  fcn->stash_dir_name (m_dir_name);
+  fcn->stash_package_name (m_package_name);
+  fcn->mark_as_system_fcn_file ();
+  fcn->stash_function_name (name);
+
+  if (m_relative_lookup)
+    fcn->mark_relative ();
+
+  if (is_legacy_constructor)
+    fcn->mark_as_legacy_constructor ();
+  if (is_legacy_method)
+    fcn->mark_as_legacy_method ();
+  if (is_classdef_constructor)
+    fcn->mark_as_classdef_constructor ();
+  if (is_classdef_method)
+    fcn->mark_as_classdef_method ();
+
+  if (! dispatch_class.empty ())
+    fcn->stash_dispatch_class (dispatch_class);
+
+  if (! doc_string.empty ())
+    fcn->document (doc_string);
+
+  scope.cache_fcn_name (name);
+  scope.cache_fcn_file_name (m_full_file);
+  scope.cache_dir_name (m_dir_name);
+
+  fcn->stash_leading_comment (lead_comm.release ());
+
+  fcn->define_ret_list (ret_list.release ());
+
+  if (is_subfunction)
+    {
+      fcn->mark_as_subfunction ();
+
+      symbol_scope pscope = primary_scope;
+
+      scope.set_parent (pscope);
+      scope.set_primary_parent (pscope);
+
+      pscope.install_subfunction (name, ov_fcn);
+    }
+
+  scope.update_nest ();
+
+  return ov_fcn;
+}
+
+void
+tree_cache_reader::get_expr_flags (tree_expression& expr, int num_parens,
+                                   char postfix_index, bool for_cmd_expr,
+                                   bool print_flag)
+{
+  for (int i = 0; i < num_parens; i++)
+    expr.mark_in_parens ();
+
+  expr.set_postfix_index (postfix_index);
+
+  if (for_cmd_expr)
+    expr.mark_as_for_cmd_expr ();
+
+  expr.set_print_flag (print_flag);
+}
+
+std::unique_ptr<tree_expression>
+tree_cache_reader::get_expr ()
+{
+  unsigned char tag = get_byte ();
+
+  if (tag == ptc_null)
+    return nullptr;
+
+  int l = get_int ();
+  int c = get_int ();
+
+  int num_parens = get_count ();
+  char postfix_index = static_cast<char> (get_byte ());
+  bool for_cmd_expr = get_bool ();
+  bool print_flag = get_bool ();
+
+  std::unique_ptr<tree_expression> retval;
+
+  switch (tag)
+    {
+    case ptc_anon_fcn_handle:
+      {
+        if (m_scopes.empty ())
+          format_error ();
+
+        symbol_scope parent_scope = m_scopes.back ();
+
+        symbol_scope scope = get_scope ();
+
+        m_scopes.push_back (scope);
+
+        std::unique_ptr<tree_parameter_list> param_list
+          = get_parameter_list ();
+
+        std::unique_ptr<tree_expression> expr = get_expr ();
+
+        m_scopes.pop_back ();
+
+        if (! expr)
+          format_error ();
+
+        retval.reset (new tree_anon_fcn_handle (param_list.release (),
+                                                expr.release (), scope,
+                                                parent_scope, l, c));
+      }
+      break;
+
+    case ptc_binary:
+    case ptc_braindead_binary:
+      {
+        octave_value::binary_op op
+          = static_cast<octave_value::binary_op> (get_int ());
+
+        std::unique_ptr<tree_expression> lhs = get_expr ();
+        std::unique_ptr<tree_expression> rhs = get_expr ();
+
+        if (! (lhs && rhs))
+          format_error ();
+
+        if (tag == ptc_braindead_binary)
+          retval.reset (new tree_braindead_shortcircuit_binary_expression
+                        (lhs.release (), rhs.release (), l, c, op));
+        else
+          retval.reset (maybe_compound_binary_expression
+                        (lhs.release (), rhs.release (), l, c, op));
+      }
+      break;
+
+    case ptc_black_hole:
+      retval.reset (new tree_black_hole (l, c));
+      break;
+
+    case ptc_boolean:
+      {
+        tree_boolean_expression::type op
+          = static_cast<tree_boolean_expression::type> (get_int ());
+
+        std::unique_ptr<tree_expression> lhs = get_expr ();
+        std::unique_ptr<tree_expression> rhs = get_expr ();
+
+        if (! (lhs && rhs))
+          format_error ();
+
+        retval.reset (new tree_boolean_expression (lhs.release (),
+                                                   rhs.release (),
+                                                   l, c, op));
+      }
+      break;
+
+    case ptc_cell:
+    case ptc_matrix:
+      {
+        std::size_t nrows = get_count ();
+
+        std::unique_ptr<tree_array_list> array_list;
+
+        if (tag == ptc_cell)
+          array_list.reset (new tree_cell (nullptr, l, c));
+        else
+          array_list.reset (new tree_matrix (nullptr, l, c));
+
+        for (std::size_t i = 0; i < nrows; i++)
+          {
+            std::unique_ptr<tree_argument_list> row = get_argument_list ();
+
+            if (! row)
+              format_error ();
+
+            array_list->push_back (row.release ());
+          }
+
+        retval = std::move (array_list);
+      }
+      break;
+
+    case ptc_colon:
+      {
+        std::unique_ptr<tree_expression> base = get_expr ();
+        std::unique_ptr<tree_expression> limit = get_expr ();
+        std::unique_ptr<tree_expression> incr = get_expr ();
+
+        retval.reset (new tree_colon_expression (base.release (),
+                                                 limit.release (),
+                                                 incr.release (), l, c));
+      }
+      break;
+
+    case ptc_constant:
+      {
+        std::string orig_text = get_string ();
+
+        octave_value val = get_value ();
+
+        retval.reset (new tree_constant (val, orig_text, l, c));
+      }
+      break;
+
+    case ptc_fcn_handle:
+      retval.reset (new tree_fcn_handle (get_string (), l, c));
+      break;
+
+    case ptc_identifier:
+      {
+        std::string nm = get_string ();
+
+        if (m_scopes.empty ())
+          format_error ();
+
+        symbol_record sr = m_scopes.back ().lookup_symbol (nm);
+
+        if (! sr)
+          format_error ();
+
+        retval.reset (new tree_identifier (sr, l, c));
+      }
+      break;
+
+    case ptc_index:
+      {
+        bool word_list_cmd = get_bool ();
+
+        std::unique_ptr<tree_expression> expr = get_expr ();
+
+        std::string type_tags = get_string ();
+
+        if (! expr || type_tags.empty ())
+          format_error ();
+
+        std::unique_ptr<tree_index_expression> idx_expr;
+
+        for (char type : type_tags)
+          {
+            if (type == '.')
+              {
+                if (get_bool ())
+                  {
+                    std::unique_ptr<tree_expression> df = get_expr ();
+
+                    if (! df)
+                      format_error ();
+
+                    if (idx_expr)
+                      idx_expr->append (df.release ());
+                    else
+                      idx_expr.reset (new tree_index_expression
+                                      (expr.release (), df.release (), l, c));
+                  }
+                else
+                  {
+                    std::string nm = get_string ();
+
+                    if (idx_expr)
+                      idx_expr->append (nm);
+                    else
+                      idx_expr.reset (new tree_index_expression
+                                      (expr.release (), nm, l, c));
+                  }
+              }
+            else if (type == '(' || type == '{')
+              {
+                std::unique_ptr<tree_argument_list> args
+                  = get_argument_list ();
+
+                if (idx_expr)
+                  idx_expr->append (args.release (), type);
+                else
+                  idx_expr.reset (new tree_index_expression
+                                  (expr.release (), args.release (),
+                                   l, c, type));
+              }
+            else
+              format_error ();
+          }
+
+        if (word_list_cmd)
+          idx_expr->mark_word_list_cmd ();
+
+        retval = std::move (idx_expr);
+      }
+      break;
+
+    case ptc_metaclass_query:
+      retval.reset (new tree_metaclass_query (get_string (), l, c));
+      break;
+
+    case ptc_multi_assignment:
+      {
+        std::unique_ptr<tree_argument_list> lhs = get_argument_list ();
+        std::unique_ptr<tree_expression> rhs = get_expr ();
+
+        if (! (lhs && rhs))
+          format_error ();
+
+        retval.reset (new tree_multi_assignment (lhs.release (),
+                                                 rhs.release (),
+                                                 false, l, c));
+      }
+      break;
+
+    case ptc_postfix:
+    case ptc_prefix:
+      {
+        octave_value::unary_op op
+          = static_cast<octave_value::unary_op> (get_int ());
+
+        std::unique_ptr<tree_expression> operand = get_expr ();
+
+        if (! operand)
+          format_error ();
+
+        if (tag == ptc_postfix)
+          retval.reset (new tree_postfix_expression (operand.release (),
+                                                     l, c, op));
+        else
+          retval.reset (new tree_prefix_expression (operand.release (),
+                                                    l, c, op));
+      }
+      break;
+
+    case ptc_simple_assignment:
+      {
+        octave_value::assign_op op
+          = static_cast<octave_value::assign_op> (get_int ());
+
+        std::unique_ptr<tree_expression> lhs = get_expr ();
+        std::unique_ptr<tree_expression> rhs = get_expr ();
+
+        if (! (lhs && rhs))
+          format_error ();
+
+        retval.reset (new tree_simple_assignment (lhs.release (),
+                                                  rhs.release (),
+                                                  false, l, c, op));
+      }
+      break;
+
+    case ptc_superclass_ref:
+      {
+        std::string meth = get_string ();
+        std::string cls = get_string ();
+
+        retval.reset (new tree_superclass_ref (meth, cls, l, c));
+      }
+      break;
+
+    default:
+      format_error ();
+    }
+
+  get_expr_flags (*retval, num_parens, postfix_index, for_cmd_expr,
+                  print_flag);
+
+  return retval;
+}
+
+std::unique_ptr<tree_identifier>
+tree_cache_reader::get_identifier ()
+{
+  std::unique_ptr<tree_expression> expr = get_expr ();
+
+  if (! expr)
+    return nullptr;
+
+  if (! expr->is_identifier ())
+    format_error ();
+
+  return std::unique_ptr<tree_identifier>
+           (static_cast<tree_identifier *> (expr.release ()));
+}
+
+std::unique_ptr<tree_command>
+tree_cache_reader::get_command ()
+{
+  unsigned char tag = get_byte ();
+
+  int l = get_int ();
+  int c = get_int ();
+
+  std::unique_ptr<tree_command> retval;
+
+  switch (tag)
+    {
+    case ptc_arguments_block:
+      {
+        std::unique_ptr<tree_args_block_attribute_list> attr_list;
+
+        if (get_bool ())
+          {
+            std::unique_ptr<tree_identifier> attr = get_identifier ();
+
+            attr_list.reset (new tree_args_block_attribute_list
+                             (attr.release ()));
+          }
+
+        std::unique_ptr<tree_args_block_validation_list> validation_list;
+
+        if (get_bool ())
+          {
+            validation_list.reset (new tree_args_block_validation_list ());
+
+            std::size_t n = get_count ();
+
+            for (std::size_t i = 0; i < n; i++)
+              {
+                std::unique_ptr<tree_expression> arg_name = get_expr ();
+
+                std::unique_ptr<tree_arg_size_spec> size_spec;
+
+                if (get_bool ())
+                  size_spec.reset (new tree_arg_size_spec
+                                   (get_argument_list ().release ()));
+
+                std::unique_ptr<tree_identifier> class_name
+                  = get_identifier ();
+
+                std::unique_ptr<tree_arg_validation_fcns> validation_fcns;
+
+                if (get_bool ())
+                  validation_fcns.reset (new tree_arg_validation_fcns
+                                         (get_argument_list ().release ()));
+
+                std::unique_ptr<tree_expression> default_value = get_expr ();
+
+                tree_arg_validation *arg_validation
+                  = new tree_arg_validation (size_spec.release (),
+                                             class_name.release (),
+                                             validation_fcns.release (),
+                                             default_value.release ());
+
+                arg_validation->arg_name (arg_name.release ());
+
+                validation_list->push_back (arg_validation);
+              }
+          }
+
+        retval.reset (new tree_arguments_block (attr_list.release (),
+                                                validation_list.release (),
+                                                l, c));
+      }
+      break;
+
+    case ptc_break:
+      retval.reset (new tree_break_command (l, c));
+      break;
+
+    case ptc_complex_for:
+      {
+        std::unique_ptr<tree_argument_list> lhs = get_argument_list ();
+        std::unique_ptr<tree_expression> expr = get_expr ();
+        std::unique_ptr<tree_statement_list> body = get_statement_list ();
+        std::unique_ptr<comment_list> lc = get_comment_list ();
+        std::unique_ptr<comment_list> tc = get_comment_list ();
+
+        if (! (lhs && expr))
+          format_error ();
+
+        retval.reset (new tree_complex_for_command (lhs.release (),
+                                                    expr.release (),
+                                                    body.release (),
+                                                    lc.release (),
+                                                    tc.release (), l, c));
+      }
+      break;
+
+    case ptc_continue:
+      retval.reset (new tree_continue_command (l, c));
+      break;
+
+    case ptc_decl:
+      {
+        std::string name = get_string ();
+
+        std::unique_ptr<tree_decl_init_list> init_list;
+
+        if (get_bool ())
+          {
+            init_list.reset (new tree_decl_init_list ());
+
+            std::size_t n = get_count ();
+
+            for (std::size_t i = 0; i < n; i++)
+              init_list->push_back (get_decl_elt ().release ());
+          }
+
+        if (name != "global" && name != "persistent")
+          format_error ();
+
+        retval.reset (new tree_decl_command (name, init_list.release (),
+                                             l, c));
+      }
+      break;
+
+    case ptc_do_until:
+    case ptc_while:
+      {
+        std::unique_ptr<tree_expression> expr = get_expr ();
+        std::unique_ptr<tree_statement_list> body = get_statement_list ();
+        std::unique_ptr<comment_list> lc = get_comment_list ();
+        std::unique_ptr<comment_list> tc = get_comment_list ();
+
+        if (! expr)
+          format_error ();
+
+        if (tag == ptc_do_until)
+          retval.reset (new tree_do_until_command (expr.release (),
+                                                   body.release (),
+                                                   lc.release (),
+                                                   tc.release (), l, c));
+        else
+          retval.reset (new tree_while_command (expr.release (),
+                                                body.release (),
+                                                lc.release (),
+                                                tc.release (), l, c));
+      }
+      break;
+
+    case ptc_if:
+      {
+        std::unique_ptr<comment_list> lc = get_comment_list ();
+        std::unique_ptr<comment_list> tc = get_comment_list ();
+
+        std::unique_ptr<tree_if_command_list> lst;
+
+        if (get_bool ())
+          {
+            lst.reset (new tree_if_command_list ());
+
+            std::size_t n = get_count ();
+
+            for (std::size_t i = 0; i < n; i++)
+              {
+                int clause_l = get_int ();
+                int clause_c = get_int ();
+
+                std::unique_ptr<tree_expression> expr = get_expr ();
+                std::unique_ptr<tree_statement_list> body
+                  = get_statement_list ();
+                std::unique_ptr<comment_list> clause_lc = get_comment_list ();
+
+                lst->push_back (new tree_if_clause (expr.release (),
+                                                    body.release (),
+                                                    clause_lc.release (),
+                                                    clause_l, clause_c));
+              }
+          }
+
+        retval.reset (new tree_if_command (lst.release (), lc.release (),
+                                           tc.release (), l, c));
+      }
+      break;
+
+    case ptc_no_op:
+      {
+        std::string orig_cmd = get_string ();
+        bool eof = get_bool ();
+
+        retval.reset (new tree_no_op_command (orig_cmd, eof, l, c));
+      }
+      break;
+
+    case ptc_return:
+      retval.reset (new tree_return_command (l, c));
+      break;
+
+    case ptc_simple_for:
+      {
+        bool parallel = get_bool ();
+
+        std::unique_ptr<tree_expression> lhs = get_expr ();
+        std::unique_ptr<tree_expression> expr = get_expr ();
+        std::unique_ptr<tree_expression> maxproc = get_expr ();
+        std::unique_ptr<tree_statement_list> body = get_statement_list ();
+        std::unique_ptr<comment_list> lc = get_comment_list ();
+        std::unique_ptr<comment_list> tc = get_comment_list ();
+
+        if (! (lhs && expr))
+          format_error ();
+
+        retval.reset (new tree_simple_for_command (parallel, lhs.release (),
+                                                   expr.release (),
+                                                   maxproc.release (),
+                                                   body.release (),
+                                                   lc.release (),
+                                                   tc.release (), l, c));
+      }
+      break;
+
+    case ptc_spmd:
+      {
+        std::unique_ptr<tree_statement_list> body = get_statement_list ();
+        std::unique_ptr<comment_list> lc = get_comment_list ();
+        std::unique_ptr<comment_list> tc = get_comment_list ();
+
+        retval.reset (new tree_spmd_command (body.release (), lc.release (),
+                                             tc.release (), l, c));
+      }
+      break;
+
+    case ptc_switch:
+      {
+        std::unique_ptr<tree_expression> expr = get_expr ();
+        std::unique_ptr<comment_list> lc = get_comment_list ();
+        std::unique_ptr<comment_list> tc = get_comment_list ();
+
+        std::unique_ptr<tree_switch_case_list> lst;
+
+        if (get_bool ())
+          {
+            lst.reset (new tree_switch_case_list ());
+
+            std::size_t n = get_count ();
+
+            for (std::size_t i = 0; i < n; i++)
+              {
+                int case_l = get_int ();
+                int case_c = get_int ();
+
+                std::unique_ptr<tree_expression> label = get_expr ();
+                std::unique_ptr<tree_statement_list> body
+                  = get_statement_list ();
+                std::unique_ptr<comment_list> case_lc = get_comment_list ();
+
+                lst->push_back (new tree_switch_case (label.release (),
+                                                      body.release (),
+                                                      case_lc.release (),
+                                                      case_l, case_c));
+              }
+          }
+
+        if (! expr)
+          format_error ();
+
+        retval.reset (new tree_switch_command (expr.release (),
+                                               lst.release (),
+                                               lc.release (), tc.release (),
+                                               l, c));
+      }
+      break;
+
+    case ptc_try_catch:
+      {
+        std::unique_ptr<tree_statement_list> body = get_statement_list ();
+        std::unique_ptr<tree_statement_list> cleanup = get_statement_list ();
+        std::unique_ptr<tree_identifier> id = get_identifier ();
+        std::unique_ptr<comment_list> lc = get_comment_list ();
+        std::unique_ptr<comment_list> mc = get_comment_list ();
+        std::unique_ptr<comment_list> tc = get_comment_list ();
+
+        retval.reset (new tree_try_catch_command (body.release (),
+                                                  cleanup.release (),
+                                                  id.release (),
+                                                  lc.release (),
+                                                  mc.release (),
+                                                  tc.release (), l, c));
+      }
+      break;
+
+    case ptc_unwind_protect:
+      {
+        std::unique_ptr<tree_statement_list> body = get_statement_list ();
+        std::unique_ptr<tree_statement_list> cleanup = get_statement_list ();
+        std::unique_ptr<comment_list> lc = get_comment_list ();
+        std::unique_ptr<comment_list> mc = get_comment_list ();
+        std::unique_ptr<comment_list> tc = get_comment_list ();
+
+        retval.reset (new tree_unwind_protect_command (body.release (),
+                                                       cleanup.release (),
+                                                       lc.release (),
+                                                       mc.release (),
+                                                       tc.release (), l, c));
+      }
+      break;
+
+    default:
+      format_error ();
+    }
+
+  return retval;
+}
+
+std::unique_ptr<tree_statement>
+tree_cache_reader::get_statement ()
+{
+  unsigned char kind = get_byte ();
+
+  std::unique_ptr<tree_command> cmd;
+  std::unique_ptr<tree_expression> expr;
+
+  if (kind == 1)
+    cmd = get_command ();
+  else if (kind == 2)
+    expr = get_expr ();
+  else if (kind != 0)
+    format_error ();
+
+  std::unique_ptr<comment_list> lst = get_comment_list ();
+
+  if (expr)
+    return std::unique_ptr<tree_statement>
+             (new tree_statement (expr.release (), lst.release ()));
+  else
+    return std::unique_ptr<tree_statement>
+             (new tree_statement (cmd.release (), lst.release ()));
+}
+
+std::unique_ptr<tree_statement_list>
+tree_cache_reader::get_statement_list ()
+{
+  if (! get_bool ())
+    return nullptr;
+
+  bool function_body = get_bool ();
+  bool anon_function_body = get_bool ();
+  bool script_body = get_bool ();
+
+  std::unique_ptr<tree_statement_list> retval (new tree_statement_list ());
+
+  if (function_body)
+    retval->mark_as_function_body ();
+  if (anon_function_body)
+    retval->mark_as_anon_function_body ();
+  if (script_body)
+    retval->mark_as_script_body ();
+
+  std::size_t n = get_count ();
+
+  for (std::size_t i = 0; i < n; i++)
+    retval->push_back (get_statement ().release ());
+
+  return retval;
+}
+
+std::unique_ptr<tree_argument_list>
+tree_cache_reader::get_argument_list ()
+{
+  if (! get_bool ())
+    return nullptr;
+
+  bool simple_assign_lhs = get_bool ();
+
+  std::unique_ptr<tree_argument_list> retval (new tree_argument_list ());
+
+  if (simple_assign_lhs)
+    retval->mark_as_simple_assign_lhs ();
+
+  std::size_t n = get_count ();
+
+  for (std::size_t i = 0; i < n; i++)
+    retval->push_back (get_expr ().release ());
+
+  return retval;
+}
+
+std::unique_ptr<tree_parameter_list>
+tree_cache_reader::get_parameter_list ()
+{
+  if (! get_bool ())
+    return nullptr;
+
+  bool is_input = get_bool ();
+  int varargs = get_int ();
+
+  std::unique_ptr<tree_parameter_list> retval
+    (new tree_parameter_list (is_input ? tree_parameter_list::in
+                              : tree_parameter_list::out));
+
+  if (varargs < 0)
+    retval->mark_varargs_only ();
+  else if (varargs > 0)
+    retval->mark_varargs ();
+
+  std::size_t n = get_count ();
+
+  for (std::size_t i = 0; i < n; i++)
+    retval->push_back (get_decl_elt ().release ());
+
+  return retval;
+}
+
+std::unique_ptr<tree_decl_elt>
+tree_cache_reader::get_decl_elt ()
+{
+  unsigned char type = get_byte ();
+
+  std::unique_ptr<tree_identifier> id = get_identifier ();
+  std::unique_ptr<tree_expression> expr = get_expr ();
+
+  if (! id)
+    format_error ();
+
+  std::unique_ptr<tree_decl_elt> retval
+    (new tree_decl_elt (id.release (), expr.release ()));
+
+  if (type == 1)
+    retval->mark_global ();
+  else if (type == 2)
+    retval->mark_persistent ();
+
+  return retval;
+}
+
+std::unique_ptr<comment_list>
+tree_cache_reader::get_comment_list ()
+{
+  if (! get_bool ())
+    return nullptr;
+
+  std::unique_ptr<comment_list> retval (new comment_list ());
+
+  std::size_t n = get_count ();
+
+  for (std::size_t i = 0; i < n; i++)
+    {
+      std::string text = get_string ();
+
+      uint64_t type = get_uint ();
+
+      if (type > comment_elt::copyright)
+        format_error ();
+
+      bool uses_hash_char = get_bool ();
+
+      retval->append (text, static_cast<comment_elt::comment_type> (type),
+                      uses_hash_char);
+    }
+
+  return retval;
+}
+
+symbol_scope
+tree_cache_reader::get_scope ()
+{
+  std::string name = get_string ();
+  bool is_static = get_bool ();
+  bool is_primary_fcn_scope = get_bool ();
+
+  std::size_t n = get_count ();
+
+  // The new scope already contains "ans".
+
+  symbol_scope scope (name);
+
+  for (std::size_t i = 0; i < n; i++)
+    {
+      std::string nm = get_string ();
+
+      symbol_record sr = (i == 0 ? scope.lookup_symbol (nm)
+                          : scope.insert (nm));
+
+      if (! sr || sr.data_offset () != i)
+        format_error ();
+
+      if (get_bool ())
+        sr.mark_local ();
+      else
+        sr.unmark_local ();
+
+      if (get_bool ())
+        sr.mark_formal ();
+      else
+        sr.unmark_formal ();
+
+      if (get_bool ())
+        sr.mark_added_static ();
+      else
+        sr.unmark_added_static ();
+
+      if (get_bool ())
+        sr.mark_variable ();
+      else
+        sr.unmark_variable ();
+    }
+
+  if (is_static)
+    scope.mark_static ();
+
+  if (is_primary_fcn_scope)
+    scope.mark_primary_fcn_scope ();
+
+  return scope;
+}
+
+octave_value
+tree_cache_reader::get_value ()
+{
+  unsigned char kind = get_byte ();
+
+  switch (kind)
+    {
+    case ptc_magic_colon:
+      return octave_value (octave_value::magic_colon_t);
+
+    case ptc_null_matrix:
+      return octave_null_matrix::instance;
+
+    case ptc_null_str:
+      return octave_null_str::instance;
+
+    case ptc_null_sq_str:
+      return octave_null_sq_str::instance;
+
+    case ptc_magic_int:
+      return octave_value (new octave_magic_int (octave_int64 (get_int ())));
+
+    case ptc_magic_uint:
+      return octave_value (new octave_magic_uint (octave_uint64 (get_uint ())));
+
+    case ptc_binary_data:
+      {
+        std::string type_name = get_string ();
+
+        type_info& ti = __get_type_info__ ();
+
+        octave_value retval = ti.lookup_type (type_name);
+
+        if (retval.is_undefined ()
+            || ! retval.load_binary (m_is, false,
+                                     mach_info::native_float_format ()))
+          format_error ();
+
+        return retval;
+      }
+
+    default:
+      format_error ();
+    }
+}
+
+// A 64-bit FNV-1a hash of the file name, used to give the cache files
+// of functions with the same name in different directories unique
+// names.
+
+static std::string
+file_name_hash (const std::string& s)
+{
+  uint64_t hash = 14695981039346656037ULL;
+
+  for (unsigned char c : s)
+    {
+      hash ^= c;
+      hash *= 1099511628211ULL;
+    }
+
+  std::ostringstream buf;
+
+  buf << std::hex;
+  buf.width (16);
+  buf.fill ('0');
+  buf << hash;
+
+  return buf.str ();
+}
+
+parse_tree_cache::parse_tree_cache (const std::string& full_file,
+                                    const std::string& file,
+                                    const std::string& dir_name,
+                                    const std::string& dispatch_type,
+                                    const std::string& package_name,
+                                    const std::string& encoding,
+                                    bool force_script, bool autoload,
+                                    bool relative_lookup)
+  : m_full_file (full_file), m_file (file), m_dir_name (dir_name),
+    m_dispatch_type (dispatch_type), m_package_name (package_name),
+    m_encoding (encoding), m_force_script (force_script),
+    m_autoload (autoload), m_relative_lookup (relative_lookup),
+    m_cache_file ()
+{
+  // Cache files are identified by the full name of the source file, so
+  // relative names can not be used.
+
+  if (! sys::env::absolute_pathname (m_full_file))
+    return;
+
+  std::string cache_dir = directory ();
+
+  if (! cache_dir.empty ())
+    m_cache_file
+      = sys::file_ops::concat (cache_dir,
+                               sys::file_ops::tail (m_full_file) + '-'
+                               + file_name_hash (m_full_file) + ".ptc");
+}
+
+std::string
+parse_tree_cache::directory ()
+{
+  std::string dir = sys::env::getenv ("OCTAVE_PARSE_TREE_CACHE_DIR");
+
+  if (! dir.empty ())
+    dir = sys::env::make_absolute (sys::file_ops::tilde_expand (dir));
+
+  return dir;
+}
+
+std::string
+parse_tree_cache::cache_key () const
+{
+  std::ostringstream buf;
+
+  buf << OCTAVE_VERSION << '\0' << m_full_file << '\0' << m_file << '\0'
+      << m_dispatch_type << '\0' << m_package_name << '\0' << m_encoding
+      << '\0' << m_force_script << m_autoload;
+
+  return buf.str ();
+}
+
+octave_value
+parse_tree_cache::load (interpreter& interp, const sys::file_stat& fs)
+{
+  if (! enabled () || ! fs)
+    return octave_value ();
+
+  std::ifstream is = sys::ifstream (m_cache_file.c_str (),
+                                    std::ios::in | std::ios::binary);
+
+  if (! is)
+    return octave_value ();
+
+  // A missing, outdated, or damaged cache file just means that the
+  // file is parsed and a new cache file is written.
+
+  try
+    {
+      tree_cache_reader reader (is, m_full_file, m_file, m_dir_name,
+                                m_package_name, m_relative_lookup);
+
+      if (reader.read_header (cache_key (), fs))
+        return reader.read_code ();
+    }
+  catch (const tree_cache_format_error&)
+    { }
+  catch (const execution_exception&)
+    {
+      interp.recover_from_exception ();
+    }
+
+  return octave_value ();
+}
+
+bool
+parse_tree_cache::save (const octave_value& fcn,
+                        const sys::file_stat& fs)
+{
+  if (! enabled ())
+    return false;
+
+  // A file that was modified within the current second could be
+  // modified again without changing its time stamp.
+
+  sys::time now;
+
+  if (! fs || fs.mtime ().unix_time () >= now.unix_time ())
+    return false;
+
+  // Write the complete tree to memory first so that nothing is written
+  // if it contains something that can not be stored.
+
+  std::ostringstream buf;
+
+  tree_cache_writer writer (buf);
+
+  writer.write_header (cache_key (), fs);
+
+  if (fcn.is_user_function ())
+    writer.write_fcn_file (*(fcn.user_function_value ()));
+  else if (fcn.is_user_script ())
+    writer.write_script_file (*(fcn.user_script_value ()));
+  else
+    return false;
+
+  if (! writer.ok ())
+    return false;
+
+  std::string cache_dir = directory ();
+
+  std::string msg;
+
+  if (! sys::dir_exists (cache_dir)
+      && sys::recursive_mkdir (cache_dir, 0777, msg) < 0)
+    return false;
+
+  // As for the load path cache, write a temporary file and rename it
+  // so that concurrent sessions never see a partially written file.
+  // The temporary file is created with a unique name because the cache
+  // directory may be shared by sessions on several hosts.
+
+  std::string tmp_file = m_cache_file + ".XXXXXX";
+
+  int fd = octave_mkostemp_wrapper (&tmp_file[0]);
+
+  if (fd < 0)
+    return false;
+
+  octave_close_wrapper (fd);
+
+  {
+    std::ofstream os = sys::ofstream (tmp_file.c_str (),
+                                      std::ios::out | std::ios::binary);
+
+    if (! os)
+      return false;
+
+    std::string data = buf.str ();
+
+    os.write (data.data (), data.length ());
+
+    os.close ();
+
+    if (! os)
+      {
+        sys::unlink (tmp_file);
+        return false;
+      }
+  }
+
+  if (sys::rename (tmp_file, m_cache_file, msg) < 0)
+    {
+      sys::unlink (tmp_file);
+      return false;
+    }
+
+  return true;
+}
+
+OCTAVE_END_NAMESPACE(octave)
+
+/*
+%!test
+%! old_cache_dir = getenv ("OCTAVE_PARSE_TREE_CACHE_DIR");
+%! cache_dir = tempname ();
+%! fcn_dir = tempname ();
+%! mkdir (fcn_dir);
+%! fcn_file = fullfile (fcn_dir, "ptc_test_fcn.m");
+%! fid = fopen (fcn_file, "w");
+%! fprintf (fid, "## Help text of ptc_test_fcn.\n\n");
+%! fprintf (fid, "function r = ptc_test_fcn (x)\n");
+%! fprintf (fid, "  f = @(y) y.^2 + 1;\n");
+%! fprintf (fid, "  r.a = [1, 2; 3, 4] * x;\n");
+%! fprintf (fid, "  r.b = {'abc', \"de\", 1:5, -int8 (7)};\n");
+%! fprintf (fid, "  r.c = 0;\n");
+%! fprintf (fid, "  for i = 1:3\n");
+%! fprintf (fid, "    if (mod (i, 2))\n");
+%! fprintf (fid, "      r.c += f (i);\n");
+%! fprintf (fid, "    else\n");
+%! fprintf (fid, "      r.c -= sub (i);\n");
+%! fprintf (fid, "    endif\n");
+%! fprintf (fid, "  endfor\n");
+%! fprintf (fid, "  switch (x)\n");
+%! fprintf (fid, "    case {1, 2}\n");
+%! fprintf (fid, "      r.d = \"small\";\n");
+%! fprintf (fid, "    otherwise\n");
+%! fprintf (fid, "      r.d = \"large\";\n");
+%! fprintf (fid, "  endswitch\n");
+%! fprintf (fid, "  try\n");
+%! fprintf (fid, "    error (\"ptc:test\", \"oops\");\n");
+%! fprintf (fid, "  catch err\n");
+%! fprintf (fid, "    r.e = err.identifier;\n");
+%! fprintf (fid, "  end_try_catch\n");
+%! fprintf (fid, "endfunction\n");
+%! fprintf (fid, "function s = sub (n)\n");
+%! fprintf (fid, "  persistent k;\n");
+%! fprintf (fid, "  if (isempty (k))\n");
+%! fprintf (fid, "    k = 10;\n");
+%! fprintf (fid, "  endif\n");
+%! fprintf (fid, "  s = n + k;\n");
+%! fprintf (fid, "endfunction\n");
+%! fclose (fid);
+%! ## The cache is only written for files that are older than the
+%! ## current second.
+%! pause (1.1);
+%! unwind_protect
+%!   setenv ("OCTAVE_PARSE_TREE_CACHE_DIR", cache_dir);
+%!   addpath (fcn_dir);
+%!   r1 = ptc_test_fcn (2);
+%!   h1 = help ("ptc_test_fcn");
+%!   assert (numel (glob (fullfile (cache_dir, "ptc_test_fcn.m-*.ptc"))), 1);
+%!   clear ptc_test_fcn;
+%!   r2 = ptc_test_fcn (2);
+%!   h2 = help ("ptc_test_fcn");
+%!   assert (r2, r1);
+%!   assert (h2, h1);
+%!   assert (r2.c, 1+1 + 9+1 - (2+10));
+%!   assert (r2.e, "ptc:test");
+%! unwind_protect_cleanup
+%!   rmpath (fcn_dir);
+%!   clear ptc_test_fcn;
+%!   if (isempty (old_cache_dir))
+%!     unsetenv ("OCTAVE_PARSE_TREE_CACHE_DIR");
+%!   else
+%!     setenv ("OCTAVE_PARSE_TREE_CACHE_DIR", old_cache_dir);
+%!   endif
+%!   confirm_recursive_rmdir (false, "local");
+%!   sts = rmdir (fcn_dir, "s");
+%!   if (exist (cache_dir, "dir"))
+%!     sts = rmdir (cache_dir, "s");
+%!   endif
+%! end_unwind_protect
+
+## Files that warn while they are parsed are not cached, even if the
+## warning is disabled, so that the warning is shown once it is enabled.
+%!test
+%! old_cache_dir = getenv ("OCTAVE_PARSE_TREE_CACHE_DIR");
+%! cache_dir = tempname ();
+%! fcn_dir = tempname ();
+%! mkdir (fcn_dir);
+%! fcn_file = fullfile (fcn_dir, "ptc_test_warn_fcn.m");
+%! fid = fopen (fcn_file, "w");
+%! fprintf (fid, "function r = ptc_test_warn_fcn (x)\n");
+%! fprintf (fid, "  r = 0;\n");
+%! fprintf (fid, "  if (r = x)\n");
+%! fprintf (fid, "    r = 2;\n");
+%! fprintf (fid, "  endif\n");
+%! fprintf (fid, "endfunction\n");
+%! fclose (fid);
+%! pause (1.1);
+%! unwind_protect
+%!   setenv ("OCTAVE_PARSE_TREE_CACHE_DIR", cache_dir);
+%!   addpath (fcn_dir);
+%!   warning ("off", "Octave:assign-as-truth-value", "local");
+%!   assert (ptc_test_warn_fcn (1), 2);
+%!   assert (isempty (glob (fullfile (cache_dir, "ptc_test_warn_fcn.m-*.ptc"))));
+%!   clear ptc_test_warn_fcn;
+%!   warning ("on", "Octave:assign-as-truth-value", "local");
+%!   lastwarn ("");
+%!   assert (ptc_test_warn_fcn (1), 2);
+%!   [~, id] = lastwarn ();
+%!   assert (id, "Octave:assign-as-truth-value");
+%! unwind_protect_cleanup
+%!   rmpath (fcn_dir);
+%!   clear ptc_test_warn_fcn;
+%!   if (isempty (old_cache_dir))
+%!     unsetenv ("OCTAVE_PARSE_TREE_CACHE_DIR");
+%!   else
+%!     setenv ("OCTAVE_PARSE_TREE_CACHE_DIR", old_cache_dir);
+%!   endif
+%!   confirm_recursive_rmdir (false, "local");
+%!   sts = rmdir (fcn_dir, "s");
+%!   if (exist (cache_dir, "dir"))
+%!     sts = rmdir (cache_dir, "s");
+%!   endif
+%! end_unwind_protect
+*/
@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_pt_cache_h)
+#define octave_pt_cache_h 1
+
+#include "octave-config.h"
+
+#include <string>
+
+#include "file-stat.h"
+
+class octave_value;
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+class interpreter;
+
+// Cache of parse trees for function and script files.
+//
+// If the environment variable OCTAVE_PARSE_TREE_CACHE_DIR names a
+// directory, the parse tree of each function or script file that is
+// read is saved there in a compact binary form.  The next time the file
+// is needed, the parse tree is restored from the cache instead of
+// parsing the file again, provided that the file still has the same
+// modification time and size.
+//
+// Files that can not be represented in the cache (classdef files and
+// files with nested functions, for example) or that produce warnings
+// when they are parsed are always parsed.
+
+class parse_tree_cache
+{
+public:
+
+  parse_tree_cache (const std::string& full_file, const std::string& file,
+                    const std::string& dir_name,
+                    const std::string& dispatch_type,
+                    const std::string& package_name,
+                    const std::string& encoding, bool force_script,
+                    bool autoload, bool relative_lookup);
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (parse_tree_cache)
+
+  ~parse_tree_cache () = default;
+
+  // The cache directory, or an empty string if caching is disabled.
+  static std::string directory ();
+
+  bool enabled () const { return ! m_cache_file.empty (); }
+
+  // Return the function or script restored from the cache, or an
+  // undefined value if there is no valid cache entry.  FS is the status
+  // of the file.
+  octave_value load (interpreter& interp, const sys::file_stat& fs);
+
+  // Save the parse tree of the function or script FCN that was just
+  // read from the file.  FS is the status of the file taken before it
+  // was parsed.  Return false if the tree was not saved.
+  bool save (const octave_value& fcn, const sys::file_stat& fs);
+
+private:
+
+  // All the parameters that influence the result of parsing the file.
+  std::string cache_key () const;
+
+  std::string m_full_file;
+  std::string m_file;
+  std::string m_dir_name;
+  std::string m_dispatch_type;
+  std::string m_package_name;
+  std::string m_encoding;
+
+  bool m_force_script;
+  bool m_autoload;
+  bool m_relative_lookup;
+
+  std::string m_cache_file;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
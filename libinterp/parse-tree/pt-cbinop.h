@@ -61,6 +61,8 @@ public:
 
   octave_value::compound_binary_op cop_type () const { return m_etype; }
 
+  bool is_compound_binary_expression () const { return true; }
+
   bool rvalue_ok () const { return true; }
 
   tree_expression * clhs () { return m_lhs; }
@@ -32,6 +32,7 @@
 #include <condition_variable>
 #include <iostream>
 #include <list>
+#include <map>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -41,6 +42,7 @@
 #include "file-stat.h"
 #include "lo-array-errwarn.h"
 #include "lo-ieee.h"
+#include "lo-mappers.h"
 #include "oct-env.h"
 
 #include "bp-table.h"
@@ -61,11 +63,15 @@
 #include "ov-usr-fcn.h"
 #include "ov-re-sparse.h"
 #include "ov-cx-sparse.h"
+#include "oct-labs.h"
+#include "oct-workers.h"
 #include "parse.h"
 #include "profiler.h"
 #include "pt-all.h"
 #include "pt-anon-scopes.h"
+#include "pt-bytecode.h"
 #include "pt-eval.h"
+#include "pt-parfor.h"
 #include "pt-tm-const.h"
 #include "stack-frame.h"
 #include "symtab.h"
@@ -3156,9 +3162,6 @@ tree_evaluator::visit_simple_for_command (tree_simple_for_command& cmd)
   if (m_debug_mode)
     do_breakpoint (cmd.is_active_breakpoint (*this));
 
-  // FIXME: need to handle PARFOR loops here using cmd.in_parallel ()
-  // and cmd.maxproc_expr ();
-
   unwind_protect_var<bool> upv (m_in_loop_command, true);
 
   tree_expression *expr = cmd.control_expr ();
@@ -3168,6 +3171,9 @@ tree_evaluator::visit_simple_for_command (tree_simple_for_command& cmd)
   if (rhs.is_undefined ())
     return;
 
+  if (cmd.in_parallel () && execute_parfor_loop (cmd, rhs))
+    return;
+
   tree_expression *lhs = cmd.left_hand_side ();
 
   octave_lvalue ult = lhs->lvalue (*this);
@@ -3270,6 +3276,351 @@ tree_evaluator::visit_simple_for_command (tree_simple_for_command& cmd)
          cmd.line (), cmd.column ());
 }
 
+// Values of the sliced variable X assigned by the iterations FIRST to
+// LAST-1 of a parfor loop, as a cell array {INDICES, VALUES}.
+// Iterations that are beyond the extent of X did not assign anything.
+
+static octave_value
+parfor_slice (octave_value x, const parfor_analyzer::sliced_var& sv,
+              const NDArray& iter, octave_idx_type first,
+              octave_idx_type last)
+{
+  Cell retval (1, 2, Matrix ());
+
+  if (x.is_undefined ())
+    return retval;
+
+  dim_vector dv = x.dims ();
+
+  octave_idx_type extent = 1;
+
+  if (sv.position == sv.nargs - 1)
+    {
+      for (int d = sv.position; d < dv.ndims (); d++)
+        extent *= dv(d);
+    }
+  else if (sv.position < dv.ndims ())
+    extent = dv(sv.position);
+
+  std::vector<double> keep;
+
+  for (octave_idx_type k = first; k < last; k++)
+    {
+      double v = iter(k);
+
+      if (v >= 1 && v <= extent)
+        keep.push_back (v);
+    }
+
+  if (keep.empty ())
+    return retval;
+
+  RowVector idx_vals (keep.size ());
+
+  for (std::size_t k = 0; k < keep.size (); k++)
+    idx_vals(k) = keep[k];
+
+  octave_value_list idx (sv.nargs, octave_value::magic_colon_t);
+
+  idx(sv.position) = idx_vals;
+
+  retval(0) = idx_vals;
+  retval(1) = x.index_op (idx);
+
+  return retval;
+}
+
+// Execute the iterations FIRST to LAST-1 of a parfor loop in a worker
+// process and send the partial results of the reduction variables, the
+// assigned parts of the sliced variables, and the final values of the
+// temporaries to the parent.
+
+int
+tree_evaluator::parfor_worker (worker_channel& chan,
+                               tree_simple_for_command& cmd,
+                               const parfor_analyzer& pa,
+                               const NDArray& iter, octave_idx_type first,
+                               octave_idx_type last)
+{
+  const std::vector<parfor_analyzer::reduction_var>& reductions
+    = pa.reductions ();
+  const std::vector<parfor_analyzer::sliced_var>& sliced = pa.sliced ();
+  const std::vector<std::string>& temporaries = pa.temporaries ();
+
+  // {OK, MESSAGE, IDENTIFIER, VALUES}
+  Cell result (1, 4, Matrix ());
+
+  try
+    {
+      for (const auto& rv : reductions)
+        assign (rv.name,
+                parfor_analyzer::identity (rv.op, varval (rv.name)));
+
+      // Temporaries are always assigned before they are used, so a
+      // defined value at the end was assigned by this worker.
+
+      for (const auto& name : temporaries)
+        clear_variable (name);
+
+      std::string loop_var = cmd.left_hand_side ()->name ();
+
+      tree_statement_list *loop_body = cmd.body ();
+
+      for (octave_idx_type k = first; k < last; k++)
+        {
+          assign (loop_var, iter(k));
+
+          if (loop_body)
+            loop_body->accept (*this);
+
+          if (quit_loop_now ())
+            break;
+        }
+
+      Cell values (1, reductions.size () + sliced.size ()
+                      + temporaries.size ());
+
+      octave_idx_type j = 0;
+
+      for (const auto& rv : reductions)
+        values(j++) = varval (rv.name);
+
+      for (const auto& sv : sliced)
+        values(j++) = parfor_slice (varval (sv.name), sv, iter, first, last);
+
+      // {VALUE} if the temporary was assigned, {} otherwise.
+
+      for (const auto& name : temporaries)
+        {
+          octave_value val = varval (name);
+
+          values(j++) = val.is_defined () ? Cell (1, 1, val) : Cell ();
+        }
+
+      result(0) = true;
+      result(3) = values;
+    }
+  catch (const execution_exception& ee)
+    {
+      result(0) = false;
+      result(1) = ee.message ();
+      result(2) = ee.identifier ();
+    }
+  catch (const interrupt_exception&)
+    {
+      result(0) = false;
+      result(1) = "parfor: worker interrupted";
+    }
+
+  chan.send (octave_value (result));
+
+  return 0;
+}
+
+// Execute a parfor loop with a pool of forked worker processes.  Each
+// worker runs a contiguous block of iterations.  Return false if the
+// loop has to be executed serially instead.
+
+bool
+tree_evaluator::execute_parfor_loop (tree_simple_for_command& cmd,
+                                     const octave_value& rhs)
+{
+  // Check the maximum number of workers even if the loop is executed
+  // serially.
+
+  int num_workers = m_parfor_num_workers;
+
+  tree_expression *maxproc = cmd.maxproc_expr ();
+
+  if (maxproc)
+    {
+      octave_value tmp = maxproc->evaluate (*this);
+
+      double val = tmp.xdouble_value ("parfor: maximum number of workers must be a real scalar");
+
+      if (math::isnan (val) || val < 0 || math::x_nint (val) != val)
+        error ("parfor: maximum number of workers must be a non-negative integer");
+
+      num_workers = (val > worker_process::num_processors ()
+                     ? worker_process::num_processors ()
+                     : static_cast<int> (val));
+    }
+
+  if (worker_process::in_worker () || ! worker_process::available ()
+      || m_debug_mode || m_echo_state || m_profiler.enabled ())
+    return false;
+
+  if (! (rhs.is_double_type () && rhs.isreal ()
+         && rhs.ndims () == 2 && rhs.rows () == 1))
+    return false;
+
+  num_workers = std::min (num_workers, worker_process::num_processors ());
+
+  NDArray iter = rhs.array_value ();
+
+  octave_idx_type steps = iter.numel ();
+
+  if (steps < num_workers)
+    num_workers = steps;
+
+  if (num_workers < 2)
+    return false;
+
+  tree_expression *lhs = cmd.left_hand_side ();
+
+  if (! lhs->is_identifier ())
+    return false;
+
+  std::string loop_var = lhs->name ();
+
+  parfor_analyzer pa (loop_var);
+
+  if (! pa.analyze (cmd.body ()))
+    return false;
+
+  const std::vector<parfor_analyzer::reduction_var>& reductions
+    = pa.reductions ();
+  const std::vector<parfor_analyzer::sliced_var>& sliced = pa.sliced ();
+
+  // Let the serial loop report undefined reduction variables.
+
+  for (const auto& rv : reductions)
+    {
+      if (! is_variable (rv.name)
+          || ! parfor_analyzer::parallel_reduction (rv.op, varval (rv.name)))
+        return false;
+    }
+
+  // Workers that are still running when this function exits (because
+  // of an error or an interrupt) are killed by the destructor.
+
+  std::vector<std::unique_ptr<worker_process>> workers;
+
+  for (int w = 0; w < num_workers; w++)
+    {
+      octave_idx_type first = (steps * w) / num_workers;
+      octave_idx_type last = (steps * (w + 1)) / num_workers;
+
+      workers.push_back (std::make_unique<worker_process> ());
+
+      bool started = workers.back ()->start
+        ([this, &cmd, &pa, &iter, first, last] (worker_channel& chan)
+         {
+           return parfor_worker (chan, cmd, pa, iter, first, last);
+         });
+
+      // Nothing has been modified yet, so fall back to serial
+      // execution if the workers can't be created.
+
+      if (! started)
+        return false;
+    }
+
+  std::vector<Cell> results (num_workers);
+
+  std::string err_msg;
+  std::string err_id;
+  bool failed = false;
+
+  for (int w = 0; w < num_workers; w++)
+    {
+      octave_value tmp = workers[w]->channel ().receive ();
+
+      workers[w]->wait ();
+
+      Cell result = tmp.cell_value ();
+
+      if (result(0).is_true ())
+        results[w] = result(3).cell_value ();
+      else if (! failed)
+        {
+          failed = true;
+          err_msg = result(1).string_value ();
+          err_id = result(2).string_value ();
+        }
+    }
+
+  if (failed)
+    {
+      if (err_id.empty ())
+        error ("%s", err_msg.c_str ());
+      else
+        error_with_id (err_id.c_str (), "%s", err_msg.c_str ());
+    }
+
+  // Merge the results in iteration order.
+
+  octave_idx_type j = 0;
+
+  for (const auto& rv : reductions)
+    {
+      octave_value acc = varval (rv.name);
+
+      for (int w = 0; w < num_workers; w++)
+        acc = parfor_analyzer::combine (m_interpreter, rv, acc,
+                                        results[w](j));
+
+      assign (rv.name, acc);
+
+      j++;
+    }
+
+  for (const auto& sv : sliced)
+    {
+      octave_value x = varval (sv.name);
+
+      // Release the reference held by the variable so that X may be
+      // modified in place.
+
+      assign (sv.name, octave_value ());
+
+      for (int w = 0; w < num_workers; w++)
+        {
+          Cell part = results[w](j).cell_value ();
+
+          if (part(0).isempty ())
+            continue;
+
+          octave_value_list idx (sv.nargs, octave_value::magic_colon_t);
+
+          idx(sv.position) = part(0);
+
+          x.assign (octave_value::op_asn_eq, "(",
+                    std::list<octave_value_list> (1, idx), part(1));
+        }
+
+      assign (sv.name, x);
+
+      j++;
+    }
+
+  // Temporaries keep the value of the last iteration that assigned
+  // them.
+
+  for (const auto& name : pa.temporaries ())
+    {
+      for (int w = num_workers - 1; w >= 0; w--)
+        {
+          Cell part = results[w](j).cell_value ();
+
+          if (! part.isempty ())
+            {
+              assign (name, part(0));
+              break;
+            }
+        }
+
+      j++;
+    }
+
+  // As for a serial loop, leave the loop variable set to the last
+  // value.
+
+  assign (loop_var, iter(steps-1));
+
+  return true;
+}
+
 void
 tree_evaluator::visit_complex_for_command (tree_complex_for_command& cmd)
 {
@@ -3349,7 +3700,10 @@ tree_evaluator::visit_complex_for_command (tree_complex_for_command& cmd)
 void
 tree_evaluator::visit_spmd_command (tree_spmd_command& cmd)
 {
-  // For now, we just execute the commands serially.
+  if (execute_spmd_block (cmd))
+    return;
+
+  // Execute the commands serially as a single lab.
 
   tree_statement_list *body = cmd.body ();
 
@@ -3357,6 +3711,223 @@ tree_evaluator::visit_spmd_command (tree_spmd_command& cmd)
     body->accept (*this);
 }
 
+// Execute the body of an spmd block as lab LABINDEX of NUMLABS in a
+// worker process and send the names and values of all variables that
+// were created or modified by the block to the client.
+
+int
+tree_evaluator::spmd_worker (worker_channel& chan, tree_spmd_command& cmd,
+                             int labindex, int numlabs,
+                             std::vector<int>& lab_fds)
+{
+  lab_context::attach (labindex, numlabs, lab_fds);
+
+  // {OK, MESSAGE, IDENTIFIER, NAMES, VALUES}
+  Cell result (1, 5, Matrix ());
+
+  try
+    {
+      // Variables are shared with the client until they are modified,
+      // so unchanged values still refer to the same representation
+      // after the block is executed.
+
+      std::map<std::string, octave_value> initial_vals;
+
+      for (const auto& name : variable_names ())
+        {
+          if (! is_global (name))
+            initial_vals[name] = varval (name);
+        }
+
+      tree_statement_list *body = cmd.body ();
+
+      if (body)
+        body->accept (*this);
+
+      std::list<std::string> names;
+      std::list<octave_value> values;
+
+      for (const auto& name : variable_names ())
+        {
+          if (is_global (name))
+            continue;
+
+          octave_value val = varval (name);
+
+          if (val.is_undefined ())
+            continue;
+
+          auto p = initial_vals.find (name);
+
+          if (p != initial_vals.end () && val.is_copy_of (p->second))
+            continue;
+
+          names.push_back (name);
+          values.push_back (val);
+        }
+
+      result(0) = true;
+      result(3) = Cell (string_vector (names));
+      result(4) = Cell (octave_value_list (values));
+    }
+  catch (const execution_exception& ee)
+    {
+      result(0) = false;
+      result(1) = ee.message ();
+      result(2) = ee.identifier ();
+    }
+  catch (const interrupt_exception&)
+    {
+      result(0) = false;
+      result(1) = "spmd: lab interrupted";
+    }
+
+  try
+    {
+      chan.send (octave_value (result));
+    }
+  catch (const execution_exception& ee)
+    {
+      // A value that can't be serialized.
+
+      Cell err (1, 5, Matrix ());
+
+      err(0) = false;
+      err(1) = ee.message ();
+      err(2) = ee.identifier ();
+
+      chan.send (octave_value (err));
+    }
+
+  return 0;
+}
+
+// Execute an spmd block with a pool of forked worker processes (labs).
+// Variables that are modified by the block become cell arrays in the
+// client with one element for each lab.  Return false if the block has
+// to be executed serially instead.
+
+bool
+tree_evaluator::execute_spmd_block (tree_spmd_command& cmd)
+{
+  if (worker_process::in_worker () || ! worker_process::available ()
+      || m_debug_mode || m_echo_state || m_profiler.enabled ())
+    return false;
+
+  int numlabs = std::min (m_spmd_num_workers,
+                          worker_process::num_processors ());
+
+  if (numlabs < 2 || ! cmd.body ())
+    return false;
+
+  std::vector<int> lab_fds;
+
+  if (! lab_context::create_pipes (numlabs, lab_fds))
+    return false;
+
+  // Labs that are still running when this function exits (because of
+  // an error or an interrupt) are killed by the destructor.
+
+  std::vector<std::unique_ptr<worker_process>> labs;
+
+  for (int k = 1; k <= numlabs; k++)
+    {
+      labs.push_back (std::make_unique<worker_process> ());
+
+      bool started = labs.back ()->start
+        ([this, &cmd, k, numlabs, &lab_fds] (worker_channel& chan)
+         {
+           return spmd_worker (chan, cmd, k, numlabs, lab_fds);
+         });
+
+      if (! started)
+        {
+          lab_context::close_pipes (lab_fds);
+          return false;
+        }
+    }
+
+  // Only the labs use the pipes between labs.  Closing them here
+  // ensures that a lab waiting for a message from a lab that exited
+  // sees the end of the pipe.
+
+  lab_context::close_pipes (lab_fds);
+
+  std::vector<Cell> results (numlabs);
+
+  int failed_lab = 0;
+
+  for (int k = 0; k < numlabs; k++)
+    {
+      octave_value tmp = labs[k]->channel ().receive ();
+
+      labs[k]->wait ();
+
+      results[k] = tmp.cell_value ();
+
+      if (results[k](0).is_true ())
+        continue;
+
+      // Prefer the original error to errors of labs that were waiting
+      // for a message from the failed lab.
+
+      if (! failed_lab
+          || (results[failed_lab-1](2).string_value ()
+              == "Octave:spmd-lab-exited"))
+        failed_lab = k + 1;
+    }
+
+  if (failed_lab)
+    {
+      const Cell& result = results[failed_lab-1];
+
+      std::string msg = result(1).string_value ();
+      std::string id = result(2).string_value ();
+
+      if (id.empty ())
+        error ("%s", msg.c_str ());
+      else
+        error_with_id (id.c_str (), "%s", msg.c_str ());
+    }
+
+  // Collect the values of each variable in lab order.  Labs that did
+  // not modify a variable contribute its value in the client.
+
+  std::list<std::string> names;
+  std::map<std::string, Cell> vals;
+
+  for (int k = 0; k < numlabs; k++)
+    {
+      string_vector lab_names = results[k](3).string_vector_value ();
+      Cell lab_vals = results[k](4).cell_value ();
+
+      for (octave_idx_type j = 0; j < lab_names.numel (); j++)
+        {
+          std::string name = lab_names(j);
+
+          auto p = vals.find (name);
+
+          if (p == vals.end ())
+            {
+              octave_value val = varval (name);
+
+              if (val.is_undefined ())
+                val = Matrix ();
+
+              names.push_back (name);
+              p = vals.emplace (name, Cell (1, numlabs, val)).first;
+            }
+
+          p->second(k) = lab_vals(j);
+        }
+    }
+
+  for (const auto& name : names)
+    assign (name, vals[name]);
+
+  return true;
+}
+
 octave_value
 tree_evaluator::evaluate_anon_fcn_handle (tree_anon_fcn_handle& afh)
 {
@@ -3720,7 +4291,18 @@ tree_evaluator::execute_user_function (octave_user_function& user_function,
             }
         }
       else
-        cmd_list->accept (*this);
+        {
+          std::shared_ptr<bytecode> code = vm_bytecode (user_function);
+
+          if (code)
+            {
+              bytecode_vm vm (*this, *code);
+
+              vm.execute ();
+            }
+          else
+            cmd_list->accept (*this);
+        }
 
       if (m_returning)
         m_returning = 0;
@@ -3962,6 +4544,9 @@ tree_evaluator::visit_statement (tree_statement& stmt)
              && m_call_stack.current_frame () == m_debug_frame))
         m_call_stack.set_location (stmt.line (), stmt.column ());
 
+      if (m_profiler.enabled ())
+        m_profiler.statement (stmt.line ());
+
       try
         {
           if (cmd)
@@ -4704,6 +5289,8 @@ tree_evaluator::add_autoload (const std::string& fcn,
                               const std::string& nm)
 {
   m_autoload_map[fcn] = check_autoload_file (nm);
+
+  symbol_table::invalidate_lookup_caches ();
 }
 
 void
@@ -4734,6 +5321,55 @@ tree_evaluator::silent_functions (const octave_value_list& args, int nargout)
                                 "silent_functions");
 }
 
+octave_value
+tree_evaluator::parfor_num_workers (const octave_value_list& args,
+                                    int nargout)
+{
+  return set_internal_variable (m_parfor_num_workers, args, nargout,
+                                "parfor_num_workers", 0);
+}
+
+octave_value
+tree_evaluator::spmd_num_workers (const octave_value_list& args,
+                                  int nargout)
+{
+  return set_internal_variable (m_spmd_num_workers, args, nargout,
+                                "spmd_num_workers", 0);
+}
+
+octave_value
+tree_evaluator::vm_enable (const octave_value_list& args, int nargout)
+{
+  return set_internal_variable (m_vm_enable, args, nargout, "__vm_enable__");
+}
+
+std::shared_ptr<bytecode>
+tree_evaluator::vm_bytecode (octave_user_function& fcn)
+{
+  if (! (m_vm_enable || fcn.is_marked_for_vm ()))
+    return std::shared_ptr<bytecode> ();
+
+  // Debugging, echoing, and profiling all work statement by statement
+  // in the tree evaluator.
+
+  error_system& es = m_interpreter.get_error_system ();
+
+  if (m_debug_mode || m_echo_state || m_profiler.enabled ()
+      || es.debug_on_error () || es.debug_on_caught ())
+    return std::shared_ptr<bytecode> ();
+
+  std::shared_ptr<bytecode> code = fcn.get_bytecode ();
+
+  if (! code && bytecode_compiler::can_compile (fcn))
+    {
+      code = bytecode_compiler::compile (fcn);
+
+      fcn.stash_bytecode (code);
+    }
+
+  return code;
+}
+
 octave_value
 tree_evaluator::string_fill_char (const octave_value_list& args, int nargout)
 {
@@ -5434,6 +6070,149 @@ The original variable value is restored when exiting the function.
   return tw.whos_line_format (args, nargout);
 }
 
+DEFMETHOD (parfor_num_workers, interp, args, nargout,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{val} =} parfor_num_workers ()
+@deftypefnx {} {@var{old_val} =} parfor_num_workers (@var{new_val})
+@deftypefnx {} {@var{old_val} =} parfor_num_workers (@var{new_val}, "local")
+Query or set the internal variable that specifies the number of worker
+processes used to execute @code{parfor} loops.
+
+If the value is less than 2, @code{parfor} loops are executed serially
+like @code{for} loops unless the maximum number of workers is given
+explicitly with @code{parfor (@var{var} = @var{range}, @var{maxproc})}.
+The number of workers is limited by the number of available processors
+(@pxref{XREFnproc,,@code{nproc}}).  The default value is 0.
+
+Workers are copies of the Octave process that share the initial values
+of all variables with the client.  A loop is only executed in parallel
+if every variable that is assigned in the loop body is either indexed
+with the loop variable (sliced), updated with an associative operation
+such as @code{@var{x} += @var{expr}} or @code{@var{x} = [@var{x},
+@var{expr}]} (reduction), or a temporary that is assigned before it is
+used in each iteration.  Otherwise, the loop is executed serially.
+Side effects of functions called in the loop body, for example on
+global variables or other workspaces, are not propagated from the
+workers to the client.
+
+When called from inside a function with the @qcode{"local"} option, the
+variable is changed locally for the function and any subroutines it calls.
+The original variable value is restored when exiting the function.
+@seealso{nproc}
+@end deftypefn */)
+{
+  tree_evaluator& tw = interp.get_evaluator ();
+
+  return tw.parfor_num_workers (args, nargout);
+}
+
+/*
+%!test
+%! orig_val = parfor_num_workers ();
+%! old_val = parfor_num_workers (4);
+%! assert (orig_val, old_val);
+%! assert (parfor_num_workers (), 4);
+%! parfor_num_workers (orig_val);
+%! assert (parfor_num_workers (), orig_val);
+
+%!error parfor_num_workers (1, 2)
+%!error parfor_num_workers (-1)
+*/
+
+DEFMETHOD (spmd_num_workers, interp, args, nargout,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{val} =} spmd_num_workers ()
+@deftypefnx {} {@var{old_val} =} spmd_num_workers (@var{new_val})
+@deftypefnx {} {@var{old_val} =} spmd_num_workers (@var{new_val}, "local")
+Query or set the internal variable that specifies the number of labs
+(worker processes) used to execute @code{spmd} blocks.
+
+If the value is less than 2, @code{spmd} blocks are executed serially in
+the client as a single lab.  The number of labs is limited by the number
+of available processors (@pxref{XREFnproc,,@code{nproc}}).  The default
+value is 0.
+
+Each lab is a copy of the Octave process that starts with the variables of
+the client and executes the block with its own @code{labindex}.  Labs may
+exchange data with @code{labSend}, @code{labReceive}, @code{gcat}, and
+@code{gplus}.  After the block, every variable that was created or
+modified by a lab is a cell array in the client with one element for each
+lab.
+
+When called from inside a function with the @qcode{"local"} option, the
+variable is changed locally for the function and any subroutines it calls.
+The original variable value is restored when exiting the function.
+@seealso{labindex, numlabs, labSend, labReceive, gcat, gplus, nproc}
+@end deftypefn */)
+{
+  tree_evaluator& tw = interp.get_evaluator ();
+
+  return tw.spmd_num_workers (args, nargout);
+}
+
+/*
+%!test
+%! orig_val = spmd_num_workers ();
+%! old_val = spmd_num_workers (4);
+%! assert (orig_val, old_val);
+%! assert (spmd_num_workers (), 4);
+%! spmd_num_workers (orig_val);
+%! assert (spmd_num_workers (), orig_val);
+
+%!error spmd_num_workers (1, 2)
+%!error spmd_num_workers (-1)
+
+%!test
+%! x = 0;
+%! spmd
+%!   x = labindex () + numlabs ();
+%! end
+%! assert (x, 2);
+
+%!testif ; ! ispc () && nproc () > 1
+%! old_val = spmd_num_workers (2);
+%! unwind_protect
+%!   a = 5;
+%!   b = 1;
+%!   spmd
+%!     x = labindex ();
+%!     n = numlabs ();
+%!     y = gcat (x);
+%!     s = gplus (10 * x);
+%!     if (labindex () == 1)
+%!       labSend ([1, 2, 3], 2, 7);
+%!       labSend ("first", 2);
+%!     else
+%!       r = labReceive (1, 0);
+%!       [q, src, tag] = labReceive (1);
+%!       b = 2;
+%!     endif
+%!     labBarrier ();
+%!   end
+%!   assert (x, {1, 2});
+%!   assert (n, {2, 2});
+%!   assert (y, {[1, 2], [1, 2]});
+%!   assert (s, {30, 30});
+%!   assert (r, {[], "first"});
+%!   assert (q, {[], [1, 2, 3]});
+%!   assert (src, {[], 1});
+%!   assert (tag, {[], 7});
+%!   assert (a, 5);
+%!   assert (b, {1, 2});
+%! unwind_protect_cleanup
+%!   spmd_num_workers (old_val);
+%! end_unwind_protect
+
+%!testif ; ! ispc () && nproc () > 1
+%! old_val = spmd_num_workers (2);
+%! unwind_protect
+%!   fail ("spmd, if (labindex () == 2), error ('lab 2 failed'); endif, labReceive (2); end",
+%!         "lab 2 failed");
+%! unwind_protect_cleanup
+%!   spmd_num_workers (old_val);
+%! end_unwind_protect
+*/
+
 DEFMETHOD (silent_functions, interp, args, nargout,
            doc: /* -*- texinfo -*-
 @deftypefn  {} {@var{val} =} silent_functions ()
@@ -52,13 +52,16 @@ class octave_user_script;
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+class bytecode;
 class symbol_info_list;
 class symbol_scope;
 class tree_decl_elt;
 class tree_expression;
+class worker_channel;
 
 class debugger;
 class interpreter;
+class parfor_analyzer;
 class push_parser;
 class unwind_protect;
 
@@ -132,7 +135,9 @@ public:
       m_debug_mode (false), m_quiet_breakpoint_flag (false),
       m_debugger_stack (), m_exit_status (0), m_max_recursion_depth (256),
       m_whos_line_format ("  %la:5; %ln:6; %cs:16:6:1;  %rb:12;  %lc:-1;\n"),
-      m_silent_functions (false), m_string_fill_char (' '), m_PS4 ("+ "),
+      m_silent_functions (false), m_parfor_num_workers (0),
+      m_spmd_num_workers (0), m_vm_enable (false),
+      m_string_fill_char (' '), m_PS4 ("+ "),
       m_dbstep_flag (0), m_break_on_next_stmt (false), m_echo (ECHO_OFF),
       m_echo_state (false), m_echo_file_name (),
       m_echo_file_pos (1),
@@ -624,6 +629,45 @@ public:
   octave_value
   silent_functions (const octave_value_list& args, int nargout);
 
+  int parfor_num_workers () const { return m_parfor_num_workers; }
+
+  int parfor_num_workers (int n)
+  {
+    int val = m_parfor_num_workers;
+    m_parfor_num_workers = n;
+    return val;
+  }
+
+  octave_value
+  parfor_num_workers (const octave_value_list& args, int nargout);
+
+  int spmd_num_workers () const { return m_spmd_num_workers; }
+
+  int spmd_num_workers (int n)
+  {
+    int val = m_spmd_num_workers;
+    m_spmd_num_workers = n;
+    return val;
+  }
+
+  octave_value
+  spmd_num_workers (const octave_value_list& args, int nargout);
+
+  bool vm_enable () const { return m_vm_enable; }
+
+  bool vm_enable (bool b)
+  {
+    bool val = m_vm_enable;
+    m_vm_enable = b;
+    return val;
+  }
+
+  octave_value vm_enable (const octave_value_list& args, int nargout);
+
+  // Return the bytecode for the body of FCN, compiling it if needed,
+  // or nullptr if the function should be run by the tree evaluator.
+  std::shared_ptr<bytecode> vm_bytecode (octave_user_function& fcn);
+
   std::size_t debug_frame () const { return m_debug_frame; }
 
   std::size_t debug_frame (std::size_t n)
@@ -783,6 +827,15 @@ public:
     return val;
   }
 
+  bool in_loop_command () const { return m_in_loop_command; }
+
+  bool in_loop_command (bool b)
+  {
+    bool val = m_in_loop_command;
+    m_in_loop_command = b;
+    return val;
+  }
+
   int returning () const { return m_returning; }
 
   int returning (int n)
@@ -863,6 +916,18 @@ private:
                            octave_lvalue& ult,
                            tree_statement_list *loop_body);
 
+  bool execute_parfor_loop (tree_simple_for_command& cmd,
+                            const octave_value& rhs);
+
+  int parfor_worker (worker_channel& chan, tree_simple_for_command& cmd,
+                     const parfor_analyzer& pa, const NDArray& iter,
+                     octave_idx_type first, octave_idx_type last);
+
+  bool execute_spmd_block (tree_spmd_command& cmd);
+
+  int spmd_worker (worker_channel& chan, tree_spmd_command& cmd,
+                   int labindex, int numlabs, std::vector<int>& lab_fds);
+
   void set_echo_state (int type, const std::string& file_name, int pos);
 
   void maybe_set_echo_state ();
@@ -941,6 +1006,19 @@ private:
   // semicolon has been appended to each statement).
   bool m_silent_functions;
 
+  // Number of worker processes used to execute parfor loops that do
+  // not specify the maximum number of workers.  Loops are executed
+  // serially if this is less than 2.
+  int m_parfor_num_workers;
+
+  // Number of labs (worker processes) used to execute spmd blocks.
+  // Blocks are executed serially if this is less than 2.
+  int m_spmd_num_workers;
+
+  // If TRUE, execute the bodies of user functions with the bytecode
+  // VM when possible.
+  bool m_vm_enable;
+
   // The character to fill with when creating string arrays.
   char m_string_fill_char;
 
@@ -0,0 +1,555 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "dNDArray.h"
+#include "oct-thread-pool.h"
+
+#include "ov-re-mat.h"
+#include "ov-scalar.h"
+#include "pt-binop.h"
+#include "pt-const.h"
+#include "pt-eval.h"
+#include "pt-fused.h"
+#include "pt-id.h"
+#include "pt-unop.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Number of elements that are processed by each operator at a time.
+// The intermediate results for one block stay in the cache.
+
+static const std::size_t fused_block_size = 256;
+
+// A value on the evaluation stack.  PTR points to the elements of the
+// current block, or is null for scalars.
+
+struct fused_operand
+{
+  const double *ptr;
+  double val;
+};
+
+struct fused_add_op
+{
+  double operator () (double x, double y) const { return x + y; }
+};
+
+struct fused_sub_op
+{
+  double operator () (double x, double y) const { return x - y; }
+};
+
+struct fused_mul_op
+{
+  double operator () (double x, double y) const { return x * y; }
+};
+
+struct fused_div_op
+{
+  double operator () (double x, double y) const { return x / y; }
+};
+
+template <typename OP>
+static inline void
+fused_apply (std::size_t n, double *r, const fused_operand& x,
+             const fused_operand& y, OP op)
+{
+  if (x.ptr && y.ptr)
+    {
+      const double *xp = x.ptr;
+      const double *yp = y.ptr;
+
+      for (std::size_t i = 0; i < n; i++)
+        r[i] = op (xp[i], yp[i]);
+    }
+  else if (x.ptr)
+    {
+      const double *xp = x.ptr;
+      double ys = y.val;
+
+      for (std::size_t i = 0; i < n; i++)
+        r[i] = op (xp[i], ys);
+    }
+  else
+    {
+      double xs = x.val;
+      const double *yp = y.ptr;
+
+      for (std::size_t i = 0; i < n; i++)
+        r[i] = op (xs, yp[i]);
+    }
+}
+
+template <typename OP>
+static inline void
+fused_apply (std::size_t n, double *r, fused_operand& x,
+             const fused_operand& y)
+{
+  OP op;
+
+  if (x.ptr || y.ptr)
+    {
+      fused_apply (n, r, x, y, op);
+      x.ptr = r;
+    }
+  else
+    x.val = op (x.val, y.val);
+}
+
+fused_elementwise_expression *
+fused_elementwise_expression::create (tree_binary_expression& expr)
+{
+  std::unique_ptr<fused_elementwise_expression>
+    retval (new fused_elementwise_expression ());
+
+  if (! retval->compile (&expr, 0))
+    return nullptr;
+
+  // A single operator gains nothing.
+
+  if (retval->m_program.size () < retval->m_operands.size () + 2)
+    return nullptr;
+
+  return retval.release ();
+}
+
+// Append the instructions for EXPR, whose value ends up at position SP
+// of the evaluation stack, to the program.
+
+bool
+fused_elementwise_expression::compile (tree_expression *expr,
+                                       std::size_t sp)
+{
+  if (! expr)
+    return false;
+
+  m_max_depth = std::max (m_max_depth, sp + 1);
+
+  if (expr->is_identifier () || expr->is_constant ())
+    {
+      if (expr->is_identifier ()
+          && dynamic_cast<tree_identifier *> (expr)->is_black_hole ())
+        return false;
+
+      if (m_operands.size () >= MAX_OPERANDS)
+        return false;
+
+      m_program.push_back ({push_operand, m_operands.size ()});
+      m_operands.push_back (expr);
+
+      return true;
+    }
+  else if (expr->is_binary_expression ())
+    {
+      tree_binary_expression *be
+        = dynamic_cast<tree_binary_expression *> (expr);
+
+      if (be->is_boolean_expression () || be->is_braindead ()
+          || be->is_compound_binary_expression ())
+        return false;
+
+      opcode op;
+
+      switch (be->op_type ())
+        {
+        case octave_value::op_add:
+          op = add;
+          break;
+
+        case octave_value::op_sub:
+          op = sub;
+          break;
+
+        case octave_value::op_mul:
+          op = mul;
+          break;
+
+        case octave_value::op_div:
+          op = div;
+          break;
+
+        case octave_value::op_el_mul:
+          op = el_mul;
+          break;
+
+        case octave_value::op_el_div:
+          op = el_div;
+          break;
+
+        default:
+          return false;
+        }
+
+      if (! (compile (be->lhs (), sp) && compile (be->rhs (), sp + 1)))
+        return false;
+
+      m_program.push_back ({op, 0});
+
+      return true;
+    }
+  else if (expr->is_unary_expression ())
+    {
+      tree_prefix_expression *pe
+        = dynamic_cast<tree_prefix_expression *> (expr);
+
+      if (! pe)
+        return false;
+
+      octave_value::unary_op op = pe->op_type ();
+
+      // Unary plus does nothing for real values.
+
+      if (op == octave_value::op_uplus)
+        return compile (pe->operand (), sp);
+      else if (op == octave_value::op_uminus)
+        {
+          if (! compile (pe->operand (), sp))
+            return false;
+
+          m_program.push_back ({uminus, 0});
+
+          return true;
+        }
+    }
+
+  return false;
+}
+
+octave_value
+fused_elementwise_expression::evaluate (tree_evaluator& tw)
+{
+  static const int scalar_type_id = octave_scalar::static_type_id ();
+  static const int matrix_type_id = octave_matrix::static_type_id ();
+
+  std::size_t num_operands = m_operands.size ();
+
+  const double *data[MAX_OPERANDS];
+  double scalars[MAX_OPERANDS];
+
+  // Keeps the data of the matrices alive.
+  std::vector<NDArray> arrays;
+
+  dim_vector dims;
+
+  for (std::size_t i = 0; i < num_operands; i++)
+    {
+      tree_expression *expr = m_operands[i];
+
+      octave_value val
+        = (expr->is_identifier ()
+           ? tw.varval (dynamic_cast<tree_identifier *> (expr)->symbol ())
+           : dynamic_cast<tree_constant *> (expr)->value ());
+
+      int type_id = val.type_id ();
+
+      data[i] = nullptr;
+      scalars[i] = 0;
+
+      if (type_id == scalar_type_id)
+        scalars[i] = val.scalar_value ();
+      else if (type_id == matrix_type_id)
+        {
+          NDArray a = val.array_value ();
+
+          if (a.numel () == 1)
+            scalars[i] = a.xelem (0);
+          else
+            {
+              if (arrays.empty ())
+                dims = a.dims ();
+              else if (a.dims () != dims)
+                return octave_value ();
+
+              data[i] = a.data ();
+
+              arrays.push_back (a);
+            }
+        }
+      else
+        return octave_value ();
+    }
+
+  // Check that * and / are element-wise for these operands.
+
+  bool is_array[MAX_OPERANDS];
+  std::size_t sp = 0;
+
+  for (const auto& ins : m_program)
+    {
+      switch (ins.op)
+        {
+        case push_operand:
+          is_array[sp++] = (data[ins.idx] != nullptr);
+          break;
+
+        case uminus:
+          break;
+
+        default:
+          {
+            bool x = is_array[sp-2];
+            bool y = is_array[sp-1];
+
+            if ((ins.op == mul && x && y) || (ins.op == div && y))
+              return octave_value ();
+
+            is_array[sp-2] = x || y;
+            sp--;
+          }
+          break;
+        }
+    }
+
+  m_used = true;
+
+  if (arrays.empty ())
+    return octave_value (run_scalar (scalars));
+
+  NDArray result (dims);
+
+  if (result.numel () == 0)
+    return octave_value (result);
+
+  double *r = result.fortran_vec ();
+
+  thread_pool::parallel_for (result.numel (),
+                             [this, r, &data, &scalars] (std::size_t begin,
+                                                         std::size_t end)
+                             {
+                               run (begin, end, r, data, scalars);
+                             });
+
+  return octave_value (result);
+}
+
+// Evaluate the expression if all operands are scalars.
+
+double
+fused_elementwise_expression::run_scalar (const double *scalars) const
+{
+  std::vector<double> stack (m_max_depth);
+
+  std::size_t sp = 0;
+
+  for (const auto& ins : m_program)
+    {
+      if (ins.op == push_operand)
+        {
+          stack[sp++] = scalars[ins.idx];
+          continue;
+        }
+
+      double& x = stack[ins.op == uminus ? sp - 1 : sp - 2];
+
+      switch (ins.op)
+        {
+        case uminus:
+          x = -x;
+          break;
+
+        case add:
+          x = fused_add_op () (x, stack[sp-1]);
+          break;
+
+        case sub:
+          x = fused_sub_op () (x, stack[sp-1]);
+          break;
+
+        case mul:
+        case el_mul:
+          x = fused_mul_op () (x, stack[sp-1]);
+          break;
+
+        case div:
+        case el_div:
+          x = fused_div_op () (x, stack[sp-1]);
+          break;
+
+        default:
+          break;
+        }
+
+      if (ins.op != uminus)
+        sp--;
+    }
+
+  return stack[0];
+}
+
+// Evaluate elements BEGIN to END - 1 of the result.  At least one of the
+// operands must be an array.
+
+void
+fused_elementwise_expression::run (std::size_t begin, std::size_t end,
+                                   double *result,
+                                   const double * const *data,
+                                   const double *scalars) const
+{
+  std::vector<fused_operand> stack (m_max_depth);
+
+  std::vector<double> buf (fused_block_size * m_max_depth);
+
+  std::size_t nprog = m_program.size ();
+
+  std::size_t off = begin;
+
+  while (off < end)
+    {
+      std::size_t n = std::min (fused_block_size, end - off);
+
+      std::size_t sp = 0;
+
+      for (std::size_t k = 0; k < nprog; k++)
+        {
+          const instruction& ins = m_program[k];
+
+          if (ins.op == push_operand)
+            {
+              const double *p = data[ins.idx];
+
+              stack[sp].ptr = (p ? p + off : nullptr);
+              stack[sp].val = scalars[ins.idx];
+              sp++;
+
+              continue;
+            }
+
+          std::size_t dst = (ins.op == uminus ? sp - 1 : sp - 2);
+
+          // The last operator stores its result in place.
+
+          double *r = (k == nprog - 1
+                       ? result + off : buf.data () + dst * fused_block_size);
+
+          fused_operand& x = stack[dst];
+
+          switch (ins.op)
+            {
+            case uminus:
+              if (x.ptr)
+                {
+                  const double *xp = x.ptr;
+
+                  for (std::size_t i = 0; i < n; i++)
+                    r[i] = -xp[i];
+
+                  x.ptr = r;
+                }
+              else
+                x.val = -x.val;
+              break;
+
+            case add:
+              fused_apply<fused_add_op> (n, r, x, stack[sp-1]);
+              break;
+
+            case sub:
+              fused_apply<fused_sub_op> (n, r, x, stack[sp-1]);
+              break;
+
+            case mul:
+            case el_mul:
+              fused_apply<fused_mul_op> (n, r, x, stack[sp-1]);
+              break;
+
+            case div:
+            case el_div:
+              fused_apply<fused_div_op> (n, r, x, stack[sp-1]);
+              break;
+
+            default:
+              break;
+            }
+
+          if (ins.op != uminus)
+            sp--;
+        }
+
+      off += n;
+    }
+}
+
+OCTAVE_END_NAMESPACE(octave)
+
+/*
+%!function r = __fused_sep__ (a, b, c, d, e)
+%!  t1 = a .* b;
+%!  t2 = c .* d;
+%!  t3 = t1 + t2;
+%!  r = t3 - e;
+%!endfunction
+
+%!test
+%! a = rand (7, 300);  b = rand (7, 300);  c = rand (7, 300);
+%! d = rand (7, 300);  e = rand (7, 300);
+%! assert (a.*b + c.*d - e, __fused_sep__ (a, b, c, d, e));
+%! assert (a.*b + c.*d - 2, __fused_sep__ (a, b, c, d, 2));
+%! assert (3.*b + c.*d - e, __fused_sep__ (3, b, c, d, e));
+%! t1 = -a;  t1 = t1 ./ b;  t2 = 2*c;  t2 = t2 / 4;  t3 = t1 - t2;
+%! assert (-a./b - 2*c/4 + +d, t3 + d);
+
+## Scalar operands only
+%!test
+%! a = 3;  b = 0.1;  c = -7;
+%! t1 = a*b;  t2 = c/a;  t3 = t1 + t2;
+%! assert (a*b + c/a - -b, t3 + b);
+
+## Operands that cannot be fused
+%!test
+%! a = [1, 2; 3, 4];  b = [5, 6; 7, 8];
+%! assert (a*b + a .* b, [19, 22; 43, 50] + [5, 12; 21, 32]);
+%! assert (b/a - 1 + 1, (b/a - 1) + 1);
+%! x = single ([1, 2]);  y = [3, 4];
+%! z = x .* y + y;
+%! assert (class (z), "single");
+%! assert (z, single ([6, 12]));
+%! assert ([1; 2] .* [3, 4] + 1, [4, 5; 7, 9]);
+%! assert (int8 ([100, 100]) + 100 - 50, int8 ([77, 77]));
+
+## Empty operands
+%!test
+%! a = zeros (0, 3);
+%! assert (a.*a + a, zeros (0, 3));
+%! assert (2*a - a./a, zeros (0, 3));
+%! b = zeros (3, 0, 2);
+%! assert (-b.*b + 1 - b, zeros (3, 0, 2));
+
+## All operands scalars
+%!test
+%! a = 2;  b = -0.5;  c = 8;
+%! assert (a*b + c/a, 3);
+%! assert (-a.*b - c./a + 1, -2);
+%! assert (a*b*c - a/b/c, -7.5);
+
+%!error <nonconformant> [1, 2, 3] .* [1, 2] + 1
+*/
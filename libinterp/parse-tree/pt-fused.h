@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_pt_fused_h)
+#define octave_pt_fused_h 1
+
+#include "octave-config.h"
+
+#include <cstddef>
+#include <vector>
+
+#include "ov.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+class tree_binary_expression;
+class tree_evaluator;
+class tree_expression;
+
+// Trees of element-wise arithmetic operators, such as a.*b + c.*d - e,
+// that are evaluated in a single pass over the data instead of one
+// operator at a time with a full size temporary for each intermediate
+// result.
+//
+// The operators +, -, .*, ./, unary minus and plus, and * and / with a
+// scalar operand may be fused.  The operands must be variables or
+// constants.  The fused evaluation is only used if all operands are
+// real double precision scalars or full matrices, and all matrices have
+// the same dimensions.  Otherwise the expression is evaluated in the
+// usual way, which also takes care of broadcasting and of reporting
+// errors.  Because the operands are variables or constants, looking at
+// their values first has no side effects.
+//
+// Each intermediate value is rounded to double precision exactly as
+// when the operators are evaluated separately, so the results are
+// identical.
+
+class fused_elementwise_expression
+{
+public:
+
+  // Maximum number of operands of a fused expression.
+  static const std::size_t MAX_OPERANDS = 32;
+
+  OCTAVE_DISABLE_COPY_MOVE (fused_elementwise_expression)
+
+  ~fused_elementwise_expression () = default;
+
+  // Return a new object if EXPR is the root of a tree with at least two
+  // operators that may be fused, or nullptr otherwise.
+  static fused_elementwise_expression *
+  create (tree_binary_expression& expr);
+
+  // Evaluate the expression.  Return an undefined value if the operands
+  // do not have suitable types or dimensions.
+  octave_value evaluate (tree_evaluator& tw);
+
+  // TRUE if the expression has been evaluated in fused form at least
+  // once.
+  bool used () const { return m_used; }
+
+  enum opcode
+  {
+    push_operand,
+    uminus,
+    add,
+    sub,
+    mul,
+    div,
+    el_mul,
+    el_div
+  };
+
+  struct instruction
+  {
+    opcode op;
+    // Index of the operand for push_operand.
+    std::size_t idx;
+  };
+
+private:
+
+  fused_elementwise_expression ()
+    : m_program (), m_operands (), m_max_depth (0), m_used (false)
+  { }
+
+  bool compile (tree_expression *expr, std::size_t depth);
+
+  double run_scalar (const double *scalars) const;
+
+  void run (std::size_t begin, std::size_t end, double *result,
+            const double * const *data, const double *scalars) const;
+
+  // The operators in postfix order.
+  std::vector<instruction> m_program;
+
+  // Identifiers and constants.
+  std::vector<tree_expression *> m_operands;
+
+  // Maximum depth of the evaluation stack.
+  std::size_t m_max_depth;
+
+  bool m_used;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
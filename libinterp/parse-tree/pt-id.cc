@@ -102,7 +102,7 @@ tree_identifier::evaluate_n (tree_evaluator& tw, int nargout)
 
       symbol_table& symtab = interp.get_symbol_table ();
 
-      val = symtab.find_function (m_sym.name ());
+      val = m_fcn_cache.find (symtab, m_sym.name ());
     }
 
   if (val.is_defined ())
@@ -0,0 +1,844 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <set>
+#include <string>
+
+#include "dMatrix.h"
+
+#include "interpreter.h"
+#include "ov-typeinfo.h"
+#include "ovl.h"
+#include "pt-all.h"
+#include "pt-parfor.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Functions that may create, modify, or clear variables behind the
+// back of the analysis, or call other functions that do.
+
+static const std::set<std::string> parfor_unsafe_functions =
+{
+  "arrayfun", "assignin", "cellfun", "clear", "clearvars", "eval",
+  "evalc", "evalin", "feval", "input", "keyboard", "load", "str2func"
+};
+
+// Remove the elements of A that are not in B.
+
+static void
+intersect_with (std::set<std::string>& a, const std::set<std::string>& b)
+{
+  for (auto p = a.begin (); p != a.end (); )
+    {
+      if (b.count (*p))
+        p++;
+      else
+        p = a.erase (p);
+    }
+}
+
+parfor_analyzer::parfor_analyzer (const std::string& loop_var)
+  : m_loop_var (loop_var), m_ok (true), m_vars (), m_assigned (),
+    m_reductions (), m_sliced (), m_temporaries ()
+{
+  m_assigned.insert (loop_var);
+}
+
+bool
+parfor_analyzer::analyze (tree_statement_list *body)
+{
+  if (body)
+    body->accept (*this);
+
+  if (! m_ok)
+    return false;
+
+  for (const auto& name_info : m_vars)
+    {
+      const std::string& name = name_info.first;
+      const var_info& vi = name_info.second;
+
+      bool written = vi.writes || vi.reductions || vi.sliced_writes;
+
+      if (name == m_loop_var)
+        {
+          if (written || vi.conflict)
+            return false;
+        }
+      else if (vi.conflict)
+        return false;
+      else if (vi.reductions)
+        {
+          if (vi.writes || vi.uses || vi.sliced_refs)
+            return false;
+
+          m_reductions.push_back ({name, vi.op, vi.left});
+        }
+      else if (vi.sliced_writes)
+        {
+          if (vi.writes || vi.uses)
+            return false;
+
+          m_sliced.push_back ({name, vi.nargs, vi.position});
+        }
+      else if (vi.writes)
+        {
+          // A temporary that may be used before it is assigned carries
+          // a value from one iteration to the next.
+
+          if (vi.read_first)
+            return false;
+
+          m_temporaries.push_back (name);
+        }
+    }
+
+  return true;
+}
+
+octave_value
+parfor_analyzer::identity (reduction_op op, const octave_value& init)
+{
+  // Keep the class of single precision values.  Integer reductions are
+  // never split (see parallel_reduction).
+
+  bool single = init.is_single_type ();
+
+  switch (op)
+    {
+    case RED_ADD:
+      return single ? octave_value (0.0f) : octave_value (0.0);
+
+    case RED_MUL:
+    case RED_EL_MUL:
+      return single ? octave_value (1.0f) : octave_value (1.0);
+
+    case RED_EL_AND:
+      return octave_value (true);
+
+    case RED_EL_OR:
+      return octave_value (false);
+
+    default:
+      return octave_value (Matrix ());
+    }
+}
+
+bool
+parfor_analyzer::parallel_reduction (reduction_op op,
+                                     const octave_value& init)
+{
+  // Integer arithmetic saturates, so the sum or product of the partial
+  // results of the workers may differ from the serial result.
+
+  switch (op)
+    {
+    case RED_ADD:
+    case RED_MUL:
+    case RED_EL_MUL:
+      return ! init.isinteger ();
+
+    default:
+      return true;
+    }
+}
+
+octave_value
+parfor_analyzer::combine (interpreter& interp, const reduction_var& rv,
+                          const octave_value& acc, const octave_value& part)
+{
+  type_info& ti = interp.get_type_info ();
+
+  // Partial results arrive in iteration order.  For operators that
+  // are not commutative, a reduction variable on the right means the
+  // new partial result goes on the left.
+
+  const octave_value& a = rv.left ? part : acc;
+  const octave_value& b = rv.left ? acc : part;
+
+  switch (rv.op)
+    {
+    case RED_ADD:
+      return binary_op (ti, octave_value::op_add, a, b);
+
+    case RED_MUL:
+      return binary_op (ti, octave_value::op_mul, a, b);
+
+    case RED_EL_MUL:
+      return binary_op (ti, octave_value::op_el_mul, a, b);
+
+    case RED_EL_AND:
+      return binary_op (ti, octave_value::op_el_and, a, b);
+
+    case RED_EL_OR:
+      return binary_op (ti, octave_value::op_el_or, a, b);
+
+    case RED_HORZCAT:
+      return interp.feval ("horzcat", ovl (a, b), 1)(0);
+
+    case RED_VERTCAT:
+      return interp.feval ("vertcat", ovl (a, b), 1)(0);
+    }
+
+  return octave_value ();
+}
+
+void
+parfor_analyzer::visit_identifier (tree_identifier& id)
+{
+  std::string name = id.name ();
+
+  if (parfor_unsafe_functions.count (name))
+    m_ok = false;
+
+  var_info& vi = m_vars[name];
+
+  vi.uses++;
+
+  if (! m_assigned.count (name))
+    vi.read_first = true;
+}
+
+void
+parfor_analyzer::visit_index_expression (tree_index_expression& expr)
+{
+  std::string name;
+  int nargs;
+  int position;
+
+  if (sliced_reference (expr, name, nargs, position))
+    {
+      var_info& vi = m_vars[name];
+
+      if (vi.sliced_refs == 0)
+        {
+          vi.nargs = nargs;
+          vi.position = position;
+        }
+      else if (vi.nargs != nargs || vi.position != position)
+        vi.conflict = true;
+
+      vi.sliced_refs++;
+
+      // Don't count the indexed variable as a plain reference.
+
+      tree_argument_list *args = expr.arg_lists ().front ();
+
+      args->accept (*this);
+    }
+  else
+    tree_walker::visit_index_expression (expr);
+}
+
+void
+parfor_analyzer::visit_simple_assignment (tree_simple_assignment& expr)
+{
+  tree_expression *lhs = expr.left_hand_side ();
+  tree_expression *rhs = expr.right_hand_side ();
+
+  if (! lhs || ! rhs)
+    {
+      m_ok = false;
+      return;
+    }
+
+  octave_value::assign_op op = expr.op_type ();
+
+  if (lhs->is_identifier () && op != octave_value::op_asn_eq)
+    {
+      std::string name = lhs->name ();
+
+      switch (op)
+        {
+        case octave_value::op_add_eq:
+        case octave_value::op_sub_eq:
+          add_reduction (name, RED_ADD, false);
+          break;
+
+        case octave_value::op_mul_eq:
+          add_reduction (name, RED_MUL, false);
+          break;
+
+        case octave_value::op_el_mul_eq:
+          add_reduction (name, RED_EL_MUL, false);
+          break;
+
+        case octave_value::op_el_and_eq:
+          add_reduction (name, RED_EL_AND, false);
+          break;
+
+        case octave_value::op_el_or_eq:
+          add_reduction (name, RED_EL_OR, false);
+          break;
+
+        default:
+          m_vars[name].conflict = true;
+          break;
+        }
+
+      rhs->accept (*this);
+    }
+  else if (! (lhs->is_identifier ()
+              && maybe_reduction (lhs->name (), rhs)))
+    {
+      // The right-hand side is evaluated before the assignment.
+
+      rhs->accept (*this);
+
+      add_write (lhs);
+    }
+}
+
+void
+parfor_analyzer::visit_multi_assignment (tree_multi_assignment& expr)
+{
+  tree_expression *rhs = expr.right_hand_side ();
+
+  if (rhs)
+    rhs->accept (*this);
+
+  tree_argument_list *lhs = expr.left_hand_side ();
+
+  if (lhs)
+    {
+      for (tree_expression *elt : *lhs)
+        add_write (elt);
+    }
+}
+
+void
+parfor_analyzer::visit_prefix_expression (tree_prefix_expression& expr)
+{
+  octave_value::unary_op op = expr.op_type ();
+
+  if (op == octave_value::op_incr || op == octave_value::op_decr)
+    {
+      tree_expression *operand = expr.operand ();
+
+      if (operand && operand->is_identifier ())
+        add_reduction (operand->name (), RED_ADD, false);
+      else
+        m_ok = false;
+    }
+  else
+    tree_walker::visit_prefix_expression (expr);
+}
+
+void
+parfor_analyzer::visit_postfix_expression (tree_postfix_expression& expr)
+{
+  octave_value::unary_op op = expr.op_type ();
+
+  if (op == octave_value::op_incr || op == octave_value::op_decr)
+    {
+      tree_expression *operand = expr.operand ();
+
+      if (operand && operand->is_identifier ())
+        add_reduction (operand->name (), RED_ADD, false);
+      else
+        m_ok = false;
+    }
+  else
+    tree_walker::visit_postfix_expression (expr);
+}
+
+void
+parfor_analyzer::visit_simple_for_command (tree_simple_for_command& cmd)
+{
+  tree_expression *expr = cmd.control_expr ();
+
+  if (expr)
+    expr->accept (*this);
+
+  // The loop may not be executed at all.
+
+  std::set<std::string> entry = m_assigned;
+
+  add_write (cmd.left_hand_side ());
+
+  tree_statement_list *body = cmd.body ();
+
+  if (body)
+    body->accept (*this);
+
+  m_assigned = entry;
+}
+
+void
+parfor_analyzer::visit_complex_for_command (tree_complex_for_command& cmd)
+{
+  tree_expression *expr = cmd.control_expr ();
+
+  if (expr)
+    expr->accept (*this);
+
+  std::set<std::string> entry = m_assigned;
+
+  tree_argument_list *lhs = cmd.left_hand_side ();
+
+  if (lhs)
+    {
+      for (tree_expression *elt : *lhs)
+        add_write (elt);
+    }
+
+  tree_statement_list *body = cmd.body ();
+
+  if (body)
+    body->accept (*this);
+
+  m_assigned = entry;
+}
+
+// A variable is definitely assigned after a conditional statement only
+// if it is assigned in every branch.  All conditions are analyzed as if
+// they were evaluated first.
+
+void
+parfor_analyzer::visit_if_command_list (tree_if_command_list& lst)
+{
+  std::set<std::string> entry = m_assigned;
+  std::set<std::string> result;
+
+  bool first = true;
+  bool has_else = false;
+
+  for (tree_if_clause *elt : lst)
+    {
+      m_assigned = entry;
+
+      tree_expression *cond = elt->condition ();
+
+      if (cond)
+        cond->accept (*this);
+      else
+        has_else = true;
+
+      tree_statement_list *list = elt->commands ();
+
+      if (list)
+        list->accept (*this);
+
+      if (first)
+        result = m_assigned;
+      else
+        intersect_with (result, m_assigned);
+
+      first = false;
+    }
+
+  m_assigned = has_else ? result : entry;
+}
+
+void
+parfor_analyzer::visit_switch_command (tree_switch_command& cmd)
+{
+  tree_expression *expr = cmd.switch_value ();
+
+  if (expr)
+    expr->accept (*this);
+
+  std::set<std::string> entry = m_assigned;
+  std::set<std::string> result;
+
+  bool first = true;
+  bool has_default = false;
+
+  tree_switch_case_list *lst = cmd.case_list ();
+
+  if (lst)
+    {
+      for (tree_switch_case *elt : *lst)
+        {
+          m_assigned = entry;
+
+          tree_expression *label = elt->case_label ();
+
+          if (label)
+            label->accept (*this);
+          else
+            has_default = true;
+
+          tree_statement_list *list = elt->commands ();
+
+          if (list)
+            list->accept (*this);
+
+          if (first)
+            result = m_assigned;
+          else
+            intersect_with (result, m_assigned);
+
+          first = false;
+        }
+    }
+
+  m_assigned = has_default ? result : entry;
+}
+
+void
+parfor_analyzer::visit_while_command (tree_while_command& cmd)
+{
+  tree_expression *expr = cmd.condition ();
+
+  if (expr)
+    expr->accept (*this);
+
+  std::set<std::string> entry = m_assigned;
+
+  tree_statement_list *body = cmd.body ();
+
+  if (body)
+    body->accept (*this);
+
+  m_assigned = entry;
+}
+
+void
+parfor_analyzer::visit_do_until_command (tree_do_until_command& cmd)
+{
+  // The body is executed at least once.
+
+  tree_statement_list *body = cmd.body ();
+
+  if (body)
+    body->accept (*this);
+
+  tree_expression *expr = cmd.condition ();
+
+  if (expr)
+    expr->accept (*this);
+}
+
+void
+parfor_analyzer::visit_try_catch_command (tree_try_catch_command& cmd)
+{
+  // The catch block may be executed after any part of the try block.
+
+  std::set<std::string> entry = m_assigned;
+
+  tree_statement_list *try_code = cmd.body ();
+
+  if (try_code)
+    try_code->accept (*this);
+
+  std::set<std::string> try_assigned = m_assigned;
+
+  m_assigned = entry;
+
+  tree_identifier *expr_id = cmd.identifier ();
+
+  if (expr_id)
+    add_write (expr_id);
+
+  tree_statement_list *catch_code = cmd.cleanup ();
+
+  if (catch_code)
+    catch_code->accept (*this);
+
+  intersect_with (m_assigned, try_assigned);
+}
+
+void
+parfor_analyzer::visit_unwind_protect_command
+  (tree_unwind_protect_command& cmd)
+{
+  // The cleanup block may be executed after any part of the body, but
+  // execution only continues after the statement if the body was
+  // completed.
+
+  std::set<std::string> entry = m_assigned;
+
+  tree_statement_list *body = cmd.body ();
+
+  if (body)
+    body->accept (*this);
+
+  std::set<std::string> body_assigned = m_assigned;
+
+  m_assigned = entry;
+
+  tree_statement_list *cleanup = cmd.cleanup ();
+
+  if (cleanup)
+    cleanup->accept (*this);
+
+  m_assigned.insert (body_assigned.begin (), body_assigned.end ());
+}
+
+void
+parfor_analyzer::visit_break_command (tree_break_command&)
+{
+  m_ok = false;
+}
+
+void
+parfor_analyzer::visit_return_command (tree_return_command&)
+{
+  m_ok = false;
+}
+
+void
+parfor_analyzer::visit_decl_command (tree_decl_command&)
+{
+  m_ok = false;
+}
+
+void
+parfor_analyzer::visit_function_def (tree_function_def&)
+{
+  m_ok = false;
+}
+
+void
+parfor_analyzer::visit_spmd_command (tree_spmd_command&)
+{
+  m_ok = false;
+}
+
+void
+parfor_analyzer::add_write (tree_expression *lhs)
+{
+  if (! lhs)
+    return;
+
+  if (lhs->is_identifier ())
+    {
+      tree_identifier *id = dynamic_cast<tree_identifier *> (lhs);
+
+      if (! id->is_black_hole ())
+        {
+          m_vars[id->name ()].writes++;
+          m_assigned.insert (id->name ());
+        }
+    }
+  else if (lhs->is_index_expression ())
+    {
+      tree_index_expression *expr
+        = dynamic_cast<tree_index_expression *> (lhs);
+
+      std::string name;
+      int nargs;
+      int position;
+
+      if (sliced_reference (*expr, name, nargs, position))
+        m_vars[name].sliced_writes++;
+      else
+        {
+          // Field references, nested indexing, or indexing without
+          // the loop variable can't be merged.
+
+          tree_expression *base = expr->expression ();
+
+          if (base && base->is_identifier ())
+            m_vars[base->name ()].conflict = true;
+          else
+            m_ok = false;
+        }
+
+      visit_index_expression (*expr);
+    }
+  else
+    m_ok = false;
+}
+
+void
+parfor_analyzer::add_reduction (const std::string& name, reduction_op op,
+                                bool left)
+{
+  var_info& vi = m_vars[name];
+
+  if (vi.reductions > 0 && (vi.op != op || vi.left != left))
+    vi.conflict = true;
+
+  vi.reductions++;
+  vi.op = op;
+  vi.left = left;
+}
+
+// TRUE if EXPR is X(ARGS) or X{ARGS} and exactly one of the arguments
+// is the loop variable.
+
+bool
+parfor_analyzer::sliced_reference (tree_index_expression& expr,
+                                   std::string& name, int& nargs,
+                                   int& position) const
+{
+  std::string type_tags = expr.type_tags ();
+
+  if (type_tags != "(" && type_tags != "{")
+    return false;
+
+  tree_expression *base = expr.expression ();
+
+  if (! base || ! base->is_identifier () || base->name () == m_loop_var)
+    return false;
+
+  tree_argument_list *args = expr.arg_lists ().front ();
+
+  if (! args)
+    return false;
+
+  nargs = args->size ();
+  position = -1;
+
+  int k = 0;
+
+  for (tree_expression *arg : *args)
+    {
+      if (is_var (arg, m_loop_var))
+        {
+          if (position >= 0)
+            return false;
+
+          position = k;
+        }
+
+      k++;
+    }
+
+  if (position < 0)
+    return false;
+
+  name = base->name ();
+
+  return true;
+}
+
+bool
+parfor_analyzer::is_var (tree_expression *expr,
+                         const std::string& name) const
+{
+  return expr && expr->is_identifier () && expr->name () == name;
+}
+
+// Recognize NAME = NAME OP EXPR, NAME = EXPR OP NAME, NAME = [NAME, EXPR],
+// and similar forms.  If RHS is a reduction, record it and analyze
+// the rest of the expression.
+
+bool
+parfor_analyzer::maybe_reduction (const std::string& name,
+                                  tree_expression *rhs)
+{
+  tree_expression *other = nullptr;
+  reduction_op op;
+  bool left;
+
+  if (rhs->is_binary_expression () && ! rhs->is_boolean_expression ()
+      && ! dynamic_cast<tree_compound_binary_expression *> (rhs))
+    {
+      tree_binary_expression *expr
+        = dynamic_cast<tree_binary_expression *> (rhs);
+
+      bool lhs_is_var = is_var (expr->lhs (), name);
+      bool rhs_is_var = is_var (expr->rhs (), name);
+
+      if (lhs_is_var == rhs_is_var)
+        return false;
+
+      left = rhs_is_var;
+      other = left ? expr->lhs () : expr->rhs ();
+
+      switch (expr->op_type ())
+        {
+        case octave_value::op_add:
+          op = RED_ADD;
+          break;
+
+        case octave_value::op_sub:
+          // Only NAME - EXPR, which is accumulated as a sum.
+          if (left)
+            return false;
+          op = RED_ADD;
+          break;
+
+        case octave_value::op_mul:
+          op = RED_MUL;
+          break;
+
+        case octave_value::op_el_mul:
+          op = RED_EL_MUL;
+          break;
+
+        case octave_value::op_el_and:
+          op = RED_EL_AND;
+          break;
+
+        case octave_value::op_el_or:
+          op = RED_EL_OR;
+          break;
+
+        default:
+          return false;
+        }
+    }
+  else if (rhs->is_matrix ())
+    {
+      tree_matrix *expr = dynamic_cast<tree_matrix *> (rhs);
+
+      tree_expression *first = nullptr;
+      tree_expression *second = nullptr;
+
+      if (expr->size () == 1 && expr->front ()->size () == 2)
+        {
+          op = RED_HORZCAT;
+          first = expr->front ()->front ();
+          second = expr->front ()->back ();
+        }
+      else if (expr->size () == 2 && expr->front ()->size () == 1
+               && expr->back ()->size () == 1)
+        {
+          op = RED_VERTCAT;
+          first = expr->front ()->front ();
+          second = expr->back ()->front ();
+        }
+      else
+        return false;
+
+      bool first_is_var = is_var (first, name);
+      bool second_is_var = is_var (second, name);
+
+      if (first_is_var == second_is_var)
+        return false;
+
+      left = second_is_var;
+      other = left ? first : second;
+    }
+  else
+    return false;
+
+  add_reduction (name, op, left);
+
+  if (other)
+    other->accept (*this);
+
+  return true;
+}
+
+OCTAVE_END_NAMESPACE(octave)
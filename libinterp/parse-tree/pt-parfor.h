@@ -0,0 +1,227 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_pt_parfor_h)
+#define octave_pt_parfor_h 1
+
+#include "octave-config.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ov.h"
+#include "pt-walk.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+class interpreter;
+class tree_expression;
+class tree_statement_list;
+
+// Classify the variables of a parfor loop body.
+//
+// The body may be executed in parallel only if every variable that is
+// assigned in the body is one of
+//
+//   sliced     X(..., I, ...) = EXPR, where I is the loop variable in
+//              the same index position in every reference to X,
+//
+//   reduction  X = X OP EXPR, X OP= EXPR, X = [X, EXPR], or similar,
+//              with no other reference to X in the body,
+//
+//   temporary  X = EXPR, where X is assigned before it is used in every
+//              iteration.  After the loop, X has the value of the last
+//              iteration that assigned it, as for a serial loop.
+//
+// Constructs that may modify variables in ways that cannot be seen in
+// the parse tree (eval, feval, cellfun, global declarations, ...) and
+// BREAK or RETURN prevent parallel execution.
+
+class parfor_analyzer : public tree_walker
+{
+public:
+
+  enum reduction_op
+  {
+    RED_ADD,
+    RED_MUL,
+    RED_EL_MUL,
+    RED_EL_AND,
+    RED_EL_OR,
+    RED_HORZCAT,
+    RED_VERTCAT
+  };
+
+  struct reduction_var
+  {
+    std::string name;
+    reduction_op op;
+    // TRUE if the reduction variable is the right operand.
+    bool left;
+  };
+
+  struct sliced_var
+  {
+    std::string name;
+    int nargs;
+    int position;
+  };
+
+  parfor_analyzer (const std::string& loop_var);
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (parfor_analyzer)
+
+  ~parfor_analyzer () = default;
+
+  // Return TRUE if the iterations of BODY may be executed in parallel.
+  bool analyze (tree_statement_list *body);
+
+  const std::vector<reduction_var>& reductions () const
+  {
+    return m_reductions;
+  }
+
+  const std::vector<sliced_var>& sliced () const { return m_sliced; }
+
+  const std::vector<std::string>& temporaries () const
+  {
+    return m_temporaries;
+  }
+
+  // Initial value of a reduction variable in a worker.  INIT is the
+  // value of the variable before the loop.
+  static octave_value identity (reduction_op op, const octave_value& init);
+
+  // Return TRUE if a reduction with the initial value INIT gives the
+  // same result when it is split across workers.
+  static bool parallel_reduction (reduction_op op, const octave_value& init);
+
+  // Combine the current value of a reduction variable with the partial
+  // result of a worker.
+  static octave_value combine (interpreter& interp, const reduction_var& rv,
+                               const octave_value& acc,
+                               const octave_value& part);
+
+  void visit_identifier (tree_identifier&);
+
+  void visit_index_expression (tree_index_expression&);
+
+  void visit_simple_assignment (tree_simple_assignment&);
+
+  void visit_multi_assignment (tree_multi_assignment&);
+
+  void visit_prefix_expression (tree_prefix_expression&);
+
+  void visit_postfix_expression (tree_postfix_expression&);
+
+  void visit_simple_for_command (tree_simple_for_command&);
+
+  void visit_complex_for_command (tree_complex_for_command&);
+
+  void visit_if_command_list (tree_if_command_list&);
+
+  void visit_switch_command (tree_switch_command&);
+
+  void visit_while_command (tree_while_command&);
+
+  void visit_do_until_command (tree_do_until_command&);
+
+  void visit_try_catch_command (tree_try_catch_command&);
+
+  void visit_unwind_protect_command (tree_unwind_protect_command&);
+
+  void visit_break_command (tree_break_command&);
+
+  void visit_return_command (tree_return_command&);
+
+  void visit_decl_command (tree_decl_command&);
+
+  void visit_function_def (tree_function_def&);
+
+  void visit_spmd_command (tree_spmd_command&);
+
+private:
+
+  struct var_info
+  {
+    var_info ()
+      : uses (0), writes (0), sliced_refs (0), sliced_writes (0),
+        nargs (-1), position (-1), reductions (0), op (RED_ADD),
+        left (false), conflict (false), read_first (false)
+    { }
+
+    // Plain references.
+    int uses;
+    // Assignments of the whole variable.
+    int writes;
+    // Indexed references and assignments with the loop variable.
+    int sliced_refs;
+    int sliced_writes;
+    int nargs;
+    int position;
+    // Reduction statements.
+    int reductions;
+    reduction_op op;
+    bool left;
+    // References that fit no category.
+    bool conflict;
+    // TRUE if the variable may be used before it is assigned in an
+    // iteration.
+    bool read_first;
+  };
+
+  void add_write (tree_expression *lhs);
+
+  void add_reduction (const std::string& name, reduction_op op, bool left);
+
+  bool sliced_reference (tree_index_expression& expr, std::string& name,
+                         int& nargs, int& position) const;
+
+  bool is_var (tree_expression *expr, const std::string& name) const;
+
+  bool maybe_reduction (const std::string& name, tree_expression *rhs);
+
+  std::string m_loop_var;
+
+  bool m_ok;
+
+  std::map<std::string, var_info> m_vars;
+
+  // Variables that are definitely assigned at the current point of the
+  // body.
+  std::set<std::string> m_assigned;
+
+  std::vector<reduction_var> m_reductions;
+
+  std::vector<sliced_var> m_sliced;
+
+  std::vector<std::string> m_temporaries;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -54,6 +54,7 @@ NUMERIC_INC = \
   %reldir%/qrp.h \
   %reldir%/randgamma.h \
   %reldir%/randmtzig.h \
+  %reldir%/randphilox.h \
   %reldir%/randpoisson.h \
   %reldir%/schur.h \
   %reldir%/sparse-chol.h \
@@ -90,6 +91,7 @@ NUMERIC_SRC = \
   %reldir%/qrp.cc \
   %reldir%/randgamma.cc \
   %reldir%/randmtzig.cc \
+  %reldir%/randphilox.cc \
   %reldir%/randpoisson.cc \
   %reldir%/schur.cc \
   %reldir%/sparse-chol.cc \
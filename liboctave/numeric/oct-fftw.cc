@@ -27,15 +27,23 @@
 #  include "config.h"
 #endif
 
+#include <cstdio>
+#include <string>
+
 #if defined (HAVE_FFTW3_H)
 #  include <fftw3.h>
 #endif
 
+#include "file-ops.h"
 #include "lo-error.h"
+#include "lo-sysdep.h"
+#include "mkostemp-wrapper.h"
+#include "oct-env.h"
 #include "oct-fftw.h"
 #include "oct-locbuf.h"
 #include "quit.h"
 #include "singleton-cleanup.h"
+#include "unistd-wrappers.h"
 
 #if defined (HAVE_FFTW3_THREADS) || defined (HAVE_FFTW3F_THREADS)
 #  include "nproc-wrapper.h"
@@ -45,6 +53,141 @@ OCTAVE_BEGIN_NAMESPACE(octave)
 
 #if defined (HAVE_FFTW)
 
+void *
+fftw_plan_cache::lookup (transform_kind kind, int rank,
+                         const dim_vector& dims, octave_idx_type howmany,
+                         octave_idx_type stride, octave_idx_type dist,
+                         bool inplace, bool simd_align)
+{
+  for (auto p = m_entries.begin (); p != m_entries.end (); p++)
+    {
+      if (p->kind == kind && p->rank == rank && p->howmany == howmany
+          && p->stride == stride && p->dist == dist
+          && p->inplace == inplace && p->simd_align == simd_align
+          && p->dims == dims)
+        {
+          // Keep the most recently used plans at the front.
+          if (p != m_entries.begin ())
+            m_entries.splice (m_entries.begin (), m_entries, p);
+
+          return m_entries.front ().plan;
+        }
+    }
+
+  return nullptr;
+}
+
+void
+fftw_plan_cache::insert (transform_kind kind, int rank,
+                         const dim_vector& dims, octave_idx_type howmany,
+                         octave_idx_type stride, octave_idx_type dist,
+                         bool inplace, bool simd_align, void *plan)
+{
+  if (m_entries.size () >= m_capacity)
+    {
+      m_destroy (m_entries.back ().plan);
+      m_entries.pop_back ();
+    }
+
+  m_entries.push_front ({kind, rank, dims, howmany, stride, dist, inplace,
+                         simd_align, plan});
+}
+
+void
+fftw_plan_cache::clear ()
+{
+  for (auto& e : m_entries)
+    m_destroy (e.plan);
+
+  m_entries.clear ();
+}
+
+// Name of the file that stores the wisdom accumulated by the planner.
+// The environment variable ENV_VAR overrides the default location in
+// the user data directory.
+
+static std::string
+wisdom_file (const char *env_var, const char *name)
+{
+  std::string file = sys::env::getenv (env_var);
+
+  if (file.empty ())
+    file = sys::env::get_user_data_directory ()
+           + sys::file_ops::dir_sep_str () + "octave"
+           + sys::file_ops::dir_sep_str () + name;
+
+  return file;
+}
+
+static void
+import_wisdom (const std::string& file, int (*import_fcn) (std::FILE *))
+{
+  std::FILE *fid = sys::fopen (file, "rb");
+
+  if (fid)
+    {
+      import_fcn (fid);
+      std::fclose (fid);
+    }
+}
+
+// Write wisdom to a temporary file which then replaces FILE, so that
+// concurrent sessions never see a partially written file.  Wisdom that
+// another session has saved in the meantime is merged first.
+
+static void
+save_wisdom (const std::string& file, int (*import_fcn) (std::FILE *),
+             void (*export_fcn) (std::FILE *))
+{
+  import_wisdom (file, import_fcn);
+
+  std::string msg;
+
+  std::string dir = sys::file_ops::dirname (file);
+
+  if (! dir.empty () && ! sys::dir_exists (dir)
+      && sys::recursive_mkdir (dir, 0777, msg) < 0)
+    return;
+
+  // The wisdom file may be shared by sessions on several hosts, so the
+  // temporary file needs a unique name.
+
+  std::string tmp_file = file + ".XXXXXX";
+
+  int fd = octave_mkostemp_wrapper (&tmp_file[0]);
+
+  if (fd < 0)
+    return;
+
+  octave_close_wrapper (fd);
+
+  std::FILE *fid = sys::fopen (tmp_file, "wb");
+
+  if (! fid)
+    {
+      sys::unlink (tmp_file);
+      return;
+    }
+
+  export_fcn (fid);
+
+  bool ok = ! std::ferror (fid);
+
+  if (std::fclose (fid) != 0)
+    ok = false;
+
+  if (! ok || sys::rename (tmp_file, file, msg) < 0)
+    sys::unlink (tmp_file);
+}
+
+// Smallest number of points per thread.  Threads only pay off for
+// large transforms, so smaller ones use fewer threads than allowed.
+
+static const octave_idx_type fftw_thread_points = 32768;
+
+#define CHECK_SIMD_ALIGNMENT(x)                         \
+  (((reinterpret_cast<std::ptrdiff_t> (x)) & 0xF) == 0)
+
 fftw_planner *fftw_planner::s_instance = nullptr;
 
 // Helper class to create and cache FFTW plans for both 1D and
@@ -64,17 +207,13 @@ fftw_planner *fftw_planner::s_instance = nullptr;
 // acceleration.
 
 // Note that it is profitable to store the FFTW3 plans, for small FFTs.
+// The most recently used plans are kept, so alternating between a few
+// transform sizes does not create new plans each time.
 
 fftw_planner::fftw_planner ()
-  : m_meth (ESTIMATE), m_rplan (nullptr), m_rd (0), m_rs (0), m_rr (0),
-    m_rh (0), m_rn (), m_rsimd_align (false), m_nthreads (1)
+  : m_meth (ESTIMATE), m_plans (destroy_plan), m_nthreads (1),
+    m_wisdom_modified (false)
 {
-  m_plan[0] = m_plan[1] = nullptr;
-  m_d[0] = m_d[1] = m_s[0] = m_s[1] = m_r[0] = m_r[1] = m_h[0] = m_h[1] = 0;
-  m_simd_align[0] = m_simd_align[1] = false;
-  m_inplace[0] = m_inplace[1] = false;
-  m_n[0] = m_n[1] = dim_vector ();
-
 #if defined (HAVE_FFTW3_THREADS)
   int init_ret = fftw_init_threads ();
   if (! init_ret)
@@ -89,29 +228,22 @@ fftw_planner::fftw_planner ()
   // This can be later changed with fftw ("threads", nthreads).
   if (m_nthreads > 3)
     m_nthreads = 3;
-
-  fftw_plan_with_nthreads (m_nthreads);
 #endif
 
   // If we have a system wide wisdom file, import it.
   fftw_import_system_wisdom ();
+
+  // Then add the wisdom of previous sessions.
+  import_wisdom (wisdom_file (), fftw_import_wisdom_from_file);
 }
 
 fftw_planner::~fftw_planner ()
 {
-  fftw_plan *plan_p;
-
-  plan_p = reinterpret_cast<fftw_plan *> (&m_rplan);
-  if (*plan_p)
-    fftw_destroy_plan (*plan_p);
+  m_plans.clear ();
 
-  plan_p = reinterpret_cast<fftw_plan *> (&m_plan[0]);
-  if (*plan_p)
-    fftw_destroy_plan (*plan_p);
-
-  plan_p = reinterpret_cast<fftw_plan *> (&m_plan[1]);
-  if (*plan_p)
-    fftw_destroy_plan (*plan_p);
+  if (m_wisdom_modified)
+    octave::save_wisdom (wisdom_file (), fftw_import_wisdom_from_file,
+                         fftw_export_wisdom_to_file);
 }
 
 bool
@@ -128,6 +260,24 @@ fftw_planner::instance_ok ()
   return retval;
 }
 
+void
+fftw_planner::save_wisdom ()
+{
+  if (instance_ok ())
+    {
+      octave::save_wisdom (wisdom_file (), fftw_import_wisdom_from_file,
+                           fftw_export_wisdom_to_file);
+
+      s_instance->m_wisdom_modified = false;
+    }
+}
+
+std::string
+fftw_planner::wisdom_file ()
+{
+  return octave::wisdom_file ("OCTAVE_FFTW_WISDOM_FILE", "fftw-wisdom");
+}
+
 void
 fftw_planner::threads (int nt)
 {
@@ -135,10 +285,8 @@ fftw_planner::threads (int nt)
   if (instance_ok () && nt != threads ())
     {
       s_instance->m_nthreads = nt;
-      fftw_plan_with_nthreads (nt);
       // Clear the current plans.
-      s_instance->m_rplan = nullptr;
-      s_instance->m_plan[0] = s_instance->m_plan[1] = nullptr;
+      s_instance->m_plans.clear ();
     }
 #else
   octave_unused_parameter (nt);
@@ -148,8 +296,19 @@ fftw_planner::threads (int nt)
 #endif
 }
 
-#define CHECK_SIMD_ALIGNMENT(x)                         \
-  (((reinterpret_cast<std::ptrdiff_t> (x)) & 0xF) == 0)
+void
+fftw_planner::destroy_plan (void *plan)
+{
+  fftw_destroy_plan (reinterpret_cast<fftw_plan> (plan));
+}
+
+int
+fftw_planner::plan_threads (octave_idx_type npts) const
+{
+  octave_idx_type nt = npts / fftw_thread_points;
+
+  return (nt < 1 ? 1 : (nt < m_nthreads ? nt : m_nthreads));
+}
 
 void *
 fftw_planner::do_create_plan (int dir, const int rank,
@@ -159,119 +318,99 @@ fftw_planner::do_create_plan (int dir, const int rank,
                               octave_idx_type dist,
                               const Complex *in, Complex *out)
 {
-  int which = (dir == FFTW_FORWARD) ? 0 : 1;
-  fftw_plan *cur_plan_p = reinterpret_cast<fftw_plan *> (&m_plan[which]);
-  bool create_new_plan = false;
+  fftw_plan_cache::transform_kind kind
+    = (dir == FFTW_FORWARD ? fftw_plan_cache::FORWARD
+       : fftw_plan_cache::BACKWARD);
   bool ioalign = CHECK_SIMD_ALIGNMENT (in) && CHECK_SIMD_ALIGNMENT (out);
   bool ioinplace = (in == out);
 
-  // Don't create a new plan if we have a non SIMD plan already but
-  // can do SIMD.  This prevents endlessly recreating plans if we
-  // change the alignment.
+  void *plan = m_plans.lookup (kind, rank, dims, howmany, stride, dist,
+                               ioinplace, ioalign);
 
-  if (m_plan[which] == nullptr || m_d[which] != dist || m_s[which] != stride
-      || m_r[which] != rank || m_h[which] != howmany
-      || ioinplace != m_inplace[which]
-      || ((ioalign != m_simd_align[which]) ? ! ioalign : false))
-    create_new_plan = true;
-  else
-    {
-      // We still might not have the same shape of array.
-
-      for (int i = 0; i < rank; i++)
-        if (dims(i) != m_n[which](i))
-          {
-            create_new_plan = true;
-            break;
-          }
-    }
+  if (plan)
+    return plan;
 
-  if (create_new_plan)
+  // Note reversal of dimensions for column major storage in FFTW.
+  octave_idx_type nn = 1;
+  OCTAVE_LOCAL_BUFFER (int, tmp, rank);
+
+  for (int i = 0, j = rank-1; i < rank; i++, j--)
     {
-      m_d[which] = dist;
-      m_s[which] = stride;
-      m_r[which] = rank;
-      m_h[which] = howmany;
-      m_simd_align[which] = ioalign;
-      m_inplace[which] = ioinplace;
-      m_n[which] = dims;
-
-      // Note reversal of dimensions for column major storage in FFTW.
-      octave_idx_type nn = 1;
-      OCTAVE_LOCAL_BUFFER (int, tmp, rank);
-
-      for (int i = 0, j = rank-1; i < rank; i++, j--)
-        {
-          tmp[i] = dims(j);
-          nn *= dims(j);
-        }
+      tmp[i] = dims(j);
+      nn *= dims(j);
+    }
 
-      int plan_flags = 0;
-      bool plan_destroys_in = true;
+  int plan_flags = 0;
+  bool plan_destroys_in = true;
 
-      switch (m_meth)
+  switch (m_meth)
+    {
+    case UNKNOWN:
+    case ESTIMATE:
+      plan_flags |= FFTW_ESTIMATE;
+      plan_destroys_in = false;
+      break;
+    case MEASURE:
+      plan_flags |= FFTW_MEASURE;
+      break;
+    case PATIENT:
+      plan_flags |= FFTW_PATIENT;
+      break;
+    case EXHAUSTIVE:
+      plan_flags |= FFTW_EXHAUSTIVE;
+      break;
+    case HYBRID:
+      if (nn < 8193)
+        plan_flags |= FFTW_MEASURE;
+      else
         {
-        case UNKNOWN:
-        case ESTIMATE:
           plan_flags |= FFTW_ESTIMATE;
           plan_destroys_in = false;
-          break;
-        case MEASURE:
-          plan_flags |= FFTW_MEASURE;
-          break;
-        case PATIENT:
-          plan_flags |= FFTW_PATIENT;
-          break;
-        case EXHAUSTIVE:
-          plan_flags |= FFTW_EXHAUSTIVE;
-          break;
-        case HYBRID:
-          if (nn < 8193)
-            plan_flags |= FFTW_MEASURE;
-          else
-            {
-              plan_flags |= FFTW_ESTIMATE;
-              plan_destroys_in = false;
-            }
-          break;
         }
+      break;
+    }
 
-      if (ioalign)
-        plan_flags &= ~FFTW_UNALIGNED;
-      else
-        plan_flags |= FFTW_UNALIGNED;
+  if (ioalign)
+    plan_flags &= ~FFTW_UNALIGNED;
+  else
+    plan_flags |= FFTW_UNALIGNED;
 
-      if (*cur_plan_p)
-        fftw_destroy_plan (*cur_plan_p);
+  OCTAVE_SCOPED_BUFFER_ANCHOR (Complex, itmp);
+  itmp = const_cast<Complex *> (in);
+  Complex *otmp = out;
 
-      OCTAVE_SCOPED_BUFFER_ANCHOR (Complex, itmp);
-      itmp = const_cast<Complex *> (in);
-      Complex *otmp = out;
+  if (plan_destroys_in)
+    {
+      // Create matrix with the same size and 16-byte alignment as input
+      OCTAVE_SCOPED_BUFFER (Complex, itmp, nn * howmany + 32);
+      itmp = reinterpret_cast<Complex *>
+             (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF)
+              + ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
 
-      if (plan_destroys_in)
-        {
-          // Create matrix with the same size and 16-byte alignment as input
-          OCTAVE_SCOPED_BUFFER (Complex, itmp, nn * howmany + 32);
-          itmp = reinterpret_cast<Complex *>
-                 (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF)
-                  + ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
-
-          if (in == out)
-            otmp = itmp;
-        }
+      if (in == out)
+        otmp = itmp;
 
-      *cur_plan_p
-        = fftw_plan_many_dft (rank, tmp, howmany,
-                              reinterpret_cast<fftw_complex *> (itmp),
-                              nullptr, stride, dist,
-                              reinterpret_cast<fftw_complex *> (otmp),
-                              nullptr, stride, dist, dir, plan_flags);
-
-      if (*cur_plan_p == nullptr)
-        (*current_liboctave_error_handler) ("Error creating FFTW plan");
+      m_wisdom_modified = true;
     }
 
-  return *cur_plan_p;
+#if defined (HAVE_FFTW3_THREADS)
+  fftw_plan_with_nthreads (plan_threads (nn * howmany));
+#endif
+
+  fftw_plan new_plan
+    = fftw_plan_many_dft (rank, tmp, howmany,
+                          reinterpret_cast<fftw_complex *> (itmp),
+                          nullptr, stride, dist,
+                          reinterpret_cast<fftw_complex *> (otmp),
+                          nullptr, stride, dist, dir, plan_flags);
+
+  if (new_plan == nullptr)
+    (*current_liboctave_error_handler) ("Error creating FFTW plan");
+
+  m_plans.insert (kind, rank, dims, howmany, stride, dist, ioinplace,
+                  ioalign, new_plan);
+
+  return new_plan;
 }
 
 void *
@@ -281,115 +420,98 @@ fftw_planner::do_create_plan (const int rank, const dim_vector& dims,
                               octave_idx_type dist,
                               const double *in, Complex *out)
 {
-  fftw_plan *cur_plan_p = reinterpret_cast<fftw_plan *> (&m_rplan);
-  bool create_new_plan = false;
+  fftw_plan_cache::transform_kind kind = fftw_plan_cache::REAL_FORWARD;
   bool ioalign = CHECK_SIMD_ALIGNMENT (in) && CHECK_SIMD_ALIGNMENT (out);
+  bool ioinplace = (reinterpret_cast<double *> (out) == in);
 
-  // Don't create a new plan if we have a non SIMD plan already but
-  // can do SIMD.  This prevents endlessly recreating plans if we
-  // change the alignment.
+  void *plan = m_plans.lookup (kind, rank, dims, howmany, stride, dist,
+                               ioinplace, ioalign);
 
-  if (m_rplan == nullptr || m_rd != dist || m_rs != stride || m_rr != rank
-      || m_rh != howmany || ((ioalign != m_rsimd_align) ? ! ioalign : false))
-    create_new_plan = true;
-  else
-    {
-      // We still might not have the same shape of array.
-
-      for (int i = 0; i < rank; i++)
-        if (dims(i) != m_rn(i))
-          {
-            create_new_plan = true;
-            break;
-          }
-    }
+  if (plan)
+    return plan;
 
-  if (create_new_plan)
+  // Note reversal of dimensions for column major storage in FFTW.
+  octave_idx_type nn = 1;
+  OCTAVE_LOCAL_BUFFER (int, tmp, rank);
+
+  for (int i = 0, j = rank-1; i < rank; i++, j--)
     {
-      m_rd = dist;
-      m_rs = stride;
-      m_rr = rank;
-      m_rh = howmany;
-      m_rsimd_align = ioalign;
-      m_rn = dims;
-
-      // Note reversal of dimensions for column major storage in FFTW.
-      octave_idx_type nn = 1;
-      OCTAVE_LOCAL_BUFFER (int, tmp, rank);
-
-      for (int i = 0, j = rank-1; i < rank; i++, j--)
-        {
-          tmp[i] = dims(j);
-          nn *= dims(j);
-        }
+      tmp[i] = dims(j);
+      nn *= dims(j);
+    }
 
-      int plan_flags = 0;
-      bool plan_destroys_in = true;
+  int plan_flags = 0;
+  bool plan_destroys_in = true;
 
-      switch (m_meth)
+  switch (m_meth)
+    {
+    case UNKNOWN:
+    case ESTIMATE:
+      plan_flags |= FFTW_ESTIMATE;
+      plan_destroys_in = false;
+      break;
+    case MEASURE:
+      plan_flags |= FFTW_MEASURE;
+      break;
+    case PATIENT:
+      plan_flags |= FFTW_PATIENT;
+      break;
+    case EXHAUSTIVE:
+      plan_flags |= FFTW_EXHAUSTIVE;
+      break;
+    case HYBRID:
+      if (nn < 8193)
+        plan_flags |= FFTW_MEASURE;
+      else
         {
-        case UNKNOWN:
-        case ESTIMATE:
           plan_flags |= FFTW_ESTIMATE;
           plan_destroys_in = false;
-          break;
-        case MEASURE:
-          plan_flags |= FFTW_MEASURE;
-          break;
-        case PATIENT:
-          plan_flags |= FFTW_PATIENT;
-          break;
-        case EXHAUSTIVE:
-          plan_flags |= FFTW_EXHAUSTIVE;
-          break;
-        case HYBRID:
-          if (nn < 8193)
-            plan_flags |= FFTW_MEASURE;
-          else
-            {
-              plan_flags |= FFTW_ESTIMATE;
-              plan_destroys_in = false;
-            }
-          break;
         }
+      break;
+    }
 
-      if (ioalign)
-        plan_flags &= ~FFTW_UNALIGNED;
-      else
-        plan_flags |= FFTW_UNALIGNED;
+  if (ioalign)
+    plan_flags &= ~FFTW_UNALIGNED;
+  else
+    plan_flags |= FFTW_UNALIGNED;
 
-      if (*cur_plan_p)
-        fftw_destroy_plan (*cur_plan_p);
+  OCTAVE_SCOPED_BUFFER_ANCHOR (double, itmp);
+  itmp = const_cast<double *> (in);
+  Complex *otmp = out;
 
-      OCTAVE_SCOPED_BUFFER_ANCHOR (double, itmp);
-      itmp = const_cast<double *> (in);
-      Complex *otmp = out;
+  if (plan_destroys_in)
+    {
+      // Create matrix with the same size and 16-byte alignment as input
+      octave_idx_type in_place = ioinplace;
+      OCTAVE_SCOPED_BUFFER (double, itmp,
+                            nn * howmany * (in_place + 1) + 32);
+      itmp = reinterpret_cast<double *>
+             (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF)
+              + ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
+
+      if (in_place)
+        otmp = reinterpret_cast<Complex *> (itmp);
+
+      m_wisdom_modified = true;
+    }
 
-      if (plan_destroys_in)
-        {
-          // Create matrix with the same size and 16-byte alignment as input
-          octave_idx_type in_place = reinterpret_cast<double *> (out) == in;
-          OCTAVE_SCOPED_BUFFER (double, itmp,
-                                nn * howmany * (in_place + 1) + 32);
-          itmp = reinterpret_cast<double *>
-                 (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF)
-                  + ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
-
-          if (in_place)
-            otmp = reinterpret_cast<Complex *> (itmp);
-        }
+#if defined (HAVE_FFTW3_THREADS)
+  fftw_plan_with_nthreads (plan_threads (nn * howmany));
+#endif
 
-      *cur_plan_p
-        = fftw_plan_many_dft_r2c (rank, tmp, howmany, itmp,
-                                  nullptr, stride, dist,
-                                  reinterpret_cast<fftw_complex *> (otmp),
-                                  nullptr, stride, dist, plan_flags);
+  fftw_plan new_plan
+    = fftw_plan_many_dft_r2c (rank, tmp, howmany, itmp,
+                              nullptr, stride, dist,
+                              reinterpret_cast<fftw_complex *> (otmp),
+                              nullptr, stride, dist, plan_flags);
 
-      if (*cur_plan_p == nullptr)
-        (*current_liboctave_error_handler) ("Error creating FFTW plan");
-    }
+  if (new_plan == nullptr)
+    (*current_liboctave_error_handler) ("Error creating FFTW plan");
 
-  return *cur_plan_p;
+  m_plans.insert (kind, rank, dims, howmany, stride, dist, ioinplace,
+                  ioalign, new_plan);
+
+  return new_plan;
 }
 
 fftw_planner::FftwMethod
@@ -409,13 +531,7 @@ fftw_planner::do_method (FftwMethod _meth)
       if (m_meth != _meth)
         {
           m_meth = _meth;
-          if (m_rplan)
-            fftw_destroy_plan (reinterpret_cast<fftw_plan> (m_rplan));
-          if (m_plan[0])
-            fftw_destroy_plan (reinterpret_cast<fftw_plan> (m_plan[0]));
-          if (m_plan[1])
-            fftw_destroy_plan (reinterpret_cast<fftw_plan> (m_plan[1]));
-          m_rplan = m_plan[0] = m_plan[1] = nullptr;
+          m_plans.clear ();
         }
     }
   else
@@ -425,48 +541,60 @@ fftw_planner::do_method (FftwMethod _meth)
 
 float_fftw_planner *float_fftw_planner::s_instance = nullptr;
 
+// Helper class to create and cache FFTW plans for both 1D and
+// 2D.  This implementation defaults to using FFTW_ESTIMATE to create
+// the plans, which in theory is suboptimal, but provides quite
+// reasonable performance in practice.
+
+// Also note that if FFTW_ESTIMATE is not used then the planner in FFTW3
+// will destroy the input and output arrays.  We must, therefore, create a
+// temporary input array with the same size and 16-byte alignment as
+// the original array when using a different planner strategy.
+// Note that we also use any wisdom that is available, either in a
+// FFTW3 system wide file or as supplied by the user.
+
+// FIXME: if we can ensure 16 byte alignment in Array<T>
+// (<T> *data) the FFTW3 can use SIMD instructions for further
+// acceleration.
+
+// Note that it is profitable to store the FFTW3 plans, for small FFTs.
+// The most recently used plans are kept, so alternating between a few
+// transform sizes does not create new plans each time.
+
 float_fftw_planner::float_fftw_planner ()
-  : m_meth (ESTIMATE), m_rplan (nullptr), m_rd (0), m_rs (0), m_rr (0),
-    m_rh (0), m_rn (), m_rsimd_align (false), m_nthreads (1)
+  : m_meth (ESTIMATE), m_plans (destroy_plan), m_nthreads (1),
+    m_wisdom_modified (false)
 {
-  m_plan[0] = m_plan[1] = nullptr;
-  m_d[0] = m_d[1] = m_s[0] = m_s[1] = m_r[0] = m_r[1] = m_h[0] = m_h[1] = 0;
-  m_simd_align[0] = m_simd_align[1] = false;
-  m_inplace[0] = m_inplace[1] = false;
-  m_n[0] = m_n[1] = dim_vector ();
-
 #if defined (HAVE_FFTW3F_THREADS)
   int init_ret = fftwf_init_threads ();
   if (! init_ret)
-    (*current_liboctave_error_handler) ("Error initializing FFTW3F threads");
+    (*current_liboctave_error_handler) ("Error initializing FFTW threads");
 
-  // Use number of processors available to the current process
-  // This can be later changed with fftw ("threads", nthreads).
+  // Check number of processors available to the current process
   m_nthreads =
     octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT_OVERRIDABLE);
 
-  fftwf_plan_with_nthreads (m_nthreads);
+  // Limit number of threads to 3 by default
+  // See: https://octave.discourse.group/t/3121
+  // This can be later changed with fftw ("threads", nthreads).
+  if (m_nthreads > 3)
+    m_nthreads = 3;
 #endif
 
   // If we have a system wide wisdom file, import it.
   fftwf_import_system_wisdom ();
+
+  // Then add the wisdom of previous sessions.
+  import_wisdom (wisdom_file (), fftwf_import_wisdom_from_file);
 }
 
 float_fftw_planner::~float_fftw_planner ()
 {
-  fftwf_plan *plan_p;
+  m_plans.clear ();
 
-  plan_p = reinterpret_cast<fftwf_plan *> (&m_rplan);
-  if (*plan_p)
-    fftwf_destroy_plan (*plan_p);
-
-  plan_p = reinterpret_cast<fftwf_plan *> (&m_plan[0]);
-  if (*plan_p)
-    fftwf_destroy_plan (*plan_p);
-
-  plan_p = reinterpret_cast<fftwf_plan *> (&m_plan[1]);
-  if (*plan_p)
-    fftwf_destroy_plan (*plan_p);
+  if (m_wisdom_modified)
+    octave::save_wisdom (wisdom_file (), fftwf_import_wisdom_from_file,
+                         fftwf_export_wisdom_to_file);
 }
 
 bool
@@ -483,6 +611,24 @@ float_fftw_planner::instance_ok ()
   return retval;
 }
 
+void
+float_fftw_planner::save_wisdom ()
+{
+  if (instance_ok ())
+    {
+      octave::save_wisdom (wisdom_file (), fftwf_import_wisdom_from_file,
+                           fftwf_export_wisdom_to_file);
+
+      s_instance->m_wisdom_modified = false;
+    }
+}
+
+std::string
+float_fftw_planner::wisdom_file ()
+{
+  return octave::wisdom_file ("OCTAVE_FFTWF_WISDOM_FILE", "fftwf-wisdom");
+}
+
 void
 float_fftw_planner::threads (int nt)
 {
@@ -490,10 +636,8 @@ float_fftw_planner::threads (int nt)
   if (instance_ok () && nt != threads ())
     {
       s_instance->m_nthreads = nt;
-      fftwf_plan_with_nthreads (nt);
       // Clear the current plans.
-      s_instance->m_rplan = nullptr;
-      s_instance->m_plan[0] = s_instance->m_plan[1] = nullptr;
+      s_instance->m_plans.clear ();
     }
 #else
   octave_unused_parameter (nt);
@@ -503,246 +647,222 @@ float_fftw_planner::threads (int nt)
 #endif
 }
 
+void
+float_fftw_planner::destroy_plan (void *plan)
+{
+  fftwf_destroy_plan (reinterpret_cast<fftwf_plan> (plan));
+}
+
+int
+float_fftw_planner::plan_threads (octave_idx_type npts) const
+{
+  octave_idx_type nt = npts / fftw_thread_points;
+
+  return (nt < 1 ? 1 : (nt < m_nthreads ? nt : m_nthreads));
+}
+
 void *
 float_fftw_planner::do_create_plan (int dir, const int rank,
-                                    const dim_vector& dims,
-                                    octave_idx_type howmany,
-                                    octave_idx_type stride,
-                                    octave_idx_type dist,
-                                    const FloatComplex *in,
-                                    FloatComplex *out)
+                              const dim_vector& dims,
+                              octave_idx_type howmany,
+                              octave_idx_type stride,
+                              octave_idx_type dist,
+                              const FloatComplex *in, FloatComplex *out)
 {
-  int which = (dir == FFTW_FORWARD) ? 0 : 1;
-  fftwf_plan *cur_plan_p = reinterpret_cast<fftwf_plan *> (&m_plan[which]);
-  bool create_new_plan = false;
+  fftw_plan_cache::transform_kind kind
+    = (dir == FFTW_FORWARD ? fftw_plan_cache::FORWARD
+       : fftw_plan_cache::BACKWARD);
   bool ioalign = CHECK_SIMD_ALIGNMENT (in) && CHECK_SIMD_ALIGNMENT (out);
   bool ioinplace = (in == out);
 
-  // Don't create a new plan if we have a non SIMD plan already but
-  // can do SIMD.  This prevents endlessly recreating plans if we
-  // change the alignment.
+  void *plan = m_plans.lookup (kind, rank, dims, howmany, stride, dist,
+                               ioinplace, ioalign);
 
-  if (m_plan[which] == nullptr || m_d[which] != dist || m_s[which] != stride
-      || m_r[which] != rank || m_h[which] != howmany
-      || ioinplace != m_inplace[which]
-      || ((ioalign != m_simd_align[which]) ? ! ioalign : false))
-    create_new_plan = true;
-  else
-    {
-      // We still might not have the same shape of array.
-
-      for (int i = 0; i < rank; i++)
-        if (dims(i) != m_n[which](i))
-          {
-            create_new_plan = true;
-            break;
-          }
-    }
+  if (plan)
+    return plan;
 
-  if (create_new_plan)
+  // Note reversal of dimensions for column major storage in FFTW.
+  octave_idx_type nn = 1;
+  OCTAVE_LOCAL_BUFFER (int, tmp, rank);
+
+  for (int i = 0, j = rank-1; i < rank; i++, j--)
     {
-      m_d[which] = dist;
-      m_s[which] = stride;
-      m_r[which] = rank;
-      m_h[which] = howmany;
-      m_simd_align[which] = ioalign;
-      m_inplace[which] = ioinplace;
-      m_n[which] = dims;
-
-      // Note reversal of dimensions for column major storage in FFTW.
-      octave_idx_type nn = 1;
-      OCTAVE_LOCAL_BUFFER (int, tmp, rank);
-
-      for (int i = 0, j = rank-1; i < rank; i++, j--)
-        {
-          tmp[i] = dims(j);
-          nn *= dims(j);
-        }
+      tmp[i] = dims(j);
+      nn *= dims(j);
+    }
 
-      int plan_flags = 0;
-      bool plan_destroys_in = true;
+  int plan_flags = 0;
+  bool plan_destroys_in = true;
 
-      switch (m_meth)
+  switch (m_meth)
+    {
+    case UNKNOWN:
+    case ESTIMATE:
+      plan_flags |= FFTW_ESTIMATE;
+      plan_destroys_in = false;
+      break;
+    case MEASURE:
+      plan_flags |= FFTW_MEASURE;
+      break;
+    case PATIENT:
+      plan_flags |= FFTW_PATIENT;
+      break;
+    case EXHAUSTIVE:
+      plan_flags |= FFTW_EXHAUSTIVE;
+      break;
+    case HYBRID:
+      if (nn < 8193)
+        plan_flags |= FFTW_MEASURE;
+      else
         {
-        case UNKNOWN:
-        case ESTIMATE:
           plan_flags |= FFTW_ESTIMATE;
           plan_destroys_in = false;
-          break;
-        case MEASURE:
-          plan_flags |= FFTW_MEASURE;
-          break;
-        case PATIENT:
-          plan_flags |= FFTW_PATIENT;
-          break;
-        case EXHAUSTIVE:
-          plan_flags |= FFTW_EXHAUSTIVE;
-          break;
-        case HYBRID:
-          if (nn < 8193)
-            plan_flags |= FFTW_MEASURE;
-          else
-            {
-              plan_flags |= FFTW_ESTIMATE;
-              plan_destroys_in = false;
-            }
-          break;
         }
+      break;
+    }
 
-      if (ioalign)
-        plan_flags &= ~FFTW_UNALIGNED;
-      else
-        plan_flags |= FFTW_UNALIGNED;
-
-      if (*cur_plan_p)
-        fftwf_destroy_plan (*cur_plan_p);
+  if (ioalign)
+    plan_flags &= ~FFTW_UNALIGNED;
+  else
+    plan_flags |= FFTW_UNALIGNED;
 
-      OCTAVE_SCOPED_BUFFER_ANCHOR (FloatComplex, itmp);
-      itmp = const_cast<FloatComplex *> (in);
-      FloatComplex *otmp = out;
+  OCTAVE_SCOPED_BUFFER_ANCHOR (FloatComplex, itmp);
+  itmp = const_cast<FloatComplex *> (in);
+  FloatComplex *otmp = out;
 
-      if (plan_destroys_in)
-        {
-          // Create matrix with the same size and 16-byte alignment as input
-          OCTAVE_SCOPED_BUFFER (FloatComplex, itmp, nn * howmany + 32);
-          itmp = reinterpret_cast<FloatComplex *>
-                 (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF)
-                  + ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
-
-          if (out == in)
-            otmp = itmp;
-        }
+  if (plan_destroys_in)
+    {
+      // Create matrix with the same size and 16-byte alignment as input
+      OCTAVE_SCOPED_BUFFER (FloatComplex, itmp, nn * howmany + 32);
+      itmp = reinterpret_cast<FloatComplex *>
+             (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF)
+              + ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
 
-      *cur_plan_p
-        = fftwf_plan_many_dft (rank, tmp, howmany,
-                               reinterpret_cast<fftwf_complex *> (itmp),
-                               nullptr, stride, dist,
-                               reinterpret_cast<fftwf_complex *> (otmp),
-                               nullptr, stride, dist, dir, plan_flags);
+      if (in == out)
+        otmp = itmp;
 
-      if (*cur_plan_p == nullptr)
-        (*current_liboctave_error_handler) ("Error creating FFTW plan");
+      m_wisdom_modified = true;
     }
 
-  return *cur_plan_p;
+#if defined (HAVE_FFTW3F_THREADS)
+  fftwf_plan_with_nthreads (plan_threads (nn * howmany));
+#endif
+
+  fftwf_plan new_plan
+    = fftwf_plan_many_dft (rank, tmp, howmany,
+                          reinterpret_cast<fftwf_complex *> (itmp),
+                          nullptr, stride, dist,
+                          reinterpret_cast<fftwf_complex *> (otmp),
+                          nullptr, stride, dist, dir, plan_flags);
+
+  if (new_plan == nullptr)
+    (*current_liboctave_error_handler) ("Error creating FFTW plan");
+
+  m_plans.insert (kind, rank, dims, howmany, stride, dist, ioinplace,
+                  ioalign, new_plan);
+
+  return new_plan;
 }
 
 void *
 float_fftw_planner::do_create_plan (const int rank, const dim_vector& dims,
-                                    octave_idx_type howmany,
-                                    octave_idx_type stride,
-                                    octave_idx_type dist,
-                                    const float *in, FloatComplex *out)
+                              octave_idx_type howmany,
+                              octave_idx_type stride,
+                              octave_idx_type dist,
+                              const float *in, FloatComplex *out)
 {
-  fftwf_plan *cur_plan_p = reinterpret_cast<fftwf_plan *> (&m_rplan);
-  bool create_new_plan = false;
+  fftw_plan_cache::transform_kind kind = fftw_plan_cache::REAL_FORWARD;
   bool ioalign = CHECK_SIMD_ALIGNMENT (in) && CHECK_SIMD_ALIGNMENT (out);
+  bool ioinplace = (reinterpret_cast<float *> (out) == in);
 
-  // Don't create a new plan if we have a non SIMD plan already but
-  // can do SIMD.  This prevents endlessly recreating plans if we
-  // change the alignment.
+  void *plan = m_plans.lookup (kind, rank, dims, howmany, stride, dist,
+                               ioinplace, ioalign);
 
-  if (m_rplan == nullptr || m_rd != dist || m_rs != stride || m_rr != rank
-      || m_rh != howmany || ((ioalign != m_rsimd_align) ? ! ioalign : false))
-    create_new_plan = true;
-  else
-    {
-      // We still might not have the same shape of array.
-
-      for (int i = 0; i < rank; i++)
-        if (dims(i) != m_rn(i))
-          {
-            create_new_plan = true;
-            break;
-          }
-    }
+  if (plan)
+    return plan;
+
+  // Note reversal of dimensions for column major storage in FFTW.
+  octave_idx_type nn = 1;
+  OCTAVE_LOCAL_BUFFER (int, tmp, rank);
 
-  if (create_new_plan)
+  for (int i = 0, j = rank-1; i < rank; i++, j--)
     {
-      m_rd = dist;
-      m_rs = stride;
-      m_rr = rank;
-      m_rh = howmany;
-      m_rsimd_align = ioalign;
-      m_rn = dims;
-
-      // Note reversal of dimensions for column major storage in FFTW.
-      octave_idx_type nn = 1;
-      OCTAVE_LOCAL_BUFFER (int, tmp, rank);
-
-      for (int i = 0, j = rank-1; i < rank; i++, j--)
-        {
-          tmp[i] = dims(j);
-          nn *= dims(j);
-        }
+      tmp[i] = dims(j);
+      nn *= dims(j);
+    }
 
-      int plan_flags = 0;
-      bool plan_destroys_in = true;
+  int plan_flags = 0;
+  bool plan_destroys_in = true;
 
-      switch (m_meth)
+  switch (m_meth)
+    {
+    case UNKNOWN:
+    case ESTIMATE:
+      plan_flags |= FFTW_ESTIMATE;
+      plan_destroys_in = false;
+      break;
+    case MEASURE:
+      plan_flags |= FFTW_MEASURE;
+      break;
+    case PATIENT:
+      plan_flags |= FFTW_PATIENT;
+      break;
+    case EXHAUSTIVE:
+      plan_flags |= FFTW_EXHAUSTIVE;
+      break;
+    case HYBRID:
+      if (nn < 8193)
+        plan_flags |= FFTW_MEASURE;
+      else
         {
-        case UNKNOWN:
-        case ESTIMATE:
           plan_flags |= FFTW_ESTIMATE;
           plan_destroys_in = false;
-          break;
-        case MEASURE:
-          plan_flags |= FFTW_MEASURE;
-          break;
-        case PATIENT:
-          plan_flags |= FFTW_PATIENT;
-          break;
-        case EXHAUSTIVE:
-          plan_flags |= FFTW_EXHAUSTIVE;
-          break;
-        case HYBRID:
-          if (nn < 8193)
-            plan_flags |= FFTW_MEASURE;
-          else
-            {
-              plan_flags |= FFTW_ESTIMATE;
-              plan_destroys_in = false;
-            }
-          break;
         }
+      break;
+    }
 
-      if (ioalign)
-        plan_flags &= ~FFTW_UNALIGNED;
-      else
-        plan_flags |= FFTW_UNALIGNED;
+  if (ioalign)
+    plan_flags &= ~FFTW_UNALIGNED;
+  else
+    plan_flags |= FFTW_UNALIGNED;
+
+  OCTAVE_SCOPED_BUFFER_ANCHOR (float, itmp);
+  itmp = const_cast<float *> (in);
+  FloatComplex *otmp = out;
 
-      if (*cur_plan_p)
-        fftwf_destroy_plan (*cur_plan_p);
+  if (plan_destroys_in)
+    {
+      // Create matrix with the same size and 16-byte alignment as input
+      octave_idx_type in_place = ioinplace;
+      OCTAVE_SCOPED_BUFFER (float, itmp,
+                            nn * howmany * (in_place + 1) + 32);
+      itmp = reinterpret_cast<float *>
+             (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF)
+              + ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
+
+      if (in_place)
+        otmp = reinterpret_cast<FloatComplex *> (itmp);
+
+      m_wisdom_modified = true;
+    }
 
-      OCTAVE_SCOPED_BUFFER_ANCHOR (float, itmp);
-      itmp = const_cast<float *> (in);
-      FloatComplex *otmp = out;
+#if defined (HAVE_FFTW3F_THREADS)
+  fftwf_plan_with_nthreads (plan_threads (nn * howmany));
+#endif
 
-      if (plan_destroys_in)
-        {
-          // Create matrix with the same size and 16-byte alignment as input
-          octave_idx_type in_place = reinterpret_cast<float *> (out) == in;
-          OCTAVE_SCOPED_BUFFER (float, itmp,
-                                nn * howmany * (in_place + 1) + 32);
-          itmp = reinterpret_cast<float *>
-                 (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF)
-                  + ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
-
-          if (in_place)
-            otmp = reinterpret_cast<FloatComplex *> (itmp);
-        }
+  fftwf_plan new_plan
+    = fftwf_plan_many_dft_r2c (rank, tmp, howmany, itmp,
+                              nullptr, stride, dist,
+                              reinterpret_cast<fftwf_complex *> (otmp),
+                              nullptr, stride, dist, plan_flags);
 
-      *cur_plan_p
-        = fftwf_plan_many_dft_r2c (rank, tmp, howmany, itmp,
-                                   nullptr, stride, dist,
-                                   reinterpret_cast<fftwf_complex *> (otmp),
-                                   nullptr, stride, dist, plan_flags);
+  if (new_plan == nullptr)
+    (*current_liboctave_error_handler) ("Error creating FFTW plan");
 
-      if (*cur_plan_p == nullptr)
-        (*current_liboctave_error_handler) ("Error creating FFTW plan");
-    }
+  m_plans.insert (kind, rank, dims, howmany, stride, dist, ioinplace,
+                  ioalign, new_plan);
 
-  return *cur_plan_p;
+  return new_plan;
 }
 
 float_fftw_planner::FftwMethod
@@ -762,13 +882,7 @@ float_fftw_planner::do_method (FftwMethod _meth)
       if (m_meth != _meth)
         {
           m_meth = _meth;
-          if (m_rplan)
-            fftwf_destroy_plan (reinterpret_cast<fftwf_plan> (m_rplan));
-          if (m_plan[0])
-            fftwf_destroy_plan (reinterpret_cast<fftwf_plan> (m_plan[0]));
-          if (m_plan[1])
-            fftwf_destroy_plan (reinterpret_cast<fftwf_plan> (m_plan[1]));
-          m_rplan = m_plan[0] = m_plan[1] = nullptr;
+          m_plans.clear ();
         }
     }
   else
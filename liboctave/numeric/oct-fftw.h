@@ -30,6 +30,7 @@
 
 #include <cstddef>
 
+#include <list>
 #include <string>
 
 #include "dim-vector.h"
@@ -37,6 +38,78 @@
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+// Cache of FFTW plans for fftw_planner and float_fftw_planner.
+//
+// Plans are identified by the kind of transform and all the parameters
+// that were used to create them.  When the cache is full, the least
+// recently used plan is destroyed.  The plans are stored as void
+// pointers so that this header does not depend on fftw3.h.
+
+class OCTAVE_API fftw_plan_cache
+{
+public:
+
+  enum transform_kind
+  {
+    FORWARD,
+    BACKWARD,
+    REAL_FORWARD
+  };
+
+  typedef void (*destroy_fcn) (void *);
+
+  static const std::size_t DEFAULT_CAPACITY = 16;
+
+  fftw_plan_cache (destroy_fcn destroy,
+                   std::size_t capacity = DEFAULT_CAPACITY)
+    : m_destroy (destroy), m_capacity (capacity > 0 ? capacity : 1),
+      m_entries ()
+  { }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (fftw_plan_cache)
+
+  ~fftw_plan_cache () { clear (); }
+
+  // Return the plan for a transform with the given parameters, or
+  // nullptr if there is none.
+  void * lookup (transform_kind kind, int rank, const dim_vector& dims,
+                 octave_idx_type howmany, octave_idx_type stride,
+                 octave_idx_type dist, bool inplace, bool simd_align);
+
+  // Add a plan that was created for the given parameters.
+  void insert (transform_kind kind, int rank, const dim_vector& dims,
+               octave_idx_type howmany, octave_idx_type stride,
+               octave_idx_type dist, bool inplace, bool simd_align,
+               void *plan);
+
+  // Destroy all plans.
+  void clear ();
+
+  std::size_t size () const { return m_entries.size (); }
+
+private:
+
+  struct entry
+  {
+    transform_kind kind;
+    int rank;
+    dim_vector dims;
+    octave_idx_type howmany;
+    octave_idx_type stride;
+    octave_idx_type dist;
+    bool inplace;
+    bool simd_align;
+    void *plan;
+  };
+
+  destroy_fcn m_destroy;
+
+  std::size_t m_capacity;
+
+  // Most recently used first.
+  std::list<entry> m_entries;
+};
+
 class OCTAVE_API fftw_planner
 {
 protected:
@@ -105,6 +178,10 @@ public:
     return instance_ok () ? s_instance->m_nthreads : 0;
   }
 
+  // Save the wisdom to the wisdom file now instead of when Octave
+  // exits.
+  static void save_wisdom ();
+
 private:
 
   static fftw_planner *s_instance;
@@ -112,6 +189,10 @@ private:
   static void cleanup_instance ()
   { delete s_instance; s_instance = nullptr; }
 
+  static std::string wisdom_file ();
+
+  static void destroy_plan (void *plan);
+
   void *
   do_create_plan (int dir, const int rank, const dim_vector& dims,
                   octave_idx_type howmany, octave_idx_type stride,
@@ -127,54 +208,21 @@ private:
 
   FftwMethod do_method (FftwMethod meth);
 
-  FftwMethod m_meth;
-
-  // FIXME: perhaps this should be split into two classes?
-
-  // Plan for fft and ifft of complex values
-  void *m_plan[2];
+  int plan_threads (octave_idx_type npts) const;
 
-  // dist
-  octave_idx_type m_d[2];
-
-  // stride
-  octave_idx_type m_s[2];
-
-  // rank
-  int m_r[2];
-
-  // howmany
-  octave_idx_type m_h[2];
-
-  // dims
-  dim_vector m_n[2];
-
-  bool m_simd_align[2];
-  bool m_inplace[2];
-
-  // Plan for fft of real values
-  void *m_rplan;
-
-  // dist
-  octave_idx_type m_rd;
-
-  // stride
-  octave_idx_type m_rs;
-
-  // rank
-  int m_rr;
-
-  // howmany
-  octave_idx_type m_rh;
-
-  // dims
-  dim_vector m_rn;
+  FftwMethod m_meth;
 
-  bool m_rsimd_align;
+  // Plans for fft and ifft of complex values and for fft of real
+  // values.
+  fftw_plan_cache m_plans;
 
-  // number of threads.  Always 1 unless compiled with multi-threading
-  // support.
+  // Maximum number of threads.  Always 1 unless compiled with
+  // multi-threading support.
   int m_nthreads;
+
+  // TRUE if plans were created by measuring, which adds to the wisdom
+  // that is saved when Octave exits.
+  bool m_wisdom_modified;
 };
 
 class OCTAVE_API float_fftw_planner
@@ -245,6 +293,10 @@ public:
     return instance_ok () ? s_instance->m_nthreads : 0;
   }
 
+  // Save the wisdom to the wisdom file now instead of when Octave
+  // exits.
+  static void save_wisdom ();
+
 private:
 
   static float_fftw_planner *s_instance;
@@ -252,6 +304,10 @@ private:
   static void cleanup_instance ()
   { delete s_instance; s_instance = nullptr; }
 
+  static std::string wisdom_file ();
+
+  static void destroy_plan (void *plan);
+
   void *
   do_create_plan (int dir, const int rank, const dim_vector& dims,
                   octave_idx_type howmany, octave_idx_type stride,
@@ -267,54 +323,21 @@ private:
 
   FftwMethod do_method (FftwMethod meth);
 
-  FftwMethod m_meth;
-
-  // FIXME: perhaps this should be split into two classes?
-
-  // Plan for fft and ifft of complex values
-  void *m_plan[2];
-
-  // dist
-  octave_idx_type m_d[2];
-
-  // stride
-  octave_idx_type m_s[2];
-
-  // rank
-  int m_r[2];
-
-  // howmany
-  octave_idx_type m_h[2];
-
-  // dims
-  dim_vector m_n[2];
+  int plan_threads (octave_idx_type npts) const;
 
-  bool m_simd_align[2];
-  bool m_inplace[2];
-
-  // Plan for fft of real values
-  void *m_rplan;
-
-  // dist
-  octave_idx_type m_rd;
-
-  // stride
-  octave_idx_type m_rs;
-
-  // rank
-  int m_rr;
-
-  // howmany
-  octave_idx_type m_rh;
-
-  // dims
-  dim_vector m_rn;
+  FftwMethod m_meth;
 
-  bool m_rsimd_align;
+  // Plans for fft and ifft of complex values and for fft of real
+  // values.
+  fftw_plan_cache m_plans;
 
-  // number of threads.  Always 1 unless compiled with multi-threading
-  // support.
+  // Maximum number of threads.  Always 1 unless compiled with
+  // multi-threading support.
   int m_nthreads;
+
+  // TRUE if plans were created by measuring, which adds to the wisdom
+  // that is saved when Octave exits.
+  bool m_wisdom_modified;
 };
 
 class OCTAVE_API fftw
@@ -31,6 +31,7 @@
 #include <cstdint>
 
 #include <limits>
+#include <random>
 
 #include "lo-error.h"
 #include "lo-ieee.h"
@@ -39,6 +40,7 @@
 #include "mach-info.h"
 #include "oct-locbuf.h"
 #include "oct-rand.h"
+#include "oct-syscalls.h"
 #include "oct-time.h"
 #include "quit.h"
 #include "randgamma.h"
@@ -52,7 +54,7 @@ rand *rand::s_instance = nullptr;
 
 rand::rand ()
   : m_current_distribution (uniform_dist), m_use_old_generators (false),
-    m_rand_states ()
+    m_rand_states (), m_philox_streams ()
 {
   initialize_ranlib_generators ();
 
@@ -168,6 +170,7 @@ rand::do_state (const uint32NDArray& s, const std::string& d)
   set_internal_state (s);
 
   m_rand_states[new_dist] = get_internal_state ();
+  m_philox_streams.erase (new_dist);
 
   if (old_dist != new_dist)
     m_rand_states[old_dist] = saved_state;
@@ -189,11 +192,68 @@ rand::do_reset (const std::string& d)
 
   init_mersenne_twister ();
   m_rand_states[new_dist] = get_internal_state ();
+  m_philox_streams.erase (new_dist);
 
   if (old_dist != new_dist)
     m_rand_states[old_dist] = saved_state;
 }
 
+uint32NDArray
+rand::do_philox_state (const std::string& d)
+{
+  auto p = m_philox_streams.find (philox_dist_id (d));
+
+  return p == m_philox_streams.end () ? uint32NDArray () : p->second.state ();
+}
+
+void
+rand::do_philox_state (const uint32NDArray& s, const std::string& d)
+{
+  philox_stream ps;
+
+  if (! ps.state (s))
+    (*current_liboctave_error_handler)
+      ("rand: Philox state must be a vector of %" OCTAVE_IDX_TYPE_FORMAT
+       " elements", philox_stream::STATE_SIZE);
+
+  m_use_old_generators = false;
+
+  m_philox_streams[philox_dist_id (d)] = ps;
+}
+
+void
+rand::do_philox_seed (uint64_t key, uint32_t substream, const std::string& d)
+{
+  m_use_old_generators = false;
+
+  m_philox_streams[philox_dist_id (d)] = philox_stream (key, substream);
+}
+
+void
+rand::do_philox_reset (const std::string& d)
+{
+  // Gather entropy as init_mersenne_twister does.
+  sys::time now;
+
+  uint64_t key = static_cast<uint64_t> (now.unix_time ()) << 20;
+  key ^= static_cast<uint64_t> (now.usec ());
+  key ^= static_cast<uint64_t> (sys::getpid ()) << 44;
+  key ^= static_cast<uint64_t> (clock ()) << 24;
+
+  try
+    {
+      std::random_device rd;
+      std::uniform_int_distribution<uint32_t> dist;
+      key ^= (static_cast<uint64_t> (dist (rd)) << 32) | dist (rd);
+    }
+  catch (const std::exception&)
+    {
+      // Just ignore any exception and skip that source of entropy.
+    }
+
+  do_philox_seed (key, 0, d);
+}
+
 std::string
 rand::do_distribution ()
 {
@@ -312,6 +372,8 @@ rand::uniform<double> ()
 
   if (m_use_old_generators)
     F77_FUNC (dgenunf, DGENUNF) (0.0, 1.0, retval);
+  else if (philox_stream *ps = current_philox_stream ())
+    retval = ps->uniform<double> ();
   else
     retval = rand_uniform<double> ();
 
@@ -326,6 +388,8 @@ rand::normal<double> ()
 
   if (m_use_old_generators)
     F77_FUNC (dgennor, DGENNOR) (0.0, 1.0, retval);
+  else if (philox_stream *ps = current_philox_stream ())
+    retval = ps->normal<double> ();
   else
     retval = rand_normal<double> ();
 
@@ -340,6 +404,8 @@ rand::exponential<double> ()
 
   if (m_use_old_generators)
     F77_FUNC (dgenexp, DGENEXP) (1.0, retval);
+  else if (philox_stream *ps = current_philox_stream ())
+    retval = ps->exponential<double> ();
   else
     retval = rand_exponential<double> ();
 
@@ -395,6 +461,8 @@ OCTAVE_API float rand::uniform<float> ()
 
   if (m_use_old_generators)
     F77_FUNC (fgenunf, FGENUNF) (0.0f, 1.0f, retval);
+  else if (philox_stream *ps = current_philox_stream ())
+    retval = ps->uniform<float> ();
   else
     retval = rand_uniform<float> ();
 
@@ -408,6 +476,8 @@ OCTAVE_API float rand::normal<float> ()
 
   if (m_use_old_generators)
     F77_FUNC (fgennor, FGENNOR) (0.0f, 1.0f, retval);
+  else if (philox_stream *ps = current_philox_stream ())
+    retval = ps->normal<float> ();
   else
     retval = rand_normal<float> ();
 
@@ -421,6 +491,8 @@ OCTAVE_API float rand::exponential<float> ()
 
   if (m_use_old_generators)
     F77_FUNC (fgenexp, FGENEXP) (1.0f, retval);
+  else if (philox_stream *ps = current_philox_stream ())
+    retval = ps->exponential<float> ();
   else
     retval = rand_exponential<float> ();
 
@@ -684,6 +756,32 @@ rand::switch_to_generator (int dist)
     }
 }
 
+// The gamma and Poisson generators draw their uniform and normal
+// deviates directly from the Mersenne Twister, so the Philox generator
+// is only available for the uniform, normal, and exponential
+// distributions.
+
+int
+rand::philox_dist_id (const std::string& d)
+{
+  int dist = (d.empty () ? m_current_distribution : get_dist_id (d));
+
+  if (dist != uniform_dist && dist != normal_dist && dist != expon_dist)
+    (*current_liboctave_error_handler)
+      ("rand: the Philox generator is only available for rand, randn, "
+       "and rande");
+
+  return dist;
+}
+
+philox_stream *
+rand::current_philox_stream ()
+{
+  auto p = m_philox_streams.find (m_current_distribution);
+
+  return p == m_philox_streams.end () ? nullptr : &(p->second);
+}
+
 void
 rand::fill (octave_idx_type len, double *v, double a)
 {
@@ -695,6 +793,8 @@ rand::fill (octave_idx_type len, double *v, double a)
     case uniform_dist:
       if (m_use_old_generators)
         std::generate_n (v, len, []() { double x; F77_FUNC (dgenunf, DGENUNF) (0.0, 1.0, x); return x; });
+      else if (philox_stream *ps = current_philox_stream ())
+        ps->uniform<double> (len, v);
       else
         rand_uniform<double> (len, v);
       break;
@@ -702,6 +802,8 @@ rand::fill (octave_idx_type len, double *v, double a)
     case normal_dist:
       if (m_use_old_generators)
         std::generate_n (v, len, []() { double x; F77_FUNC (dgennor, DGENNOR) (0.0, 1.0, x); return x; });
+      else if (philox_stream *ps = current_philox_stream ())
+        ps->normal<double> (len, v);
       else
         rand_normal<double> (len, v);
       break;
@@ -709,6 +811,8 @@ rand::fill (octave_idx_type len, double *v, double a)
     case expon_dist:
       if (m_use_old_generators)
         std::generate_n (v, len, []() { double x; F77_FUNC (dgenexp, DGENEXP) (1.0, x); return x; });
+      else if (philox_stream *ps = current_philox_stream ())
+        ps->exponential<double> (len, v);
       else
         rand_exponential<double> (len, v);
       break;
@@ -764,6 +868,8 @@ rand::fill (octave_idx_type len, float *v, float a)
     case uniform_dist:
       if (m_use_old_generators)
         std::generate_n (v, len, []() { float x; F77_FUNC (fgenunf, FGENUNF) (0.0f, 1.0f, x); return x; });
+      else if (philox_stream *ps = current_philox_stream ())
+        ps->uniform<float> (len, v);
       else
         rand_uniform<float> (len, v);
       break;
@@ -771,6 +877,8 @@ rand::fill (octave_idx_type len, float *v, float a)
     case normal_dist:
       if (m_use_old_generators)
         std::generate_n (v, len, []() { float x; F77_FUNC (fgennor, FGENNOR) (0.0f, 1.0f, x); return x; });
+      else if (philox_stream *ps = current_philox_stream ())
+        ps->normal<float> (len, v);
       else
         rand_normal<float> (len, v);
       break;
@@ -778,6 +886,8 @@ rand::fill (octave_idx_type len, float *v, float a)
     case expon_dist:
       if (m_use_old_generators)
         std::generate_n (v, len, []() { float x; F77_FUNC (fgenexp, FGENEXP) (1.0f, x); return x; });
+      else if (philox_stream *ps = current_philox_stream ())
+        ps->exponential<float> (len, v);
       else
         rand_exponential<float> (len, v);
       break;
@@ -35,6 +35,7 @@
 #include "dNDArray.h"
 #include "fNDArray.h"
 #include "lo-ieee.h"
+#include "randphilox.h"
 #include "uint32NDArray.h"
 
 //class dim_vector;
@@ -97,6 +98,38 @@ public:
       s_instance->do_reset (d);
   }
 
+  // Return the state of the Philox generator, or an empty array if
+  // the distribution does not use the Philox generator.
+  static uint32NDArray philox_state (const std::string& d = "")
+  {
+    return instance_ok () ? s_instance->do_philox_state (d) : uint32NDArray ();
+  }
+
+  // Use the Philox generator with the state S that was returned by
+  // philox_state.
+  static void philox_state (const uint32NDArray& s,
+                            const std::string& d = "")
+  {
+    if (instance_ok ())
+      s_instance->do_philox_state (s, d);
+  }
+
+  // Use the Philox generator with the given key and substream, starting
+  // at the first element of the stream.
+  static void philox_seed (uint64_t key, uint32_t substream = 0,
+                           const std::string& d = "")
+  {
+    if (instance_ok ())
+      s_instance->do_philox_seed (key, substream, d);
+  }
+
+  // Use the Philox generator with a random key.
+  static void philox_reset (const std::string& d = "")
+  {
+    if (instance_ok ())
+      s_instance->do_philox_reset (d);
+  }
+
   // Return the current distribution.
   static std::string distribution ()
   {
@@ -209,6 +242,10 @@ private:
   // Saved MT states.
   std::map<int, uint32NDArray> m_rand_states;
 
+  // Philox streams of the distributions that use the Philox generator
+  // instead of the Mersenne Twister.
+  std::map<int, philox_stream> m_philox_streams;
+
   // Return the current seed.
   OCTAVE_API double do_seed ();
 
@@ -227,6 +264,16 @@ private:
   // Reset the current state/
   OCTAVE_API void do_reset (const std::string& d);
 
+  OCTAVE_API uint32NDArray do_philox_state (const std::string& d);
+
+  OCTAVE_API void do_philox_state (const uint32NDArray& s,
+                                   const std::string& d);
+
+  OCTAVE_API void do_philox_seed (uint64_t key, uint32_t substream,
+                                  const std::string& d);
+
+  OCTAVE_API void do_philox_reset (const std::string& d);
+
   // Return the current distribution.
   OCTAVE_API std::string do_distribution ();
 
@@ -289,6 +336,12 @@ private:
 
   OCTAVE_API void switch_to_generator (int dist);
 
+  OCTAVE_API int philox_dist_id (const std::string& d);
+
+  // Return the Philox stream of the current distribution, or nullptr if
+  // it uses the Mersenne Twister.
+  OCTAVE_API philox_stream * current_philox_stream ();
+
   OCTAVE_API void fill (octave_idx_type len, double *v, double a);
 
   OCTAVE_API void fill (octave_idx_type len, float *v, float a);
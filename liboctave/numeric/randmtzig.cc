@@ -110,8 +110,10 @@
    extra performance. Check whether -DUSE_X86_32=0 is faster on 64-bit
    x86 architectures.
 
-   If you want to replace the Mersenne Twister with another
-   generator then redefine randi32 appropriately.
+   The uniform and ziggurat generators take the source of 32-bit
+   integers as a template argument, which must provide randi32 ().  They
+   are used with the Mersenne Twister and with the Philox generator of
+   randphilox.h.
 
    === Usage instructions ===
    Before using any of the generators, initialize the state with one of
@@ -138,11 +140,10 @@
    static uint32_t randmt ()               returns 32-bit unsigned int
 
    === inline generators ===
-   static uint32_t randi32 ()   returns 32-bit unsigned int
-   static uint64_t randi53 ()   returns 53-bit unsigned int
-   static uint64_t randi54 ()   returns 54-bit unsigned int
-   static float randu24 ()      returns 24-bit uniform in (0,1)
-   static double randu53 ()     returns 53-bit uniform in (0,1)
+   static uint64_t randi53 (gen)   returns 53-bit unsigned int
+   static uint64_t randi54 (gen)   returns 54-bit unsigned int
+   static float randu24 (gen)      returns 24-bit uniform in (0,1)
+   static double randu53 (gen)     returns 53-bit uniform in (0,1)
 
    double rand_uniform ()       returns M-bit uniform in (0,1)
    double rand_normal ()        returns M-bit standard normal
@@ -168,6 +169,7 @@
 #include "oct-syscalls.h"
 #include "oct-time.h"
 #include "randmtzig.h"
+#include "randphilox.h"
 
 /* FIXME: may want to suppress X86 if sizeof(long) > 4 */
 #if ! defined (USE_X86_32)
@@ -193,8 +195,6 @@ static uint32_t *next;
 static uint32_t state[MT_N]; /* the array for the state vector  */
 static int left = 1;
 static int initf = 0;
-static int initt = 1;
-static int inittf = 1;
 
 /* initializes state[MT_N] with a seed */
 void
@@ -370,14 +370,19 @@ randmt ()
 
 /* ===== Uniform generators ===== */
 
-/* Select which 32 bit generator to use */
-#define randi32 randmt
+/* Source of 32 bit integers from the Mersenne Twister */
+class mt_source
+{
+public:
+  uint32_t randi32 () { return randmt (); }
+};
 
+template <typename G>
 static uint64_t
-randi53 ()
+randi53 (G& gen)
 {
-  const uint32_t lo = randi32 ();
-  const uint32_t hi = randi32 () & 0x1FFFFF;
+  const uint32_t lo = gen.randi32 ();
+  const uint32_t hi = gen.randi32 () & 0x1FFFFF;
 #if defined (HAVE_X86_32)
   uint64_t u;
   uint32_t *p = (uint32_t *)&u;
@@ -389,11 +394,12 @@ randi53 ()
 #endif
 }
 
+template <typename G>
 static uint64_t
-randi54 ()
+randi54 (G& gen)
 {
-  const uint32_t lo = randi32 ();
-  const uint32_t hi = randi32 () & 0x3FFFFF;
+  const uint32_t lo = gen.randi32 ();
+  const uint32_t hi = gen.randi32 () & 0x3FFFFF;
 #if defined (HAVE_X86_32)
   uint64_t u;
   uint32_t *p = static_cast<uint32_t *> (&u);
@@ -406,14 +412,15 @@ randi54 ()
 }
 
 /* generates a random number on (0,1)-real-interval */
+template <typename G>
 static float
-randu24 ()
+randu24 (G& gen)
 {
   uint32_t i;
 
   do
     {
-      i = randi32 () & static_cast<uint32_t> (0xFFFFFF);
+      i = gen.randi32 () & static_cast<uint32_t> (0xFFFFFF);
     }
   while (i == 0);
 
@@ -421,15 +428,16 @@ randu24 ()
 }
 
 /* generates a random number on (0,1) with 53-bit resolution */
+template <typename G>
 static double
-randu53 ()
+randu53 (G& gen)
 {
   int32_t a, b;
 
   do
     {
-      a = randi32 () >> 5;
-      b = randi32 () >> 6;
+      a = gen.randi32 () >> 5;
+      b = gen.randi32 () >> 6;
     }
   while (a == 0 && b == 0);
 
@@ -441,7 +449,15 @@ template <>
 OCTAVE_API double
 rand_uniform<double> ()
 {
-  return randu53 ();
+  mt_source mt;
+  return randu53 (mt);
+}
+
+template <>
+OCTAVE_API double
+rand_uniform<double> (philox_generator& gen)
+{
+  return randu53 (gen);
 }
 
 /* Determine mantissa for uniform floats */
@@ -449,7 +465,15 @@ template <>
 OCTAVE_API float
 rand_uniform<float> ()
 {
-  return randu24 ();
+  mt_source mt;
+  return randu24 (mt);
+}
+
+template <>
+OCTAVE_API float
+rand_uniform<float> (philox_generator& gen)
+{
+  return randu24 (gen);
 }
 
 /* ===== Ziggurat normal and exponential generators ===== */
@@ -466,10 +490,10 @@ rand_uniform<float> ()
 
 #define ZIGINT uint64_t
 #define EMANTISSA 9007199254740992.0  /* 53 bit mantissa */
-#define ERANDI randi53() /* 53 bits for mantissa */
+#define ERANDI randi53 (gen) /* 53 bits for mantissa */
 #define NMANTISSA EMANTISSA
-#define NRANDI randi54() /* 53 bits for mantissa + 1 bit sign */
-#define RANDU randu53()
+#define NRANDI randi54 (gen) /* 53 bits for mantissa + 1 bit sign */
+#define RANDU randu53 (gen)
 
 static ZIGINT ki[ZIGGURAT_TABLE_SIZE];
 static double wi[ZIGGURAT_TABLE_SIZE], fi[ZIGGURAT_TABLE_SIZE];
@@ -514,7 +538,7 @@ static double we[ZIGGURAT_TABLE_SIZE], fe[ZIGGURAT_TABLE_SIZE];
   so I'm not going to try and optimize further.
 */
 
-void
+static void
 create_ziggurat_tables ()
 {
   int i;
@@ -574,8 +598,17 @@ create_ziggurat_tables ()
       x1 = x;
     }
   ke[1] = 0;
+}
+
+/* Create the tables on first use.  The initialization of the static
+   variable is thread-safe, which is needed for the parallel fills of
+   Philox streams.  */
+static void
+init_ziggurat_tables ()
+{
+  static const bool initialized = (create_ziggurat_tables (), true);
 
-  initt = 0;
+  octave_unused_parameter (initialized);
 }
 
 /*
@@ -594,12 +627,11 @@ create_ziggurat_tables ()
  */
 
 
-template <>
-OCTAVE_API double
-rand_normal<double> ()
+template <typename G>
+static double
+ziggurat_normal (G& gen)
 {
-  if (initt)
-    create_ziggurat_tables ();
+  init_ziggurat_tables ();
 
   while (1)
     {
@@ -618,9 +650,9 @@ rand_normal<double> ()
       uint32_t lo, hi;
       int64_t rabs;
       uint32_t *p = (uint32_t *)&rabs;
-      lo = randi32 ();
+      lo = gen.randi32 ();
       idx = lo & 0xFF;
-      hi = randi32 ();
+      hi = gen.randi32 ();
       si = hi & UMASK;
       p[0] = lo;
       p[1] = hi & 0x1FFFFF;
@@ -660,12 +692,11 @@ rand_normal<double> ()
     }
 }
 
-template <>
-OCTAVE_API double
-rand_exponential<double> ()
+template <typename G>
+static double
+ziggurat_exponential (G& gen)
 {
-  if (initt)
-    create_ziggurat_tables ();
+  init_ziggurat_tables ();
 
   while (1)
     {
@@ -688,6 +719,36 @@ rand_exponential<double> ()
     }
 }
 
+template <>
+OCTAVE_API double
+rand_normal<double> ()
+{
+  mt_source mt;
+  return ziggurat_normal (mt);
+}
+
+template <>
+OCTAVE_API double
+rand_normal<double> (philox_generator& gen)
+{
+  return ziggurat_normal (gen);
+}
+
+template <>
+OCTAVE_API double
+rand_exponential<double> ()
+{
+  mt_source mt;
+  return ziggurat_exponential (mt);
+}
+
+template <>
+OCTAVE_API double
+rand_exponential<double> (philox_generator& gen)
+{
+  return ziggurat_exponential (gen);
+}
+
 template <> OCTAVE_API void rand_uniform<double> (octave_idx_type n, double *p)
 {
   std::generate_n (p, n, []() { return rand_uniform<double> (); });
@@ -712,10 +773,10 @@ template <> OCTAVE_API void rand_exponential (octave_idx_type n, double *p)
 
 #define ZIGINT uint32_t
 #define EMANTISSA 4294967296.0 /* 32 bit mantissa */
-#define ERANDI randi32() /* 32 bits for mantissa */
+#define ERANDI gen.randi32 () /* 32 bits for mantissa */
 #define NMANTISSA 2147483648.0 /* 31 bit mantissa */
-#define NRANDI randi32() /* 31 bits for mantissa + 1 bit sign */
-#define RANDU randu24()
+#define NRANDI gen.randi32 () /* 31 bits for mantissa + 1 bit sign */
+#define RANDU randu24 (gen)
 
 static ZIGINT fki[ZIGGURAT_TABLE_SIZE];
 static float fwi[ZIGGURAT_TABLE_SIZE], ffi[ZIGGURAT_TABLE_SIZE];
@@ -782,8 +843,14 @@ create_ziggurat_float_tables ()
       x1 = x;
     }
   fke[1] = 0;
+}
+
+static void
+init_ziggurat_float_tables ()
+{
+  static const bool initialized = (create_ziggurat_float_tables (), true);
 
-  inittf = 0;
+  octave_unused_parameter (initialized);
 }
 
 /*
@@ -801,17 +868,16 @@ create_ziggurat_float_tables ()
  * distribution is exp(-0.5*x*x)
  */
 
-template <>
-OCTAVE_API float
-rand_normal<float> ()
+template <typename G>
+static float
+ziggurat_float_normal (G& gen)
 {
-  if (inittf)
-    create_ziggurat_float_tables ();
+  init_ziggurat_float_tables ();
 
   while (1)
     {
       /* 32-bit mantissa */
-      const uint32_t r = randi32 ();
+      const uint32_t r = gen.randi32 ();
       const uint32_t rabs = r & LMASK;
       const int idx = static_cast<int> (r & 0xFF);
       const float x = static_cast<int32_t> (r) * fwi[idx];
@@ -843,12 +909,11 @@ rand_normal<float> ()
     }
 }
 
-template <>
-OCTAVE_API float
-rand_exponential<float> ()
+template <typename G>
+static float
+ziggurat_float_exponential (G& gen)
 {
-  if (inittf)
-    create_ziggurat_float_tables ();
+  init_ziggurat_float_tables ();
 
   while (1)
     {
@@ -871,6 +936,36 @@ rand_exponential<float> ()
     }
 }
 
+template <>
+OCTAVE_API float
+rand_normal<float> ()
+{
+  mt_source mt;
+  return ziggurat_float_normal (mt);
+}
+
+template <>
+OCTAVE_API float
+rand_normal<float> (philox_generator& gen)
+{
+  return ziggurat_float_normal (gen);
+}
+
+template <>
+OCTAVE_API float
+rand_exponential<float> ()
+{
+  mt_source mt;
+  return ziggurat_float_exponential (mt);
+}
+
+template <>
+OCTAVE_API float
+rand_exponential<float> (philox_generator& gen)
+{
+  return ziggurat_float_exponential (gen);
+}
+
 template <> OCTAVE_API void rand_uniform (octave_idx_type n, float *p)
 {
   std::generate_n (p, n, []() { return rand_uniform<float> (); });
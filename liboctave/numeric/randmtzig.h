@@ -118,6 +118,25 @@ rand_normal<float> (octave_idx_type n, float *p);
 template <> OCTAVE_API void
 rand_exponential<float> (octave_idx_type n, float *p);
 
+// The same generators, but using the 32-bit random integers of one
+// element of a Philox stream (see randphilox.h) instead of the Mersenne
+// Twister.
+
+class philox_generator;
+
+template <typename T> OCTAVE_API T rand_uniform (philox_generator& gen);
+template <typename T> OCTAVE_API T rand_normal (philox_generator& gen);
+template <typename T> OCTAVE_API T rand_exponential (philox_generator& gen);
+
+template <> OCTAVE_API double rand_uniform<double> (philox_generator& gen);
+template <> OCTAVE_API double rand_normal<double> (philox_generator& gen);
+template <> OCTAVE_API double
+rand_exponential<double> (philox_generator& gen);
+
+template <> OCTAVE_API float rand_uniform<float> (philox_generator& gen);
+template <> OCTAVE_API float rand_normal<float> (philox_generator& gen);
+template <> OCTAVE_API float rand_exponential<float> (philox_generator& gen);
+
 OCTAVE_END_NAMESPACE(octave)
 
 #endif
@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include "oct-thread-pool.h"
+#include "randmtzig.h"
+#include "randphilox.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+uint32NDArray
+philox_stream::state () const
+{
+  uint32NDArray s (dim_vector (STATE_SIZE, 1));
+
+  uint32_t *sdata = reinterpret_cast<uint32_t *> (s.rwdata ());
+
+  sdata[0] = static_cast<uint32_t> (m_key);
+  sdata[1] = static_cast<uint32_t> (m_key >> 32);
+  sdata[2] = m_substream;
+  sdata[3] = static_cast<uint32_t> (m_position);
+  sdata[4] = static_cast<uint32_t> (m_position >> 32);
+
+  return s;
+}
+
+bool
+philox_stream::state (const uint32NDArray& s)
+{
+  if (s.numel () != STATE_SIZE)
+    return false;
+
+  const uint32_t *sdata = reinterpret_cast<const uint32_t *> (s.data ());
+
+  m_key = (static_cast<uint64_t> (sdata[1]) << 32) | sdata[0];
+  m_substream = sdata[2];
+  m_position = (static_cast<uint64_t> (sdata[4]) << 32) | sdata[3];
+
+  return true;
+}
+
+template <typename T>
+T
+philox_stream::uniform ()
+{
+  philox_generator gen = next_generator ();
+  return rand_uniform<T> (gen);
+}
+
+template <typename T>
+T
+philox_stream::normal ()
+{
+  philox_generator gen = next_generator ();
+  return rand_normal<T> (gen);
+}
+
+template <typename T>
+T
+philox_stream::exponential ()
+{
+  philox_generator gen = next_generator ();
+  return rand_exponential<T> (gen);
+}
+
+// Element I of the array is element POSITION + I of the stream, no
+// matter which thread computes it.
+
+template <typename T, typename F>
+void
+philox_stream::fill (octave_idx_type n, T *p, F fcn)
+{
+  if (n < 1)
+    return;
+
+  const uint64_t key = m_key;
+  const uint32_t substream = m_substream;
+  const uint64_t position = m_position;
+
+  thread_pool::parallel_for
+    (n, [=] (std::size_t begin, std::size_t end)
+     {
+       for (std::size_t i = begin; i < end; i++)
+         {
+           philox_generator gen (key, substream, position + i);
+           p[i] = fcn (gen);
+         }
+     });
+
+  m_position += n;
+}
+
+template <typename T>
+void
+philox_stream::uniform (octave_idx_type n, T *p)
+{
+  fill (n, p, [] (philox_generator& gen) { return rand_uniform<T> (gen); });
+}
+
+template <typename T>
+void
+philox_stream::normal (octave_idx_type n, T *p)
+{
+  fill (n, p, [] (philox_generator& gen) { return rand_normal<T> (gen); });
+}
+
+template <typename T>
+void
+philox_stream::exponential (octave_idx_type n, T *p)
+{
+  fill (n, p, [] (philox_generator& gen)
+        { return rand_exponential<T> (gen); });
+}
+
+template OCTAVE_API double philox_stream::uniform<double> ();
+template OCTAVE_API double philox_stream::normal<double> ();
+template OCTAVE_API double philox_stream::exponential<double> ();
+
+template OCTAVE_API float philox_stream::uniform<float> ();
+template OCTAVE_API float philox_stream::normal<float> ();
+template OCTAVE_API float philox_stream::exponential<float> ();
+
+template OCTAVE_API void
+philox_stream::uniform<double> (octave_idx_type, double *);
+template OCTAVE_API void
+philox_stream::normal<double> (octave_idx_type, double *);
+template OCTAVE_API void
+philox_stream::exponential<double> (octave_idx_type, double *);
+
+template OCTAVE_API void
+philox_stream::uniform<float> (octave_idx_type, float *);
+template OCTAVE_API void
+philox_stream::normal<float> (octave_idx_type, float *);
+template OCTAVE_API void
+philox_stream::exponential<float> (octave_idx_type, float *);
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,180 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_randphilox_h)
+#define octave_randphilox_h 1
+
+#include "octave-config.h"
+
+#include <cstdint>
+
+#include "uint32NDArray.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Philox4x32-10 counter-based random number generator of J. K. Salmon,
+// M. A. Moraes, R. O. Dror, and D. E. Shaw, "Parallel random numbers: As
+// easy as 1, 2, 3", Proceedings of the International Conference for High
+// Performance Computing, Networking, Storage and Analysis (SC11), 2011.
+//
+// The generator is a keyed bijection of a 128-bit counter.  A stream is
+// identified by the 64-bit key and a 32-bit substream number.  Element I
+// of a stream is computed from the counters {I, SUBSTREAM, 0},
+// {I, SUBSTREAM, 1}, ..., so it does not depend on any other element.
+// That makes it possible to fill arrays in parallel with results that
+// are independent of the number of threads.
+
+// The 32-bit random integers for one element of a stream.  This class
+// provides the randi32 function that is used by the generators in
+// randmtzig.cc.
+
+class philox_generator
+{
+public:
+
+  philox_generator (uint64_t key, uint32_t substream, uint64_t index)
+    : m_key {static_cast<uint32_t> (key), static_cast<uint32_t> (key >> 32)},
+      m_ctr {static_cast<uint32_t> (index),
+             static_cast<uint32_t> (index >> 32), substream, 0},
+      m_out (), m_pos (4)
+  { }
+
+  OCTAVE_DEFAULT_COPY_MOVE (philox_generator)
+
+  ~philox_generator () = default;
+
+  uint32_t randi32 ()
+  {
+    if (m_pos == 4)
+      {
+        philox4x32 (m_ctr, m_key, m_out);
+        m_ctr[3]++;
+        m_pos = 0;
+      }
+
+    return m_out[m_pos++];
+  }
+
+  // Apply the 10 rounds of Philox4x32 to CTR with KEY.
+  static void philox4x32 (const uint32_t ctr[4], const uint32_t key[2],
+                          uint32_t out[4])
+  {
+    uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for (int r = 0; r < 10; r++)
+      {
+        if (r > 0)
+          {
+            k0 += 0x9E3779B9;
+            k1 += 0xBB67AE85;
+          }
+
+        const uint64_t p0 = static_cast<uint64_t> (0xD2511F53) * c0;
+        const uint64_t p1 = static_cast<uint64_t> (0xCD9E8D57) * c2;
+
+        const uint32_t hi0 = p0 >> 32;
+        const uint32_t lo0 = static_cast<uint32_t> (p0);
+        const uint32_t hi1 = p1 >> 32;
+        const uint32_t lo1 = static_cast<uint32_t> (p1);
+
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+      }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+  }
+
+private:
+
+  uint32_t m_key[2];
+  uint32_t m_ctr[4];
+  uint32_t m_out[4];
+  int m_pos;
+};
+
+// A stream of random numbers.  The position is the index of the next
+// element.  Arrays with many elements are filled on multiple threads.
+
+class OCTAVE_API philox_stream
+{
+public:
+
+  // Number of elements of the state vector.
+  static const octave_idx_type STATE_SIZE = 5;
+
+  philox_stream (uint64_t key = 0, uint32_t substream = 0)
+    : m_key (key), m_substream (substream), m_position (0)
+  { }
+
+  OCTAVE_DEFAULT_COPY_MOVE (philox_stream)
+
+  ~philox_stream () = default;
+
+  uint64_t key () const { return m_key; }
+
+  uint32_t substream () const { return m_substream; }
+
+  uint64_t position () const { return m_position; }
+
+  // Return the key, substream, and position as a vector of STATE_SIZE
+  // 32-bit values.
+  uint32NDArray state () const;
+
+  // Restore a state that was returned by state ().  Return false if S
+  // is not a valid state.
+  bool state (const uint32NDArray& s);
+
+  template <typename T> T uniform ();
+  template <typename T> T normal ();
+  template <typename T> T exponential ();
+
+  template <typename T> void uniform (octave_idx_type n, T *p);
+  template <typename T> void normal (octave_idx_type n, T *p);
+  template <typename T> void exponential (octave_idx_type n, T *p);
+
+private:
+
+  template <typename T, typename F>
+  void fill (octave_idx_type n, T *p, F fcn);
+
+  philox_generator next_generator ()
+  {
+    return philox_generator (m_key, m_substream, m_position++);
+  }
+
+  uint64_t m_key;
+  uint32_t m_substream;
+  uint64_t m_position;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -28,10 +28,15 @@
 
 #include "octave-config.h"
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include "Array-util.h"
 #include "lo-array-errwarn.h"
 #include "mx-inlines.cc"
 #include "oct-locbuf.h"
+#include "oct-thread-pool.h"
 
 // sparse matrix by scalar operations.
 
@@ -1760,6 +1765,55 @@
 
 #define SPARSE_ANY_OP(DIM) SPARSE_ANY_ALL_OP (DIM, false, false, !=, true)
 
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Helpers for the multiplication macros below.  Products with enough
+// work are split into parts that are computed by the threads of
+// octave::thread_pool.  The parts write disjoint parts of the result.
+// Except for sparse times full products with fewer columns than there
+// are threads, the elements of the result are summed in the same order
+// as by the serial code.
+
+// Number of threads to use for a product with about WORK operations.
+
+inline int
+sparse_mul_threads (double work)
+{
+  return (work < thread_pool::MIN_ELEMENTS ? 1 : thread_pool::num_threads ());
+}
+
+// Call FCN (BEGIN, END) for about four chunks per thread of [0, N).
+
+template <typename F>
+inline void
+sparse_mul_parallel_for (octave_idx_type n, int nt, F fcn)
+{
+  std::size_t grain = std::max (static_cast<std::size_t> (n) / (4 * nt),
+                                std::size_t (1));
+
+  thread_pool::parallel_for (n, fcn, grain, 2);
+}
+
+// Split [0, N) into NPARTS ranges from BOUNDS[P] to BOUNDS[P+1] with
+// about the same amount of work.  CUM[I] is the work for the first I
+// items.
+
+template <typename T>
+inline void
+sparse_mul_split (octave_idx_type n, const T *cum, octave_idx_type nparts,
+                  octave_idx_type *bounds)
+{
+  double total = cum[n];
+
+  bounds[0] = 0;
+  for (octave_idx_type p = 1; p < nparts; p++)
+    bounds[p] = std::lower_bound (cum + bounds[p-1], cum + n,
+                                  total * p / nparts) - cum;
+  bounds[nparts] = n;
+}
+
+OCTAVE_END_NAMESPACE(octave)
+
 #define SPARSE_SPARSE_MUL(RET_TYPE, RET_EL_TYPE, EL_TYPE)               \
   octave_idx_type nr = m.rows ();                                       \
   octave_idx_type nc = m.cols ();                                       \
@@ -1810,44 +1864,78 @@
       return r;                                                         \
     }                                                                   \
   else if (nc != a_nr)                                                  \
-    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);               \
+    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);       \
   else                                                                  \
     {                                                                   \
-      OCTAVE_LOCAL_BUFFER (octave_idx_type, w, nr);                     \
-      RET_TYPE retval (nr, a_nc, static_cast<octave_idx_type> (0));     \
-      for (octave_idx_type i = 0; i < nr; i++)                          \
-        w[i] = 0;                                                       \
-      retval.xcidx (0) = 0;                                             \
-                                                                        \
-      octave_idx_type nel = 0;                                          \
-                                                                        \
+      /* The columns of the result are computed in two passes.  The */  \
+      /* first one counts the elements of each column and the second */ \
+      /* one computes them.  Large products are split into ranges of */ \
+      /* columns with about the same number of operations that are */   \
+      /* computed by different threads. */                              \
+      OCTAVE_LOCAL_BUFFER (double, flops, a_nc + 1);                    \
+      flops[0] = 0;                                                     \
       for (octave_idx_type i = 0; i < a_nc; i++)                        \
         {                                                               \
+          double f = 0;                                                 \
           for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++)   \
-            {                                                           \
-              octave_idx_type col = a.ridx (j);                         \
-              for (octave_idx_type k = m.cidx (col) ; k < m.cidx (col+1); k++) \
-                {                                                       \
-                  if (w[m.ridx (k)] < i + 1)                            \
-                    {                                                   \
-                      w[m.ridx (k)] = i + 1;                            \
-                      nel++;                                            \
-                    }                                                   \
-                  octave_quit ();                                       \
-                }                                                       \
-            }                                                           \
-          retval.xcidx (i+1) = nel;                                     \
+            f += m.cidx (a.ridx (j) + 1) - m.cidx (a.ridx (j));         \
+          flops[i+1] = flops[i] + f;                                    \
         }                                                               \
                                                                         \
+      /* Each part needs work arrays with one element per row. */       \
+      octave_idx_type nparts = octave::sparse_mul_threads (flops[a_nc]); \
+      if (nparts > a_nc)                                                \
+        nparts = a_nc;                                                  \
+      if (nparts < 1 || flops[a_nc] < static_cast<double> (nparts) * nr) \
+        nparts = 1;                                                     \
+      OCTAVE_LOCAL_BUFFER (octave_idx_type, bounds, nparts + 1);        \
+      octave::sparse_mul_split (a_nc, flops, nparts, bounds);           \
+                                                                        \
+      RET_TYPE retval (nr, a_nc, static_cast<octave_idx_type> (0));     \
+      octave_idx_type *rcidx = retval.xcidx ();                         \
+      rcidx[0] = 0;                                                     \
+                                                                        \
+      /* Only check for interrupts if the calling thread does all */    \
+      /* the work. */                                                   \
+      bool serial = (nparts == 1);                                      \
+                                                                        \
+      auto count_cols = [&] (std::size_t lo, std::size_t hi)            \
+        {                                                               \
+          std::vector<octave_idx_type> w (nr, 0);                       \
+          for (std::size_t p = lo; p < hi; p++)                         \
+            for (octave_idx_type i = bounds[p]; i < bounds[p+1]; i++)   \
+              {                                                         \
+                octave_idx_type nel = 0;                                \
+                for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
+                  {                                                     \
+                    octave_idx_type col = a.ridx (j);                   \
+                    for (octave_idx_type k = m.cidx (col) ;             \
+                         k < m.cidx (col+1); k++)                       \
+                      {                                                 \
+                        if (w[m.ridx (k)] < i + 1)                      \
+                          {                                             \
+                            w[m.ridx (k)] = i + 1;                      \
+                            nel++;                                      \
+                          }                                             \
+                      }                                                 \
+                    if (serial)                                         \
+                      octave_quit ();                                   \
+                  }                                                     \
+                rcidx[i+1] = nel;                                       \
+              }                                                         \
+        };                                                              \
+                                                                        \
+      octave::thread_pool::parallel_for (nparts, count_cols, 1, 2);     \
+                                                                        \
+      for (octave_idx_type i = 0; i < a_nc; i++)                        \
+        rcidx[i+1] += rcidx[i];                                         \
+                                                                        \
+      octave_idx_type nel = rcidx[a_nc];                                \
+                                                                        \
       if (nel == 0)                                                     \
         return RET_TYPE (nr, a_nc);                                     \
       else                                                              \
         {                                                               \
-          for (octave_idx_type i = 0; i < nr; i++)                      \
-            w[i] = 0;                                                   \
-                                                                        \
-          OCTAVE_LOCAL_BUFFER (RET_EL_TYPE, Xcol, nr);                  \
-                                                                        \
           retval.change_capacity (nel);                                 \
           /* The optimal break-point as estimated from simulations */   \
           /* Note that Mergesort is O(nz log(nz)) while searching all */ \
@@ -1862,65 +1950,82 @@
           /* to these breakpoints */                                    \
           octave_idx_type n_per_col = (a_nc > 43000 ? 43000 :           \
                                        (a_nc * a_nc) / 43000);          \
-          octave_idx_type ii = 0;                                       \
           octave_idx_type *ri = retval.xridx ();                        \
-          octave_sort<octave_idx_type> sort;                            \
+          RET_EL_TYPE *rd = retval.xdata ();                            \
                                                                         \
-          for (octave_idx_type i = 0; i < a_nc ; i++)                   \
+          auto fill_cols = [&] (std::size_t lo, std::size_t hi)         \
             {                                                           \
-              if (retval.xcidx (i+1) - retval.xcidx (i) > n_per_col)    \
+              std::vector<octave_idx_type> w (nr, 0);                   \
+              std::vector<RET_EL_TYPE> Xcol (nr);                       \
+              octave_sort<octave_idx_type> sort;                        \
+                                                                        \
+              for (std::size_t p = lo; p < hi; p++)                     \
                 {                                                       \
-                  for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
+                  octave_idx_type ii = rcidx[bounds[p]];                \
+                                                                        \
+                  for (octave_idx_type i = bounds[p]; i < bounds[p+1]; i++) \
                     {                                                   \
-                      octave_idx_type col = a.ridx (j);                 \
-                      EL_TYPE tmpval = a.data (j);                      \
-                      for (octave_idx_type k = m.cidx (col) ;           \
-                           k < m.cidx (col+1); k++)                     \
+                      if (serial)                                       \
+                        octave_quit ();                                 \
+                                                                        \
+                      if (rcidx[i+1] - rcidx[i] > n_per_col)            \
                         {                                               \
-                          octave_quit ();                               \
-                          octave_idx_type row = m.ridx (k);             \
-                          if (w[row] < i + 1)                           \
+                          for (octave_idx_type j = a.cidx (i);          \
+                               j < a.cidx (i+1); j++)                   \
                             {                                           \
-                              w[row] = i + 1;                           \
-                              Xcol[row] = tmpval * m.data (k);          \
+                              octave_idx_type col = a.ridx (j);         \
+                              EL_TYPE tmpval = a.data (j);              \
+                              for (octave_idx_type k = m.cidx (col) ;   \
+                                   k < m.cidx (col+1); k++)             \
+                                {                                       \
+                                  octave_idx_type row = m.ridx (k);     \
+                                  if (w[row] < i + 1)                   \
+                                    {                                   \
+                                      w[row] = i + 1;                   \
+                                      Xcol[row] = tmpval * m.data (k);  \
+                                    }                                   \
+                                  else                                  \
+                                    Xcol[row] += tmpval * m.data (k);   \
+                                }                                       \
                             }                                           \
-                          else                                          \
-                            Xcol[row] += tmpval * m.data (k);           \
+                          for (octave_idx_type k = 0; k < nr; k++)      \
+                            if (w[k] == i + 1)                          \
+                              {                                         \
+                                rd[ii] = Xcol[k];                       \
+                                ri[ii++] = k;                           \
+                              }                                         \
                         }                                               \
-                    }                                                   \
-                  for (octave_idx_type k = 0; k < nr; k++)              \
-                    if (w[k] == i + 1)                                  \
-                      {                                                 \
-                        retval.xdata (ii) = Xcol[k];                    \
-                        retval.xridx (ii++) = k;                        \
-                      }                                                 \
-                }                                                       \
-              else                                                      \
-                {                                                       \
-                  for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
-                    {                                                   \
-                      octave_idx_type col = a.ridx (j);                 \
-                      EL_TYPE tmpval = a.data (j);                      \
-                      for (octave_idx_type k = m.cidx (col) ;           \
-                           k < m.cidx (col+1); k++)                     \
+                      else                                              \
                         {                                               \
-                          octave_quit ();                               \
-                          octave_idx_type row = m.ridx (k);             \
-                          if (w[row] < i + 1)                           \
+                          for (octave_idx_type j = a.cidx (i);          \
+                               j < a.cidx (i+1); j++)                   \
                             {                                           \
-                              w[row] = i + 1;                           \
-                              retval.xridx (ii++) = row;                \
-                              Xcol[row] = tmpval * m.data (k);          \
+                              octave_idx_type col = a.ridx (j);         \
+                              EL_TYPE tmpval = a.data (j);              \
+                              for (octave_idx_type k = m.cidx (col) ;   \
+                                   k < m.cidx (col+1); k++)             \
+                                {                                       \
+                                  octave_idx_type row = m.ridx (k);     \
+                                  if (w[row] < i + 1)                   \
+                                    {                                   \
+                                      w[row] = i + 1;                   \
+                                      ri[ii++] = row;                   \
+                                      Xcol[row] = tmpval * m.data (k);  \
+                                    }                                   \
+                                  else                                  \
+                                    Xcol[row] += tmpval * m.data (k);   \
+                                }                                       \
                             }                                           \
-                          else                                          \
-                            Xcol[row] += tmpval * m.data (k);           \
+                          sort.sort (ri + rcidx[i], ii - rcidx[i]);     \
+                          for (octave_idx_type k = rcidx[i]; k < ii; k++) \
+                            rd[k] = Xcol[ri[k]];                        \
                         }                                               \
                     }                                                   \
-                  sort.sort (ri + retval.xcidx (i), ii - retval.xcidx (i)); \
-                  for (octave_idx_type k = retval.xcidx (i); k < ii; k++) \
-                    retval.xdata (k) = Xcol[retval.xridx (k)];          \
                 }                                                       \
-            }                                                           \
+            };                                                          \
+                                                                        \
+          octave::thread_pool::parallel_for (nparts, fill_cols, 1, 2);  \
+                                                                        \
           retval.maybe_compress (true);                                 \
           return retval;                                                \
         }                                                               \
@@ -1939,22 +2044,99 @@
       return retval;                                                    \
     }                                                                   \
   else if (nc != a_nr)                                                  \
-    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);               \
+    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);       \
   else                                                                  \
     {                                                                   \
       RET_TYPE::element_type zero = RET_TYPE::element_type ();          \
                                                                         \
       RET_TYPE retval (nr, a_nc, zero);                                 \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
+      int nt = octave::sparse_mul_threads (double (m.nnz ()) * a_nc);   \
+                                                                        \
+      if (nt > 1 && a_nc >= nt)                                         \
         {                                                               \
-          for (octave_idx_type j = 0; j < a_nr; j++)                    \
+          /* Compute the columns of the result in parallel. */          \
+          RET_TYPE::element_type *rd = retval.fortran_vec ();           \
+          const EL_TYPE *ad = a.data ();                                \
+                                                                        \
+          auto mul_cols = [&] (std::size_t lo, std::size_t hi)          \
             {                                                           \
-              octave_quit ();                                           \
+              for (std::size_t i = lo; i < hi; i++)                     \
+                for (octave_idx_type j = 0; j < a_nr; j++)              \
+                  {                                                     \
+                    EL_TYPE tmpval = ad[j + i*a_nr];                    \
+                    for (octave_idx_type k = m.cidx (j) ;               \
+                         k < m.cidx (j+1); k++)                         \
+                      rd[m.ridx (k) + i*nr] += tmpval * m.data (k);     \
+                  }                                                     \
+            };                                                          \
+                                                                        \
+          octave::sparse_mul_parallel_for (a_nc, nt, mul_cols);         \
+        }                                                               \
+      else if (nt > 1 && nc >= nt)                                      \
+        {                                                               \
+          /* Split the columns of M into parts with about the same */   \
+          /* number of elements.  Each part is multiplied into its own */ \
+          /* copy of the result, and the copies are summed. */          \
+          octave_idx_type nparts = nt;                                  \
+          OCTAVE_LOCAL_BUFFER (octave_idx_type, bounds, nparts + 1);    \
+          octave::sparse_mul_split (nc, m.cidx (), nparts, bounds);     \
+                                                                        \
+          octave_idx_type nel = nr * a_nc;                              \
+          std::unique_ptr<RET_TYPE::element_type[]>                     \
+            buf (new RET_TYPE::element_type [(nparts - 1) * nel]);      \
+          RET_TYPE::element_type *rd = retval.fortran_vec ();           \
+          RET_TYPE::element_type *bd = buf.get ();                      \
+          const EL_TYPE *ad = a.data ();                                \
+                                                                        \
+          auto mul_part = [&] (std::size_t lo, std::size_t hi)          \
+            {                                                           \
+              for (std::size_t p = lo; p < hi; p++)                     \
+                {                                                       \
+                  RET_TYPE::element_type *pd = rd;                      \
+                  if (p > 0)                                            \
+                    {                                                   \
+                      pd = bd + (p - 1) * nel;                          \
+                      std::fill (pd, pd + nel, zero);                   \
+                    }                                                   \
+                                                                        \
+                  for (octave_idx_type i = 0; i < a_nc; i++)            \
+                    for (octave_idx_type j = bounds[p]; j < bounds[p+1]; j++) \
+                      {                                                 \
+                        EL_TYPE tmpval = ad[j + i*a_nr];                \
+                        for (octave_idx_type k = m.cidx (j) ;           \
+                             k < m.cidx (j+1); k++)                     \
+                          pd[m.ridx (k) + i*nr] += tmpval * m.data (k); \
+                      }                                                 \
+                }                                                       \
+            };                                                          \
+                                                                        \
+          octave::thread_pool::parallel_for (nparts, mul_part, 1, 2);   \
+                                                                        \
+          auto sum_parts = [&] (std::size_t lo, std::size_t hi)         \
+            {                                                           \
+              for (octave_idx_type p = 1; p < nparts; p++)              \
+                {                                                       \
+                  const RET_TYPE::element_type *pd = bd + (p - 1) * nel; \
+                  for (std::size_t i = lo; i < hi; i++)                 \
+                    rd[i] += pd[i];                                     \
+                }                                                       \
+            };                                                          \
+                                                                        \
+          octave::thread_pool::parallel_for (nel, sum_parts);           \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          for (octave_idx_type i = 0; i < a_nc ; i++)                   \
+            {                                                           \
+              for (octave_idx_type j = 0; j < a_nr; j++)                \
+                {                                                       \
+                  octave_quit ();                                       \
                                                                         \
-              EL_TYPE tmpval = a.elem (j,i);                            \
-              for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
-                retval.elem (m.ridx (k),i) += tmpval * m.data (k);      \
+                  EL_TYPE tmpval = a.elem (j,i);                        \
+                  for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
+                    retval.elem (m.ridx (k),i) += tmpval * m.data (k);  \
+                }                                                       \
             }                                                           \
         }                                                               \
       return retval;                                                    \
@@ -1973,21 +2155,48 @@
       return retval;                                                    \
     }                                                                   \
   else if (nr != a_nr)                                                  \
-    octave::err_nonconformant ("operator *", nc, nr, a_nr, a_nc);               \
+    octave::err_nonconformant ("operator *", nc, nr, a_nr, a_nc);       \
   else                                                                  \
     {                                                                   \
       RET_TYPE retval (nc, a_nc);                                       \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
+      int nt = octave::sparse_mul_threads (double (m.nnz ()) * a_nc);   \
+                                                                        \
+      if (nt > 1)                                                       \
         {                                                               \
-          for (octave_idx_type j = 0; j < nc; j++)                      \
+          /* Compute the elements of the result in parallel. */         \
+          RET_TYPE::element_type *rd = retval.fortran_vec ();           \
+          const EL_TYPE *ad = a.data ();                                \
+                                                                        \
+          auto mul_elems = [&] (std::size_t lo, std::size_t hi)         \
             {                                                           \
-              octave_quit ();                                           \
+              for (std::size_t n = lo; n < hi; n++)                     \
+                {                                                       \
+                  octave_idx_type i = n / nc;                           \
+                  octave_idx_type j = n % nc;                           \
                                                                         \
-              EL_TYPE acc = EL_TYPE ();                                 \
-              for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
-                acc += a.elem (m.ridx (k),i) * CONJ_OP (m.data (k));    \
-              retval.xelem (j,i) = acc;                                 \
+                  EL_TYPE acc = EL_TYPE ();                             \
+                  for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
+                    acc += ad[m.ridx (k) + i*a_nr] * CONJ_OP (m.data (k)); \
+                  rd[n] = acc;                                          \
+                }                                                       \
+            };                                                          \
+                                                                        \
+          octave::sparse_mul_parallel_for (nc * a_nc, nt, mul_elems);   \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          for (octave_idx_type i = 0; i < a_nc ; i++)                   \
+            {                                                           \
+              for (octave_idx_type j = 0; j < nc; j++)                  \
+                {                                                       \
+                  octave_quit ();                                       \
+                                                                        \
+                  EL_TYPE acc = EL_TYPE ();                             \
+                  for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
+                    acc += a.elem (m.ridx (k),i) * CONJ_OP (m.data (k)); \
+                  retval.xelem (j,i) = acc;                             \
+                }                                                       \
             }                                                           \
         }                                                               \
       return retval;                                                    \
@@ -2006,23 +2215,73 @@
       return retval;                                                    \
     }                                                                   \
   else if (nc != a_nr)                                                  \
-    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);               \
+    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);       \
   else                                                                  \
     {                                                                   \
       RET_TYPE::element_type zero = RET_TYPE::element_type ();          \
                                                                         \
       RET_TYPE retval (nr, a_nc, zero);                                 \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
+      int nt = octave::sparse_mul_threads (double (a.nnz ()) * nr);     \
+                                                                        \
+      RET_TYPE::element_type *rd = retval.fortran_vec ();               \
+      const auto *md = m.data ();                                       \
+                                                                        \
+      if (nt > 1 && a_nc >= nt)                                         \
         {                                                               \
-          octave_quit ();                                               \
-          for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++)   \
+          /* Split the columns of the result into parts with about the */ \
+          /* same number of operations. */                              \
+          octave_idx_type nparts = nt;                                  \
+          OCTAVE_LOCAL_BUFFER (octave_idx_type, bounds, nparts + 1);    \
+          octave::sparse_mul_split (a_nc, a.cidx (), nparts, bounds);   \
+                                                                        \
+          auto mul_cols = [&] (std::size_t lo, std::size_t hi)          \
+            {                                                           \
+              for (std::size_t p = lo; p < hi; p++)                     \
+                for (octave_idx_type i = bounds[p]; i < bounds[p+1]; i++) \
+                  for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
+                    {                                                   \
+                      octave_idx_type col = a.ridx (j);                 \
+                      EL_TYPE tmpval = a.data (j);                      \
+                                                                        \
+                      for (octave_idx_type k = 0 ; k < nr; k++)         \
+                        rd[k + i*nr] += tmpval * md[k + col*nr];        \
+                    }                                                   \
+            };                                                          \
+                                                                        \
+          octave::thread_pool::parallel_for (nparts, mul_cols, 1, 2);   \
+        }                                                               \
+      else if (nt > 1 && nr >= nt)                                      \
+        {                                                               \
+          /* Compute ranges of rows of the result in parallel. */       \
+          auto mul_rows = [&] (std::size_t lo, std::size_t hi)          \
             {                                                           \
-              octave_idx_type col = a.ridx (j);                         \
-              EL_TYPE tmpval = a.data (j);                              \
+              for (octave_idx_type i = 0; i < a_nc ; i++)               \
+                for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
+                  {                                                     \
+                    octave_idx_type col = a.ridx (j);                   \
+                    EL_TYPE tmpval = a.data (j);                        \
+                                                                        \
+                    for (std::size_t k = lo ; k < hi; k++)              \
+                      rd[k + i*nr] += tmpval * md[k + col*nr];          \
+                  }                                                     \
+            };                                                          \
                                                                         \
-              for (octave_idx_type k = 0 ; k < nr; k++)                 \
-                retval.xelem (k,i) += tmpval * m.elem (k,col);          \
+          octave::sparse_mul_parallel_for (nr, nt, mul_rows);           \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          for (octave_idx_type i = 0; i < a_nc ; i++)                   \
+            {                                                           \
+              octave_quit ();                                           \
+              for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
+                {                                                       \
+                  octave_idx_type col = a.ridx (j);                     \
+                  EL_TYPE tmpval = a.data (j);                          \
+                                                                        \
+                  for (octave_idx_type k = 0 ; k < nr; k++)             \
+                    retval.xelem (k,i) += tmpval * m.elem (k,col);      \
+                }                                                       \
             }                                                           \
         }                                                               \
       return retval;                                                    \
@@ -2041,22 +2300,47 @@
       return retval;                                                    \
     }                                                                   \
   else if (nc != a_nc)                                                  \
-    octave::err_nonconformant ("operator *", nr, nc, a_nc, a_nr);               \
+    octave::err_nonconformant ("operator *", nr, nc, a_nc, a_nr);       \
   else                                                                  \
     {                                                                   \
       RET_TYPE::element_type zero = RET_TYPE::element_type ();          \
                                                                         \
       RET_TYPE retval (nr, a_nr, zero);                                 \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
+      int nt = octave::sparse_mul_threads (double (a.nnz ()) * nr);     \
+                                                                        \
+      if (nt > 1 && nr >= nt)                                           \
         {                                                               \
-          octave_quit ();                                               \
-          for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++)   \
+          /* Compute ranges of rows of the result in parallel. */       \
+          RET_TYPE::element_type *rd = retval.fortran_vec ();           \
+          const auto *md = m.data ();                                   \
+                                                                        \
+          auto mul_rows = [&] (std::size_t lo, std::size_t hi)          \
             {                                                           \
-              octave_idx_type col = a.ridx (j);                         \
-              EL_TYPE tmpval = CONJ_OP (a.data (j));                    \
-              for (octave_idx_type k = 0 ; k < nr; k++)                 \
-                retval.xelem (k,col) += tmpval * m.elem (k,i);          \
+              for (octave_idx_type i = 0; i < a_nc ; i++)               \
+                for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
+                  {                                                     \
+                    octave_idx_type col = a.ridx (j);                   \
+                    EL_TYPE tmpval = CONJ_OP (a.data (j));              \
+                    for (std::size_t k = lo ; k < hi; k++)              \
+                      rd[k + col*nr] += tmpval * md[k + i*nr];          \
+                  }                                                     \
+            };                                                          \
+                                                                        \
+          octave::sparse_mul_parallel_for (nr, nt, mul_rows);           \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          for (octave_idx_type i = 0; i < a_nc ; i++)                   \
+            {                                                           \
+              octave_quit ();                                           \
+              for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
+                {                                                       \
+                  octave_idx_type col = a.ridx (j);                     \
+                  EL_TYPE tmpval = CONJ_OP (a.data (j));                \
+                  for (octave_idx_type k = 0 ; k < nr; k++)             \
+                    retval.xelem (k,col) += tmpval * m.elem (k,i);      \
+                }                                                       \
             }                                                           \
         }                                                               \
       return retval;                                                    \
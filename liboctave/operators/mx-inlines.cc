@@ -37,9 +37,11 @@
 #include "Array-util.h"
 #include "Array.h"
 #include "bsxfun.h"
+#include "mx-simd.h"
 #include "oct-cmplx.h"
-#include "oct-inttypes-fwd.h"
+#include "oct-inttypes.h"
 #include "oct-locbuf.h"
+#include "oct-thread-pool.h"
 
 // Provides some commonly repeated, basic loop templates.
 
@@ -410,6 +412,109 @@ DEFMINMAXSPEC (double, mx_inline_xmax, >=)
 DEFMINMAXSPEC (float, mx_inline_xmin, <=)
 DEFMINMAXSPEC (float, mx_inline_xmax, >=)
 
+// Use the explicitly vectorized loops from mx-simd.cc where they
+// exist.  They give the same results as the generic templates above.
+
+#define DEFSIMDCHECKSPEC(T)                                     \
+  template <>                                                   \
+  inline bool mx_inline_any_nan<T> (std::size_t n, const T *x)  \
+  {                                                             \
+    return octave::simd::any_nan (n, x);                        \
+  }                                                             \
+  template <>                                                   \
+  inline bool mx_inline_all_finite<T> (std::size_t n, const T *x) \
+  {                                                             \
+    return octave::simd::all_finite (n, x);                     \
+  }
+
+DEFSIMDCHECKSPEC (double)
+DEFSIMDCHECKSPEC (float)
+
+#define DEFSIMDMINMAXSPEC(T, F, SIMDF)                                  \
+  template <>                                                           \
+  inline void F<T> (std::size_t n, T *r, const T *x, const T *y)        \
+  {                                                                     \
+    octave::simd::SIMDF (n, r, x, y);                                   \
+  }
+
+DEFSIMDMINMAXSPEC (double, mx_inline_xmin, xmin)
+DEFSIMDMINMAXSPEC (double, mx_inline_xmax, xmax)
+DEFSIMDMINMAXSPEC (float, mx_inline_xmin, xmin)
+DEFSIMDMINMAXSPEC (float, mx_inline_xmax, xmax)
+
+#define DEFSIMDCMPSPEC(T, F, SIMDF)                                     \
+  template <>                                                           \
+  inline void F<T, T> (std::size_t n, bool *r, const T *x, const T *y)  \
+  {                                                                     \
+    octave::simd::SIMDF (n, r, x, y);                                   \
+  }                                                                     \
+  template <>                                                           \
+  inline void F<T, T> (std::size_t n, bool *r, const T *x, T y)         \
+  {                                                                     \
+    octave::simd::SIMDF (n, r, x, y);                                   \
+  }                                                                     \
+  template <>                                                           \
+  inline void F<T, T> (std::size_t n, bool *r, T x, const T *y)         \
+  {                                                                     \
+    octave::simd::SIMDF (n, r, x, y);                                   \
+  }
+
+#define DEFSIMDCMPSPECS(T)                      \
+  DEFSIMDCMPSPEC (T, mx_inline_lt, lt)          \
+  DEFSIMDCMPSPEC (T, mx_inline_le, le)          \
+  DEFSIMDCMPSPEC (T, mx_inline_gt, gt)          \
+  DEFSIMDCMPSPEC (T, mx_inline_ge, ge)          \
+  DEFSIMDCMPSPEC (T, mx_inline_eq, eq)          \
+  DEFSIMDCMPSPEC (T, mx_inline_ne, ne)
+
+DEFSIMDCMPSPECS (double)
+DEFSIMDCMPSPECS (float)
+
+// octave_int<T> has the same representation as T.
+
+#define DEFSIMDSATSPEC(T, F, SIMDF)                                     \
+  template <>                                                           \
+  inline void                                                           \
+  F<octave_int<T>, octave_int<T>, octave_int<T>>                        \
+  (std::size_t n, octave_int<T> *r,                                     \
+   const octave_int<T> *x, const octave_int<T> *y)                      \
+  {                                                                     \
+    octave::simd::SIMDF (n, reinterpret_cast<T *> (r),                  \
+                         reinterpret_cast<const T *> (x),               \
+                         reinterpret_cast<const T *> (y));              \
+  }                                                                     \
+  template <>                                                           \
+  inline void                                                           \
+  F<octave_int<T>, octave_int<T>, octave_int<T>>                        \
+  (std::size_t n, octave_int<T> *r,                                     \
+   const octave_int<T> *x, octave_int<T> y)                             \
+  {                                                                     \
+    octave::simd::SIMDF (n, reinterpret_cast<T *> (r),                  \
+                         reinterpret_cast<const T *> (x), y.value ());  \
+  }                                                                     \
+  template <>                                                           \
+  inline void                                                           \
+  F<octave_int<T>, octave_int<T>, octave_int<T>>                        \
+  (std::size_t n, octave_int<T> *r,                                     \
+   octave_int<T> x, const octave_int<T> *y)                             \
+  {                                                                     \
+    octave::simd::SIMDF (n, reinterpret_cast<T *> (r), x.value (),      \
+                         reinterpret_cast<const T *> (y));              \
+  }
+
+#define DEFSIMDSATSPECS(T)                              \
+  DEFSIMDSATSPEC (T, mx_inline_add, add_sat)            \
+  DEFSIMDSATSPEC (T, mx_inline_sub, sub_sat)
+
+DEFSIMDSATSPECS (int8_t)
+DEFSIMDSATSPECS (int16_t)
+DEFSIMDSATSPECS (int32_t)
+DEFSIMDSATSPECS (int64_t)
+DEFSIMDSATSPECS (uint8_t)
+DEFSIMDSATSPECS (uint16_t)
+DEFSIMDSATSPECS (uint32_t)
+DEFSIMDSATSPECS (uint64_t)
+
 // FIXME: Is this comment correct anymore?  It seems like std::pow is chosen.
 // Let the compiler decide which pow to use, whichever best matches the
 // arguments provided.
@@ -464,6 +569,11 @@ mx_inline_map (std::size_t n, R *r, const X *x)
 
 // Appliers.  Since these call the operation just once, we pass it as
 // a pointer, to allow the compiler reduce number of instances.
+//
+// Operations on large arrays are split into chunks that are processed
+// by the threads of octave::thread_pool.  The data pointers are
+// obtained before the loop is started so that any copy on write
+// happens in the calling thread.
 
 template <typename R, typename X>
 inline Array<R>
@@ -471,7 +581,11 @@ do_mx_unary_op (const Array<X>& x,
                 void (*op) (std::size_t, R *, const X *))
 {
   Array<R> r (x.dims ());
-  op (r.numel (), r.rwdata (), x.data ());
+  R *pr = r.rwdata ();
+  const X *px = x.data ();
+  octave::thread_pool::parallel_for
+    (r.numel (), [=] (std::size_t lo, std::size_t hi)
+     { op (hi - lo, pr + lo, px + lo); });
   return r;
 }
 
@@ -496,7 +610,10 @@ inline Array<R>&
 do_mx_inplace_op (Array<R>& r,
                   void (*op) (std::size_t, R *))
 {
-  op (r.numel (), r.rwdata ());
+  R *pr = r.rwdata ();
+  octave::thread_pool::parallel_for
+    (r.numel (), [=] (std::size_t lo, std::size_t hi)
+     { op (hi - lo, pr + lo); });
   return r;
 }
 
@@ -513,7 +630,12 @@ do_mm_binary_op (const Array<X>& x, const Array<Y>& y,
   if (dx == dy)
     {
       Array<R> r (dx);
-      op (r.numel (), r.rwdata (), x.data (), y.data ());
+      R *pr = r.rwdata ();
+      const X *px = x.data ();
+      const Y *py = y.data ();
+      octave::thread_pool::parallel_for
+        (r.numel (), [=] (std::size_t lo, std::size_t hi)
+         { op (hi - lo, pr + lo, px + lo, py + lo); });
       return r;
     }
   else if (is_valid_bsxfun (opname, dx, dy))
@@ -530,7 +652,11 @@ do_ms_binary_op (const Array<X>& x, const Y& y,
                  void (*op) (std::size_t, R *, const X *, Y))
 {
   Array<R> r (x.dims ());
-  op (r.numel (), r.rwdata (), x.data (), y);
+  R *pr = r.rwdata ();
+  const X *px = x.data ();
+  octave::thread_pool::parallel_for
+    (r.numel (), [=, &y] (std::size_t lo, std::size_t hi)
+     { op (hi - lo, pr + lo, px + lo, y); });
   return r;
 }
 
@@ -540,7 +666,11 @@ do_sm_binary_op (const X& x, const Array<Y>& y,
                  void (*op) (std::size_t, R *, X, const Y *))
 {
   Array<R> r (y.dims ());
-  op (r.numel (), r.rwdata (), x, y.data ());
+  R *pr = r.rwdata ();
+  const Y *py = y.data ();
+  octave::thread_pool::parallel_for
+    (r.numel (), [=, &x] (std::size_t lo, std::size_t hi)
+     { op (hi - lo, pr + lo, x, py + lo); });
   return r;
 }
 
@@ -554,7 +684,13 @@ do_mm_inplace_op (Array<R>& r, const Array<X>& x,
   const dim_vector &dr = r.dims ();
   const dim_vector &dx = x.dims ();
   if (dr == dx)
-    op (r.numel (), r.rwdata (), x.data ());
+    {
+      R *pr = r.rwdata ();
+      const X *px = x.data ();
+      octave::thread_pool::parallel_for
+        (r.numel (), [=] (std::size_t lo, std::size_t hi)
+         { op (hi - lo, pr + lo, px + lo); });
+    }
   else if (is_valid_inplace_bsxfun (opname, dr, dx))
     do_inplace_bsxfun_op (r, x, op, op1);
   else
@@ -568,7 +704,10 @@ inline Array<R>&
 do_ms_inplace_op (Array<R>& r, const X& x,
                   void (*op) (std::size_t, R *, X))
 {
-  op (r.numel (), r.rwdata (), x);
+  R *pr = r.rwdata ();
+  octave::thread_pool::parallel_for
+    (r.numel (), [=, &x] (std::size_t lo, std::size_t hi)
+     { op (hi - lo, pr + lo, x); });
   return r;
 }
 
@@ -0,0 +1,821 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <cstring>
+
+#include <atomic>
+#include <limits>
+#include <type_traits>
+
+#include "mx-simd.h"
+
+// The vector kernels are written with the GCC vector extensions (also
+// supported by Clang) and instantiated once for each vector width.
+// Each instance is inlined into a function that is compiled for the
+// corresponding instruction set with the target attribute, so no
+// special compiler flags are needed for this file.
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#  define OCTAVE_SIMD_X86 1
+#  define OCTAVE_SIMD_INLINE inline __attribute__ ((always_inline))
+#  define OCTAVE_SIMD_TARGET(ISA) __attribute__ ((target (ISA)))
+#  pragma GCC diagnostic ignored "-Wpsabi"
+#  if defined (__has_builtin)
+#    if __has_builtin (__builtin_convertvector)
+#      define OCTAVE_SIMD_HAVE_CONVERTVECTOR 1
+#    endif
+#  endif
+#else
+#  define OCTAVE_SIMD_INLINE inline
+#endif
+
+static_assert (sizeof (bool) == 1, "mx-simd.cc: bool must be one byte");
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+OCTAVE_BEGIN_NAMESPACE(simd)
+
+static isa_level
+detect_level ()
+{
+#if defined (OCTAVE_SIMD_X86)
+  __builtin_cpu_init ();
+
+  if (__builtin_cpu_supports ("avx512f")
+      && __builtin_cpu_supports ("avx512bw")
+      && __builtin_cpu_supports ("avx512dq")
+      && __builtin_cpu_supports ("avx512vl"))
+    return AVX512;
+  else if (__builtin_cpu_supports ("avx2"))
+    return AVX2;
+  else if (__builtin_cpu_supports ("sse2"))
+    return SSE2;
+#endif
+
+  return NONE;
+}
+
+static isa_level
+cpu_level ()
+{
+  static const isa_level lvl = detect_level ();
+
+  return lvl;
+}
+
+// -1 means that the level has not been determined yet.
+
+static std::atomic<int> s_level (-1);
+
+isa_level
+max_level ()
+{
+  return cpu_level ();
+}
+
+isa_level
+level ()
+{
+  int lvl = s_level;
+
+  if (lvl < 0)
+    {
+      lvl = cpu_level ();
+      s_level = lvl;
+    }
+
+  return static_cast<isa_level> (lvl);
+}
+
+isa_level
+set_level (isa_level lvl)
+{
+  isa_level retval = level ();
+
+  s_level = (lvl > cpu_level () ? cpu_level () : (lvl < NONE ? NONE : lvl));
+
+  return retval;
+}
+
+const char *
+level_name (isa_level lvl)
+{
+  switch (lvl)
+    {
+    case SSE2:
+      return "sse2";
+    case AVX2:
+      return "avx2";
+    case AVX512:
+      return "avx512";
+    default:
+      return "none";
+    }
+}
+
+// Scalar loops.  They are used for the elements that remain after the
+// vector loops and if no vector instructions are available.  The index
+// of the first element to process is passed in I.
+
+struct cmp_lt
+{
+  template <typename A, typename B>
+  static OCTAVE_SIMD_INLINE auto
+  op (const A& a, const B& b) -> decltype (a < b)
+  { return a < b; }
+};
+
+struct cmp_le
+{
+  template <typename A, typename B>
+  static OCTAVE_SIMD_INLINE auto
+  op (const A& a, const B& b) -> decltype (a <= b)
+  { return a <= b; }
+};
+
+struct cmp_gt
+{
+  template <typename A, typename B>
+  static OCTAVE_SIMD_INLINE auto
+  op (const A& a, const B& b) -> decltype (a > b)
+  { return a > b; }
+};
+
+struct cmp_ge
+{
+  template <typename A, typename B>
+  static OCTAVE_SIMD_INLINE auto
+  op (const A& a, const B& b) -> decltype (a >= b)
+  { return a >= b; }
+};
+
+struct cmp_eq
+{
+  template <typename A, typename B>
+  static OCTAVE_SIMD_INLINE auto
+  op (const A& a, const B& b) -> decltype (a == b)
+  { return a == b; }
+};
+
+struct cmp_ne
+{
+  template <typename A, typename B>
+  static OCTAVE_SIMD_INLINE auto
+  op (const A& a, const B& b) -> decltype (a != b)
+  { return a != b; }
+};
+
+template <typename T>
+static inline bool
+any_nan_tail (std::size_t i, std::size_t n, const T *x)
+{
+  for (; i < n; i++)
+    if (x[i] != x[i])
+      return true;
+
+  return false;
+}
+
+// X - X is zero for all finite values and NaN for Inf and NaN.
+
+template <typename T>
+static inline bool
+all_finite_tail (std::size_t i, std::size_t n, const T *x)
+{
+  for (; i < n; i++)
+    if (! (x[i] - x[i] == 0))
+      return false;
+
+  return true;
+}
+
+// Same as octave::math::min and octave::math::max.
+
+template <typename T>
+static inline void
+xmin_tail (std::size_t i, std::size_t n, T *r, const T *x, const T *y)
+{
+  for (; i < n; i++)
+    r[i] = (x[i] <= y[i] || y[i] != y[i]) ? x[i] : y[i];
+}
+
+template <typename T>
+static inline void
+xmax_tail (std::size_t i, std::size_t n, T *r, const T *x, const T *y)
+{
+  for (; i < n; i++)
+    r[i] = (x[i] >= y[i] || y[i] != y[i]) ? x[i] : y[i];
+}
+
+template <typename OP, typename T>
+static inline void
+cmp_tail (std::size_t i, std::size_t n, bool *r, const T *x, const T *y)
+{
+  for (; i < n; i++)
+    r[i] = OP::op (x[i], y[i]);
+}
+
+template <typename OP, typename T>
+static inline void
+cmp_tail (std::size_t i, std::size_t n, bool *r, const T *x, T y)
+{
+  for (; i < n; i++)
+    r[i] = OP::op (x[i], y);
+}
+
+template <typename OP, typename T>
+static inline void
+cmp_tail (std::size_t i, std::size_t n, bool *r, T x, const T *y)
+{
+  for (; i < n; i++)
+    r[i] = OP::op (x, y[i]);
+}
+
+// Saturating arithmetic.  The scalar versions follow the definitions
+// in oct-inttypes.h.
+
+struct sat_add
+{
+  template <typename T>
+  static OCTAVE_SIMD_INLINE T op (T x, T y, std::false_type)
+  {
+    T u = x + y;
+    return u < x ? std::numeric_limits<T>::max () : u;
+  }
+
+  template <typename T>
+  static OCTAVE_SIMD_INLINE T op (T x, T y, std::true_type)
+  {
+    return (y < 0
+            ? (x < std::numeric_limits<T>::min () - y
+               ? std::numeric_limits<T>::min () : x + y)
+            : (x > std::numeric_limits<T>::max () - y
+               ? std::numeric_limits<T>::max () : x + y));
+  }
+
+  template <typename T>
+  static OCTAVE_SIMD_INLINE T op (T x, T y)
+  { return op (x, y, typename std::is_signed<T>::type ()); }
+};
+
+struct sat_sub
+{
+  template <typename T>
+  static OCTAVE_SIMD_INLINE T op (T x, T y, std::false_type)
+  {
+    T u = x - y;
+    return u > x ? 0 : u;
+  }
+
+  template <typename T>
+  static OCTAVE_SIMD_INLINE T op (T x, T y, std::true_type)
+  {
+    return (y < 0
+            ? (x > std::numeric_limits<T>::max () + y
+               ? std::numeric_limits<T>::max () : x - y)
+            : (x < std::numeric_limits<T>::min () + y
+               ? std::numeric_limits<T>::min () : x - y));
+  }
+
+  template <typename T>
+  static OCTAVE_SIMD_INLINE T op (T x, T y)
+  { return op (x, y, typename std::is_signed<T>::type ()); }
+};
+
+template <typename OP, typename T>
+static inline void
+sat_tail (std::size_t i, std::size_t n, T *r, const T *x, const T *y)
+{
+  for (; i < n; i++)
+    r[i] = OP::op (x[i], y[i]);
+}
+
+template <typename OP, typename T>
+static inline void
+sat_tail (std::size_t i, std::size_t n, T *r, const T *x, T y)
+{
+  for (; i < n; i++)
+    r[i] = OP::op (x[i], y);
+}
+
+template <typename OP, typename T>
+static inline void
+sat_tail (std::size_t i, std::size_t n, T *r, T x, const T *y)
+{
+  for (; i < n; i++)
+    r[i] = OP::op (x, y[i]);
+}
+
+#if defined (OCTAVE_SIMD_X86)
+
+// Vector types with B bytes for elements of type T.  Comparisons of
+// vectors yield vectors of signed integers of the same size with all
+// bits set for true and zero for false.
+
+template <std::size_t S> struct int_types;
+
+template <> struct int_types<1> { typedef int8_t s; typedef uint8_t u; };
+template <> struct int_types<2> { typedef int16_t s; typedef uint16_t u; };
+template <> struct int_types<4> { typedef int32_t s; typedef uint32_t u; };
+template <> struct int_types<8> { typedef int64_t s; typedef uint64_t u; };
+
+template <int B, typename T>
+struct vec
+{
+  static const std::size_t N = B / sizeof (T);
+
+  typedef typename int_types<sizeof (T)>::s stype;
+  typedef typename int_types<sizeof (T)>::u utype;
+
+  typedef T type __attribute__ ((vector_size (B)));
+  typedef stype mask __attribute__ ((vector_size (B)));
+  typedef utype utype_vec __attribute__ ((vector_size (B)));
+};
+
+template <typename V>
+static OCTAVE_SIMD_INLINE V
+vload (const void *p)
+{
+  V v;
+  std::memcpy (&v, p, sizeof (V));
+  return v;
+}
+
+template <typename V>
+static OCTAVE_SIMD_INLINE void
+vstore (void *p, const V& v)
+{
+  std::memcpy (p, &v, sizeof (V));
+}
+
+template <typename M>
+static OCTAVE_SIMD_INLINE bool
+any_set (const M& m)
+{
+  uint64_t w[sizeof (M) / 8];
+  std::memcpy (w, &m, sizeof (M));
+
+  uint64_t acc = 0;
+  for (std::size_t k = 0; k < sizeof (M) / 8; k++)
+    acc |= w[k];
+
+  return acc != 0;
+}
+
+// Store the lanes of mask M as bool values.
+
+template <int B, typename T>
+static OCTAVE_SIMD_INLINE void
+store_mask (bool *r, const typename vec<B, T>::mask& m)
+{
+#if defined (OCTAVE_SIMD_HAVE_CONVERTVECTOR)
+  typedef int8_t bvec __attribute__ ((vector_size (vec<B, T>::N)));
+
+  bvec b = __builtin_convertvector (m, bvec) & 1;
+
+  std::memcpy (r, &b, sizeof (bvec));
+#else
+  for (std::size_t k = 0; k < vec<B, T>::N; k++)
+    r[k] = m[k] & 1;
+#endif
+}
+
+template <typename V, typename M>
+static OCTAVE_SIMD_INLINE V
+select (const M& m, const V& a, const V& b)
+{
+  return (V) ((m & (M) a) | (~m & (M) b));
+}
+
+template <int B, typename T>
+static OCTAVE_SIMD_INLINE bool
+any_nan_kernel (std::size_t n, const T *x)
+{
+  typedef vec<B, T> V;
+  typedef typename V::type VT;
+
+  const std::size_t step = 4 * V::N;
+
+  std::size_t i = 0;
+
+  for (; i + step <= n; i += step)
+    {
+      VT v0 = vload<VT> (x + i);
+      VT v1 = vload<VT> (x + i + V::N);
+      VT v2 = vload<VT> (x + i + 2*V::N);
+      VT v3 = vload<VT> (x + i + 3*V::N);
+
+      if (any_set ((v0 != v0) | (v1 != v1) | (v2 != v2) | (v3 != v3)))
+        return true;
+    }
+
+  return any_nan_tail (i, n, x);
+}
+
+template <int B, typename T>
+static OCTAVE_SIMD_INLINE bool
+all_finite_kernel (std::size_t n, const T *x)
+{
+  typedef vec<B, T> V;
+  typedef typename V::type VT;
+
+  const std::size_t step = 4 * V::N;
+
+  std::size_t i = 0;
+
+  for (; i + step <= n; i += step)
+    {
+      VT v0 = vload<VT> (x + i);
+      VT v1 = vload<VT> (x + i + V::N);
+      VT v2 = vload<VT> (x + i + 2*V::N);
+      VT v3 = vload<VT> (x + i + 3*V::N);
+
+      if (any_set (((v0 - v0) != 0) | ((v1 - v1) != 0)
+                   | ((v2 - v2) != 0) | ((v3 - v3) != 0)))
+        return false;
+    }
+
+  return all_finite_tail (i, n, x);
+}
+
+template <int B, typename T>
+static OCTAVE_SIMD_INLINE void
+xmin_kernel (std::size_t n, T *r, const T *x, const T *y)
+{
+  typedef vec<B, T> V;
+  typedef typename V::type VT;
+
+  std::size_t i = 0;
+
+  for (; i + V::N <= n; i += V::N)
+    {
+      VT vx = vload<VT> (x + i);
+      VT vy = vload<VT> (y + i);
+
+      vstore (r + i, select ((vx <= vy) | (vy != vy), vx, vy));
+    }
+
+  xmin_tail (i, n, r, x, y);
+}
+
+template <int B, typename T>
+static OCTAVE_SIMD_INLINE void
+xmax_kernel (std::size_t n, T *r, const T *x, const T *y)
+{
+  typedef vec<B, T> V;
+  typedef typename V::type VT;
+
+  std::size_t i = 0;
+
+  for (; i + V::N <= n; i += V::N)
+    {
+      VT vx = vload<VT> (x + i);
+      VT vy = vload<VT> (y + i);
+
+      vstore (r + i, select ((vx >= vy) | (vy != vy), vx, vy));
+    }
+
+  xmax_tail (i, n, r, x, y);
+}
+
+template <int B, typename OP, typename T>
+static OCTAVE_SIMD_INLINE void
+cmp_kernel (std::size_t n, bool *r, const T *x, const T *y)
+{
+  typedef vec<B, T> V;
+  typedef typename V::type VT;
+
+  std::size_t i = 0;
+
+  for (; i + V::N <= n; i += V::N)
+    store_mask<B, T> (r + i, OP::op (vload<VT> (x + i), vload<VT> (y + i)));
+
+  cmp_tail<OP> (i, n, r, x, y);
+}
+
+template <int B, typename OP, typename T>
+static OCTAVE_SIMD_INLINE void
+cmp_kernel (std::size_t n, bool *r, const T *x, T y)
+{
+  typedef vec<B, T> V;
+  typedef typename V::type VT;
+
+  const VT vy = VT {} + y;
+
+  std::size_t i = 0;
+
+  for (; i + V::N <= n; i += V::N)
+    store_mask<B, T> (r + i, OP::op (vload<VT> (x + i), vy));
+
+  cmp_tail<OP> (i, n, r, x, y);
+}
+
+template <int B, typename OP, typename T>
+static OCTAVE_SIMD_INLINE void
+cmp_kernel (std::size_t n, bool *r, T x, const T *y)
+{
+  typedef vec<B, T> V;
+  typedef typename V::type VT;
+
+  const VT vx = VT {} + x;
+
+  std::size_t i = 0;
+
+  for (; i + V::N <= n; i += V::N)
+    store_mask<B, T> (r + i, OP::op (vx, vload<VT> (y + i)));
+
+  cmp_tail<OP> (i, n, r, x, y);
+}
+
+// Saturating vector arithmetic without branches.  The arithmetic is
+// done with unsigned lanes so that overflow is well defined.
+
+template <int B, typename T>
+struct sat_vec
+{
+  typedef vec<B, T> V;
+  typedef typename V::type VT;
+  typedef typename V::mask VM;
+  typedef typename V::utype_vec VU;
+
+  static const int SHIFT = 8 * sizeof (T) - 1;
+
+  // The saturated value in the direction of the sign of X.
+  static OCTAVE_SIMD_INLINE VT
+  limit (const VT& x)
+  {
+    const VT max_val = VT {} + std::numeric_limits<T>::max ();
+
+    return (VT) ((VU) (x >> SHIFT) ^ (VU) max_val);
+  }
+
+  static OCTAVE_SIMD_INLINE VT
+  add (const VT& x, const VT& y, std::false_type)
+  {
+    VT u = x + y;
+    return u | (VT) (u < x);
+  }
+
+  static OCTAVE_SIMD_INLINE VT
+  add (const VT& x, const VT& y, std::true_type)
+  {
+    VT s = (VT) ((VU) x + (VU) y);
+    VM ovf = (VM) (((x ^ s) & (y ^ s)) < 0);
+    return select (ovf, limit (x), s);
+  }
+
+  static OCTAVE_SIMD_INLINE VT
+  sub (const VT& x, const VT& y, std::false_type)
+  {
+    VT u = x - y;
+    return u & ~((VT) (u > x));
+  }
+
+  static OCTAVE_SIMD_INLINE VT
+  sub (const VT& x, const VT& y, std::true_type)
+  {
+    VT s = (VT) ((VU) x - (VU) y);
+    VM ovf = (VM) (((x ^ y) & (x ^ s)) < 0);
+    return select (ovf, limit (x), s);
+  }
+};
+
+template <int B, typename T>
+struct sat_add_vec
+{
+  typedef typename vec<B, T>::type VT;
+
+  static OCTAVE_SIMD_INLINE VT
+  op (const VT& x, const VT& y)
+  { return sat_vec<B, T>::add (x, y, typename std::is_signed<T>::type ()); }
+};
+
+template <int B, typename T>
+struct sat_sub_vec
+{
+  typedef typename vec<B, T>::type VT;
+
+  static OCTAVE_SIMD_INLINE VT
+  op (const VT& x, const VT& y)
+  { return sat_vec<B, T>::sub (x, y, typename std::is_signed<T>::type ()); }
+};
+
+template <typename OP> struct sat_vec_op;
+
+template <>
+struct sat_vec_op<sat_add>
+{
+  template <int B, typename T>
+  using type = sat_add_vec<B, T>;
+};
+
+template <>
+struct sat_vec_op<sat_sub>
+{
+  template <int B, typename T>
+  using type = sat_sub_vec<B, T>;
+};
+
+template <int B, typename OP, typename T>
+static OCTAVE_SIMD_INLINE void
+sat_kernel (std::size_t n, T *r, const T *x, const T *y)
+{
+  typedef vec<B, T> V;
+  typedef typename V::type VT;
+  typedef typename sat_vec_op<OP>::template type<B, T> VOP;
+
+  std::size_t i = 0;
+
+  for (; i + V::N <= n; i += V::N)
+    vstore (r + i, VOP::op (vload<VT> (x + i), vload<VT> (y + i)));
+
+  sat_tail<OP> (i, n, r, x, y);
+}
+
+template <int B, typename OP, typename T>
+static OCTAVE_SIMD_INLINE void
+sat_kernel (std::size_t n, T *r, const T *x, T y)
+{
+  typedef vec<B, T> V;
+  typedef typename V::type VT;
+  typedef typename sat_vec_op<OP>::template type<B, T> VOP;
+
+  const VT vy = VT {} + y;
+
+  std::size_t i = 0;
+
+  for (; i + V::N <= n; i += V::N)
+    vstore (r + i, VOP::op (vload<VT> (x + i), vy));
+
+  sat_tail<OP> (i, n, r, x, y);
+}
+
+template <int B, typename OP, typename T>
+static OCTAVE_SIMD_INLINE void
+sat_kernel (std::size_t n, T *r, T x, const T *y)
+{
+  typedef vec<B, T> V;
+  typedef typename V::type VT;
+  typedef typename sat_vec_op<OP>::template type<B, T> VOP;
+
+  const VT vx = VT {} + x;
+
+  std::size_t i = 0;
+
+  for (; i + V::N <= n; i += V::N)
+    vstore (r + i, VOP::op (vx, vload<VT> (y + i)));
+
+  sat_tail<OP> (i, n, r, x, y);
+}
+
+// Define the variants of function NAME for each instruction set and
+// the function that dispatches to them.  KERNEL<B EXTRA> is the vector
+// kernel and TAIL<TEXTRA> the scalar loop.  W512 is the vector width in
+// bytes for the AVX-512 variant.  GCC does not generate good code for
+// some 64-byte floating point operations whose result is a vector mask,
+// so those use the 256-bit forms of the AVX-512 instructions.
+
+#define OCTAVE_SIMD_FCN(RET, NAME, PARAMS, ARGS, W512,                 \
+                        KERNEL, EXTRA, TAIL, TEXTRA)                    \
+  OCTAVE_SIMD_TARGET ("avx512f,avx512bw,avx512dq,avx512vl") static RET  \
+  NAME ## _avx512 PARAMS                                                \
+  { return KERNEL<W512 EXTRA> ARGS; }                                   \
+  OCTAVE_SIMD_TARGET ("avx2") static RET                                \
+  NAME ## _avx2 PARAMS                                                  \
+  { return KERNEL<32 EXTRA> ARGS; }                                     \
+  OCTAVE_SIMD_TARGET ("sse2") static RET                                \
+  NAME ## _sse2 PARAMS                                                  \
+  { return KERNEL<16 EXTRA> ARGS; }                                     \
+  RET                                                                   \
+  NAME PARAMS                                                           \
+  {                                                                     \
+    switch (level ())                                                   \
+      {                                                                 \
+      case AVX512:                                                      \
+        return NAME ## _avx512 ARGS;                                    \
+      case AVX2:                                                        \
+        return NAME ## _avx2 ARGS;                                      \
+      case SSE2:                                                        \
+        return NAME ## _sse2 ARGS;                                      \
+      default:                                                          \
+        return TAIL<TEXTRA> (0, OCTAVE_SIMD_UNPAREN ARGS);              \
+      }                                                                 \
+  }
+
+#else
+
+#define OCTAVE_SIMD_FCN(RET, NAME, PARAMS, ARGS, W512,                 \
+                        KERNEL, EXTRA, TAIL, TEXTRA)                    \
+  RET                                                                   \
+  NAME PARAMS                                                           \
+  {                                                                     \
+    return TAIL<TEXTRA> (0, OCTAVE_SIMD_UNPAREN ARGS);                  \
+  }
+
+#endif
+
+#define OCTAVE_SIMD_UNPAREN(...) __VA_ARGS__
+
+#define OCTAVE_SIMD_DEF_CHECK(T)                                        \
+  OCTAVE_SIMD_FCN (bool, any_nan, (std::size_t n, const T *x), (n, x), 32, \
+                   any_nan_kernel, , any_nan_tail, T)                   \
+  OCTAVE_SIMD_FCN (bool, all_finite, (std::size_t n, const T *x), (n, x), \
+                   32, all_finite_kernel, , all_finite_tail, T)
+
+#define OCTAVE_SIMD_DEF_MINMAX(T)                                       \
+  OCTAVE_SIMD_FCN (void, xmin,                                          \
+                   (std::size_t n, T *r, const T *x, const T *y),       \
+                   (n, r, x, y), 32, xmin_kernel, , xmin_tail, T)       \
+  OCTAVE_SIMD_FCN (void, xmax,                                          \
+                   (std::size_t n, T *r, const T *x, const T *y),       \
+                   (n, r, x, y), 32, xmax_kernel, , xmax_tail, T)
+
+#define OCTAVE_SIMD_DEF_CMP_OP(F, OP, T)                                \
+  OCTAVE_SIMD_FCN (void, F,                                             \
+                   (std::size_t n, bool *r, const T *x, const T *y),    \
+                   (n, r, x, y), 64, cmp_kernel, OCTAVE_SIMD_COMMA OP,  \
+                   cmp_tail, OP)                                        \
+  OCTAVE_SIMD_FCN (void, F,                                             \
+                   (std::size_t n, bool *r, const T *x, T y),           \
+                   (n, r, x, y), 64, cmp_kernel, OCTAVE_SIMD_COMMA OP,  \
+                   cmp_tail, OP)                                        \
+  OCTAVE_SIMD_FCN (void, F,                                             \
+                   (std::size_t n, bool *r, T x, const T *y),           \
+                   (n, r, x, y), 64, cmp_kernel, OCTAVE_SIMD_COMMA OP,  \
+                   cmp_tail, OP)
+
+#define OCTAVE_SIMD_DEF_CMP(T)                                          \
+  OCTAVE_SIMD_DEF_CMP_OP (lt, cmp_lt, T)                                \
+  OCTAVE_SIMD_DEF_CMP_OP (le, cmp_le, T)                                \
+  OCTAVE_SIMD_DEF_CMP_OP (gt, cmp_gt, T)                                \
+  OCTAVE_SIMD_DEF_CMP_OP (ge, cmp_ge, T)                                \
+  OCTAVE_SIMD_DEF_CMP_OP (eq, cmp_eq, T)                                \
+  OCTAVE_SIMD_DEF_CMP_OP (ne, cmp_ne, T)
+
+#define OCTAVE_SIMD_DEF_SAT_OP(F, OP, T)                                \
+  OCTAVE_SIMD_FCN (void, F,                                             \
+                   (std::size_t n, T *r, const T *x, const T *y),       \
+                   (n, r, x, y), 64, sat_kernel, OCTAVE_SIMD_COMMA OP,  \
+                   sat_tail, OP)                                        \
+  OCTAVE_SIMD_FCN (void, F,                                             \
+                   (std::size_t n, T *r, const T *x, T y),              \
+                   (n, r, x, y), 64, sat_kernel, OCTAVE_SIMD_COMMA OP,  \
+                   sat_tail, OP)                                        \
+  OCTAVE_SIMD_FCN (void, F,                                             \
+                   (std::size_t n, T *r, T x, const T *y),              \
+                   (n, r, x, y), 64, sat_kernel, OCTAVE_SIMD_COMMA OP,  \
+                   sat_tail, OP)
+
+#define OCTAVE_SIMD_DEF_SAT(T)                                          \
+  OCTAVE_SIMD_DEF_SAT_OP (add_sat, sat_add, T)                          \
+  OCTAVE_SIMD_DEF_SAT_OP (sub_sat, sat_sub, T)
+
+#define OCTAVE_SIMD_COMMA ,
+
+OCTAVE_SIMD_DEF_CHECK (double)
+OCTAVE_SIMD_DEF_CHECK (float)
+
+OCTAVE_SIMD_DEF_MINMAX (double)
+OCTAVE_SIMD_DEF_MINMAX (float)
+
+OCTAVE_SIMD_DEF_CMP (double)
+OCTAVE_SIMD_DEF_CMP (float)
+
+OCTAVE_SIMD_DEF_SAT (int8_t)
+OCTAVE_SIMD_DEF_SAT (int16_t)
+OCTAVE_SIMD_DEF_SAT (int32_t)
+OCTAVE_SIMD_DEF_SAT (int64_t)
+OCTAVE_SIMD_DEF_SAT (uint8_t)
+OCTAVE_SIMD_DEF_SAT (uint16_t)
+OCTAVE_SIMD_DEF_SAT (uint32_t)
+OCTAVE_SIMD_DEF_SAT (uint64_t)
+
+OCTAVE_END_NAMESPACE(simd)
+
+OCTAVE_END_NAMESPACE(octave)
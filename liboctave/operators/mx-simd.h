@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_mx_simd_h)
+#define octave_mx_simd_h 1
+
+#include "octave-config.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Explicitly vectorized versions of some of the loops in mx-inlines.cc.
+//
+// Each function exists in variants for SSE2, AVX2, and AVX-512 which
+// are selected at run time according to the capabilities of the
+// processor.  On other architectures, or if the level is set to NONE,
+// plain scalar loops are used.  All variants produce exactly the same
+// results as the generic templates in mx-inlines.cc, including the
+// treatment of NaN values and the saturation of integer values.
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+OCTAVE_BEGIN_NAMESPACE(simd)
+
+enum isa_level
+{
+  NONE = 0,
+  SSE2 = 1,
+  AVX2 = 2,
+  AVX512 = 3
+};
+
+// The instruction set that is currently used.
+extern OCTAVE_API isa_level level ();
+
+// The best instruction set supported by the processor.
+extern OCTAVE_API isa_level max_level ();
+
+// Select the instruction set (limited to max_level) and return the
+// previous setting.  This is mostly useful for testing and
+// benchmarking.
+extern OCTAVE_API isa_level set_level (isa_level lvl);
+
+extern OCTAVE_API const char * level_name (isa_level lvl);
+
+#define OCTAVE_SIMD_DECL_CHECK(T)                                       \
+  extern OCTAVE_API bool any_nan (std::size_t n, const T *x);           \
+  extern OCTAVE_API bool all_finite (std::size_t n, const T *x);
+
+#define OCTAVE_SIMD_DECL_MINMAX(T)                                      \
+  extern OCTAVE_API void                                                \
+  xmin (std::size_t n, T *r, const T *x, const T *y);                   \
+  extern OCTAVE_API void                                                \
+  xmax (std::size_t n, T *r, const T *x, const T *y);
+
+#define OCTAVE_SIMD_DECL_CMP_OP(F, T)                                   \
+  extern OCTAVE_API void F (std::size_t n, bool *r, const T *x, const T *y); \
+  extern OCTAVE_API void F (std::size_t n, bool *r, const T *x, T y);   \
+  extern OCTAVE_API void F (std::size_t n, bool *r, T x, const T *y);
+
+#define OCTAVE_SIMD_DECL_CMP(T)                 \
+  OCTAVE_SIMD_DECL_CMP_OP (lt, T)               \
+  OCTAVE_SIMD_DECL_CMP_OP (le, T)               \
+  OCTAVE_SIMD_DECL_CMP_OP (gt, T)               \
+  OCTAVE_SIMD_DECL_CMP_OP (ge, T)               \
+  OCTAVE_SIMD_DECL_CMP_OP (eq, T)               \
+  OCTAVE_SIMD_DECL_CMP_OP (ne, T)
+
+// Saturating integer arithmetic with the semantics of octave_int<T>.
+
+#define OCTAVE_SIMD_DECL_SAT_OP(F, T)                                   \
+  extern OCTAVE_API void F (std::size_t n, T *r, const T *x, const T *y); \
+  extern OCTAVE_API void F (std::size_t n, T *r, const T *x, T y);      \
+  extern OCTAVE_API void F (std::size_t n, T *r, T x, const T *y);
+
+#define OCTAVE_SIMD_DECL_SAT(T)                 \
+  OCTAVE_SIMD_DECL_SAT_OP (add_sat, T)          \
+  OCTAVE_SIMD_DECL_SAT_OP (sub_sat, T)
+
+OCTAVE_SIMD_DECL_CHECK (double)
+OCTAVE_SIMD_DECL_CHECK (float)
+
+OCTAVE_SIMD_DECL_MINMAX (double)
+OCTAVE_SIMD_DECL_MINMAX (float)
+
+OCTAVE_SIMD_DECL_CMP (double)
+OCTAVE_SIMD_DECL_CMP (float)
+
+OCTAVE_SIMD_DECL_SAT (int8_t)
+OCTAVE_SIMD_DECL_SAT (int16_t)
+OCTAVE_SIMD_DECL_SAT (int32_t)
+OCTAVE_SIMD_DECL_SAT (int64_t)
+OCTAVE_SIMD_DECL_SAT (uint8_t)
+OCTAVE_SIMD_DECL_SAT (uint16_t)
+OCTAVE_SIMD_DECL_SAT (uint32_t)
+OCTAVE_SIMD_DECL_SAT (uint64_t)
+
+#undef OCTAVE_SIMD_DECL_CHECK
+#undef OCTAVE_SIMD_DECL_MINMAX
+#undef OCTAVE_SIMD_DECL_CMP_OP
+#undef OCTAVE_SIMD_DECL_CMP
+#undef OCTAVE_SIMD_DECL_SAT_OP
+#undef OCTAVE_SIMD_DECL_SAT
+
+OCTAVE_END_NAMESPACE(simd)
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
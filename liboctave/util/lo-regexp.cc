@@ -30,6 +30,7 @@
 #include <list>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #if defined (HAVE_PCRE2)
@@ -50,11 +51,11 @@
 #include "Matrix.h"
 #include "lo-error.h"
 #include "oct-locbuf.h"
+#include "oct-mutex.h"
 #include "quit.h"
 #include "lo-regexp.h"
 #include "str-vec.h"
 #include "unistr-wrappers.h"
-#include "unwind-prot.h"
 
 #if defined (HAVE_PCRE2)
 typedef pcre2_code octave_pcre_code;
@@ -107,20 +108,234 @@ OCTAVE_BEGIN_NAMESPACE(octave)
 
 static bool lookbehind_warned = false;
 
-// FIXME: don't bother collecting and composing return values
-//        the user doesn't want.
+// Compiled code and the information about named tokens of a pattern.
+
+struct compiled_pattern
+{
+  std::shared_ptr<void> code;
+  string_vector named_pats;
+  int names;
+  Array<int> named_idx;
+};
+
+// Least recently used cache of compiled patterns.  The key is the
+// pattern prefixed with the options that affect compilation.
+
+class pattern_cache
+{
+public:
+
+  pattern_cache ()
+    : m_mutex (), m_lru (), m_map (), m_capacity (128), m_hits (0),
+      m_misses (0), m_evictions (0)
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (pattern_cache)
+
+  ~pattern_cache () = default;
+
+  bool find (const std::string& key, compiled_pattern& pat)
+  {
+    autolock guard (m_mutex);
+
+    auto p = m_map.find (key);
+
+    if (p == m_map.end ())
+      {
+        m_misses++;
+        return false;
+      }
+
+    m_hits++;
+
+    // Move to the front of the list of recently used patterns.
+    m_lru.splice (m_lru.begin (), m_lru, p->second.second);
+
+    pat = p->second.first;
+
+    return true;
+  }
+
+  void insert (const std::string& key, const compiled_pattern& pat)
+  {
+    autolock guard (m_mutex);
+
+    if (m_capacity == 0 || m_map.find (key) != m_map.end ())
+      return;
+
+    evict (m_capacity - 1);
+
+    m_lru.push_front (key);
+    m_map.emplace (key, std::make_pair (pat, m_lru.begin ()));
+  }
+
+  void clear ()
+  {
+    autolock guard (m_mutex);
+
+    m_lru.clear ();
+    m_map.clear ();
+
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
+  }
+
+  void capacity (std::size_t n)
+  {
+    autolock guard (m_mutex);
+
+    m_capacity = n;
+
+    evict (n);
+  }
+
+  regexp::cache_statistics stats ()
+  {
+    autolock guard (m_mutex);
+
+    return {m_hits, m_misses, m_evictions, m_map.size (), m_capacity};
+  }
+
+private:
+
+  // Drop the least recently used patterns until at most N remain.
+  // The mutex must be locked.
+
+  void evict (std::size_t n)
+  {
+    while (m_map.size () > n)
+      {
+        m_map.erase (m_lru.back ());
+        m_lru.pop_back ();
+        m_evictions++;
+      }
+  }
+
+  mutex m_mutex;
+
+  std::list<std::string> m_lru;
+
+  std::unordered_map<std::string,
+                     std::pair<compiled_pattern,
+                               std::list<std::string>::iterator>> m_map;
+
+  std::size_t m_capacity;
+
+  std::size_t m_hits;
+  std::size_t m_misses;
+  std::size_t m_evictions;
+};
+
+static pattern_cache&
+get_pattern_cache ()
+{
+  static pattern_cache cache;
+
+  return cache;
+}
+
+regexp::cache_statistics
+regexp::cache_stats ()
+{
+  return get_pattern_cache ().stats ();
+}
 
 void
-regexp::free ()
+regexp::clear_cache ()
 {
-  octave_pcre_code_free (static_cast<octave_pcre_code *> (m_code));
+  get_pattern_cache ().clear ();
 }
 
+void
+regexp::cache_capacity (std::size_t n)
+{
+  get_pattern_cache ().capacity (n);
+}
+
+#if defined (HAVE_PCRE2)
+
+// Match data that is reused by all matches of the current thread.  It
+// grows as needed to hold the results of the pattern with the largest
+// number of subpatterns.
+
+class thread_match_data
+{
+public:
+
+  thread_match_data () : m_data (nullptr), m_pairs (0) { }
+
+  OCTAVE_DISABLE_COPY_MOVE (thread_match_data)
+
+  ~thread_match_data ()
+  {
+    if (m_data)
+      pcre2_match_data_free (m_data);
+  }
+
+  pcre2_match_data * get (uint32_t pairs)
+  {
+    if (pairs > m_pairs)
+      {
+        if (m_data)
+          pcre2_match_data_free (m_data);
+
+        m_data = pcre2_match_data_create (pairs, nullptr);
+
+        if (! m_data)
+          {
+            m_pairs = 0;
+            (*current_liboctave_error_handler)
+              ("regexp: unable to allocate match data");
+          }
+
+        m_pairs = pairs;
+      }
+
+    return m_data;
+  }
+
+private:
+
+  pcre2_match_data *m_data;
+
+  uint32_t m_pairs;
+};
+
+#endif
+
+// FIXME: don't bother collecting and composing return values
+//        the user doesn't want.
+
 void
 regexp::compile_internal ()
 {
-  // If we had a previously compiled pattern, release it.
-  free ();
+  m_code.reset ();
+  m_named_pats = string_vector ();
+  m_names = 0;
+  m_named_idx = Array<int> ();
+
+  std::string key;
+
+  key += (m_options.case_insensitive () ? 'i' : '-');
+  key += (m_options.dotexceptnewline () ? 'n' : '-');
+  key += (m_options.lineanchors () ? 'm' : '-');
+  key += (m_options.freespacing () ? 'x' : '-');
+  key += m_pattern;
+
+  pattern_cache& cache = get_pattern_cache ();
+
+  compiled_pattern cached;
+
+  if (cache.find (key, cached))
+    {
+      m_code = cached.code;
+      m_named_pats = cached.named_pats;
+      m_names = cached.names;
+      m_named_idx = cached.named_idx;
+
+      return;
+    }
 
   std::size_t max_length = MAXLOOKBEHIND;
 
@@ -288,11 +503,12 @@ regexp::compile_internal ()
   PCRE2_SIZE erroffset;
   int errnumber;
 
-  m_code = pcre2_compile (reinterpret_cast<PCRE2_SPTR> (buf_str.c_str ()),
-                          PCRE2_ZERO_TERMINATED, pcre_options,
-                          &errnumber, &erroffset, nullptr);
+  octave_pcre_code *code
+    = pcre2_compile (reinterpret_cast<PCRE2_SPTR> (buf_str.c_str ()),
+                     PCRE2_ZERO_TERMINATED, pcre_options,
+                     &errnumber, &erroffset, nullptr);
 
-  if (! m_code)
+  if (! code)
     {
       // PCRE docs say:
       //
@@ -314,13 +530,26 @@ regexp::compile_internal ()
   const char *err;
   int erroffset;
 
-  m_code = pcre_compile (buf_str.c_str (), pcre_options,
-                         &err, &erroffset, nullptr);
+  octave_pcre_code *code = pcre_compile (buf_str.c_str (), pcre_options,
+                                         &err, &erroffset, nullptr);
 
-  if (! m_code)
+  if (! code)
     (*current_liboctave_error_handler)
       ("%s: %s at position %d of expression", m_who.c_str (), err, erroffset);
 #endif
+
+#if defined (HAVE_PCRE2)
+  // Compile to machine code if PCRE2 supports JIT on this platform.
+  // If not, pcre2_match silently uses the interpreter.
+  pcre2_jit_compile (code, PCRE2_JIT_COMPLETE);
+#endif
+
+  m_code = std::shared_ptr<void> (code, [] (void *p)
+  {
+    octave_pcre_code_free (static_cast<octave_pcre_code *> (p));
+  });
+
+  cache.insert (key, {m_code, m_named_pats, m_names, m_named_idx});
 }
 
 regexp::match_data
@@ -342,14 +571,20 @@ regexp::match (const std::string& buffer) const
   char *nametable;
   std::size_t idx = 0;
 
-  octave_pcre_code *re = static_cast<octave_pcre_code *> (m_code);
+  octave_pcre_code *re = static_cast<octave_pcre_code *> (m_code.get ());
 
   octave_pcre_pattern_info (re, OCTAVE_PCRE_INFO_CAPTURECOUNT, &subpatterns);
   octave_pcre_pattern_info (re, OCTAVE_PCRE_INFO_NAMECOUNT, &namecount);
   octave_pcre_pattern_info (re, OCTAVE_PCRE_INFO_NAMEENTRYSIZE, &nameentrysize);
   octave_pcre_pattern_info (re, OCTAVE_PCRE_INFO_NAMETABLE, &nametable);
 
-#if defined (HAVE_PCRE)
+#if defined (HAVE_PCRE2)
+  static thread_local thread_match_data match_data_cache;
+
+  pcre2_match_data *m_data = match_data_cache.get (subpatterns+1);
+
+  uint32_t match_options = 0;
+#else
   OCTAVE_LOCAL_BUFFER (OCTAVE_PCRE_SIZE, ovector, (subpatterns+1)*3);
 #endif
 
@@ -368,17 +603,20 @@ regexp::match (const std::string& buffer) const
       octave_quit ();
 
 #if defined (HAVE_PCRE2)
-      pcre2_match_data *m_data
-        = pcre2_match_data_create_from_pattern (re, nullptr);
-
-      unwind_action cleanup_match_data
-      ([=] () { pcre2_match_data_free (m_data); });
-
       int matches = pcre2_match (re, reinterpret_cast<PCRE2_SPTR> (buffer.c_str ()),
                                  buffer.length (), idx,
-                                 PCRE2_NO_UTF_CHECK | (idx ? PCRE2_NOTBOL : 0),
+                                 PCRE2_NO_UTF_CHECK | (idx ? PCRE2_NOTBOL : 0)
+                                 | match_options,
                                  m_data, nullptr);
 
+      if (matches == PCRE2_ERROR_JIT_STACKLIMIT)
+        {
+          // The JIT stack is much smaller than the limits of the
+          // interpreter.  Use the interpreter for this pattern.
+          match_options = PCRE2_NO_JIT;
+          continue;
+        }
+
       if (matches < 0 && matches != PCRE2_ERROR_NOMATCH)
         (*current_liboctave_error_handler)
           ("%s: internal error calling pcre2_match; "
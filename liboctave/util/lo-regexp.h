@@ -29,6 +29,7 @@
 #include "octave-config.h"
 
 #include <list>
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -48,7 +49,7 @@ public:
   regexp (const std::string& pat = "",
           const regexp::opts& opt = regexp::opts (),
           const std::string& w = "regexp")
-    : m_pattern (pat), m_options (opt), m_code (nullptr), m_named_pats (),
+    : m_pattern (pat), m_options (opt), m_code (), m_named_pats (),
       m_names (0), m_named_idx (), m_who (w)
   {
     compile_internal ();
@@ -58,7 +59,7 @@ public:
 
   regexp& operator = (const regexp& rx) = default;
 
-  ~regexp () { free (); }
+  ~regexp () = default;
 
   void compile (const std::string& pat,
                 const regexp::opts& opt = regexp::opts ())
@@ -118,6 +119,28 @@ public:
     return rx.replace (buffer, replacement);
   }
 
+  // Compiled patterns are kept in a cache that is shared by all regexp
+  // objects so that a pattern that is used repeatedly is compiled only
+  // once.  The least recently used pattern is dropped when the cache
+  // is full.
+
+  struct cache_statistics
+  {
+    std::size_t hits;
+    std::size_t misses;
+    std::size_t evictions;
+    std::size_t entries;
+    std::size_t capacity;
+  };
+
+  static cache_statistics cache_stats ();
+
+  static void clear_cache ();
+
+  // Set the maximum number of cached patterns.  A capacity of 0
+  // disables the cache.
+  static void cache_capacity (std::size_t n);
+
   class opts
   {
   public:
@@ -221,16 +244,15 @@ private:
 
   opts m_options;
 
-  // Internal data describing the regular expression.
-  void *m_code;
+  // Internal data describing the regular expression.  The compiled
+  // code may be shared with the pattern cache and other copies.
+  std::shared_ptr<void> m_code;
 
   string_vector m_named_pats;
   int m_names;
   Array<int> m_named_idx;
   std::string m_who;
 
-  void free ();
-
   void compile_internal ();
 };
 
@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <new>
+
+#include "oct-alloc.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// The per-thread state is trivially destructible so that objects that
+// are destroyed late during exit may still be returned to the pool.
+
+struct free_block
+{
+  free_block *next;
+};
+
+struct size_class_state
+{
+  free_block *free_list;
+  std::size_t allocations;
+  std::size_t deallocations;
+  std::size_t chunks;
+  std::size_t free_blocks;
+};
+
+static thread_local size_class_state
+pool_state[small_object_pool::NUM_SIZE_CLASSES];
+
+static inline std::size_t
+size_class (std::size_t size)
+{
+  return (size + small_object_pool::GRANULARITY - 1)
+         / small_object_pool::GRANULARITY - 1;
+}
+
+static void
+refill (size_class_state& st, std::size_t block_size)
+{
+  std::size_t n = small_object_pool::CHUNK_BLOCKS;
+
+  char *chunk = static_cast<char *> (::operator new (n * block_size));
+
+  // Link the blocks so that they are handed out in address order.
+
+  free_block *head = st.free_list;
+
+  for (std::size_t k = n; k > 0; k--)
+    {
+      free_block *blk
+        = reinterpret_cast<free_block *> (chunk + (k-1) * block_size);
+      blk->next = head;
+      head = blk;
+    }
+
+  st.free_list = head;
+  st.free_blocks += n;
+  st.chunks++;
+}
+
+void *
+small_object_pool::allocate (std::size_t size)
+{
+  if (size == 0 || size > MAX_SIZE)
+    return ::operator new (size);
+
+  std::size_t idx = size_class (size);
+
+  size_class_state& st = pool_state[idx];
+
+  if (! st.free_list)
+    refill (st, (idx + 1) * GRANULARITY);
+
+  free_block *blk = st.free_list;
+
+  st.free_list = blk->next;
+  st.free_blocks--;
+  st.allocations++;
+
+  return blk;
+}
+
+void
+small_object_pool::deallocate (void *p, std::size_t size) noexcept
+{
+  if (! p)
+    return;
+
+  if (size == 0 || size > MAX_SIZE)
+    {
+      ::operator delete (p);
+      return;
+    }
+
+  // A block may be freed by a different thread than the one that
+  // allocated it.  It then simply moves to the free list of the
+  // current thread.
+
+  size_class_state& st = pool_state[size_class (size)];
+
+  free_block *blk = static_cast<free_block *> (p);
+
+  blk->next = st.free_list;
+  st.free_list = blk;
+  st.free_blocks++;
+  st.deallocations++;
+}
+
+small_object_pool::statistics
+small_object_pool::stats (std::size_t idx)
+{
+  statistics retval {0, 0, 0, 0, 0};
+
+  if (idx < NUM_SIZE_CLASSES)
+    {
+      const size_class_state& st = pool_state[idx];
+
+      retval.block_size = (idx + 1) * GRANULARITY;
+      retval.allocations = st.allocations;
+      retval.deallocations = st.deallocations;
+      retval.chunks = st.chunks;
+      retval.free_blocks = st.free_blocks;
+    }
+
+  return retval;
+}
+
+void
+small_object_pool::reset_stats ()
+{
+  for (std::size_t idx = 0; idx < NUM_SIZE_CLASSES; idx++)
+    {
+      pool_state[idx].allocations = 0;
+      pool_state[idx].deallocations = 0;
+    }
+}
+
+OCTAVE_END_NAMESPACE(octave)
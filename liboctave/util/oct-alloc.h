@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_oct_alloc_h)
+#define octave_oct_alloc_h 1
+
+#include "octave-config.h"
+
+#include <cstddef>
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Allocator for small objects that are created and destroyed at a high
+// rate, such as the representations of scalar values.
+//
+// Blocks are grouped in size classes that are multiples of GRANULARITY
+// bytes.  Each thread keeps a free list for every size class that is
+// refilled from chunks of CHUNK_BLOCKS blocks.  Memory is never
+// returned to the system, but freed blocks are reused immediately.
+// Requests larger than MAX_SIZE are passed on to operator new.
+
+class OCTAVE_API small_object_pool
+{
+public:
+
+  static const std::size_t GRANULARITY = 16;
+
+  static const std::size_t MAX_SIZE = 128;
+
+  static const std::size_t NUM_SIZE_CLASSES = MAX_SIZE / GRANULARITY;
+
+  static const std::size_t CHUNK_BLOCKS = 256;
+
+  // Counters for one size class of the calling thread.
+
+  struct statistics
+  {
+    // Size of the blocks in bytes.
+    std::size_t block_size;
+    // Number of calls to allocate and deallocate.
+    std::size_t allocations;
+    std::size_t deallocations;
+    // Number of chunks obtained from operator new.
+    std::size_t chunks;
+    // Number of blocks on the free list.
+    std::size_t free_blocks;
+  };
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (small_object_pool)
+
+  ~small_object_pool () = delete;
+
+  static void * allocate (std::size_t size);
+
+  static void deallocate (void *p, std::size_t size) noexcept;
+
+  static statistics stats (std::size_t size_class);
+
+  static void reset_stats ();
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+// Use the small object pool for a class and all classes derived from
+// it.  The sized form of operator delete is used, so this also works
+// for derived classes that are larger than the base class, provided
+// that the destructor is virtual.
+
+#define OCTAVE_SMALL_OBJECT_ALLOCATOR                                   \
+  static void * operator new (std::size_t size)                         \
+  {                                                                     \
+    return octave::small_object_pool::allocate (size);                  \
+  }                                                                     \
+                                                                        \
+  static void operator delete (void *p, std::size_t size)               \
+  {                                                                     \
+    octave::small_object_pool::deallocate (p, size);                    \
+  }
+
+#endif
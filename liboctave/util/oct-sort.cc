@@ -109,14 +109,249 @@
 
 #include <cassert>
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
+#include <limits>
 #include <stack>
+#include <type_traits>
+#include <vector>
 
 #include "lo-error.h"
 #include "lo-mappers.h"
 #include "quit.h"
+#include "oct-inttypes-fwd.h"
 #include "oct-sort.h"
 #include "oct-locbuf.h"
+#include "oct-thread-pool.h"
+
+// Map values of type T to unsigned integer keys that compare like the
+// values themselves, for the LSD radix sort.  Types without a
+// specialization are always sorted by timsort.
+
+template <typename T, typename Enable = void>
+struct octave_sort_radix_traits
+{
+  static const bool enabled = false;
+
+  typedef unsigned char key_type;
+
+  static key_type key (const T&) { return 0; }
+};
+
+template <typename T>
+struct octave_sort_radix_traits
+  <T, typename std::enable_if<std::is_integral<T>::value
+                              && ! std::is_same<T, bool>::value>::type>
+{
+  static const bool enabled = true;
+
+  typedef typename std::make_unsigned<T>::type key_type;
+
+  static key_type key (T x)
+  {
+    // Flip the sign bit so that negative values come first.
+    key_type k = static_cast<key_type> (x);
+    if (std::is_signed<T>::value)
+      k ^= key_type (1) << (std::numeric_limits<key_type>::digits - 1);
+    return k;
+  }
+};
+
+template <typename T>
+struct octave_sort_radix_traits
+  <T, typename std::enable_if<std::is_floating_point<T>::value
+                              && (sizeof (T) == 4 || sizeof (T) == 8)>::type>
+{
+  static const bool enabled = true;
+
+  typedef typename std::conditional<sizeof (T) == 4, uint32_t,
+                                    uint64_t>::type key_type;
+
+  static key_type key (T x)
+  {
+    static const key_type sign = key_type (1) << (sizeof (T) * 8 - 1);
+
+    // NaN is greater than all other values, as for sort_isnan.  Both
+    // zeros compare equal, as they do with std::less.
+    if (x != x)
+      return ~key_type (0);
+    if (x == 0)
+      return sign;
+
+    key_type k;
+    std::memcpy (&k, &x, sizeof (T));
+    return (k & sign) ? ~k : (k | sign);
+  }
+};
+
+template <typename T>
+struct octave_sort_radix_traits<octave_int<T>>
+{
+  static const bool enabled = octave_sort_radix_traits<T>::enabled;
+
+  typedef typename octave_sort_radix_traits<T>::key_type key_type;
+
+  static key_type key (const octave_int<T>& x)
+  {
+    return octave_sort_radix_traits<T>::key (x.value ());
+  }
+};
+
+template <typename T>
+static inline bool
+sort_is_descending (const std::less<T>&)
+{
+  return false;
+}
+
+template <typename T>
+static inline bool
+sort_is_descending (const std::greater<T>&)
+{
+  return true;
+}
+
+// Stable LSD radix sort of DATA and, if it is not null, IDX.  The bytes
+// of the keys are sorted from least to most significant.  Bytes that
+// are the same for all elements are skipped.
+
+template <typename T>
+static void
+radix_sort (T *data, octave_idx_type *idx, octave_idx_type nel,
+            bool descending, std::true_type)
+{
+  typedef octave_sort_radix_traits<T> traits;
+  typedef typename traits::key_type key_type;
+
+  static const int nbytes = sizeof (key_type);
+
+  // Sorting the complemented keys in ascending order keeps equal
+  // elements in their original order.
+  const key_type flip = descending ? ~key_type (0) : key_type (0);
+
+  std::vector<octave_idx_type> count (nbytes * 256, 0);
+
+  for (octave_idx_type i = 0; i < nel; i++)
+    {
+      key_type k = traits::key (data[i]) ^ flip;
+      for (int b = 0; b < nbytes; b++)
+        count[b * 256 + ((k >> (8 * b)) & 0xff)]++;
+    }
+
+  OCTAVE_LOCAL_BUFFER (T, tbuf, nel);
+  OCTAVE_LOCAL_BUFFER (octave_idx_type, ibuf, idx ? nel : 0);
+
+  T *src = data;
+  T *dst = tbuf;
+  octave_idx_type *isrc = idx;
+  octave_idx_type *idst = ibuf;
+
+  for (int b = 0; b < nbytes; b++)
+    {
+      octave_idx_type *cnt = &count[b * 256];
+      const int shift = 8 * b;
+
+      if (cnt[((traits::key (src[0]) ^ flip) >> shift) & 0xff] == nel)
+        continue;
+
+      octave_idx_type pos = 0;
+      for (int d = 0; d < 256; d++)
+        {
+          octave_idx_type n = cnt[d];
+          cnt[d] = pos;
+          pos += n;
+        }
+
+      for (octave_idx_type i = 0; i < nel; i++)
+        {
+          key_type k = traits::key (src[i]) ^ flip;
+          octave_idx_type j = cnt[(k >> shift) & 0xff]++;
+          dst[j] = src[i];
+          if (idx)
+            idst[j] = isrc[i];
+        }
+
+      std::swap (src, dst);
+      std::swap (isrc, idst);
+    }
+
+  if (src != data)
+    {
+      std::copy (src, src + nel, data);
+      if (idx)
+        std::copy (isrc, isrc + nel, idx);
+    }
+}
+
+template <typename T>
+static void
+radix_sort (T *, octave_idx_type *, octave_idx_type, bool, std::false_type)
+{ }
+
+// Return the number of elements of the sorted range A that precede
+// element K of the stable merge of A and B.
+
+template <typename T, typename Comp>
+static octave_idx_type
+merge_split (octave_idx_type k, const T *a, octave_idx_type na,
+             const T *b, octave_idx_type nb, Comp comp)
+{
+  octave_idx_type lo = std::max (k - nb, octave_idx_type (0));
+  octave_idx_type hi = std::min (k, na);
+
+  for (;;)
+    {
+      octave_idx_type i = lo + (hi - lo) / 2;
+      octave_idx_type j = k - i;
+
+      if (i > 0 && j < nb && comp (b[j], a[i-1]))
+        hi = i - 1;
+      else if (j > 0 && i < na && ! comp (b[j-1], a[i]))
+        lo = i + 1;
+      else
+        return i;
+    }
+}
+
+// Merge the sorted ranges [LO, MID) and [MID, HI) of SRC (and ISRC) and
+// store elements K0 to K1 - 1 of the result at DST + LO + K0.  Equal
+// elements are taken from the first range first.
+
+template <typename T, typename Comp>
+static void
+merge_segment (const T *src, const octave_idx_type *isrc,
+               T *dst, octave_idx_type *idst,
+               octave_idx_type lo, octave_idx_type mid, octave_idx_type hi,
+               octave_idx_type k0, octave_idx_type k1, Comp comp)
+{
+  const T *a = src + lo;
+  const T *b = src + mid;
+  octave_idx_type na = mid - lo;
+  octave_idx_type nb = hi - mid;
+
+  octave_idx_type i = merge_split (k0, a, na, b, nb, comp);
+  octave_idx_type j = k0 - i;
+  octave_idx_type iend = merge_split (k1, a, na, b, nb, comp);
+  octave_idx_type jend = k1 - iend;
+
+  for (octave_idx_type k = lo + k0; k < lo + k1; k++)
+    {
+      if (j < jend && (i == iend || comp (b[j], a[i])))
+        {
+          dst[k] = b[j];
+          if (isrc)
+            idst[k] = isrc[mid+j];
+          j++;
+        }
+      else
+        {
+          dst[k] = a[i];
+          if (isrc)
+            idst[k] = isrc[lo+i];
+          i++;
+        }
+    }
+}
 
 template <typename T>
 octave_sort<T>::octave_sort () :
@@ -1513,6 +1748,142 @@ octave_sort<T>::sort (T *data, octave_idx_type *idx, octave_idx_type nel,
     }
 }
 
+template <typename T>
+template <typename Comp>
+void
+octave_sort<T>::sort_inline (T *data, octave_idx_type *idx,
+                             octave_idx_type nel, Comp comp)
+{
+  if (nel >= PARALLEL_SORT_MIN && octave::thread_pool::num_threads () > 1)
+    parallel_sort (data, idx, nel, comp);
+  else
+    sort_part (data, idx, nel, comp);
+}
+
+template <typename T>
+template <typename Comp>
+void
+octave_sort<T>::sort_part (T *data, octave_idx_type *idx,
+                           octave_idx_type nel, Comp comp)
+{
+  typedef octave_sort_radix_traits<T> traits;
+
+  if (traits::enabled && nel >= RADIX_SORT_MIN)
+    {
+      // Timsort needs only one pass for data that is already sorted or
+      // strictly reversed.
+      bool descending;
+      if (count_run (data, nel, descending, comp) == nel)
+        {
+          if (descending)
+            {
+              std::reverse (data, data + nel);
+              if (idx)
+                std::reverse (idx, idx + nel);
+            }
+        }
+      else
+        radix_sort (data, idx, nel, sort_is_descending (comp),
+                    std::integral_constant<bool, traits::enabled> ());
+    }
+  else if (idx)
+    sort (data, idx, nel, comp);
+  else
+    sort (data, nel, comp);
+}
+
+// Sort one part of the array for each thread and merge pairs of sorted
+// parts until only one is left.  The comparison must not call back into
+// the interpreter, which is true for std::less and std::greater.
+
+template <typename T>
+template <typename Comp>
+void
+octave_sort<T>::parallel_sort (T *data, octave_idx_type *idx,
+                               octave_idx_type nel, Comp comp)
+{
+  octave_idx_type nparts = octave::thread_pool::num_threads ();
+
+  std::vector<octave_idx_type> runs (nparts + 1);
+  for (octave_idx_type p = 0; p <= nparts; p++)
+    runs[p] = p * (nel / nparts) + std::min (p, nel % nparts);
+
+  octave::thread_pool::parallel_for
+    (nparts, [=, &runs] (std::size_t begin, std::size_t end)
+     {
+       for (std::size_t p = begin; p < end; p++)
+         {
+           octave_sort<T> part_sort;
+           octave_idx_type lo = runs[p];
+           part_sort.sort_part (data + lo, idx ? idx + lo : nullptr,
+                                runs[p+1] - lo, comp);
+         }
+     }, 1, 2);
+
+  OCTAVE_LOCAL_BUFFER (T, tbuf, nel);
+  OCTAVE_LOCAL_BUFFER (octave_idx_type, ibuf, idx ? nel : 0);
+
+  T *src = data;
+  T *dst = tbuf;
+  octave_idx_type *isrc = idx;
+  octave_idx_type *idst = idx ? ibuf : nullptr;
+
+  // Each merge is split into segments so that all threads are busy
+  // even when only the last two parts are left.
+  const octave_idx_type seg_len
+    = std::max (nel / (4 * nparts),
+                static_cast<octave_idx_type> (octave::thread_pool::GRAIN));
+
+  struct merge_task
+  {
+    octave_idx_type lo, mid, hi, k0, k1;
+  };
+
+  while (runs.size () > 2)
+    {
+      std::vector<merge_task> tasks;
+      std::vector<octave_idx_type> next_runs;
+
+      octave_idx_type nruns = runs.size () - 1;
+      for (octave_idx_type r = 0; r < nruns; r += 2)
+        {
+          octave_idx_type lo = runs[r];
+          octave_idx_type mid = runs[std::min (r + 1, nruns)];
+          octave_idx_type hi = runs[std::min (r + 2, nruns)];
+
+          // A final run without a partner is copied.
+          for (octave_idx_type k = 0; k < hi - lo; k += seg_len)
+            tasks.push_back ({lo, mid, hi, k,
+                              std::min (k + seg_len, hi - lo)});
+
+          next_runs.push_back (lo);
+        }
+      next_runs.push_back (nel);
+
+      octave::thread_pool::parallel_for
+        (tasks.size (), [=, &tasks] (std::size_t begin, std::size_t end)
+         {
+           for (std::size_t t = begin; t < end; t++)
+             {
+               const merge_task& mt = tasks[t];
+               merge_segment (src, isrc, dst, idst, mt.lo, mt.mid, mt.hi,
+                              mt.k0, mt.k1, comp);
+             }
+         }, 1, 2);
+
+      std::swap (src, dst);
+      std::swap (isrc, idst);
+      runs.swap (next_runs);
+    }
+
+  if (src != data)
+    {
+      std::copy (src, src + nel, data);
+      if (idx)
+        std::copy (isrc, isrc + nel, idx);
+    }
+}
+
 template <typename T>
 using compare_fcn_ptr = bool (*) (typename ref_param<T>::type,
                                   typename ref_param<T>::type);
@@ -1523,12 +1894,12 @@ octave_sort<T>::sort (T *data, octave_idx_type nel)
 {
 #if defined (INLINE_ASCENDING_SORT)
   if (*m_compare.template target<compare_fcn_ptr<T>> () == ascending_compare)
-    sort (data, nel, std::less<T> ());
+    sort_inline (data, nullptr, nel, std::less<T> ());
   else
 #endif
 #if defined (INLINE_DESCENDING_SORT)
     if (*m_compare.template target<compare_fcn_ptr<T>> () == descending_compare)
-      sort (data, nel, std::greater<T> ());
+      sort_inline (data, nullptr, nel, std::greater<T> ());
     else
 #endif
       if (m_compare)
@@ -1541,12 +1912,12 @@ octave_sort<T>::sort (T *data, octave_idx_type *idx, octave_idx_type nel)
 {
 #if defined (INLINE_ASCENDING_SORT)
   if (*m_compare.template target<compare_fcn_ptr<T>> () == ascending_compare)
-    sort (data, idx, nel, std::less<T> ());
+    sort_inline (data, idx, nel, std::less<T> ());
   else
 #endif
 #if defined (INLINE_DESCENDING_SORT)
     if (*m_compare.template target<compare_fcn_ptr<T>> () == descending_compare)
-      sort (data, idx, nel, std::greater<T> ());
+      sort_inline (data, idx, nel, std::greater<T> ());
     else
 #endif
       if (m_compare)
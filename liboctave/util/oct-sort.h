@@ -176,6 +176,16 @@ private:
   // Avoid malloc for small temp arrays.
   static const int MERGESTATE_TEMP_SIZE = 1024;
 
+  // Arrays of types with fixed-width keys (see octave_sort_radix_traits
+  // in oct-sort.cc) that have at least this many elements are sorted by
+  // an LSD radix sort instead of timsort.
+  static const octave_idx_type RADIX_SORT_MIN = 1024;
+
+  // Arrays with at least this many elements are split into one part for
+  // each thread of the thread pool.  The parts are sorted independently
+  // and merged in parallel.
+  static const octave_idx_type PARALLEL_SORT_MIN = 1 << 18;
+
   // One MergeState exists on the stack per invocation of mergesort.
   // It's just a convenient way to pass state around among the helper
   // functions.
@@ -304,6 +314,20 @@ private:
   template <typename Comp>
   void sort (T *data, octave_idx_type *idx, octave_idx_type nel, Comp comp);
 
+  // Sort with one of the inline comparisons std::less or std::greater.
+  // IDX may be null.
+  template <typename Comp>
+  void sort_inline (T *data, octave_idx_type *idx, octave_idx_type nel,
+                    Comp comp);
+
+  template <typename Comp>
+  void sort_part (T *data, octave_idx_type *idx, octave_idx_type nel,
+                  Comp comp);
+
+  template <typename Comp>
+  void parallel_sort (T *data, octave_idx_type *idx, octave_idx_type nel,
+                      Comp comp);
+
   template <typename Comp>
   bool issorted (const T *data, octave_idx_type nel, Comp comp);
 
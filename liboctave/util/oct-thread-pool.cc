@@ -0,0 +1,328 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "nproc-wrapper.h"
+#include "oct-thread-pool.h"
+#include "unistd-wrappers.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// The number of threads.  Zero means that the default has not been
+// determined yet.
+
+static std::atomic<int> s_num_threads (0);
+
+// True in pool threads and in a thread that is executing a parallel
+// loop.  Used to run nested loops serially.
+
+static thread_local bool s_in_parallel_loop = false;
+
+class pool_state
+{
+public:
+
+  pool_state () = default;
+
+  OCTAVE_DISABLE_COPY_MOVE (pool_state)
+
+  ~pool_state ()
+  {
+    {
+      std::lock_guard<std::mutex> lock (m_mutex);
+      m_shutdown = true;
+    }
+
+    m_work_cv.notify_all ();
+
+    for (auto& t : m_threads)
+      t.join ();
+  }
+
+  void run (std::size_t n, std::size_t grain, int nthreads,
+            void (*fcn) (void *, std::size_t, std::size_t), void *data);
+
+  // Serializes the use of the pool by different threads.
+  std::mutex m_run_mutex;
+
+private:
+
+  void worker (int idx);
+
+  void work ();
+
+  std::mutex m_mutex;
+
+  std::condition_variable m_work_cv;
+
+  std::condition_variable m_done_cv;
+
+  std::vector<std::thread> m_threads;
+
+  unsigned long m_generation = 0;
+
+  bool m_shutdown = false;
+
+  // The current loop.
+
+  std::size_t m_n = 0;
+
+  std::size_t m_grain = 0;
+
+  void (*m_fcn) (void *, std::size_t, std::size_t) = nullptr;
+
+  void *m_data = nullptr;
+
+  // Number of pool threads that take part in the current loop and the
+  // number of those that have not finished yet.
+  int m_nworkers = 0;
+
+  int m_active = 0;
+
+  std::atomic<std::size_t> m_next {0};
+
+  std::exception_ptr m_error;
+};
+
+void
+pool_state::work ()
+{
+  for (;;)
+    {
+      std::size_t begin = m_next.fetch_add (m_grain);
+
+      if (begin >= m_n)
+        break;
+
+      std::size_t end = std::min (begin + m_grain, m_n);
+
+      try
+        {
+          m_fcn (m_data, begin, end);
+        }
+      catch (...)
+        {
+          std::lock_guard<std::mutex> lock (m_mutex);
+
+          if (! m_error)
+            m_error = std::current_exception ();
+
+          // Skip the remaining chunks.
+          m_next = m_n;
+        }
+    }
+}
+
+void
+pool_state::worker (int idx)
+{
+  s_in_parallel_loop = true;
+
+  unsigned long seen = 0;
+
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  for (;;)
+    {
+      m_work_cv.wait (lock, [this, seen] ()
+                      { return m_shutdown || m_generation != seen; });
+
+      if (m_shutdown)
+        return;
+
+      seen = m_generation;
+
+      if (idx >= m_nworkers)
+        continue;
+
+      lock.unlock ();
+
+      work ();
+
+      lock.lock ();
+
+      if (--m_active == 0)
+        m_done_cv.notify_one ();
+    }
+}
+
+void
+pool_state::run (std::size_t n, std::size_t grain, int nthreads,
+                 void (*fcn) (void *, std::size_t, std::size_t),
+                 void *data)
+{
+  std::size_t nchunks = (n + grain - 1) / grain;
+
+  int nworkers = std::min (static_cast<std::size_t> (nthreads - 1),
+                           nchunks - 1);
+
+  // Threads are started on first use.  If a thread can not be
+  // created, work with those that exist.
+
+  while (static_cast<int> (m_threads.size ()) < nworkers)
+    {
+      try
+        {
+          int idx = m_threads.size ();
+          m_threads.emplace_back ([this, idx] () { worker (idx); });
+        }
+      catch (const std::system_error&)
+        {
+          nworkers = m_threads.size ();
+          break;
+        }
+    }
+
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+
+    m_n = n;
+    m_grain = grain;
+    m_fcn = fcn;
+    m_data = data;
+    m_nworkers = nworkers;
+    m_active = nworkers;
+    m_next = 0;
+    m_error = nullptr;
+    m_generation++;
+  }
+
+  m_work_cv.notify_all ();
+
+  s_in_parallel_loop = true;
+
+  work ();
+
+  s_in_parallel_loop = false;
+
+  std::exception_ptr err;
+
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+
+    m_done_cv.wait (lock, [this] () { return m_active == 0; });
+
+    std::swap (err, m_error);
+  }
+
+  if (err)
+    std::rethrow_exception (err);
+}
+
+static std::unique_ptr<pool_state> s_pool;
+
+static pid_t s_pool_pid = 0;
+
+static std::mutex s_pool_mutex;
+
+static pool_state&
+get_pool ()
+{
+  std::lock_guard<std::mutex> lock (s_pool_mutex);
+
+  pid_t pid = octave_getpid_wrapper ();
+
+  if (s_pool && s_pool_pid != pid)
+    {
+      // The threads of the pool do not exist in a child process
+      // created by fork.  They can neither be joined nor notified, so
+      // the old state is abandoned.
+      s_pool.release ();
+    }
+
+  if (! s_pool)
+    {
+      s_pool.reset (new pool_state ());
+      s_pool_pid = pid;
+    }
+
+  return *s_pool;
+}
+
+int
+thread_pool::num_threads ()
+{
+  int n = s_num_threads;
+
+  if (n == 0)
+    {
+      unsigned long nproc
+        = octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT_OVERRIDABLE);
+
+      n = (nproc < 1 ? 1 : static_cast<int> (nproc));
+
+      s_num_threads = n;
+    }
+
+  return n;
+}
+
+int
+thread_pool::num_threads (int n)
+{
+  int retval = num_threads ();
+
+  s_num_threads = (n < 1 ? 0 : n);
+
+  return retval;
+}
+
+void
+thread_pool::run (std::size_t n, std::size_t grain, range_fcn fcn,
+                  void *data)
+{
+  if (s_in_parallel_loop)
+    {
+      fcn (data, 0, n);
+      return;
+    }
+
+  pool_state& pool = get_pool ();
+
+  std::unique_lock<std::mutex> lock (pool.m_run_mutex, std::try_to_lock);
+
+  if (! lock.owns_lock ())
+    {
+      fcn (data, 0, n);
+      return;
+    }
+
+  pool.run (n, grain, num_threads (), fcn, data);
+}
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_oct_thread_pool_h)
+#define octave_oct_thread_pool_h 1
+
+#include "octave-config.h"
+
+#include <cstddef>
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// A process-wide pool of threads for data parallel loops over large
+// arrays.
+//
+// parallel_for splits the range [0, N) into chunks of GRAIN elements
+// that are handed out dynamically to the calling thread and to up to
+// num_threads () - 1 pool threads.  Loops shorter than MIN_ELEMENTS,
+// nested loops, and loops that are started while another thread is
+// using the pool are executed serially by the calling thread.
+//
+// The loop body must not call back into the interpreter.  Exceptions
+// that are thrown by the loop body are rethrown in the calling thread
+// once all chunks have been processed.
+
+class OCTAVE_API thread_pool
+{
+public:
+
+  // Minimum number of elements before a loop is split.
+  static const std::size_t MIN_ELEMENTS = 1 << 17;
+
+  // Default number of elements per chunk.
+  static const std::size_t GRAIN = 1 << 15;
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (thread_pool)
+
+  ~thread_pool () = delete;
+
+  // Number of threads that are used for parallel loops, including the
+  // calling thread.  The default is the number of processors that are
+  // available to Octave (see nproc).
+  static int num_threads ();
+
+  // Set the number of threads and return the previous value.  A value
+  // less than 1 restores the default.
+  static int num_threads (int n);
+
+  // Call FCN (BEGIN, END) for consecutive, non-overlapping subranges
+  // that cover [0, N).
+  template <typename F>
+  static void
+  parallel_for (std::size_t n, F fcn, std::size_t grain = GRAIN,
+                std::size_t min_elements = MIN_ELEMENTS)
+  {
+    if (n < min_elements || n <= grain || num_threads () < 2)
+      fcn (std::size_t (0), n);
+    else
+      run (n, grain, call<F>, &fcn);
+  }
+
+private:
+
+  typedef void (*range_fcn) (void *, std::size_t, std::size_t);
+
+  template <typename F>
+  static void
+  call (void *fcn, std::size_t begin, std::size_t end)
+  {
+    (*static_cast<F *> (fcn)) (begin, end);
+  }
+
+  static void run (std::size_t n, std::size_t grain, range_fcn fcn,
+                   void *data);
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+// These functions may be provided by gnulib.  We don't include gnulib
+// headers directly in Octave's C++ source files to avoid problems that
+// may be caused by the way that gnulib overrides standard library
+// functions.
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined (HAVE_MMAP) && defined (HAVE_MUNMAP)
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+#include "mman-wrappers.h"
+
+const char *
+octave_mmap_file_wrapper (int fd, off_t offset, size_t *len,
+                          void **base, size_t *map_len)
+{
+  *len = 0;
+  *base = NULL;
+  *map_len = 0;
+
+#if defined (HAVE_MMAP) && defined (HAVE_MUNMAP)
+  struct stat st;
+
+  if (fd < 0 || offset < 0 || fstat (fd, &st) != 0 || ! S_ISREG (st.st_mode)
+      || offset >= st.st_size)
+    return NULL;
+
+  // The offset of the mapping must be a multiple of the page size.
+  long page_size = sysconf (_SC_PAGESIZE);
+  if (page_size <= 0)
+    return NULL;
+
+  off_t map_offset = offset - offset % page_size;
+
+  if ((uintmax_t) (st.st_size - map_offset) > (uintmax_t) SIZE_MAX)
+    return NULL;
+
+  size_t n = st.st_size - map_offset;
+
+  void *p = mmap (NULL, n, PROT_READ, MAP_PRIVATE, fd, map_offset);
+
+  if (p == MAP_FAILED)
+    return NULL;
+
+#  if defined (MADV_SEQUENTIAL)
+  madvise (p, n, MADV_SEQUENTIAL);
+#  endif
+
+  *base = p;
+  *map_len = n;
+  *len = st.st_size - offset;
+
+  return (const char *) p + (offset - map_offset);
+#else
+  octave_unused_parameter (fd);
+  octave_unused_parameter (offset);
+
+  return NULL;
+#endif
+}
+
+void
+octave_munmap_file_wrapper (void *base, size_t map_len)
+{
+#if defined (HAVE_MMAP) && defined (HAVE_MUNMAP)
+  if (base)
+    munmap (base, map_len);
+#else
+  octave_unused_parameter (base);
+  octave_unused_parameter (map_len);
+#endif
+}
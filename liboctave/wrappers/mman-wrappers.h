@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_mman_wrappers_h)
+#define octave_mman_wrappers_h 1
+
+#if defined __cplusplus
+#  include <cstddef>
+#else
+#  include <stddef.h>
+#endif
+
+#include <sys/types.h>
+
+#if defined __cplusplus
+extern "C" {
+#endif
+
+// Map the part of the regular file open on FD that starts at OFFSET
+// and extends to the end of the file into memory for reading.  Return
+// a pointer to the data and store its length in *LEN.  Return NULL if
+// the file can't be mapped.  *BASE and *MAP_LEN receive the values
+// that must be passed to octave_munmap_file_wrapper.
+
+extern OCTAVE_API const char *
+octave_mmap_file_wrapper (int fd, off_t offset, size_t *len,
+                          void **base, size_t *map_len);
+
+extern OCTAVE_API void
+octave_munmap_file_wrapper (void *base, size_t map_len);
+
+#if defined __cplusplus
+}
+#endif
+
+#endif
@@ -15,6 +15,7 @@ NOINSTALL_WRAPPERS_INC = \
   %reldir%/intprops-wrappers.h \
   %reldir%/localcharset-wrapper.h \
   %reldir%/math-wrappers.h \
+  %reldir%/mman-wrappers.h \
   %reldir%/mkostemp-wrapper.h \
   %reldir%/mkostemps-wrapper.h \
   %reldir%/nanosleep-wrapper.h \
@@ -60,6 +61,7 @@ WRAPPERS_SRC = \
   %reldir%/intprops-wrappers.c \
   %reldir%/localcharset-wrapper.c \
   %reldir%/math-wrappers.c \
+  %reldir%/mman-wrappers.c \
   %reldir%/mkostemp-wrapper.c \
   %reldir%/mkostemps-wrapper.c \
   %reldir%/nanosleep-wrapper.c \
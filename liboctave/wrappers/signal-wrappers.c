@@ -44,6 +44,10 @@
 #  include <pthread.h>
 #endif
 
+#if defined (HAVE_SETITIMER)
+#  include <sys/time.h>
+#endif
+
 #include "signal-wrappers.h"
 
 int
@@ -79,6 +83,49 @@ octave_have_kill (void)
 #endif
 }
 
+bool
+octave_have_profiling_timer (void)
+{
+#if defined (HAVE_SETITIMER) && defined (SIGPROF)
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Arrange for SIGPROF to be delivered every INTERVAL seconds of CPU
+// time consumed by the process.  An interval of zero stops the timer.
+
+bool
+octave_set_profiling_timer (double interval)
+{
+#if defined (HAVE_SETITIMER) && defined (SIGPROF)
+  struct itimerval tv;
+
+  long sec = 0;
+  long usec = 0;
+
+  if (interval > 0)
+    {
+      sec = (long) interval;
+      usec = (long) ((interval - sec) * 1e6);
+
+      if (sec == 0 && usec == 0)
+        usec = 1;
+    }
+
+  tv.it_interval.tv_sec = sec;
+  tv.it_interval.tv_usec = usec;
+  tv.it_value = tv.it_interval;
+
+  return setitimer (ITIMER_PROF, &tv, NULL) == 0;
+#else
+  octave_unused_parameter (interval);
+
+  return false;
+#endif
+}
+
 bool
 octave_get_sig_number (const char *signame, int *signum)
 {
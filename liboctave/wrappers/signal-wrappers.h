@@ -44,6 +44,10 @@ extern OCTAVE_API char * octave_strsignal_wrapper (int signum);
 
 extern OCTAVE_API bool octave_have_kill (void);
 
+extern OCTAVE_API bool octave_have_profiling_timer (void);
+
+extern OCTAVE_API bool octave_set_profiling_timer (double interval);
+
 extern OCTAVE_API bool octave_get_sig_number (const char *signame, int *signum);
 
 extern OCTAVE_API octave_sig_handler *
@@ -183,6 +183,12 @@ octave_execvp_wrapper (const char *file, char *const *argv)
   return execvp (file, argv);
 }
 
+void
+octave__exit_wrapper (int status)
+{
+  _exit (status);
+}
+
 pid_t
 octave_fork_wrapper (void)
 {
@@ -320,6 +326,12 @@ octave_pipe_wrapper (int *fd)
   return pipe (fd);
 }
 
+ssize_t
+octave_read_wrapper (int fd, void *buf, size_t n)
+{
+  return read (fd, buf, n);
+}
+
 int
 octave_rmdir_wrapper (const char *nm)
 {
@@ -392,6 +404,12 @@ octave_vfork_wrapper (void)
 #endif
 }
 
+ssize_t
+octave_write_wrapper (int fd, const void *buf, size_t n)
+{
+  return write (fd, buf, n);
+}
+
 bool
 octave_have_fork (void)
 {
@@ -101,7 +101,8 @@ classdef Map < handle
   endproperties
 
   properties (private)
-    map = struct ();
+    ## Hash table of keys and values, created by the constructor.
+    map = [];
 
     numeric_keys = false;
   endproperties
@@ -112,6 +113,7 @@ classdef Map < handle
 
       if (nargin == 0)
         ## Empty object with "char" key type and "any" value type.
+        this.map = __containers_map_new__ ("char");
       elseif (nargin == 2 || (nargin == 4
                               && strcmpi (varargin{3}, "UniformValues")))
         ## Get Map keys
@@ -203,18 +205,9 @@ classdef Map < handle
         ## Check type of keys and values, and define numeric_keys
         check_types (this);
 
-        ## Sort keys (faster than call to sort_keys once encoded)
-        if (this.numeric_keys)
-          [~, I] = sort (cell2mat (keys));
-        else
-          [~, I] = sort (keys);
-        endif
-        keys = keys(I);
-        vals = vals(I);
-        ## Convert keys to char vectors
-        keys = encode_keys (this, keys);
         ## Fill in the Map
-        this.map = cell2struct (vals, keys);
+        this.map = __containers_map_new__ (this.KeyType);
+        __containers_map_set__ (this.map, keys, vals);
       elseif (nargin == 4)
         for i = [1, 3]
           switch (lower (varargin{i}))
@@ -227,6 +220,7 @@ classdef Map < handle
           endswitch
         endfor
         check_types (this);
+        this.map = __containers_map_new__ (this.KeyType);
       else
         error ("containers.Map: incorrect number of inputs specified");
       endif
@@ -240,8 +234,7 @@ classdef Map < handle
       ## Return the sorted list of all keys of the map as a cell vector.
       ## @end deftypefn
 
-      keySet = fieldnames (this.map).';  # compatibility requires row vector
-      keySet = decode_keys (this, keySet);
+      keySet = __containers_map_keys__ (this.map);
 
     endfunction
 
@@ -257,21 +250,16 @@ classdef Map < handle
       ## @end deftypefn
 
       if (nargin == 1)
-        valueSet = struct2cell (this.map).';
+        valueSet = __containers_map_values__ (this.map);
       else
         if (! iscell (keySet))
           error ("containers.Map: input argument 'keySet' must be a cell");
         endif
-        enckeySet = encode_keys (this, keySet);
-        valueSet = cell (size (keySet));
-        for i = 1:numel (valueSet)
-          try
-            valueSet{i} = this.map.(enckeySet{i});
-          catch
-            error ("containers.Map: key <%s> does not exist",
-                   strtrim (disp (keySet{i})));
-          end_try_catch
-        endfor
+        [valueSet, missing] = __containers_map_get__ (this.map, keySet);
+        if (missing)
+          error ("containers.Map: key <%s> does not exist",
+                 strtrim (disp (keySet{missing})));
+        endif
       endif
 
     endfunction
@@ -288,20 +276,7 @@ classdef Map < handle
       ## vector.
       ## @end deftypefn
 
-      if (! iscell (keySet))
-        if (isnumeric (keySet) || islogical (keySet))
-          keySet = num2cell (keySet);
-        else
-          keySet = { keySet };
-        endif
-      endif
-      tf = false (size (keySet));
-      in = cellfun ("isnumeric", keySet) | cellfun ("islogical", keySet);
-      if (! this.numeric_keys)
-        in = ! in;
-      endif
-      keySet = encode_keys (this, keySet(in));
-      tf(in) = isfield (this.map, keySet);
+      tf = __containers_map_iskey__ (this.map, keySet);
 
     endfunction
 
@@ -317,20 +292,7 @@ classdef Map < handle
       ## single key.
       ## @end deftypefn
 
-      if (! iscell (keySet))
-        if (isnumeric (keySet) || islogical (keySet))
-          keySet = num2cell (keySet);
-        else
-          keySet = { keySet };
-        endif
-      endif
-      in = cellfun ("isnumeric", keySet) | cellfun ("islogical", keySet);
-      if (! this.numeric_keys)
-        in = ! in;
-      endif
-      keySet = encode_keys (this, keySet(in));
-      in = isfield (this.map, keySet);
-      this.map = rmfield (this.map, keySet(in));
+      __containers_map_remove__ (this.map, keySet);
 
     endfunction
 
@@ -383,7 +345,7 @@ classdef Map < handle
     endfunction
 
     function count = get.Count (this)
-      count = uint64 (numfields (this.map));
+      count = uint64 (__containers_map_count__ (this.map));
     endfunction
 
     function sref = subsref (this, s)
@@ -435,12 +397,12 @@ classdef Map < handle
                                         || ! isscalar (key))))
             error ("containers.Map: specified key type does not match the type of this container");
           endif
-          enckey = encode_keys (this, key);
-          if (! isfield (this.map, enckey))
+          [sref, missing] = __containers_map_get__ (this.map, key);
+          if (missing)
             error ("containers.Map: specified key <%s> does not exist",
                    strtrim (disp (key)));
           endif
-          sref = this.map.(enckey);
+          sref = sref{1};
         otherwise
           error ("containers.Map: only '()' indexing is supported");
       endswitch
@@ -474,13 +436,7 @@ classdef Map < handle
             endif
             val = feval (this.ValueType, val);
           endif
-          key = encode_keys (this, key);
-          if (isfield (this.map, key))
-            this.map.(key) = val;
-          else
-            this.map.(key) = val;
-            this = sort_keys (this);
-          endif
+          __containers_map_set__ (this.map, key, {val});
         case "{}"
           error ("containers.Map: only '()' indexing is supported for assigning values");
       endswitch
@@ -529,52 +485,6 @@ classdef Map < handle
 
   methods (Access = private)
 
-    ## All keys are encoded as strings.
-    ## For numeric keys, this requires conversion.
-    function keys = encode_keys (this, keys)
-
-      if (iscellstr (keys) || ischar (keys))
-        return;
-      endif
-      cell_input = iscell (keys);
-      if (cell_input)
-        orig_sz = size (keys);
-        if (! all (cellfun ("isclass", keys, this.KeyType)))
-          ## Convert input set to KeyType.  This is rarely necessary.
-          keys = cellfun (@(x) feval (this.KeyType, x), keys);
-        else
-          keys = cell2mat (keys);
-        endif
-      elseif (! isa (keys, this.KeyType))
-        keys = feval (this.KeyType, keys);
-      endif
-      keys = num2hex (keys);  # Force to char matrix with single logical column
-      if (cell_input)
-        keys = reshape (cellstr (keys), orig_sz);
-      endif
-
-    endfunction
-
-    function keys = decode_keys (this, keys)
-      if (this.numeric_keys)
-        keys = hex2num (keys, this.KeyType);
-        ## This always returns a 1xN list of keys ignoring input shape
-        keys = mat2cell (keys(:).', 1, ones (1, numel (keys)));
-      endif
-    endfunction
-
-    function this = sort_keys (this)
-
-      keySet = keys (this);
-      if (this.numeric_keys)
-        [~, p] = sort (cell2mat (keySet));
-      else
-        [~, p] = sort (keySet);
-      endif
-      this.map = orderfields (this.map, p);
-
-    endfunction
-
     function check_types (this)
 
       switch (this.KeyType)
@@ -871,6 +781,22 @@ endclassdef
 %! keys = {'Jan', 'FooBar', 'Feb'};
 %! assert (M.isKey (keys)(2:end), logical ([0, 1]));
 
+## Test a large map
+%!test
+%! n = 1e4;
+%! m = containers.Map ("KeyType", "double", "ValueType", "any");
+%! for i = n:-1:1
+%!   m(i) = 2*i;
+%! endfor
+%! assert (m.Count, uint64 (n));
+%! assert (cell2mat (keys (m)), 1:n);
+%! remove (m, num2cell (2:2:n));
+%! assert (m.Count, uint64 (n/2));
+%! assert (isKey (m, {1, 2, n-1}), [true, false, true]);
+%! assert (values (m, {3, 5}), {6, 10});
+%! m2 = containers.Map (cellstr (num2str ((1:n)')), num2cell (1:n));
+%! assert (m2(strtrim (num2str (n))), n);
+
 ## Test input validation
 %!error containers.Map (1,2,3)
 %!error containers.Map (1,2,3,4,5)
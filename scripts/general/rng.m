@@ -40,10 +40,13 @@
 ##
 ## The optional string @var{generator} specifies the type of random number
 ## generator to be used.  Its value can be @qcode{"twister"},
-## @qcode{"v5uniform"}, or @qcode{"v5normal"}.  The @qcode{"twister"} keyword
-## is described below.  @qcode{"v5uniform"} and @qcode{"v5normal"} refer to
-## older versions of Octave that used to use a different random number
-## generator.
+## @qcode{"philox"}, @qcode{"v5uniform"}, or @qcode{"v5normal"}.  The
+## @qcode{"twister"} keyword is described below.  @qcode{"philox"} selects
+## the counter-based Philox4x32-10 generator, which fills large arrays on
+## multiple threads with results that do not depend on the number of threads
+## (@pxref{XREFrand,,@code{rand}}).  @qcode{"v5uniform"} and
+## @qcode{"v5normal"} refer to older versions of Octave that used to use a
+## different random number generator.
 ##
 ## The state or seed of the random number generator can be reset to a new
 ## random value using the @qcode{"shuffle"} keyword.
@@ -93,9 +96,26 @@ function s = rng (varargin)
   ## Type is the generator name.
   ## Seed is the initial seed value.
   ## State is a structure describing internal state of the generator.
-  srng = struct ("Type", "twister",
+  ## The Type is "philox" only if both rand and randn use the Philox
+  ## generator.  Otherwise, the state of a generator that uses Philox is
+  ## still stored as returned by rand ("philox") and recognized by its class
+  ## when it is restored.
+  state_rand = rand ("philox");
+  state_randn = randn ("philox");
+  if (! isempty (state_rand) && ! isempty (state_randn))
+    type = "philox";
+  else
+    type = "twister";
+    if (isempty (state_rand))
+      state_rand = rand ("state");
+    endif
+    if (isempty (state_randn))
+      state_randn = randn ("state");
+    endif
+  endif
+  srng = struct ("Type", type,
                  "Seed", "Not applicable",
-                 "State", {{rand("state"), randn("state")}});
+                 "State", {{state_rand, state_randn}});
 
   if (nargin == 0)
     s = srng;
@@ -138,9 +158,9 @@ function s = rng (varargin)
     generator = srng.Type;
   endif
   switch (generator)
-    case "twister"
-      rand ("state", s_rand);
-      randn ("state", s_randn);
+    case {"twister", "philox"}
+      set_state (@rand, s_rand, generator);
+      set_state (@randn, s_randn, generator);
 
     case "legacy"
       rand ("seed", s_rand);
@@ -164,6 +184,19 @@ function s = rng (varargin)
 endfunction
 
 
+## Restore the state S of the generator used by the function FCN.  States of
+## the Philox generator are uint32 arrays.
+
+function set_state (fcn, s, generator)
+
+  if (strcmp (generator, "philox") || isa (s, "uint32"))
+    fcn ("philox", s);
+  else
+    fcn ("state", s);
+  endif
+
+endfunction
+
 function gen = check_generator (val)
 
   if (isempty (val))
@@ -174,9 +207,9 @@ function gen = check_generator (val)
   endif
 
   gen = lower (char (val));
-  if (any (strcmp (gen, {"simdtwister", "combrecursive", "philox", "threefry", "multfibonacci", "v4"})))
+  if (any (strcmp (gen, {"simdtwister", "combrecursive", "threefry", "multfibonacci", "v4"})))
     error ('rng: random number generator "%s" is not available in Octave', gen);
-  elseif (! any (strcmp (gen, {"twister", "v5uniform", "v5normal"})))
+  elseif (! any (strcmp (gen, {"twister", "philox", "v5uniform", "v5normal"})))
     error ('rng: unknown random number generator "%s"', gen);
   endif
 
@@ -287,6 +320,50 @@ endfunction
 %!   rng (state);
 %! end_unwind_protect
 
+%!test
+%! state = rng ();
+%! unwind_protect
+%!   rng (42, "philox");
+%!   s = rng ();
+%!   assert (s.Type, "philox");
+%!   ru1 = rand (1, 3);
+%!   rn1 = randn (1, 3);
+%!   rng (s);
+%!   assert (rand (1, 3), ru1);
+%!   assert (randn (1, 3), rn1);
+%!   rng (42);
+%!   s = rng ();
+%!   assert (s.Type, "philox");
+%!   assert (rand (1, 3), ru1);
+%!   rng ("default");
+%!   s = rng ();
+%!   assert (s.Type, "twister");
+%! unwind_protect_cleanup
+%!   rng (state);
+%! end_unwind_protect
+
+## Only rand uses the Philox generator
+%!test
+%! state = rng ();
+%! unwind_protect
+%!   rng ("default");
+%!   rand ("philox", 42);
+%!   s = rng ();
+%!   assert (s.Type, "twister");
+%!   assert (class (s.State{1}), "uint32");
+%!   ru1 = rand (1, 3);
+%!   rn1 = randn (1, 3);
+%!   rng (s);
+%!   assert (rand (1, 3), ru1);
+%!   assert (randn (1, 3), rn1);
+%!   assert (isempty (randn ("philox")));
+%!   rng (s);
+%!   assert (isequal (rng (rng ()), s));
+%!   assert (rand (1, 3), ru1);
+%! unwind_protect_cleanup
+%!   rng (state);
+%! end_unwind_protect
+
 ## Test input validation
 %!error <Invalid call> rng (1, 2, 3)
 %!error <Invalid call> rng (eye (2))
@@ -301,6 +378,6 @@ endfunction
 %!error <input structure requires "Type">
 %! rng (struct ("Type1",[],"State",[],"Seed",[]));
 %!error <GENERATOR must be a string> rng (0, struct ())
-%!error <"philox" is not available in Octave> rng (0, "philox")
+%!error <"threefry" is not available in Octave> rng (0, "threefry")
 %!error <GENERATOR must be a string> rng ("shuffle", struct ())
 %!error <unknown random number generator "foobar"> rng ("shuffle", "foobar")
@@ -25,17 +25,36 @@
 
 ## -*- texinfo -*-
 ## @deftypefn  {} {} profile on
+## @deftypefnx {} {} profile on -lines
+## @deftypefnx {} {} profile on -sample
+## @deftypefnx {} {} profile ("on", "-sample", @var{interval})
 ## @deftypefnx {} {} profile off
 ## @deftypefnx {} {} profile resume
 ## @deftypefnx {} {} profile clear
 ## @deftypefnx {} {@var{S} =} profile ("status")
 ## @deftypefnx {} {@var{T} =} profile ("info")
+## @deftypefnx {} {@var{L} =} profile ("lines")
+## @deftypefnx {} {} profile ("flamegraph", @var{file})
 ## Control the built-in profiler.
 ##
 ## @table @code
 ## @item profile on
 ## Start the profiler.  Any previously collected data is cleared.
 ##
+## @item profile on -lines
+## In addition to the statistics for each function, record the number of
+## executions and the time spent on each line of user code.  The time of a
+## line includes the time of the functions called from it.
+##
+## @item profile on -sample
+## Instead of timing each call, take a snapshot of the call stack at regular
+## intervals of CPU time and attribute the interval to the functions and
+## lines on the stack.  This has a much lower overhead for code that makes
+## many short calls, but the results are statistical and no calls are
+## counted.  The default interval is 5@tie{}ms; a different one (in seconds)
+## can be given as third argument.  Sampling is not available on all
+## systems.
+##
 ## @item profile off
 ## Stop profiling.  The collected data can later be retrieved and examined
 ## with @code{T = profile ("info")}.
@@ -61,19 +80,55 @@
 ## index into the @code{FunctionTable} identifying the function it corresponds
 ## to as well as data fields for number of calls and time spent at this level
 ## in the call tree.
+##
+## @item @var{L} = profile ("lines")
+## Return the line statistics that were collected in the @option{-lines} or
+## @option{-sample} mode as a structure array with fields
+## @code{FunctionName}, @code{Line}, @code{NumCalls}, and @code{TotalTime}.
+##
+## @item profile ("flamegraph", @var{file})
+## Write the call tree to @var{file} in the collapsed stack format that is
+## used by flame graph tools such as @file{flamegraph.pl} or speedscope.
+## Each line contains the names of the functions on a call stack, separated
+## by semicolons, and the time in microseconds spent in the innermost
+## function.
 ## @end table
 ##
 ## @seealso{profshow, profexplore}
 ## @end deftypefn
 
-function retval = profile (arg)
+function retval = profile (arg, varargin)
 
   if (nargin < 1)
     print_usage ();
   endif
 
+  if (nargin > 1 && ! any (strcmp (arg, {"on", "flamegraph"})))
+    print_usage ();
+  endif
+
   switch (arg)
     case "on"
+      if (nargin == 1)
+        __profiler_mode__ ("functions");
+      elseif (nargin == 2 && strcmp (varargin{1}, "-lines"))
+        __profiler_mode__ ("lines");
+      elseif (nargin <= 3 && strcmp (varargin{1}, "-sample"))
+        if (nargin == 3)
+          interval = varargin{2};
+          if (ischar (interval))
+            interval = str2double (interval);
+          endif
+          if (! (isscalar (interval) && isreal (interval) && interval > 0))
+            error ("profile: INTERVAL must be a positive number");
+          endif
+          __profiler_mode__ ("samples", interval);
+        else
+          __profiler_mode__ ("samples");
+        endif
+      else
+        print_usage ();
+      endif
       __profiler_enable__ (true);
 
     case "off"
@@ -98,6 +153,23 @@ function retval = profile (arg)
       [flat, tree] = __profiler_data__ ();
       retval = struct ("FunctionTable", flat, "Hierarchical", tree);
 
+    case "lines"
+      retval = __profiler_lines__ ();
+
+    case "flamegraph"
+      if (nargin != 2 || ! ischar (varargin{1}))
+        print_usage ();
+      endif
+      [fid, msg] = fopen (varargin{1}, "wt");
+      if (fid < 0)
+        error ("profile: unable to open '%s': %s", varargin{1}, msg);
+      endif
+      unwind_protect
+        fputs (fid, __profiler_collapsed__ ());
+      unwind_protect_cleanup
+        fclose (fid);
+      end_unwind_protect
+
     otherwise
       warning ("profile: Unrecognized option '%s'", arg);
       print_usage ();
@@ -150,7 +222,65 @@ endfunction
 %! assert (size (hier), [0, 1]);
 %! assert (fieldnames (hier), {"Index"; "SelfTime"; "TotalTime"; "NumCalls"; "Children"});
 
+%!function r = __profile_test_fcn__ (n)
+%!  r = 0;
+%!  for i = 1:n
+%!    r += sum (sqrt (1:100));
+%!  endfor
+%!endfunction
+
+%!test
+%! profile ("clear");
+%! profile ("on", "-lines");
+%! __profile_test_fcn__ (10);
+%! profile ("off");
+%! L = profile ("lines");
+%! assert (fieldnames (L), {"FunctionName"; "Line"; "NumCalls"; "TotalTime"});
+%! L = L(strcmp ({L.FunctionName}, "__profile_test_fcn__"));
+%! assert (numel (L) >= 3);
+%! assert (max ([L.NumCalls]), 10);
+%! assert (all ([L.TotalTime] >= 0));
+%! profile ("clear");
+%! L = profile ("lines");
+%! assert (size (L), [0, 1]);
+
+%!test
+%! profile ("clear");
+%! profile ("on");
+%! __profile_test_fcn__ (100);
+%! profile ("off");
+%! f = [tempname() ".txt"];
+%! unwind_protect
+%!   profile ("flamegraph", f);
+%!   txt = fileread (f);
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+%! assert (! isempty (regexp (txt, '__profile_test_fcn__;sum \d+', 'once')));
+%! profile ("clear");
+
+%!testif ; ! ispc ()
+%! profile ("clear");
+%! profile ("on", "-sample", 0.001);
+%! t0 = cputime ();
+%! while (cputime () - t0 < 0.2)
+%!   __profile_test_fcn__ (100);
+%! endwhile
+%! profile ("off");
+%! T = profile ("info");
+%! assert (any (strcmp ({T.FunctionTable.FunctionName}, "__profile_test_fcn__")));
+%! assert (sum ([T.FunctionTable.TotalTime]) > 0);
+%! assert (all ([T.FunctionTable.NumCalls] == 0));
+%! profile ("clear");
+%! profile ("on");
+%! profile ("off");
+%! profile ("clear");
+
 ## Test input validation
 %!error <Invalid call> profile ()
 %!error profile ("on", 2)
 %!error profile ("INVALID_OPTION")
+%!error profile ("on", "-INVALID")
+%!error <INTERVAL must be a positive number> profile ("on", "-sample", -1)
+%!error profile ("off", "-lines")
+%!error profile ("flamegraph")
@@ -87,6 +87,26 @@ function [c, ia, ib] = intersect (a, b, varargin)
     isrowvec = isrow (a) && isrow (b);
   endif
 
+  if (! optlegacy && strcmp (class (a), class (b)) && hashable_setargs (a, b))
+    ## Keep the distinct elements of A that are found in B.
+    [a, ia] = unique (a, varargin{:});
+    [b, ib] = unique (b, varargin{:});
+    [tf, loc] = __ismember__ (a, b, by_rows);
+    if (by_rows)
+      c = a(tf,:);
+    else
+      c = a(tf);
+      c = c(:);
+      if (isrowvec)
+        c = c.';
+      endif
+    endif
+    ia = ia(tf(:));
+    ib = ib(loc(tf));
+    ib = ib(:);
+    return;
+  endif
+
   ## Form A and B into sets
   if (nargout > 1 || ! optsorted)
     [a, ia] = unique (a, varargin{:});
@@ -251,6 +271,24 @@ endfunction
 %! assert (ia, [1:3]');
 %! assert (ib, [1:3]');
 
+%!test
+%! a = {"d", "b", "a", "b", "e"};
+%! b = {"b", "c", "d", "d"};
+%! [c, ia, ib] = intersect (a, b);
+%! assert (c, {"b", "d"});
+%! assert (ia, [2; 1]);
+%! assert (ib, [1; 3]);
+%! [c, ia, ib] = intersect (a, b, "stable");
+%! assert (c, {"d", "b"});
+%! assert (ia, [1; 2]);
+%! assert (ib, [3; 1]);
+
+%!test
+%! [c, ia, ib] = intersect (uint16 ([4, 2, 1, 2, 5]), uint16 ([2, 3, 4, 4]));
+%! assert (c, uint16 ([2, 4]));
+%! assert (ia, [2; 1]);
+%! assert (ib, [1; 3]);
+
 ## Test "legacy" argument
 %!test
 %! a = [7 1 7 7 4];
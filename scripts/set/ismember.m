@@ -124,6 +124,11 @@ function [tf, s_idx] = ismember (a, s, varargin)
   ## FIXME: uncomment if bug #56692 is addressed.
   ## optlegacy = any (strcmp ("legacy", varargin));
 
+  if (hashable_setargs (a, s))
+    [tf, s_idx] = __ismember__ (a, s, by_rows);
+    return;
+  endif
+
   if (! by_rows)
     s = s(:);
     ## Check sort status, because we expect the array will often be sorted.
@@ -261,6 +266,16 @@ endfunction
 %! assert (result, logical ([1 0 0 0 1 0]'));
 %! assert (s_idx, [1 0 0 0 1 0]');
 
+%!test
+%! a = int8 ([1, 5, -3; 2, 1, 7]);
+%! s = [7, 1, 1, 9];
+%! [tf, s_idx] = ismember (a, s);
+%! assert (tf, logical ([1, 0, 0; 0, 1, 1]));
+%! assert (s_idx, [3, 0, 0; 0, 3, 1]);
+%! [tf, s_idx] = ismember (uint64 ([2^60, 3]), uint64 ([3, 2^60]));
+%! assert (tf, [true, true]);
+%! assert (s_idx, [2, 1]);
+
 %!test <*51187>
 %! assert (ismember ('b ', {'a ', 'b '}), true);
 
@@ -0,0 +1,61 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## -*- texinfo -*-
+## @deftypefn {} {@var{tf} =} hashable_setargs (@var{x}, @var{y})
+## Internal function to determine whether the set operations on @var{x} and
+## @var{y} can use the hash tables of @code{__unique__} and
+## @code{__ismember__}.
+##
+## This is the case for two cell arrays of strings that only contain row
+## vectors and for two real full arrays.  Arrays of different classes are
+## compared as double values, which is only exact if neither of them is a
+## 64-bit integer array.
+## @seealso{unique, ismember, intersect, setdiff}
+## @end deftypefn
+
+function tf = hashable_setargs (x, y)
+
+  if (iscellstr (x) || iscellstr (y))
+    tf = (iscellstr (x) && iscellstr (y)
+          && all_row_strings (x) && all_row_strings (y));
+  elseif (! (isnumeric (x) || ischar (x) || islogical (x))
+          || ! (isnumeric (y) || ischar (y) || islogical (y))
+          || issparse (x) || issparse (y) || iscomplex (x) || iscomplex (y)
+          || isobject (x) || isobject (y))
+    tf = false;
+  elseif (strcmp (class (x), class (y)))
+    tf = true;
+  else
+    tf = ! (isa (x, "int64") || isa (x, "uint64")
+            || isa (y, "int64") || isa (y, "uint64"));
+  endif
+
+endfunction
+
+## Character matrices in a cell array are compared as a whole.
+function tf = all_row_strings (c)
+  tf = all (cellfun ("size", c, 1) <= 1) && all (cellfun ("ndims", c) == 2);
+endfunction
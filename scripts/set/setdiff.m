@@ -77,14 +77,18 @@ function [c, ia] = setdiff (a, b, varargin)
       c = unique (a, varargin{:});
     endif
     if (! isempty (c) && ! isempty (b))
-      ## Form A and B into combined set.
-      b = unique (b, varargin{:});
-      [csort, idx] = sortrows ([c; b]);
-      ## Eliminate those elements of A that are the same as in B.
-      dups = find (all (csort(1:end-1,:) == csort(2:end,:), 2));
-      c(idx(dups),:) = [];
+      if (hashable_setargs (c, b))
+        dups = __ismember__ (c, b, true);
+      else
+        ## Form A and B into combined set.
+        b = unique (b, varargin{:});
+        [csort, idx] = sortrows ([c; b]);
+        ## Eliminate those elements of A that are the same as in B.
+        dups = idx(find (all (csort(1:end-1,:) == csort(2:end,:), 2)));
+      endif
+      c(dups,:) = [];
       if (nargout > 1)
-        ia(idx(dups),:) = [];
+        ia(dups,:) = [];
       endif
     endif
   else
@@ -94,16 +98,20 @@ function [c, ia] = setdiff (a, b, varargin)
       c = unique (a, varargin{:});
     endif
     if (! isempty (c) && ! isempty (b))
-      ## Form a and b into combined set.
-      b = unique (b);
-      [csort, idx] = sort ([c(:); b(:)]);
-      ## Eliminate those elements of a that are the same as in b.
-      if (iscellstr (csort))
-        dups = find (strcmp (csort(1:end-1), csort(2:end)));
+      if (hashable_setargs (c, b))
+        dups = __ismember__ (c, b, false);
       else
-        dups = find (csort(1:end-1) == csort(2:end));
+        ## Form a and b into combined set.
+        b = unique (b);
+        [csort, idx] = sort ([c(:); b(:)]);
+        ## Eliminate those elements of a that are the same as in b.
+        if (iscellstr (csort))
+          dups = idx(find (strcmp (csort(1:end-1), csort(2:end))));
+        else
+          dups = idx(find (csort(1:end-1) == csort(2:end)));
+        endif
       endif
-      c(idx(dups)) = [];
+      c(dups) = [];
 
       ## Reshape if necessary for Matlab compatibility.
       if (isrowvec)
@@ -113,7 +121,7 @@ function [c, ia] = setdiff (a, b, varargin)
       endif
 
       if (nargout > 1)
-        ia(idx(dups)) = [];
+        ia(dups) = [];
         if (optlegacy && isrowvec)
           ia = ia(:).';
         endif
@@ -170,6 +178,9 @@ endfunction
 %! assert (ia, [1; 5]);
 
 ## Test output orientation compatibility
+%!assert (setdiff (int8 ([3, 1, 2, 1]), [2, 5]), int8 ([1, 3]))
+%!assert (setdiff ({"a", "b"; "c", "a"}, {"a", "x"}), {"b"; "c"})
+
 %!assert <*42577> (setdiff ([1:5], 2), [1,3,4,5])
 %!assert <*42577> (setdiff ([1:5]', 2), [1;3;4;5])
 %!assert <*42577> (setdiff ([1:5], [2:3]), [1,4,5])
@@ -84,8 +84,9 @@
 ## outputs @var{i}, @var{j} will follow the shape of the input @var{x} rather
 ## than always being column vectors.
 ##
-## The third output, @var{j}, has not been implemented yet when the sort
-## order is @qcode{"stable"}.
+## Cell arrays of strings and real arrays that are not sparse are processed
+## with a hash table, which takes time proportional to the number of
+## elements.  Only the distinct values are sorted.
 ##
 ## @seealso{uniquetol, union, intersect, setdiff, setxor, ismember}
 ## @end deftypefn
@@ -186,6 +187,16 @@ function [y, i, j] = unique (x, varargin)
     return;
   endif
 
+  if (! optlegacy && hashable_setargs (x, x))
+    [i, j] = __unique__ (x, optrows, ! optfirst, ! optsorted);
+    if (optrows)
+      y = x(i,:);
+    else
+      y = x(i);
+    endif
+    return;
+  endif
+
   ## Calculate y output
   if (optrows)
     if (nargout > 1 || ! optsorted)
@@ -235,8 +246,10 @@ function [y, i, j] = unique (x, varargin)
     j = i;  # cheap way to copy dimensions
     j(i) = cumsum ([1; ! match(:)]);
     if (! optsorted)
-      warning ("unique: third output J is not yet implemented");
-      j = [];
+      ## Number the distinct values in the order of their first occurrence.
+      [~, p] = sort (i([true; ! match(:)]));
+      r(p) = 1:numel (p);
+      j = r(j)(:);
     endif
 
     if (optlegacy && isrowvec)
@@ -302,11 +315,10 @@ endfunction
 %! assert (j, [1;1;2;3;3;3;4]);
 
 %!test
-%! [y,i,~] = unique ([4,4,2,2,2,3,1], "stable");
+%! [y,i,j] = unique ([4,4,2,2,2,3,1], "stable");
 %! assert (y, [4,2,3,1]);
 %! assert (i, [1;3;6;7]);
-%! ## FIXME: 'j' input not calculated with stable
-%! ##assert (j, []);
+%! assert (j, [1;1;2;2;2;3;4]);
 
 %!test
 %! [y,i,j] = unique ([1,1,2,3,3,3,4]', "last");
@@ -335,11 +347,10 @@ endfunction
 
 %!test
 %! A = [4,5,6; 1,2,3; 4,5,6];
-%! [y,i,~] = unique (A, "rows", "stable");
+%! [y,i,j] = unique (A, "rows", "stable");
 %! assert (y, [4,5,6; 1,2,3]);
 %! assert (A(i,:), y);
-%! ## FIXME: 'j' output not calculated correctly with "stable"
-%! ##assert (y(j,:), A);
+%! assert (y(j,:), A);
 
 ## Test "legacy" option
 %!test
@@ -355,6 +366,30 @@ endfunction
 %! assert (i, [2; 5; 4; 3]);
 %! assert (j, [4; 1; 4; 3; 2]);
 
+## Test the paths for sparse and complex input
+%!test
+%! x = [2+i, 1, 2+i, 3; 1, 3, 2, 1];
+%! [y,i,j] = unique (x, "stable");
+%! assert (y, [2+i; 1; 3; 2]);
+%! assert (i, [1; 2; 4; 6]);
+%! assert (y(j), x(:));
+
+%!test
+%! x = sparse ([0, 2, 0, 1, 2]);
+%! [y,i,j] = unique (x);
+%! assert (y, sparse ([0, 1, 2]));
+%! assert (y(j), x(:).');
+
+%!test
+%! x = int32 (randi (50, 1000, 1));
+%! [y,i,j] = unique (x);
+%! [ys,is,js] = unique (double (x));
+%! assert (double (y), ys);
+%! assert (i, is);
+%! assert (j, js);
+%! assert (x(i), y);
+%! assert (y(j), x);
+
 ## Test input validation
 %!error <Invalid call> unique ()
 %!error <X must be an array or cell array of strings> unique ({1})
@@ -376,6 +411,3 @@ endfunction
 %!error <invalid option> unique ({"a", "b", "c"}, "rows", "UnknownOption2")
 %!error <invalid option> unique ({"a", "b", "c"}, "UnknownOption1", "last")
 %!warning <"rows" is ignored for cell arrays> unique ({"1"}, "rows");
-%!warning <third output J is not yet implemented>
-%! [y,i,j] = unique ([2,1], "stable");
-%! assert (j, []);
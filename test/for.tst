@@ -130,6 +130,145 @@
 %! __printf_assert__ ("\n");
 %! assert (__prog_output_assert__ ("1234"));
 
+## parfor loops executed by worker processes
+%!test
+%! old_val = parfor_num_workers (2);
+%! unwind_protect
+%!   a = 10 * (1:9);
+%!   y = zeros (1, 9);
+%!   z = zeros (2, 9);
+%!   s = 0;
+%!   p = 1;
+%!   c = [];
+%!   parfor i = 1:9
+%!     t = a(i) + 1;
+%!     y(i) = t;
+%!     z(:,i) = [i; -i];
+%!     s += i;
+%!     p = p * i;
+%!     c = [c, i];
+%!   endparfor
+%!   assert (y, a + 1);
+%!   assert (z, [1:9; -(1:9)]);
+%!   assert (s, 45);
+%!   assert (p, factorial (9));
+%!   assert (c, 1:9);
+%!   assert (i, 9);
+%! unwind_protect_cleanup
+%!   parfor_num_workers (old_val);
+%! end_unwind_protect
+
+%!test
+%! y = zeros (8, 1);
+%! parfor (i = 1:8, 4)
+%!   y(i) = i^2;
+%! endparfor
+%! assert (y, ((1:8).^2)');
+
+## Temporaries that carry values from one iteration to the next are not
+## split, and the others keep the value of the last iteration
+%!test
+%! old_val = parfor_num_workers (4);
+%! unwind_protect
+%!   y = zeros (1, 8);
+%!   last = 0;
+%!   parfor i = 1:8
+%!     y(i) = last;
+%!     last = i;
+%!   endparfor
+%!   assert (y, 0:7);
+%!   assert (last, 8);
+%!   w = zeros (1, 8);
+%!   s = -1;
+%!   parfor i = 1:8
+%!     if (mod (i, 2))
+%!       s = i;
+%!     endif
+%!     w(i) = s;
+%!   endparfor
+%!   assert (w, [1, 1, 3, 3, 5, 5, 7, 7]);
+%!   z = zeros (1, 8);
+%!   parfor i = 1:8
+%!     t = 2*i;
+%!     if (i < 6)
+%!       u = t;
+%!     endif
+%!     z(i) = t + 1;
+%!   endparfor
+%!   assert (z, 2*(1:8) + 1);
+%!   assert (t, 16);
+%!   assert (u, 10);
+%! unwind_protect_cleanup
+%!   parfor_num_workers (old_val);
+%! end_unwind_protect
+
+## Functions called through feval are executed serially
+%!test
+%! old_val = parfor_num_workers (2);
+%! unwind_protect
+%!   parfor i = 1:4
+%!     feval ("assignin", "base", "__parfor_feval_test__", i);
+%!   endparfor
+%!   assert (evalin ("base", "__parfor_feval_test__"), 4);
+%! unwind_protect_cleanup
+%!   evalin ("base", "clear __parfor_feval_test__");
+%!   parfor_num_workers (old_val);
+%! end_unwind_protect
+
+## Reductions keep the class of the initial value
+%!test
+%! old_val = parfor_num_workers (2);
+%! unwind_protect
+%!   x = uint8 (200);
+%!   y = int8 (-100);
+%!   s = single (0);
+%!   parfor i = 1:20
+%!     x -= i;
+%!     y += 10;
+%!     s += i;
+%!   endparfor
+%!   assert (x, uint8 (0));
+%!   assert (y, int8 (100));
+%!   assert (s, single (210));
+%!   x = uint8 (200);
+%!   parfor i = 1:4
+%!     x -= i;
+%!   endparfor
+%!   assert (x, uint8 (190));
+%! unwind_protect_cleanup
+%!   parfor_num_workers (old_val);
+%! end_unwind_protect
+
+%!error <must be a non-negative integer>
+%! parfor (i = 1:4, NaN)
+%! endparfor
+%!error <must be a non-negative integer>
+%! parfor (i = 1:4, -1)
+%! endparfor
+%!error <must be a non-negative integer>
+%! parfor (i = 1:4, 2.5)
+%! endparfor
+
+## Loops that can't be split are executed serially
+%!test
+%! old_val = parfor_num_workers (2);
+%! unwind_protect
+%!   x = 0;
+%!   parfor i = 1:4
+%!     x = 2*x + i;
+%!   endparfor
+%!   assert (x, 26);
+%! unwind_protect_cleanup
+%!   parfor_num_workers (old_val);
+%! end_unwind_protect
+
+%!error <parfor worker error>
+%! parfor (i = 1:4, 2)
+%!   if (i == 3)
+%!     error ("parfor worker error");
+%!   endif
+%! endparfor
+
 %!test <*55622>
 %! cnt = 0;
 %! for k = zeros (0,3)
@@ -233,3 +233,19 @@
 %!error <function called with too many outputs> r = __fn_narginout0__ ()
 %!error <function called with too many inputs>  __fn_no_arg_list__ (1)
 %!error <function called with too many outputs>  r = __fn_no_arg_list__ ()
+
+## Call sites must see functions that are redefined or cleared
+%!test
+%! unwind_protect
+%!   eval ("function r = __fn_lookup_cache__ (x), r = x; endfunction");
+%!   r = zeros (1, 3);
+%!   for k = 1:3
+%!     r(k) = __fn_lookup_cache__ (k);
+%!     eval (sprintf ("function r = __fn_lookup_cache__ (x), r = %d*x; endfunction", k+1));
+%!   endfor
+%!   assert (r, [1, 4, 9]);
+%!   clear __fn_lookup_cache__
+%!   assert (exist ("__fn_lookup_cache__"), 0);
+%! unwind_protect_cleanup
+%!   clear __fn_lookup_cache__
+%! end_unwind_protect
@@ -0,0 +1,89 @@
+#include <stdint.h>
+
+#include "mex.h"
+
+// To be called without arguments.
+//
+// Returns integer and character arrays created with
+// mxCreateNumericArray and mxCreateCharArray to test the mxArray ->
+// octave_value conversion, which borrows the data of the mxArray.
+// The last two outputs are an array that is modified after it was
+// passed to mexCallMATLAB, and the result of that call.
+
+#define MAKE_INT_ARRAY(TYPE, ID, LHS, V0, V1, V2, V3, V4, V5)   \
+  do                                                            \
+    {                                                           \
+      size_t i;                                                 \
+      mwSize dims[2] = { 2, 3 };                                \
+      TYPE vals[6] = { V0, V1, V2, V3, V4, V5 };                \
+      TYPE *data;                                               \
+      LHS = mxCreateNumericArray (2, dims, ID, mxREAL);         \
+      data = mxGetData (LHS);                                   \
+      for (i = 0; i < 6; i++)                                   \
+        data[i] = vals[i];                                      \
+    }                                                           \
+  while (0)
+
+void
+mexFunction (int nlhs, mxArray *plhs[],
+             int nrhs, const mxArray *prhs[])
+{
+  size_t i;
+  mwSize dims[2] = { 2, 3 };
+  mxChar *cdata;
+  uint16_t *udata;
+  mxArray *tmp;
+
+  if (nrhs != 0 || nlhs != 11)
+    mexErrMsgTxt ("invalid arguments");
+
+  MAKE_INT_ARRAY (int8_t, mxINT8_CLASS, plhs[0],
+                  INT8_MIN, -1, 0, 1, 2, INT8_MAX);
+
+  MAKE_INT_ARRAY (uint8_t, mxUINT8_CLASS, plhs[1],
+                  0, 1, 2, 3, 4, UINT8_MAX);
+
+  MAKE_INT_ARRAY (int16_t, mxINT16_CLASS, plhs[2],
+                  INT16_MIN, -1, 0, 1, 2, INT16_MAX);
+
+  MAKE_INT_ARRAY (uint16_t, mxUINT16_CLASS, plhs[3],
+                  0, 1, 2, 3, 4, UINT16_MAX);
+
+  MAKE_INT_ARRAY (int32_t, mxINT32_CLASS, plhs[4],
+                  INT32_MIN, -1, 0, 1, 2, INT32_MAX);
+
+  MAKE_INT_ARRAY (uint32_t, mxUINT32_CLASS, plhs[5],
+                  0, 1, 2, 3, 4, UINT32_MAX);
+
+  MAKE_INT_ARRAY (int64_t, mxINT64_CLASS, plhs[6],
+                  INT64_MIN, -1, 0, 1, 2, INT64_MAX);
+
+  MAKE_INT_ARRAY (uint64_t, mxUINT64_CLASS, plhs[7],
+                  0, 1, 2, 3, 4, UINT64_MAX);
+
+  plhs[8] = mxCreateCharArray (2, dims);
+
+  cdata = mxGetData (plhs[8]);
+
+  for (i = 0; i < 6; i++)
+    cdata[i] = 'a' + i;
+
+  // Convert the array for a call to mexCallMATLAB, then reuse it.
+
+  dims[0] = 1;
+  dims[1] = 4;
+
+  tmp = mxCreateNumericArray (2, dims, mxUINT16_CLASS, mxREAL);
+
+  udata = mxGetData (tmp);
+
+  for (i = 0; i < 4; i++)
+    udata[i] = i + 1;
+
+  mexCallMATLAB (1, &plhs[10], 1, &tmp, "cumsum");
+
+  for (i = 0; i < 4; i++)
+    udata[i] *= 10;
+
+  plhs[9] = tmp;
+}
@@ -0,0 +1,24 @@
+%!test
+%! [i8, u8, i16, u16, i32, u32, i64, u64, c, b, r] = mexinttst ();
+%! assert (i8, [intmin("int8"), 0, 2; -1, 1, intmax("int8")]);
+%! assert (u8, [0, 2, 4; 1, 3, intmax("uint8")]);
+%! assert (i16, [intmin("int16"), 0, 2; -1, 1, intmax("int16")]);
+%! assert (u16, [0, 2, 4; 1, 3, intmax("uint16")]);
+%! assert (i32, [intmin("int32"), 0, 2; -1, 1, intmax("int32")]);
+%! assert (u32, [0, 2, 4; 1, 3, intmax("uint32")]);
+%! assert (i64, [intmin("int64"), 0, 2; -1, 1, intmax("int64")]);
+%! assert (u64, [0, 2, 4; 1, 3, intmax("uint64")]);
+%! assert (c, ["ace"; "bdf"]);
+%! assert (b, uint16 ([10, 20, 30, 40]));
+%! assert (r, uint16 ([1, 3, 6, 10]));
+%! ## The values remain valid after the MEX file is unloaded.
+%! clear mexinttst;
+%! assert (i64, [intmin("int64"), 0, 2; -1, 1, intmax("int64")]);
+%! assert (u64, [0, 2, 4; 1, 3, intmax("uint64")]);
+%! assert (c, ["ace"; "bdf"]);
+%! assert (b, uint16 ([10, 20, 30, 40]));
+%! ## Modifying a copy does not change the original.
+%! x = i32;
+%! x(1) = 5;
+%! assert (x, [5, 0, 2; -1, 1, intmax("int32")]);
+%! assert (i32, [intmin("int32"), 0, 2; -1, 1, intmax("int32")]);